@@ -77,11 +77,18 @@ recompute path. Also enables more complicated dependencies beyond trees.
 
 #include <QCoreApplication>
 #include <QCryptographicHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 #include "Document.h"
 #include "Application.h"
 #include "DocumentObject.h"
 #include "MergeDocuments.h"
+#include "RecomputeProfile.h"
 #include <App/DocumentPy.h>
 
 #include <Base/Console.h>
@@ -153,15 +160,40 @@ struct DocumentP
     bool undoing; ///< document in the middle of undo or redo
     std::bitset<32> StatusBits;
     int iUndoMode;
-    unsigned int UndoMemSize;
+    std::size_t UndoMemSize;
     unsigned int UndoMaxStackSize;
+    // parallel recompute
+    bool concurrentRecompute;
+    QThread* recomputeThread;
+    QMutex recomputeMutex;
+    QMutex jobMutex;
+    QWaitCondition jobFinished;
+    std::vector<std::pair<DocumentObject*, bool> > finishedJobs;
+    // property changes of a worker thread, 'before' marks a before-change signal
+    struct DeferredChange {
+        const Property* prop;
+        bool before;
+    };
+    std::map<const DocumentObject*, std::vector<DeferredChange> > deferredChanges;
+    // skip the recompute of dependent objects if the outputs didn't change
+    bool skipUnchanged;
+    // property hashes after the last execution, keyed by property name so
+    // that removed dynamic properties don't leave dangling entries behind
+    std::map<const DocumentObject*, std::map<std::string, std::size_t> > valueHashes;
+    std::set<const DocumentObject*> unchangedObjects;
+    // recompute profiling
+    bool profiling;
+    RecomputeProfile profile;
+    std::map<QThread*, int> profileThreads;
+    // files that are read on demand (lazy restore)
+    std::vector<std::weak_ptr<Base::DeferredFile> > deferredFiles;
 #ifdef USE_OLD_DAG
     DependencyList DepList;
     std::map<DocumentObject*,Vertex> VertexObjectList;
     std::map<Vertex,DocumentObject*> vertexMap;
 #endif //USE_OLD_DAG
 
-    DocumentP() {
+    DocumentP() : recomputeMutex(QMutex::Recursive) {
         activeObject = 0;
         activeUndoTransaction = 0;
         iTransactionMode = 0;
@@ -173,6 +205,64 @@ struct DocumentP
         iUndoMode = 0;
         UndoMemSize = 0;
         UndoMaxStackSize = 20;
+        concurrentRecompute = false;
+        recomputeThread = 0;
+        skipUnchanged = false;
+        profiling = false;
+    }
+
+    /// true if the object has a property changed since the last recompute
+    static bool hasTouchedProperty(const DocumentObject* obj)
+    {
+        std::vector<Property*> props;
+        obj->getPropertyList(props);
+        for (auto prop : props) {
+            if (prop->isTouched())
+                return true;
+        }
+        return false;
+    }
+
+    /*!
+      Returns true if the last execution of \a obj didn't change any of its
+      properties. A touched property counts as unchanged if it supports
+      hashing and its hash is the same as after the previous execution.
+      Adding or removing a hashable property counts as a change.
+     */
+    bool isOutputUnchanged(const DocumentObject* obj)
+    {
+        std::vector<Property*> props;
+        obj->getPropertyList(props);
+
+        bool unchanged = true;
+        std::map<std::string, std::size_t> hashes;
+        for (auto prop : props) {
+            std::size_t hash;
+            const char* name = prop->getName();
+            if (name && prop->getValueHash(hash))
+                hashes[name] = hash;
+            else if (prop->isTouched())
+                unchanged = false;
+        }
+
+        QMutexLocker locker(concurrentRecompute ? &recomputeMutex : 0);
+        std::map<std::string, std::size_t>& last = valueHashes[obj];
+        if (last != hashes)
+            unchanged = false;
+        last.swap(hashes);
+        return unchanged;
+    }
+
+    /// forget the stored hashes of the properties of \a obj
+    void clearValueHashes(const DocumentObject* obj)
+    {
+        valueHashes.erase(obj);
+        unchangedObjects.erase(obj);
+    }
+
+    /// true if called from a worker thread of a parallel recompute
+    bool isRecomputeWorker() const {
+        return concurrentRecompute && QThread::currentThread() != recomputeThread;
     }
 
     static
@@ -184,6 +274,87 @@ struct DocumentP
     partialTopologicalSort(const std::vector<App::DocumentObject*>& objects) const;
 };
 
+/// Starts and stops the recompute profile of a document
+class RecomputeProfileLocker
+{
+public:
+    RecomputeProfileLocker(DocumentP* d) : d(d)
+    {
+        if (d->profiling) {
+            d->profile.start();
+            d->profileThreads.clear();
+            d->profileThreads[QThread::currentThread()] = 0;
+        }
+    }
+    ~RecomputeProfileLocker()
+    {
+        if (d->profiling)
+            d->profile.stop();
+    }
+
+private:
+    DocumentP* d;
+};
+
+/// Records the execution of an object in the recompute profile
+class ObjectProfiler
+{
+public:
+    ObjectProfiler(DocumentP* d, DocumentObject* obj)
+      : d(d), obj(obj), active(d->profiling), memSize(0)
+    {
+        if (!active)
+            return;
+
+        const char* name = obj->getNameInDocument();
+        entry.name = name ? name : "";
+        entry.label = obj->Label.getValue();
+
+        // the touched input properties are the reason for the recompute
+        std::vector<Property*> props;
+        obj->getPropertyList(props);
+        for (auto prop : props) {
+            if (prop->isTouched()) {
+                if (!entry.reason.empty())
+                    entry.reason += ", ";
+                entry.reason += obj->getPropertyName(prop);
+            }
+        }
+        if (entry.reason.empty()) {
+            if (obj->ExpressionEngine.isTouched())
+                entry.reason = "Expressions";
+            else
+                entry.reason = "Dependencies";
+        }
+
+        memSize = obj->getMemSize();
+        entry.start = d->profile.elapsed();
+    }
+    ~ObjectProfiler()
+    {
+        if (!active)
+            return;
+
+        entry.duration = d->profile.elapsed() - entry.start;
+        entry.memoryDelta = static_cast<long long>(obj->getMemSize()) - static_cast<long long>(memSize);
+
+        QMutexLocker locker(d->concurrentRecompute ? &d->recomputeMutex : 0);
+        QThread* thread = QThread::currentThread();
+        auto it = d->profileThreads.find(thread);
+        if (it == d->profileThreads.end())
+            it = d->profileThreads.insert(std::make_pair(thread, static_cast<int>(d->profileThreads.size()))).first;
+        entry.thread = it->second;
+        d->profile.addEntry(obj, entry);
+    }
+
+private:
+    DocumentP* d;
+    DocumentObject* obj;
+    bool active;
+    unsigned int memSize;
+    RecomputeProfileEntry entry;
+};
+
 } // namespace App
 
 PROPERTY_SOURCE(App::Document, App::PropertyContainer)
@@ -1006,6 +1177,16 @@ void Document::commitTransaction()
             delete mUndoTransactions.front();
             mUndoTransactions.pop_front();
         }
+        // check the memory budget but always keep the last transaction
+        if (d->UndoMemSize > 0) {
+            std::size_t size = getUndoMemSize();
+            while (size > d->UndoMemSize && mUndoTransactions.size() > 1) {
+                std::size_t front = mUndoTransactions.front()->getOwnedMemSize();
+                size = size > front ? size - front : 0;
+                delete mUndoTransactions.front();
+                mUndoTransactions.pop_front();
+            }
+        }
         signalCommitTransaction(*this);
     }
 }
@@ -1091,12 +1272,20 @@ int Document::getUndoMode(void) const
     return d->iUndoMode;
 }
 
-unsigned int Document::getUndoMemSize (void) const
+std::size_t Document::getUndoMemSize (void) const
 {
-    return d->UndoMemSize;
+    std::size_t size = 0;
+    std::list<Transaction*>::const_iterator it;
+    for (it = mUndoTransactions.begin(); it != mUndoTransactions.end(); ++it)
+        size += (*it)->getOwnedMemSize();
+    for (it = mRedoTransactions.begin(); it != mRedoTransactions.end(); ++it)
+        size += (*it)->getOwnedMemSize();
+    if (d->activeUndoTransaction)
+        size += d->activeUndoTransaction->getOwnedMemSize();
+    return size;
 }
 
-void Document::setUndoLimit(unsigned int UndoMemSize)
+void Document::setUndoLimit(std::size_t UndoMemSize)
 {
     d->UndoMemSize = UndoMemSize;
 }
@@ -1160,8 +1349,21 @@ void Document::onChanged(const Property* prop)
 
 void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Property *What)
 {
-    if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId()))
-        signalBeforeChangeObject(*static_cast<const App::DocumentObject*>(Who), *What);
+    // the connected slots are not thread-safe, so changes made by a worker
+    // thread of a parallel recompute are signaled by the recompute thread
+    // together with the after-change signals once the object has finished
+    bool worker = d->isRecomputeWorker();
+    QMutexLocker locker(d->concurrentRecompute ? &d->recomputeMutex : 0);
+    if(Who->isDerivedFrom(App::DocumentObject::getClassTypeId())) {
+        const App::DocumentObject* obj = static_cast<const App::DocumentObject*>(Who);
+        if (worker) {
+            DocumentP::DeferredChange change = {What, true};
+            d->deferredChanges[obj].push_back(change);
+        }
+        else {
+            signalBeforeChangeObject(*obj, *What);
+        }
+    }
 
     if (d->activeUndoTransaction && !d->rollback)
         d->activeUndoTransaction->addObjectChange(Who,What);
@@ -1169,6 +1371,15 @@ void Document::onBeforeChangeProperty(const TransactionalObject *Who, const Prop
 
 void Document::onChangedProperty(const DocumentObject *Who, const Property *What)
 {
+    // changes made by a worker thread are signaled by the recompute
+    // thread once the object has finished
+    if (d->isRecomputeWorker()) {
+        QMutexLocker locker(&d->recomputeMutex);
+        DocumentP::DeferredChange change = {What, false};
+        d->deferredChanges[Who].push_back(change);
+        return;
+    }
+
     signalChangedObject(*Who, *What);
 }
 
@@ -1644,7 +1855,7 @@ unsigned int Document::getMemSize (void) const
     size += PropertyContainer::getMemSize();
 
     // Undo Redo size
-    size += getUndoMemSize();
+    size += static_cast<unsigned int>(getUndoMemSize());
 
     return size;
 }
@@ -1718,6 +1929,10 @@ bool Document::saveToFile(const char* filename) const
     }
     Base::FileInfo tmp(fn);
 
+    // the files of a lazily restored document must be read before the
+    // archive they come from gets replaced
+    restoreDeferredFiles();
+
     // open extra scope to close ZipWriter properly
     {
         Base::ofstream file(tmp, std::ios::out | std::ios::binary);
@@ -1728,6 +1943,8 @@ bool Document::saveToFile(const char* filename) const
 
         writer.setComment("FreeCAD Document");
         writer.setLevel(compression);
+        // 0 means as many threads as there are cores, 1 disables parallel saving
+        writer.setThreadCount(hGrp->GetInt("SaveThreads", 0));
         writer.putNextEntry("Document.xml");
 
         if (hGrp->GetBool("SaveBinaryBrep", false))
@@ -1818,6 +2035,37 @@ bool Document::saveToFile(const char* filename) const
     return true;
 }
 
+namespace {
+/// Reads the files of a lazily restored document into memory in the background
+class DeferredFilePrefetcher : public QRunnable
+{
+public:
+    DeferredFilePrefetcher(const std::vector<std::weak_ptr<Base::DeferredFile> >& files, std::size_t maxBytes)
+        : files(files), maxBytes(maxBytes)
+    {
+    }
+    virtual void run()
+    {
+        Base::DeferredFile::fetchAll(files, maxBytes);
+    }
+
+private:
+    std::vector<std::weak_ptr<Base::DeferredFile> > files;
+    std::size_t maxBytes;
+};
+}
+
+void Document::restoreDeferredFiles() const
+{
+    std::vector<std::weak_ptr<Base::DeferredFile> > files;
+    files.swap(d->deferredFiles);
+    for (std::vector<std::weak_ptr<Base::DeferredFile> >::iterator it = files.begin(); it != files.end(); ++it) {
+        std::shared_ptr<Base::DeferredFile> file = it->lock();
+        if (file)
+            file->restore();
+    }
+}
+
 // Open the document
 void Document::restore (void)
 {
@@ -1853,6 +2101,12 @@ void Document::restore (void)
     if (!reader.isValid())
         throw Base::FileException("Error reading compression file",FileName.getValue());
 
+    // Lazy restore: big data files of e.g. shapes or meshes are read from the
+    // archive on demand when the data is accessed the first time
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document");
+    reader.setLazyRestore(hGrp->GetBool("LazyRestore", false));
+    d->deferredFiles.clear();
+
     GetApplication().signalStartRestoreDocument(*this);
     setStatus(Document::Restoring, true);
 
@@ -1870,6 +2124,14 @@ void Document::restore (void)
     signalRestoreDocument(reader);
     reader.readFiles(zipstream);
 
+    const std::vector<std::shared_ptr<Base::DeferredFile> >& deferred = reader.getDeferredFiles();
+    d->deferredFiles.assign(deferred.begin(), deferred.end());
+    if (!d->deferredFiles.empty() && hGrp->GetBool("LazyRestorePrefetch", true)) {
+        // read the files into memory in the background up to the given size in MB
+        std::size_t maxBytes = static_cast<std::size_t>(hGrp->GetUnsigned("LazyRestorePrefetchSize", 256)) * 1024 * 1024;
+        QThreadPool::globalInstance()->start(new DeferredFilePrefetcher(d->deferredFiles, maxBytes));
+    }
+
     // reset all touched
     for (std::map<std::string,DocumentObject*>::iterator It= d->objectMap.begin();It!=d->objectMap.end();++It) {
         It->second->connectRelabelSignals();
@@ -2288,6 +2550,12 @@ int Document::recompute()
         return 0;
 
     Base::ObjectStatusLocker<Document::Status, Document> exe(Document::Recomputing, this);
+    RecomputeProfileLocker profile(d);
+
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document");
+    d->skipUnchanged = hGrp->GetBool("SkipUnchangedOutputs", false);
+    d->unchangedObjects.clear();
 
     // delete recompute log
     for (auto LogEntry: _RecomputeLog)
@@ -2305,6 +2573,9 @@ int Document::recompute()
         cerr << "App::Document::recompute(): cyclic dependency detected" << endl;
         topoSortedObjects = d->partialTopologicalSort(d->objectArray);
     }
+    else if (hGrp->GetBool("ParallelRecompute", false)) {
+        return _recomputeParallel(topoSortedObjects);
+    }
 
     for (auto objIt = topoSortedObjects.rbegin(); objIt != topoSortedObjects.rend(); ++objIt){
         // ask the object if it should be recomputed
@@ -2322,9 +2593,12 @@ int Document::recompute()
 
         if ((*objIt)->isTouched() || doRecompute) {
             (*objIt)->purgeTouched();
-            // force recompute of all dependent objects
-            for (auto inObjIt : (*objIt)->getInList())
-                inObjIt->enforceRecompute();
+            // force recompute of all dependent objects unless the
+            // execution left the outputs unchanged
+            if (d->unchangedObjects.erase(*objIt) == 0) {
+                for (auto inObjIt : (*objIt)->getInList())
+                    inObjIt->enforceRecompute();
+            }
         }
     }
 
@@ -2343,6 +2617,247 @@ int Document::recompute()
 
 #endif // USE_OLD_DAG
 
+namespace App {
+class RecomputeRunnable : public QRunnable
+{
+public:
+    RecomputeRunnable(const std::function<void()>& f) : func(f)
+    {
+    }
+    virtual void run()
+    {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+
+// switches the document into the state of a parallel recompute and restores
+// the previous state when leaving the scope, also if an exception is thrown
+class ConcurrentRecompute
+{
+public:
+    ConcurrentRecompute(DocumentP* d, QThreadPool& pool) : d(d), pool(pool)
+    {
+        d->recomputeThread = QThread::currentThread();
+        d->concurrentRecompute = true;
+        d->finishedJobs.clear();
+        d->deferredChanges.clear();
+        // the console observers may only be notified from the main thread
+        Base::Console().SetConnectionMode(Base::ConsoleSingleton::Queued);
+    }
+    ~ConcurrentRecompute()
+    {
+        finish();
+        d->deferredChanges.clear();
+    }
+    // waits for the jobs that were started and leaves the concurrent mode
+    void finish()
+    {
+        if (!d->concurrentRecompute)
+            return;
+        pool.waitForDone();
+        d->concurrentRecompute = false;
+        d->recomputeThread = 0;
+        d->finishedJobs.clear();
+        Base::Console().SetConnectionMode(Base::ConsoleSingleton::Direct);
+    }
+
+private:
+    DocumentP* d;
+    QThreadPool& pool;
+};
+}
+
+// signals the property changes of a worker thread in their original order
+static void replayChanges(Document& doc, const DocumentObject& obj,
+                          const std::vector<DocumentP::DeferredChange>& changes)
+{
+    for (auto change : changes) {
+        if (change.before)
+            doc.signalBeforeChangeObject(obj, *change.prop);
+        else
+            doc.signalChangedObject(obj, *change.prop);
+    }
+}
+
+/*!
+  Recomputes the objects in \a topoSortedObjects like the serial recompute does
+  but executes independent objects concurrently on a pool of worker threads.
+  An object becomes ready as soon as all objects of its OutList have been
+  handled. Objects for which \ref DocumentObject::isExecuteThreadSafe() returns
+  false are recomputed in the calling thread while no worker thread is active.
+
+  While the workers are running, writes to properties are serialized through the
+  document and the signalBeforeChangeObject() and signalChangedObject()
+  notifications are replayed in order in the calling thread when the object has
+  finished. The number of threads can be set with the parameter
+  'RecomputeThreads' (0 means the number of cores).
+ */
+int Document::_recomputeParallel(const std::vector<App::DocumentObject*>& topoSortedObjects)
+{
+    ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Document");
+    int numThreads = hGrp->GetInt("RecomputeThreads", 0);
+    if (numThreads <= 0)
+        numThreads = QThread::idealThreadCount();
+
+    // number of not yet handled dependencies of each object
+    std::map<DocumentObject*, int> pending;
+    std::set<DocumentObject*> inDocument(topoSortedObjects.begin(), topoSortedObjects.end());
+    for (auto obj : topoSortedObjects) {
+        auto out = obj->getOutList();
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        int count = 0;
+        for (auto dep : out) {
+            if (dep != obj && inDocument.find(dep) != inDocument.end())
+                count++;
+        }
+        pending[obj] = count;
+    }
+
+    // go through the objects in the order of the serial recompute to get
+    // a deterministic order of the ready objects
+    std::list<DocumentObject*> ready;
+    std::list<DocumentObject*> readySerial;
+    for (auto objIt = topoSortedObjects.rbegin(); objIt != topoSortedObjects.rend(); ++objIt) {
+        if (pending[*objIt] == 0)
+            ready.push_back(*objIt);
+    }
+
+    int objectCount = 0;
+    int running = 0;
+    bool abort = false;
+
+    auto finish = [&](DocumentObject* obj, bool doRecompute) {
+        auto in = obj->getInList();
+        std::sort(in.begin(), in.end());
+        in.erase(std::unique(in.begin(), in.end()), in.end());
+        if (obj->isTouched() || doRecompute) {
+            obj->purgeTouched();
+            // force recompute of all dependent objects unless the
+            // execution left the outputs unchanged
+            bool unchanged;
+            {
+                QMutexLocker locker(&d->recomputeMutex);
+                unchanged = d->unchangedObjects.erase(obj) > 0;
+            }
+            if (!unchanged) {
+                for (auto inObj : in)
+                    inObj->enforceRecompute();
+            }
+        }
+        for (auto inObj : in) {
+            auto it = pending.find(inObj);
+            if (it != pending.end() && --it->second == 0)
+                ready.push_back(inObj);
+        }
+    };
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+    ConcurrentRecompute concurrent(d, pool);
+
+    while (!abort) {
+        while (!ready.empty() && !abort) {
+            DocumentObject* obj = ready.front();
+            ready.pop_front();
+            if (!obj->mustRecompute()) {
+                finish(obj, false);
+            }
+            else if (!obj->isExecuteThreadSafe() || numThreads < 2) {
+                readySerial.push_back(obj);
+            }
+            else {
+                running++;
+                pool.start(new RecomputeRunnable([this, obj]() {
+                    bool stop = true;
+                    try {
+                        stop = _recomputeFeature(obj);
+                    }
+                    catch (...) {
+                    }
+                    QMutexLocker locker(&d->jobMutex);
+                    d->finishedJobs.push_back(std::make_pair(obj, stop));
+                    d->jobFinished.wakeAll();
+                }));
+            }
+        }
+
+        // objects which are not thread-safe are only handled while no worker is active
+        if (running == 0 && !readySerial.empty() && !abort) {
+            DocumentObject* obj = readySerial.front();
+            readySerial.pop_front();
+            objectCount++;
+            if (_recomputeFeature(obj)) {
+                abort = true;
+                break;
+            }
+            signalRecomputedObject(*obj);
+            finish(obj, true);
+            continue;
+        }
+
+        if (running == 0)
+            break;
+
+        std::vector<std::pair<DocumentObject*, bool> > jobs;
+        {
+            QMutexLocker locker(&d->jobMutex);
+            while (d->finishedJobs.empty())
+                d->jobFinished.wait(&d->jobMutex);
+            jobs.swap(d->finishedJobs);
+        }
+
+        for (auto job : jobs) {
+            running--;
+            objectCount++;
+
+            std::vector<DocumentP::DeferredChange> changes;
+            {
+                QMutexLocker locker(&d->recomputeMutex);
+                auto it = d->deferredChanges.find(job.first);
+                if (it != d->deferredChanges.end()) {
+                    changes.swap(it->second);
+                    d->deferredChanges.erase(it);
+                }
+            }
+            replayChanges(*this, *job.first, changes);
+
+            if (job.second) {
+                abort = true;
+                continue;
+            }
+
+            signalRecomputedObject(*job.first);
+            finish(job.first, true);
+        }
+    }
+
+    // wait for the jobs that were started before an abort
+    concurrent.finish();
+    for (auto it : d->deferredChanges)
+        replayChanges(*this, *it.first, it.second);
+    d->deferredChanges.clear();
+
+    if (abort)
+        return -1;
+
+    // check if all objects are recalculated which were touched
+    for (auto objectIt : d->objectArray) {
+        if (objectIt->isTouched()) {
+            Base::Console().Warning("Document::recompute(): %s still touched after recompute\n",
+                                    objectIt->getNameInDocument());
+        }
+    }
+
+    signalRecomputed(*this);
+
+    return objectCount;
+}
+
 /*!
   Does almost the same as topologicalSort() until no object with an input degree of zero
   can be found. It then searches for objects with an output degree of zero until neither
@@ -2505,6 +3020,21 @@ std::vector<App::DocumentObject*> Document::topologicalSort() const
     return d->topologicalSort(d->objectArray);
 }
 
+void Document::setRecomputeProfiling(bool on)
+{
+    d->profiling = on;
+}
+
+bool Document::isRecomputeProfiling() const
+{
+    return d->profiling;
+}
+
+const RecomputeProfile& Document::getRecomputeProfile() const
+{
+    return d->profile;
+}
+
 const char * Document::getErrorDescription(const App::DocumentObject*Obj) const
 {
     for (std::vector<App::DocumentObjectExecReturn*>::const_iterator it=_RecomputeLog.begin();it!=_RecomputeLog.end();++it)
@@ -2520,12 +3050,23 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     std::clog << "Solv: Executing Feature: " << Feat->getNameInDocument() << std::endl;;
 #endif
 
+    // the log is shared with the worker threads of a parallel recompute
+    auto addLog = [this](DocumentObjectExecReturn* ret) {
+        QMutexLocker locker(d->concurrentRecompute ? &d->recomputeMutex : 0);
+        _RecomputeLog.push_back(ret);
+    };
+
+    ObjectProfiler profiler(d, Feat);
+
+    // objects with changed inputs always propagate the recompute
+    bool inputTouched = d->skipUnchanged && DocumentP::hasTouchedProperty(Feat);
+
     DocumentObjectExecReturn  *returnCode = 0;
     try {
         returnCode = Feat->ExpressionEngine.execute();
         if (returnCode != DocumentObject::StdReturn) {
             returnCode->Which = Feat;
-            _RecomputeLog.push_back(returnCode);
+            addLog(returnCode);
     #ifdef FC_DEBUG
             Base::Console().Error("Error in feature: %s\n%s\n",Feat->getNameInDocument(),returnCode->Why.c_str());
     #endif
@@ -2537,32 +3078,32 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     }
     catch(Base::AbortException &e){
         e.ReportException();
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("User abort",Feat));
+        addLog(new DocumentObjectExecReturn("User abort",Feat));
         Feat->setError();
         return true;
     }
     catch (const Base::MemoryException& e) {
         Base::Console().Error("Memory exception in feature '%s' thrown: %s\n",Feat->getNameInDocument(),e.what());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("Out of memory exception",Feat));
+        addLog(new DocumentObjectExecReturn("Out of memory exception",Feat));
         Feat->setError();
         return true;
     }
     catch (Base::Exception &e) {
         e.ReportException();
-        _RecomputeLog.push_back(new DocumentObjectExecReturn(e.what(),Feat));
+        addLog(new DocumentObjectExecReturn(e.what(),Feat));
         Feat->setError();
         return false;
     }
     catch (std::exception &e) {
         Base::Console().Warning("exception in Feature \"%s\" thrown: %s\n",Feat->getNameInDocument(),e.what());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn(e.what(),Feat));
+        addLog(new DocumentObjectExecReturn(e.what(),Feat));
         Feat->setError();
         return false;
     }
 #ifndef FC_DEBUG
     catch (...) {
         Base::Console().Error("App::Document::_RecomputeFeature(): Unknown exception in Feature \"%s\" thrown\n",Feat->getNameInDocument());
-        _RecomputeLog.push_back(new DocumentObjectExecReturn("Unknown exception!"));
+        addLog(new DocumentObjectExecReturn("Unknown exception!"));
         Feat->setError();
         return true;
     }
@@ -2571,10 +3112,15 @@ bool Document::_recomputeFeature(DocumentObject* Feat)
     // error code
     if (returnCode == DocumentObject::StdReturn) {
         Feat->resetError();
+        // the hashes must be updated even if the inputs were changed
+        if (d->skipUnchanged && d->isOutputUnchanged(Feat) && !inputTouched) {
+            QMutexLocker locker(d->concurrentRecompute ? &d->recomputeMutex : 0);
+            d->unchangedObjects.insert(Feat);
+        }
     }
     else {
         returnCode->Which = Feat;
-        _RecomputeLog.push_back(returnCode);
+        addLog(returnCode);
 #ifdef FC_DEBUG
         Base::Console().Error("Error in feature: %s\n%s\n",Feat->getNameInDocument(),returnCode->Why.c_str());
 #endif
@@ -2869,6 +3415,7 @@ void Document::removeObject(const char* sName)
 
     // Before deleting we must nullify all dependent objects
     breakDependency(pos->second, true);
+    d->clearValueHashes(pos->second);
 
     //and remove the tip if needed
     if (Tip.getValue() && strcmp(Tip.getValue()->getNameInDocument(), sName)==0) {
@@ -2943,6 +3490,7 @@ void Document::_removeObject(DocumentObject* pcObject)
     // remove from map
     pcObject->setStatus(ObjectStatus::Remove, false); // Unset the bit to be on the safe side
     d->objectMap.erase(pos);
+    d->clearValueHashes(pcObject);
 
     for (std::vector<DocumentObject*>::iterator it = d->objectArray.begin(); it != d->objectArray.end(); ++it) {
         if (*it == pcObject) {
@@ -52,6 +52,7 @@ namespace App
     class DocumentPy; // the python document class
     class Application;
     class Transaction;
+    class RecomputeProfile;
 }
 
 namespace App
@@ -177,6 +178,10 @@ public:
     bool saveCopy(const char* file) const;
     /// Restore the document from the file in Property Path
     void restore (void);
+    /** Reads the content of all files that haven't been read yet because the
+     * document has been restored lazily (see the LazyRestore parameter).
+     */
+    void restoreDeferredFiles() const;
     void exportObjects(const std::vector<App::DocumentObject*>&, std::ostream&);
     void exportGraphviz(std::ostream&) const;
     std::vector<App::DocumentObject*> importObjects(Base::XMLReader& reader);
@@ -281,6 +286,12 @@ public:
     const std::vector<App::DocumentObjectExecReturn*> &getRecomputeLog(void)const{return _RecomputeLog;}
     /// get the text of the error of a specified object
     const char* getErrorDescription(const App::DocumentObject*) const;
+    /// enable or disable the collection of timing data for recomputes
+    void setRecomputeProfiling(bool on);
+    /// check whether timing data for recomputes are collected
+    bool isRecomputeProfiling() const;
+    /// get the timing data of the last recompute run
+    const RecomputeProfile& getRecomputeProfile() const;
     /// return the status bits
     bool testStatus(Status pos) const;
     /// set the status bits
@@ -307,10 +318,12 @@ public:
     /// Check if a transaction is open and its list is empty.
     /// If no transaction is open true is returned.
     bool isTransactionEmpty() const;
-    /// Set the Undo limit in Byte!
-    void setUndoLimit(unsigned int UndoMemSize=0);
+    /** Set the Undo limit in Byte! If the memory consumption of the undo stack
+     * exceeds this limit the oldest transactions are dropped. 0 means no limit.
+     */
+    void setUndoLimit(std::size_t UndoMemSize=0);
     /// Returns the actual memory consumption of the Undo redo stuff.
-    unsigned int getUndoMemSize (void) const;
+    std::size_t getUndoMemSize (void) const;
     /// Set the Undo limit as stack size
     void setMaxUndoStackSize(unsigned int UndoMaxStackSize=20);
     /// Set the Undo limit as stack size
@@ -396,6 +409,8 @@ protected:
     /// helper which Recompute only this feature
     /// @return True if the recompute process of the Document shall be stopped, False if it shall be continued.
     bool _recomputeFeature(DocumentObject* Feat);
+    /// helper which recomputes the sorted objects on a pool of worker threads
+    int _recomputeParallel(const std::vector<App::DocumentObject*>& topoSortedObjects);
     void _clearRedos();
 
     /// refresh the internal dependency graph
@@ -172,6 +172,13 @@ short DocumentObject::mustExecute(void) const
     return 0;
 }
 
+bool DocumentObject::isExecuteThreadSafe(void) const
+{
+    // most features call into OCC, the mesh kernel or the Python interpreter
+    // which are not reentrant, so only audited classes opt in
+    return false;
+}
+
 const char* DocumentObject::getStatusString(void) const
 {
     if (isError()) {
@@ -200,6 +200,17 @@ public:
      */
     virtual short mustExecute(void) const;
 
+    /** isExecuteThreadSafe
+     *  Returns true if execute() of this object may be called from a worker
+     *  thread of the parallel recompute, concurrently with the execution of
+     *  other objects of the same document. The default is false, then the
+     *  object is recomputed in the thread that started the recompute while no
+     *  worker thread is active. A subclass may only return true if its
+     *  execute() neither calls into the Python interpreter nor modifies global
+     *  state, e.g. of OCC or the mesh kernel.
+     */
+    virtual bool isExecuteThreadSafe(void) const;
+
     /// Recompute only this feature
     bool recomputeFeature();
 
@@ -32,6 +32,7 @@
 #include "DocumentObject.h"
 #include "DocumentObjectPy.h"
 #include "MergeDocuments.h"
+#include "RecomputeProfile.h"
 
 // inclusion of the generated files (generated By DocumentPy.xml)
 #include "DocumentPy.h"
@@ -414,6 +415,61 @@ PyObject*  DocumentPy::recompute(PyObject * args)
     }
 }
 
+PyObject*  DocumentPy::recomputeProfile(PyObject * args)
+{
+    char* format = 0;
+    if (!PyArg_ParseTuple(args, "|s", &format))
+        return NULL;
+
+    const RecomputeProfile& profile = getDocumentPtr()->getRecomputeProfile();
+    if (format) {
+        std::stringstream str;
+        if (strcmp(format, "json") == 0) {
+            profile.exportJson(str);
+        }
+        else if (strcmp(format, "trace") == 0) {
+            profile.exportChromeTrace(str);
+        }
+        else {
+            PyErr_SetString(PyExc_ValueError, "Format must be 'json' or 'trace'");
+            return NULL;
+        }
+        return Py::new_reference_to(Py::String(str.str()));
+    }
+
+    const std::vector<RecomputeProfileEntry>& entries = profile.getEntries();
+    Py::List objects;
+    for (std::vector<RecomputeProfileEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+        Py::Dict entry;
+        entry.setItem("Name", Py::String(it->name));
+        entry.setItem("Label", Py::String(it->label));
+        entry.setItem("Reason", Py::String(it->reason));
+        entry.setItem("Start", Py::Float(it->start));
+        entry.setItem("Duration", Py::Float(it->duration));
+        entry.setItem("MemoryDelta", Py::Long(static_cast<long>(it->memoryDelta)));
+        entry.setItem("Thread", Py::Int(it->thread));
+        Py::List deps;
+        for (std::vector<std::size_t>::const_iterator jt = it->dependencies.begin(); jt != it->dependencies.end(); ++jt)
+            deps.append(Py::String(entries[*jt].name));
+        entry.setItem("Dependencies", deps);
+        objects.append(entry);
+    }
+
+    double length = 0.0;
+    std::vector<std::size_t> path = profile.getCriticalPath(&length);
+    Py::List critical;
+    for (std::vector<std::size_t>::iterator it = path.begin(); it != path.end(); ++it)
+        critical.append(Py::String(entries[*it].name));
+
+    Py::Dict dict;
+    dict.setItem("TotalTime", Py::Float(profile.getTotalTime()));
+    dict.setItem("ExecutionTime", Py::Float(profile.getExecutionTime()));
+    dict.setItem("CriticalPathTime", Py::Float(length));
+    dict.setItem("CriticalPath", critical);
+    dict.setItem("Objects", objects);
+    return Py::new_reference_to(dict);
+}
+
 PyObject*  DocumentPy::getObject(PyObject *args)
 {
     char *sName;
@@ -610,6 +666,16 @@ void DocumentPy::setRecomputesFrozen(Py::Boolean arg)
     getDocumentPtr()->setStatus(Document::Status::SkipRecompute, arg.isTrue());
 }
 
+Py::Boolean DocumentPy::getRecomputeProfiling(void) const
+{
+    return Py::Boolean(getDocumentPtr()->isRecomputeProfiling());
+}
+
+void DocumentPy::setRecomputeProfiling(Py::Boolean arg)
+{
+    getDocumentPtr()->setRecomputeProfiling(arg.isTrue());
+}
+
 PyObject* DocumentPy::getTempFileName(PyObject *args)
 {
     PyObject *value;
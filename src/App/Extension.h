@@ -242,7 +242,7 @@ public:
     //get extension name without namespace
     std::string name() const;
  
-    bool isPythonExtension() {return m_isPythonExtension;}
+    bool isPythonExtension() const {return m_isPythonExtension;}
   
     virtual PyObject* getExtensionPyObject(void);
   
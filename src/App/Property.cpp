@@ -59,6 +59,11 @@ Property::~Property()
 
 }
 
+bool Property::getValueHash(std::size_t&) const
+{
+    return false;
+}
+
 const char* Property::getName(void) const
 {
     return father->getPropertyName(this);
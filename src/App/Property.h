@@ -83,6 +83,20 @@ public:
         // you have to implement this method in all property classes!
         return sizeof(father) + sizeof(StatusBits);
     }
+    /** Returns the memory that is kept alive by this property only.
+     * Properties whose copies share the data with the original (see Copy())
+     * don't count it as long as another copy still refers to it.
+     */
+    virtual std::size_t getOwnedMemSize (void) const {
+        return getMemSize();
+    }
+
+    /** Computes a hash of the current value.
+     * The recompute uses it to detect that the execution of an object left
+     * the value unchanged so that the dependent objects need not be recomputed.
+     * Returns false if the property doesn't support hashing its value.
+     */
+    virtual bool getValueHash(std::size_t& hash) const;
 
     /// get the name of this property in the belonging container
     const char* getName(void) const;
@@ -27,6 +27,8 @@
 #	include <assert.h>
 #endif
 
+#include <boost/functional/hash.hpp>
+
 /// Here the FreeCAD includes sorted by Base,App,Gui......
 
 #include <Base/Exception.h>
@@ -803,6 +805,23 @@ void PropertyPlacement::Paste(const Property &from)
     hasSetValue();
 }
 
+bool PropertyPlacement::getValueHash(std::size_t& hash) const
+{
+    const Base::Vector3d& pos = _cPos.getPosition();
+    double q0, q1, q2, q3;
+    _cPos.getRotation().getValue(q0, q1, q2, q3);
+
+    hash = 0;
+    boost::hash_combine(hash, pos.x);
+    boost::hash_combine(hash, pos.y);
+    boost::hash_combine(hash, pos.z);
+    boost::hash_combine(hash, q0);
+    boost::hash_combine(hash, q1);
+    boost::hash_combine(hash, q2);
+    boost::hash_combine(hash, q3);
+    return true;
+}
+
 
 //**************************************************************************
 // PropertyPlacementList
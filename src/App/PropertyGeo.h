@@ -224,6 +224,7 @@ public:
     virtual void Restore(Base::XMLReader &reader);
 
     virtual void SaveDocFile (Base::Writer &writer) const;
+    virtual bool isSaveDocFileThreadSafe() const { return true; }
     virtual void RestoreDocFile(Base::Reader &reader);
 
     virtual Property *Copy(void) const;
@@ -336,6 +337,8 @@ public:
         return sizeof(Base::Placement);
     }
 
+    virtual bool getValueHash(std::size_t& hash) const;
+
     static const Placement Null;
 
 private:
@@ -414,6 +417,7 @@ public:
     virtual void Restore(Base::XMLReader &reader);
 
     virtual void SaveDocFile (Base::Writer &writer) const;
+    virtual bool isSaveDocFileThreadSafe() const { return true; }
     virtual void RestoreDocFile(Base::Reader &reader);
 
     virtual Property *Copy(void) const;
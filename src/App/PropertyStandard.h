@@ -640,6 +640,7 @@ public:
     virtual void Restore(Base::XMLReader &reader);
     
     virtual void SaveDocFile (Base::Writer &writer) const;
+    virtual bool isSaveDocFileThreadSafe() const { return true; }
     virtual void RestoreDocFile(Base::Reader &reader);
     
     virtual Property *Copy(void) const;
@@ -978,6 +979,7 @@ public:
     virtual void Restore(Base::XMLReader &reader);
     
     virtual void SaveDocFile (Base::Writer &writer) const;
+    virtual bool isSaveDocFileThreadSafe() const { return true; }
     virtual void RestoreDocFile(Base::Reader &reader);
     
     virtual Property *Copy(void) const;
@@ -1082,6 +1084,7 @@ public:
     virtual void Restore(Base::XMLReader &reader);
 
     virtual void SaveDocFile(Base::Writer &writer) const;
+    virtual bool isSaveDocFileThreadSafe() const { return true; }
     virtual void RestoreDocFile(Base::Reader &reader);
 
     virtual const char* getEditorName(void) const;
@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <iomanip>
+# include <ostream>
+# include <sstream>
+#endif
+
+#include "RecomputeProfile.h"
+#include "DocumentObject.h"
+
+using namespace App;
+
+namespace {
+std::string escapeJson(const std::string& str)
+{
+    std::stringstream out;
+    for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
+        unsigned char c = static_cast<unsigned char>(*it);
+        switch (c) {
+        case '"':  out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n";  break;
+        case '\r': out << "\\r";  break;
+        case '\t': out << "\\t";  break;
+        default:
+            if (c < 0x20)
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+            else
+                out << *it;
+            break;
+        }
+    }
+    return out.str();
+}
+}
+
+RecomputeProfile::RecomputeProfile()
+  : origin(std::chrono::steady_clock::now()), totalTime(0.0)
+{
+}
+
+RecomputeProfile::~RecomputeProfile()
+{
+}
+
+void RecomputeProfile::start()
+{
+    entries.clear();
+    objectIndex.clear();
+    totalTime = 0.0;
+    origin = std::chrono::steady_clock::now();
+}
+
+void RecomputeProfile::stop()
+{
+    totalTime = elapsed();
+}
+
+double RecomputeProfile::elapsed() const
+{
+    std::chrono::duration<double> diff = std::chrono::steady_clock::now() - origin;
+    return diff.count();
+}
+
+void RecomputeProfile::addEntry(const DocumentObject* obj, const RecomputeProfileEntry& entry)
+{
+    RecomputeProfileEntry copy(entry);
+    copy.dependencies.clear();
+
+    // the dependencies always finish before the object itself is executed
+    std::vector<App::DocumentObject*> out = obj->getOutList();
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    for (std::vector<App::DocumentObject*>::iterator it = out.begin(); it != out.end(); ++it) {
+        std::map<const DocumentObject*, std::size_t>::iterator jt = objectIndex.find(*it);
+        if (jt != objectIndex.end())
+            copy.dependencies.push_back(jt->second);
+    }
+
+    objectIndex[obj] = entries.size();
+    entries.push_back(copy);
+}
+
+double RecomputeProfile::getExecutionTime() const
+{
+    double time = 0.0;
+    for (std::vector<RecomputeProfileEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+        time += it->duration;
+    return time;
+}
+
+std::vector<std::size_t> RecomputeProfile::getCriticalPath(double* length) const
+{
+    // the entries are in execution order, so all dependencies of an
+    // entry are already handled when it is reached
+    std::vector<double> finish(entries.size(), 0.0);
+    std::vector<std::size_t> predecessor(entries.size(), entries.size());
+
+    double longest = 0.0;
+    std::size_t last = entries.size();
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        double begin = 0.0;
+        const std::vector<std::size_t>& deps = entries[i].dependencies;
+        for (std::vector<std::size_t>::const_iterator it = deps.begin(); it != deps.end(); ++it) {
+            if (finish[*it] > begin) {
+                begin = finish[*it];
+                predecessor[i] = *it;
+            }
+        }
+
+        finish[i] = begin + entries[i].duration;
+        if (last == entries.size() || finish[i] > longest) {
+            longest = finish[i];
+            last = i;
+        }
+    }
+
+    std::vector<std::size_t> path;
+    while (last < entries.size()) {
+        path.push_back(last);
+        last = predecessor[last];
+    }
+    std::reverse(path.begin(), path.end());
+
+    if (length)
+        *length = longest;
+    return path;
+}
+
+void RecomputeProfile::exportJson(std::ostream& out) const
+{
+    double length = 0.0;
+    std::vector<std::size_t> path = getCriticalPath(&length);
+
+    out << "{\n"
+        << "  \"TotalTime\": " << totalTime << ",\n"
+        << "  \"ExecutionTime\": " << getExecutionTime() << ",\n"
+        << "  \"CriticalPathTime\": " << length << ",\n"
+        << "  \"CriticalPath\": [";
+    for (std::size_t i = 0; i < path.size(); i++) {
+        if (i > 0)
+            out << ", ";
+        out << "\"" << escapeJson(entries[path[i]].name) << "\"";
+    }
+    out << "],\n"
+        << "  \"Objects\": [";
+
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        const RecomputeProfileEntry& entry = entries[i];
+        out << (i > 0 ? ",\n" : "\n")
+            << "    {\"Name\": \"" << escapeJson(entry.name) << "\""
+            << ", \"Label\": \"" << escapeJson(entry.label) << "\""
+            << ", \"Reason\": \"" << escapeJson(entry.reason) << "\""
+            << ", \"Start\": " << entry.start
+            << ", \"Duration\": " << entry.duration
+            << ", \"MemoryDelta\": " << entry.memoryDelta
+            << ", \"Thread\": " << entry.thread
+            << ", \"Dependencies\": [";
+        for (std::size_t j = 0; j < entry.dependencies.size(); j++) {
+            if (j > 0)
+                out << ", ";
+            out << "\"" << escapeJson(entries[entry.dependencies[j]].name) << "\"";
+        }
+        out << "]}";
+    }
+
+    out << "\n  ]\n}\n";
+}
+
+void RecomputeProfile::exportChromeTrace(std::ostream& out) const
+{
+    // complete events ('X') of the Trace Event Format, one row per thread
+    out << "{\"traceEvents\": [";
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        const RecomputeProfileEntry& entry = entries[i];
+        out << (i > 0 ? ",\n" : "\n")
+            << "  {\"name\": \"" << escapeJson(entry.label) << "\""
+            << ", \"cat\": \"recompute\", \"ph\": \"X\""
+            << ", \"ts\": " << static_cast<long long>(entry.start * 1.0e6)
+            << ", \"dur\": " << static_cast<long long>(entry.duration * 1.0e6)
+            << ", \"pid\": 1, \"tid\": " << entry.thread
+            << ", \"args\": {\"Name\": \"" << escapeJson(entry.name) << "\""
+            << ", \"Reason\": \"" << escapeJson(entry.reason) << "\""
+            << ", \"MemoryDelta\": " << entry.memoryDelta << "}}";
+    }
+    out << "\n], \"displayTimeUnit\": \"ms\"}\n";
+}
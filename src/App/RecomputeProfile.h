@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef APP_RECOMPUTEPROFILE_H
+#define APP_RECOMPUTEPROFILE_H
+
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace App
+{
+class DocumentObject;
+
+/** Timing record of one object executed by Document::recompute() */
+struct AppExport RecomputeProfileEntry
+{
+    RecomputeProfileEntry() : start(0.0), duration(0.0), memoryDelta(0), thread(0)
+    {
+    }
+
+    /// the internal name of the object
+    std::string name;
+    /// the label of the object
+    std::string label;
+    /// why the object has been recomputed, e.g. the names of its touched properties
+    std::string reason;
+    /// start of the execution in seconds relative to the start of the recompute
+    double start;
+    /// wall time of the execution in seconds
+    double duration;
+    /// change of the memory size of the object in bytes
+    long long memoryDelta;
+    /// index of the thread that executed the object, 0 is the calling thread
+    int thread;
+    /// indexes of the entries of the dependencies recomputed in the same run
+    std::vector<std::size_t> dependencies;
+};
+
+/** The RecomputeProfile class collects the execution times of all objects
+ * recomputed by a document and computes the critical path, i.e. the chain of
+ * dependent objects with the longest accumulated execution time. This is the
+ * lower bound for the recompute time even if all independent objects are
+ * executed in parallel.
+ *
+ * The class itself is not thread-safe, the document serializes the calls of
+ * addEntry() when recomputing in parallel.
+ */
+class AppExport RecomputeProfile
+{
+public:
+    RecomputeProfile();
+    ~RecomputeProfile();
+
+    /// Clears all entries and sets the time origin to now
+    void start();
+    /// Sets the end of the recompute
+    void stop();
+    /// Returns the seconds elapsed since start()
+    double elapsed() const;
+    /// Adds the record of the executed object \a obj
+    void addEntry(const DocumentObject* obj, const RecomputeProfileEntry& entry);
+
+    const std::vector<RecomputeProfileEntry>& getEntries() const
+    { return entries; }
+    /// Returns the wall time of the last recompute in seconds
+    double getTotalTime() const
+    { return totalTime; }
+    /// Returns the sum of the execution times of all objects in seconds
+    double getExecutionTime() const;
+    /// Returns the indexes of the entries of the critical path in execution order
+    std::vector<std::size_t> getCriticalPath(double* length = 0) const;
+
+    /// Writes all entries and the critical path as JSON
+    void exportJson(std::ostream&) const;
+    /// Writes the entries in the Trace Event Format of chrome://tracing
+    void exportChromeTrace(std::ostream&) const;
+
+private:
+    std::chrono::steady_clock::time_point origin;
+    double totalTime;
+    std::vector<RecomputeProfileEntry> entries;
+    std::map<const DocumentObject*, std::size_t> objectIndex;
+};
+
+} //namespace App
+
+#endif // APP_RECOMPUTEPROFILE_H
@@ -24,7 +24,9 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <algorithm>
 # include <cassert>
+# include <climits>
 #endif
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
@@ -97,7 +99,17 @@ Transaction::~Transaction()
 
 unsigned int Transaction::getMemSize (void) const
 {
-    return 0;
+    std::size_t size = getOwnedMemSize();
+    return static_cast<unsigned int>(std::min<std::size_t>(size, UINT_MAX));
+}
+
+std::size_t Transaction::getOwnedMemSize (void) const
+{
+    std::size_t size = 0;
+    TransactionList::const_iterator It;
+    for (It = _Objects.begin(); It != _Objects.end(); ++It)
+        size += It->second->getOwnedMemSize();
+    return size;
 }
 
 void Transaction::Save (Base::Writer &/*writer*/) const
@@ -314,7 +326,20 @@ void TransactionObject::removeProperty(const Property* pcProp)
 
 unsigned int TransactionObject::getMemSize (void) const
 {
-    return 0;
+    std::size_t size = getOwnedMemSize();
+    return static_cast<unsigned int>(std::min<std::size_t>(size, UINT_MAX));
+}
+
+std::size_t TransactionObject::getOwnedMemSize (void) const
+{
+    // Note: Properties with large data (e.g. meshes or point clouds) share their
+    // data with the document until it gets modified. Such data is only counted
+    // once the snapshot is the last one referring to it.
+    std::size_t size = 0;
+    std::map<const Property*,Property*>::const_iterator It;
+    for (It = _PropChangeMap.begin(); It != _PropChangeMap.end(); ++It)
+        size += It->second->getOwnedMemSize();
+    return size;
 }
 
 void TransactionObject::Save (Base::Writer &/*writer*/) const
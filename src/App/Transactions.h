@@ -58,6 +58,8 @@ public:
     std::string Name;
 
     virtual unsigned int getMemSize (void) const;
+    /// Returns the memory of the snapshots that is kept alive by this transaction only
+    std::size_t getOwnedMemSize (void) const;
     virtual void Save (Base::Writer &writer) const;
     /// This method is used to restore properties from an XML document.
     virtual void Restore(Base::XMLReader &reader);
@@ -100,6 +102,8 @@ public:
     void removeProperty(const Property* pcProp);
 
     virtual unsigned int getMemSize (void) const;
+    /// Returns the memory of the snapshots that is kept alive by this object only
+    std::size_t getOwnedMemSize (void) const;
     virtual void Save (Base::Writer &writer) const;
     /// This method is used to restore properties from an XML document.
     virtual void Restore(Base::XMLReader &reader);
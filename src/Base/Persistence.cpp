@@ -68,6 +68,16 @@ void Persistence::SaveDocFile (Writer &/*writer*/) const
 {
 }
 
+bool Persistence::isSaveDocFileThreadSafe() const
+{
+    return false;
+}
+
+bool Persistence::deferRestoreDocFile(const std::shared_ptr<DeferredFile>&)
+{
+    return false;
+}
+
 void Persistence::RestoreDocFile(Reader &/*reader*/)
 {
 }
@@ -28,11 +28,13 @@
 
 
 #include <assert.h>
+#include <memory>
 
 #include "BaseClass.h"
 
 namespace Base
 {
+class DeferredFile;
 class Reader;
 class Writer;
 class XMLReader;
@@ -116,6 +118,12 @@ public:
      * In this method you can simply stream your content to the file (Base::Writer inheriting from ostream).
      */
     virtual void SaveDocFile (Writer &/*writer*/) const;
+    /** Returns true if SaveDocFile() may be called from a worker thread while
+     * other files are written. This requires that SaveDocFile() only reads the
+     * data of this object and doesn't call Writer::addFile(). The default
+     * implementation returns false.
+     */
+    virtual bool isSaveDocFileThreadSafe() const;
     /** This method is used to restore large amounts of data from a file
      * In this method you simply stream in your SaveDocFile() saved data.
      * Again you have to apply for the call of this method in the Restore() call:
@@ -146,6 +154,15 @@ public:
      * @see Base::Reader,Base::XMLReader
      */
     virtual void RestoreDocFile(Reader &/*reader*/);
+    /** This method is called instead of RestoreDocFile() if the document is
+     * restored lazily. If the object accepts to read the file on demand it
+     * keeps the passed file, sets its handler and calls DeferredFile::restore()
+     * before its data is accessed the first time.
+     * The default implementation returns false, i.e. RestoreDocFile() is
+     * called immediately.
+     * @see Base::DeferredFile, Base::XMLReader::setLazyRestore()
+     */
+    virtual bool deferRestoreDocFile(const std::shared_ptr<DeferredFile>&);
     /// Encodes an attribute upon saving.
     static std::string encodeAttribute(const std::string&);
 
@@ -30,6 +30,7 @@
 # include <xercesc/sax2/SAX2XMLReader.hpp>
 #endif
 
+#include <iterator>
 #include <locale>
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
@@ -40,6 +41,7 @@
 #include "InputSource.h"
 #include "Console.h"
 #include "Sequencer.h"
+#include "Stream.h"
 
 #ifdef _MSC_VER
 #include <zipios++/zipios-config.h>
@@ -51,6 +53,9 @@
 
 #include "XMLTools.h"
 
+#include <QMutex>
+#include <QMutexLocker>
+
 XERCES_CPP_NAMESPACE_USE
 
 using namespace std;
@@ -64,7 +69,7 @@ using namespace std;
 Base::XMLReader::XMLReader(const char* FileName, std::istream& str)
   : DocumentSchema(0), ProgramVersion(""), FileVersion(0), Level(0),
     CharacterCount(0), ReadType(None), _File(FileName), _valid(false),
-    _verbose(true)
+    _verbose(true), _lazyRestore(false)
 {
 #ifdef _MSC_VER
     str.imbue(std::locale::empty());
@@ -321,17 +326,30 @@ void Base::XMLReader::readFiles(zipios::ZipInputStream &zipstream) const
         // If this condition is true both file names match and we can read-in the data, otherwise
         // no file name for the current entry in the zip was registered.
         if (jt != FileList.end()) {
-            try {
-                Base::Reader reader(zipstream, jt->FileName, FileVersion);
-                jt->Object->RestoreDocFile(reader);
+            bool deferred = false;
+            if (_lazyRestore) {
+                // the object reads the file later from the archive
+                std::shared_ptr<DeferredFile> file = std::make_shared<DeferredFile>
+                    (_File.filePath(), jt->FileName, entry->getCrc(), FileVersion);
+                if (jt->Object->deferRestoreDocFile(file)) {
+                    DeferredFiles.push_back(file);
+                    deferred = true;
+                }
             }
-            catch(...) {
-                // For any exception we just continue with the next file.
-                // It doesn't matter if the last reader has read more or
-                // less data than the file size would allow.
-                // All what we need to do is to notify the user about the
-                // failure.
-                Base::Console().Error("Reading failed from embedded file: %s\n", entry->toString().c_str());
+
+            if (!deferred) {
+                try {
+                    Base::Reader reader(zipstream, jt->FileName, FileVersion);
+                    jt->Object->RestoreDocFile(reader);
+                }
+                catch(...) {
+                    // For any exception we just continue with the next file.
+                    // It doesn't matter if the last reader has read more or
+                    // less data than the file size would allow.
+                    // All what we need to do is to notify the user about the
+                    // failure.
+                    Base::Console().Error("Reading failed from embedded file: %s\n", entry->toString().c_str());
+                }
             }
             // Go to the next registered file name
             it = jt + 1;
@@ -367,6 +385,16 @@ const std::vector<std::string>& Base::XMLReader::getFilenames() const
     return FileNames;
 }
 
+void Base::XMLReader::setLazyRestore(bool on)
+{
+    _lazyRestore = on;
+}
+
+const std::vector<std::shared_ptr<Base::DeferredFile> >& Base::XMLReader::getDeferredFiles() const
+{
+    return DeferredFiles;
+}
+
 bool Base::XMLReader::isRegistered(Base::Persistence *Object) const
 {
     if (Object) {
@@ -565,3 +593,157 @@ std::istream& Base::Reader::getStream()
     return this->_str;
 }
 
+// ----------------------------------------------------------------------------
+
+struct Base::DeferredFile::Private {
+    // recursive because the handler may access the owner of the file again
+    QMutex mutex;
+    std::string archive;
+    std::string fileName;
+    unsigned long crc;
+    int version;
+    Handler handler;
+    std::string data;
+    bool fetched;
+    bool restoring;
+
+    Private() : mutex(QMutex::Recursive), crc(0), version(0), fetched(false), restoring(false)
+    {
+    }
+};
+
+Base::DeferredFile::DeferredFile(const std::string& archive, const std::string& fileName,
+                                 unsigned long crc, int version)
+  : d(new Private), pending(true)
+{
+    d->archive = archive;
+    d->fileName = fileName;
+    d->crc = crc;
+    d->version = version;
+}
+
+Base::DeferredFile::~DeferredFile()
+{
+    delete d;
+}
+
+const std::string& Base::DeferredFile::getFileName() const
+{
+    return d->fileName;
+}
+
+void Base::DeferredFile::setHandler(const Handler& handler)
+{
+    QMutexLocker locker(&d->mutex);
+    d->handler = handler;
+}
+
+void Base::DeferredFile::restore()
+{
+    QMutexLocker locker(&d->mutex);
+    // the handler may access its owner which must not read the file again
+    if (!pending || d->restoring)
+        return;
+    d->restoring = true;
+
+    try {
+        if (d->fetched) {
+            std::string data;
+            data.swap(d->data);
+            Base::Streambuf buf(data);
+            std::istream str(&buf);
+#ifdef _MSC_VER
+            str.imbue(std::locale::empty());
+#else
+            str.imbue(std::locale::classic());
+#endif
+            Base::Reader reader(str, d->fileName, d->version);
+            if (d->handler)
+                d->handler(reader);
+        }
+        else {
+            zipios::ZipFile zip(d->archive);
+            zipios::ConstEntryPointer entry = zip.getEntry(d->fileName);
+            // make sure that the archive hasn't been replaced in the meantime
+            if (!entry || (d->crc != 0 && entry->getCrc() != d->crc))
+                throw Base::FileException("Embedded file has changed", d->archive.c_str());
+            std::unique_ptr<std::istream> str(zip.getInputStream(entry));
+            if (!str)
+                throw Base::FileException("Cannot read embedded file", d->archive.c_str());
+#ifdef _MSC_VER
+            str->imbue(std::locale::empty());
+#else
+            str->imbue(std::locale::classic());
+#endif
+            Base::Reader reader(*str, d->fileName, d->version);
+            if (d->handler)
+                d->handler(reader);
+        }
+    }
+    catch(...) {
+        Base::Console().Error("Reading failed from embedded file: %s\n", d->fileName.c_str());
+    }
+
+    d->handler = Handler();
+    d->restoring = false;
+    // only now other threads may skip restore() and access the data
+    pending = false;
+}
+
+void Base::DeferredFile::cancel()
+{
+    QMutexLocker locker(&d->mutex);
+    pending = false;
+    d->handler = Handler();
+    d->data.clear();
+    d->fetched = false;
+}
+
+bool Base::DeferredFile::readData(zipios::ZipFile& zip, std::string& data) const
+{
+    zipios::ConstEntryPointer entry = zip.getEntry(d->fileName);
+    if (!entry || (d->crc != 0 && entry->getCrc() != d->crc))
+        return false;
+    std::unique_ptr<std::istream> str(zip.getInputStream(entry));
+    if (!str)
+        return false;
+    data.reserve(entry->getSize());
+    data.assign(std::istreambuf_iterator<char>(*str), std::istreambuf_iterator<char>());
+    return true;
+}
+
+std::size_t Base::DeferredFile::fetch(zipios::ZipFile& zip)
+{
+    QMutexLocker locker(&d->mutex);
+    if (!pending || d->fetched)
+        return 0;
+
+    std::string data;
+    if (!readData(zip, data))
+        return 0;
+    d->data.swap(data);
+    d->fetched = true;
+    return d->data.size();
+}
+
+void Base::DeferredFile::fetchAll(const std::vector<std::weak_ptr<DeferredFile> >& files, std::size_t maxBytes)
+{
+    std::size_t bytes = 0;
+    try {
+        std::unique_ptr<zipios::ZipFile> zip;
+        for (std::vector<std::weak_ptr<DeferredFile> >::const_iterator it = files.begin(); it != files.end(); ++it) {
+            std::shared_ptr<DeferredFile> file = it->lock();
+            if (!file || !file->isPending())
+                continue;
+            if (!zip)
+                zip.reset(new zipios::ZipFile(file->d->archive));
+            bytes += file->fetch(*zip);
+            if (bytes >= maxBytes)
+                break;
+        }
+    }
+    catch (...) {
+        // Prefetching is optional. If the archive cannot be read
+        // restore() will report it.
+    }
+}
@@ -27,6 +27,9 @@
 #include <string>
 #include <map>
 #include <bitset>
+#include <atomic>
+#include <functional>
+#include <memory>
 
 #include <xercesc/framework/XMLPScanToken.hpp>
 #include <xercesc/sax2/Attributes.hpp>
@@ -47,6 +50,7 @@ XERCES_CPP_NAMESPACE_END
 namespace Base
 {
 
+class DeferredFile;
 
 /** The XML reader class
  * This is an important helper class for the store and retrieval system
@@ -165,6 +169,12 @@ public:
     const char *addFile(const char* Name, Base::Persistence *Object);
     /// process the requested file writes
     void readFiles(zipios::ZipInputStream &zipstream) const;
+    /** If enabled readFiles() doesn't read the files of objects that accept to
+     * restore them on demand, see Persistence::deferRestoreDocFile().
+     */
+    void setLazyRestore(bool on);
+    /// get the files whose reading has been deferred by readFiles()
+    const std::vector<std::shared_ptr<DeferredFile> >& getDeferredFiles() const;
     /// get all registered file names
     const std::vector<std::string>& getFilenames() const;
     bool isRegistered(Base::Persistence *Object) const;
@@ -271,6 +281,8 @@ protected:
     };
     std::vector<FileEntry> FileList;
     std::vector<std::string> FileNames;
+    bool _lazyRestore;
+    mutable std::vector<std::shared_ptr<DeferredFile> > DeferredFiles;
 
     std::bitset<32> StatusBits;
 };
@@ -289,6 +301,55 @@ private:
     int fileVersion;
 };
 
+/** The DeferredFile class
+ * Refers to a file inside a project archive whose content is read on demand
+ * instead of when the document is loaded. The object owning the file must call
+ * restore() before its data is accessed for the first time.
+ * \see XMLReader::setLazyRestore(), Persistence::deferRestoreDocFile()
+ */
+class BaseExport DeferredFile
+{
+public:
+    typedef std::function<void(Reader&)> Handler;
+
+    DeferredFile(const std::string& archive, const std::string& fileName,
+                 unsigned long crc, int version);
+    ~DeferredFile();
+
+    const std::string& getFileName() const;
+    /// Sets the function that reads the content of the file
+    void setHandler(const Handler&);
+    /** Returns true as long as the content hasn't been read completely.
+     * It is reset only after the handler has returned so that a caller seeing
+     * false can access the data without calling restore().
+     */
+    bool isPending() const
+    { return pending; }
+    /** Reads the content of the file with the handler if it's still pending.
+     * This method is thread-safe.
+     */
+    void restore();
+    /// Drops the file without reading it, e.g. because the owner got a new value
+    void cancel();
+    /** Decompresses the content of the file into memory so that restore()
+     * doesn't need to access the archive any more. This method is thread-safe.
+     * Returns the number of bytes read.
+     */
+    std::size_t fetch(zipios::ZipFile&);
+    /** Fetches the files of the same archive in the given order until
+     * \a maxBytes have been read. This is meant to run in a background thread.
+     */
+    static void fetchAll(const std::vector<std::weak_ptr<DeferredFile> >&, std::size_t maxBytes);
+
+private:
+    bool readData(zipios::ZipFile&, std::string&) const;
+
+private:
+    struct Private;
+    Private* d;
+    std::atomic<bool> pending;
+};
+
 }
 
 
@@ -36,8 +36,20 @@
 #include "Tools.h"
 
 #include <algorithm>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <locale>
 #include <limits>
+#include <memory>
+#include <sstream>
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
 
 using namespace Base;
 using namespace std;
@@ -241,7 +253,7 @@ void Writer::decInd(void)
 // ----------------------------------------------------------------------------
 
 ZipWriter::ZipWriter(const char* FileName) 
-  : ZipStream(FileName)
+  : ZipStream(FileName), threadCount(1)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -254,7 +266,7 @@ ZipWriter::ZipWriter(const char* FileName)
 }
 
 ZipWriter::ZipWriter(std::ostream& os) 
-  : ZipStream(os)
+  : ZipStream(os), threadCount(1)
 {
 #ifdef _MSC_VER
     ZipStream.imbue(std::locale::empty());
@@ -268,6 +280,12 @@ ZipWriter::ZipWriter(std::ostream& os)
 
 void ZipWriter::writeFiles(void)
 {
+    int numThreads = threadCount > 0 ? threadCount : QThread::idealThreadCount();
+    if (numThreads > 1) {
+        writeFilesParallel(numThreads);
+        return;
+    }
+
     // use a while loop because it is possible that while
     // processing the files new ones can be added
     size_t index = 0;
@@ -279,6 +297,141 @@ void ZipWriter::writeFiles(void)
     }
 }
 
+namespace {
+/// Writes the content of a single file into memory, used by worker threads
+class ZipEntryWriter : public Writer
+{
+public:
+    ZipEntryWriter(const std::set<std::string>& modes, int version, const std::ios& format)
+    {
+        setModes(modes);
+        setFileVersion(version);
+        // use the same locale and number format as the zip stream
+        StrStream.copyfmt(format);
+    }
+
+    virtual std::ostream &Stream(void){return StrStream;}
+    virtual void writeFiles(void){}
+    std::string getString(void) const {return StrStream.str();}
+
+private:
+    std::ostringstream StrStream;
+};
+
+class ZipEntryRunnable : public QRunnable
+{
+public:
+    ZipEntryRunnable(const std::function<void()>& func) : func(func)
+    {
+    }
+    virtual void run()
+    {
+        func();
+    }
+
+private:
+    std::function<void()> func;
+};
+
+struct ZipEntryJob {
+    std::string fileName;
+    const Base::Persistence* object;
+    bool threadSafe;
+    bool done;
+    bool deflated;
+    std::string data;
+    zipios::uint32 crc;
+    zipios::uint32 size;
+    std::vector<std::string> errors;
+    std::exception_ptr exception;
+};
+}
+
+void ZipWriter::writeFilesParallel(int numThreads)
+{
+    // the worker threads must not access this writer
+    std::ostringstream format;
+    format.copyfmt(ZipStream);
+    std::set<std::string> modes = getModes();
+    int version = getFileVersion();
+    int level = ZipStream.getLevel();
+
+    QMutex mutex;
+    QWaitCondition jobFinished;
+    QThreadPool pool;
+    pool.setMaxThreadCount(numThreads);
+
+    // limit the number of files that are kept in memory at the same time
+    const std::size_t maxPending = 2 * static_cast<std::size_t>(numThreads);
+    std::deque<std::shared_ptr<ZipEntryJob> > pending;
+
+    // The files are written in the same order as with the sequential version. Files
+    // whose objects are thread-safe are serialized and compressed in the thread pool
+    // while the others are written by this thread when it's their turn.
+    // Use a while loop because it is possible that while processing the files new
+    // ones can be added.
+    std::size_t index = 0;
+    while (index < FileList.size() || !pending.empty()) {
+        while (index < FileList.size() && pending.size() < maxPending) {
+            std::shared_ptr<ZipEntryJob> job = std::make_shared<ZipEntryJob>();
+            job->fileName = FileList[index].FileName;
+            job->object = FileList[index].Object;
+            job->threadSafe = job->object->isSaveDocFileThreadSafe();
+            job->done = false;
+            job->deflated = false;
+            job->crc = 0;
+            job->size = 0;
+            pending.push_back(job);
+            index++;
+
+            if (job->threadSafe) {
+                pool.start(new ZipEntryRunnable([job, &modes, version, &format, level, &mutex, &jobFinished]() {
+                    try {
+                        ZipEntryWriter writer(modes, version, format);
+                        job->object->SaveDocFile(writer);
+                        std::string raw = writer.getString();
+                        job->size = static_cast<zipios::uint32>(raw.size());
+                        job->deflated = zipios::ZipOutputStreambuf::deflateData
+                            (raw.data(), raw.size(), level, job->data, job->crc);
+                        job->errors = writer.getErrors();
+                    }
+                    catch (...) {
+                        job->exception = std::current_exception();
+                    }
+
+                    QMutexLocker locker(&mutex);
+                    job->done = true;
+                    jobFinished.wakeAll();
+                }));
+            }
+        }
+
+        std::shared_ptr<ZipEntryJob> job = pending.front();
+        pending.pop_front();
+
+        if (job->threadSafe) {
+            {
+                QMutexLocker locker(&mutex);
+                while (!job->done)
+                    jobFinished.wait(&mutex);
+            }
+
+            if (job->exception)
+                std::rethrow_exception(job->exception);
+            for (std::vector<std::string>::iterator it = job->errors.begin(); it != job->errors.end(); ++it)
+                addError(*it);
+            if (job->deflated)
+                ZipStream.putDeflatedEntry(job->fileName, job->data, job->crc, job->size);
+            else
+                addError(std::string("Failed to compress file ") + job->fileName);
+        }
+        else {
+            ZipStream.putNextEntry(job->fileName);
+            job->object->SaveDocFile(*this);
+        }
+    }
+}
+
 ZipWriter::~ZipWriter()
 {
     ZipStream.close();
@@ -157,9 +157,19 @@ public:
     void setComment(const char* str){ZipStream.setComment(str);}
     void setLevel(int level){ZipStream.setLevel( level );}
     void putNextEntry(const char* str){ZipStream.putNextEntry(str);}
+    /** Sets the number of threads used by writeFiles() to serialize and compress
+     * the files of objects whose SaveDocFile() is thread-safe. 0 uses as many
+     * threads as there are cores, 1 writes all files sequentially. The entries
+     * of the archive are the same in either case.
+     */
+    void setThreadCount(int num){threadCount = num;}
+
+private:
+    void writeFilesParallel(int numThreads);
 
 private:
     zipios::ZipOutputStream ZipStream;
+    int threadCount;
 };
 
 /** The StringWriter class 
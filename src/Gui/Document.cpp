@@ -176,6 +176,10 @@ Document::Document(App::Document* pcDocument,Application * app)
         d->_pcDocument->setUndoMode(1);
         // set the maximum stack size
         d->_pcDocument->setMaxUndoStackSize(App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document")->GetInt("MaxUndoSize",20));
+        // set the memory budget of the undo stack in MB (0 means unlimited)
+        long undoMem = App::GetApplication().GetParameterGroupByPath("User parameter:BaseApp/Preferences/Document")->GetInt("MaxUndoMemory",0);
+        if (undoMem > 0)
+            d->_pcDocument->setUndoLimit(static_cast<std::size_t>(undoMem) * 1024 * 1024);
     }
 }
 
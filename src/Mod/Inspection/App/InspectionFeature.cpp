@@ -22,24 +22,27 @@
 
 
 #include "PreCompiled.h"
+#include <climits>
+#include <gp.hxx>
 #include <gp_Pnt.hxx>
+#include <BRep_Tool.hxx>
 #include <BRepExtrema_DistShapeShape.hxx>
 #include <BRepBuilderAPI_MakeVertex.hxx>
+#include <BRepClass_FaceClassifier.hxx>
 #include <BRepClass3d_SolidClassifier.hxx>
 #include <BRepGProp_Face.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <Precision.hxx>
+#include <ShapeAnalysis_Surface.hxx>
+#include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
 #include <TopoDS_Vertex.hxx>
 
-#include <QEventLoop>
-#include <QFuture>
-#include <QFutureWatcher>
-#include <QtConcurrentMap>
-
-#include <boost/bind.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
 
 #include <Base/Console.h>
 #include <Base/Exception.h>
-#include <Base/FutureWatcherProgress.h>
 #include <Base/Parameter.h>
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
@@ -47,11 +50,13 @@
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/Mesh/App/MeshFeature.h>
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/BVH.h>
+#include <Mod/Mesh/App/Core/Functional.h>
 #include <Mod/Mesh/App/Core/Grid.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/MeshKernel.h>
 #include <Mod/Points/App/PointsFeature.h>
-#include <Mod/Points/App/PointsGrid.h>
+#include <Mod/Points/App/PointsKdTree.h>
 #include <Mod/Part/App/PartFeature.h>
 
 #include "InspectionFeature.h"
@@ -124,6 +129,197 @@ Base::Vector3f InspectActualShape::getPoint(unsigned long index)
 
 // ----------------------------------------------------------------
 
+void InspectNominalGeometry::getDistances(const Base::Vector3f* points, unsigned long count, float* distances)
+{
+    for (unsigned long index = 0; index < count; index++)
+        distances[index] = getDistance(points[index]);
+}
+
+namespace {
+
+// the number of points a thread processes in one go
+const unsigned long BlockSize = 4096;
+
+uint32_t SpreadBits(uint32_t v)
+{
+    v &= 0x3ff;
+    v = (v | (v << 16)) & 0x030000ff;
+    v = (v | (v <<  8)) & 0x0300f00f;
+    v = (v | (v <<  4)) & 0x030c30c3;
+    v = (v | (v <<  2)) & 0x09249249;
+    return v;
+}
+
+/*
+ * Returns the indices of the valid points sorted along a Morton curve. So
+ * consecutive points lie close together and the search for a point can start
+ * from the result of the previous point.
+ */
+std::vector<unsigned long> SpatialOrder(const Base::Vector3f* points, unsigned long count)
+{
+    Base::BoundBox3f box;
+    for (unsigned long index = 0; index < count; index++) {
+        const Base::Vector3f& p = points[index];
+        if (!(boost::math::isnan(p.x) || boost::math::isnan(p.y) || boost::math::isnan(p.z)))
+            box.Add(p);
+    }
+
+    std::vector<unsigned long> order;
+    if (!box.IsValid())
+        return order;
+
+    float scaleX = 1023.0f / std::max(box.LengthX(), FLT_MIN);
+    float scaleY = 1023.0f / std::max(box.LengthY(), FLT_MIN);
+    float scaleZ = 1023.0f / std::max(box.LengthZ(), FLT_MIN);
+    std::vector<std::pair<uint32_t, unsigned long> > keys;
+    keys.reserve(count);
+    for (unsigned long index = 0; index < count; index++) {
+        const Base::Vector3f& p = points[index];
+        if (boost::math::isnan(p.x) || boost::math::isnan(p.y) || boost::math::isnan(p.z))
+            continue;
+        uint32_t x = static_cast<uint32_t>((p.x - box.MinX) * scaleX);
+        uint32_t y = static_cast<uint32_t>((p.y - box.MinY) * scaleY);
+        uint32_t z = static_cast<uint32_t>((p.z - box.MinZ) * scaleZ);
+        keys.push_back(std::make_pair(SpreadBits(x) | (SpreadBits(y) << 1) | (SpreadBits(z) << 2), index));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    order.reserve(keys.size());
+    for (std::vector<std::pair<uint32_t, unsigned long> >::iterator it = keys.begin(); it != keys.end(); ++it)
+        order.push_back(it->second);
+    return order;
+}
+
+// Returns the number of blocks of at most BlockSize points
+int CountBlocks(const std::vector<unsigned long>& order)
+{
+    return static_cast<int>((order.size() + BlockSize - 1) / BlockSize);
+}
+
+/*
+ * Computes the signed distances of points to the nearest facets of a mesh.
+ * The distance to the nearest facet of the previous point bounds the search
+ * for the next point which prunes most of the hierarchy.
+ * If \a facets is set it receives the index of the nearest facet of each point.
+ */
+struct NearestFacets
+{
+    NearestFacets(const MeshCore::MeshFacetBVH& bvh, const MeshCore::MeshFacetIterator& iter,
+                  const Base::BoundBox3f* box, const std::vector<unsigned long>& order,
+                  const Base::Vector3f* points, float* distances, unsigned long* facets = 0)
+      : bvh(bvh), iter(iter), box(box), order(order), points(points), distances(distances), facets(facets)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end, int) const
+    {
+        MeshCore::MeshFacetIterator facet(iter);
+        unsigned long prev = ULONG_MAX;
+        for (unsigned long pos = begin; pos < end; pos++) {
+            unsigned long index = order[pos];
+            const Base::Vector3f& point = points[index];
+            if (box && !box->IsInBox(point))
+                continue; // must be inside bbox
+
+            Base::Vector3f res;
+            unsigned long nearest;
+            bool found = false;
+            if (prev != ULONG_MAX) {
+                // slightly enlarged so that the previous facet itself is found again
+                facet.Set(prev);
+                float maxDist = facet->DistanceToPoint(point) * 1.001f;
+                found = bvh.NearestFacetToPoint(point, maxDist, res, nearest);
+            }
+            if (!found && !bvh.NearestFacetToPoint(point, res, nearest))
+                continue;
+
+            prev = nearest;
+            facet.Set(nearest);
+            float fMinDist = Base::Distance(point, res);
+            bool positive = point.DistanceToPlane(facet->_aclPoints[0], facet->GetNormal()) > 0;
+            if (!positive)
+                fMinDist = -fMinDist;
+            distances[index] = fMinDist;
+            if (facets)
+                facets[index] = nearest;
+        }
+    }
+
+    const MeshCore::MeshFacetBVH& bvh;
+    const MeshCore::MeshFacetIterator& iter;
+    const Base::BoundBox3f* box;
+    const std::vector<unsigned long>& order;
+    const Base::Vector3f* points;
+    float* distances;
+    unsigned long* facets;
+};
+
+/*
+ * Refines the estimated distances of points to a shape by projecting them onto
+ * the face of their nearest facet of the tessellation. The projection converges
+ * up to Precision::Confusion(). If the projection falls outside the face or
+ * is farther away than the estimate allows, the point is marked as failed and
+ * must be computed exactly.
+ */
+struct ProjectOnFaces
+{
+    ProjectOnFaces(const std::vector<TopoDS_Face>& faces, const std::vector<int>& facetFaces,
+                   const std::vector<unsigned long>& indices, const std::vector<unsigned long>& nearest,
+                   const Base::Vector3f* points, float deflection, float* distances, std::vector<char>& failed)
+      : faces(faces), facetFaces(facetFaces), indices(indices), nearest(nearest)
+      , points(points), deflection(deflection), distances(distances), failed(failed)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end, int) const
+    {
+        // the surfaces cache the last projection which speeds up the next one
+        std::vector<Handle(ShapeAnalysis_Surface)> surfaces(faces.size());
+        for (unsigned long pos = begin; pos < end; pos++) {
+            unsigned long index = indices[pos];
+            int faceIndex = facetFaces[nearest[index]];
+            const TopoDS_Face& face = faces[faceIndex];
+            Handle(ShapeAnalysis_Surface)& surface = surfaces[faceIndex];
+            if (surface.IsNull())
+                surface = new ShapeAnalysis_Surface(BRep_Tool::Surface(face));
+
+            const Base::Vector3f& point = points[index];
+            gp_Pnt pnt3d(point.x, point.y, point.z);
+            gp_Pnt2d uv = surface->ValueOfUV(pnt3d, Precision::Confusion());
+            BRepClass_FaceClassifier classifier(face, uv, Precision::Confusion());
+            if (classifier.State() == TopAbs_OUT) {
+                failed[pos] = 1;
+                continue;
+            }
+
+            BRepGProp_Face props(face);
+            gp_Vec normal;
+            gp_Pnt center;
+            props.Normal(uv.X(), uv.Y(), center, normal);
+            Standard_Real dist = center.Distance(pnt3d);
+            if (normal.Magnitude() < gp::Resolution() || dist > fabs(distances[index]) + deflection) {
+                failed[pos] = 1;
+                continue;
+            }
+
+            if (normal.Dot(gp_Vec(center, pnt3d)) < 0)
+                dist = -dist;
+            distances[index] = static_cast<float>(dist);
+        }
+    }
+
+    const std::vector<TopoDS_Face>& faces;
+    const std::vector<int>& facetFaces;
+    const std::vector<unsigned long>& indices;
+    const std::vector<unsigned long>& nearest;
+    const Base::Vector3f* points;
+    float deflection;
+    float* distances;
+    std::vector<char>& failed;
+};
+
+}
+
+// ----------------------------------------------------------------
+
 namespace Inspection {
     class MeshInspectGrid : public MeshCore::MeshGrid
     {
@@ -257,29 +453,16 @@ InspectNominalMesh::InspectNominalMesh(const Mesh::MeshObject& rMesh, float offs
     const MeshCore::MeshKernel& kernel = rMesh.getKernel();
     _iter.Transform(rMesh.getTransform());
 
-    // Max. limit of grid elements
-    float fMaxGridElements=8000000.0f;
-    Base::BoundBox3f box = kernel.GetBoundBox().Transformed(rMesh.getTransform());
-
-    // estimate the minimum allowed grid length
-    float fMinGridLen = (float)pow((box.LengthX()*box.LengthY()*box.LengthZ()/fMaxGridElements), 0.3333f);
-    float fGridLen = 5.0f * MeshCore::MeshAlgorithm(kernel).GetAverageEdgeLength();
-
-    // We want to avoid to get too small grid elements otherwise building up the grid structure would take
-    // too much time and memory. 
-    // Having quite a dense grid speeds up more the following algorithms extremely. Due to the issue above it's
-    // always a compromise between speed and memory usage.
-    fGridLen = std::max<float>(fMinGridLen, fGridLen);
-
-    // build up grid structure to speed up algorithms
-    _pGrid = new MeshInspectGrid(kernel, fGridLen, rMesh.getTransform());
-    _box = box;
+    // Unlike a grid the bounding volume hierarchy doesn't depend on a uniform
+    // distribution of the facets, which is rarely the case for scanned data
+    _pBVH = new MeshCore::MeshFacetBVH(kernel, rMesh.getTransform());
+    _box = kernel.GetBoundBox().Transformed(rMesh.getTransform());
     _box.Enlarge(offset);
 }
 
 InspectNominalMesh::~InspectNominalMesh()
 {
-    delete this->_pGrid;
+    delete this->_pBVH;
 }
 
 float InspectNominalMesh::getDistance(const Base::Vector3f& point)
@@ -287,30 +470,28 @@ float InspectNominalMesh::getDistance(const Base::Vector3f& point)
     if (!_box.IsInBox(point))
         return FLT_MAX; // must be inside bbox
 
-    std::vector<unsigned long> indices;
-    //_pGrid->GetElements(point, indices);
-    if (indices.empty()) {
-        std::set<unsigned long> inds;
-        _pGrid->MeshGrid::SearchNearestFromPoint(point, inds);
-        indices.insert(indices.begin(), inds.begin(), inds.end());
-    }
-
-    float fMinDist=FLT_MAX;
-    bool positive = true;
-    for (std::vector<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        _iter.Set(*it);
-        float fDist = _iter->DistanceToPoint(point);
-        if (fabs(fDist) < fabs(fMinDist)) {
-            fMinDist = fDist;
-            positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
-        }
-    }
+    Base::Vector3f res;
+    unsigned long index;
+    if (!_pBVH->NearestFacetToPoint(point, res, index))
+        return FLT_MAX;
 
+    _iter.Set(index);
+    float fMinDist = Base::Distance(point, res);
+    bool positive = point.DistanceToPlane(_iter->_aclPoints[0], _iter->GetNormal()) > 0;
     if (!positive)
         fMinDist = -fMinDist;
     return fMinDist;
 }
 
+void InspectNominalMesh::getDistances(const Base::Vector3f* points, unsigned long count, float* distances)
+{
+    std::fill(distances, distances + count, FLT_MAX);
+
+    std::vector<unsigned long> order = SpatialOrder(points, count);
+    MeshCore::parallel_blocks(order.size(), CountBlocks(order),
+                              NearestFacets(*_pBVH, _iter, &_box, order, points, distances));
+}
+
 // ----------------------------------------------------------------
 
 InspectNominalFastMesh::InspectNominalFastMesh(const Mesh::MeshObject& rMesh, float offset) : _iter(rMesh.getKernel())
@@ -361,16 +542,55 @@ float InspectNominalFastMesh::getDistance(const Base::Vector3f& point)
 #else
     unsigned long ulX, ulY, ulZ;
     _pGrid->Position(point, ulX, ulY, ulZ);
+    getFacets(ulX, ulY, ulZ, indices);
+#endif
+
+    return distanceToFacets(point, indices);
+}
+
+void InspectNominalFastMesh::getDistances(const Base::Vector3f* points, unsigned long count, float* distances)
+{
+    std::fill(distances, distances + count, FLT_MAX);
+
+    // consecutive points mostly lie in the same grid element, so the facets
+    // around an element are only collected once
+    std::vector<unsigned long> order = SpatialOrder(points, count);
+    std::set<unsigned long> indices;
+    unsigned long cellX = ULONG_MAX, cellY = ULONG_MAX, cellZ = ULONG_MAX;
+    for (std::vector<unsigned long>::iterator it = order.begin(); it != order.end(); ++it) {
+        const Base::Vector3f& point = points[*it];
+        if (!_box.IsInBox(point))
+            continue; // must be inside bbox
+
+        unsigned long ulX, ulY, ulZ;
+        _pGrid->Position(point, ulX, ulY, ulZ);
+        if (ulX != cellX || ulY != cellY || ulZ != cellZ) {
+            indices.clear();
+            getFacets(ulX, ulY, ulZ, indices);
+            cellX = ulX;
+            cellY = ulY;
+            cellZ = ulZ;
+        }
+
+        distances[*it] = distanceToFacets(point, indices);
+    }
+}
+
+void InspectNominalFastMesh::getFacets(unsigned long ulX, unsigned long ulY, unsigned long ulZ,
+                                       std::set<unsigned long>& indices) const
+{
     unsigned long ulLevel = 0;
     while (indices.size() == 0 && ulLevel <= max_level)
         _pGrid->GetHull(ulX, ulY, ulZ, ulLevel++, indices);
     if (indices.size() == 0 || ulLevel==1)
         _pGrid->GetHull(ulX, ulY, ulZ, ulLevel, indices);
-#endif
+}
 
+float InspectNominalFastMesh::distanceToFacets(const Base::Vector3f& point, const std::set<unsigned long>& indices)
+{
     float fMinDist=FLT_MAX;
     bool positive = true;
-    for (std::set<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
+    for (std::set<unsigned long>::const_iterator it = indices.begin(); it != indices.end(); ++it) {
         _iter.Set(*it);
         float fDist = _iter->DistanceToPoint(point);
         if (fabs(fDist) < fabs(fMinDist)) {
@@ -389,73 +609,140 @@ float InspectNominalFastMesh::getDistance(const Base::Vector3f& point)
 InspectNominalPoints::InspectNominalPoints(const Points::PointKernel& Kernel, float /*offset*/)
   : _rKernel(Kernel)
 {
-    int uGridPerAxis = 50; // totally 125.000 grid elements 
-    this->_pGrid = new Points::PointsGrid (Kernel, uGridPerAxis);
+    // Unlike a grid cell the k-d tree always finds the nearest point
+    this->_pTree = new Points::PointsKdTree();
+    this->_pTree->Build(Kernel);
 }
 
 InspectNominalPoints::~InspectNominalPoints()
 {
-    delete this->_pGrid;
+    delete this->_pTree;
 }
 
 float InspectNominalPoints::getDistance(const Base::Vector3f& point)
 {
-    //TODO: Make faster
-    std::set<unsigned long> indices;
-    unsigned long x,y,z;
-    Base::Vector3d pointd(point.x,point.y,point.z);
-    _pGrid->Position(pointd, x, y, z);
-    _pGrid->GetElements(x,y,z,indices);
-
-    double fMinDist=DBL_MAX;
-    for (std::set<unsigned long>::iterator it = indices.begin(); it != indices.end(); ++it) {
-        Base::Vector3d pt = _rKernel.getPoint(*it);
-        double fDist = Base::Distance(pointd, pt);
-        if (fDist < fMinDist) {
-            fMinDist = fDist;
-        }
-    }
+    std::vector<unsigned long> indices;
+    std::vector<float> sqrDistances;
+    _pTree->FindNearest(point, 1, indices, &sqrDistances);
+    if (sqrDistances.empty())
+        return FLT_MAX;
+    return sqrt(sqrDistances.front());
+}
 
-    return (float)fMinDist;
+void InspectNominalPoints::getDistances(const Base::Vector3f* points, unsigned long count, float* distances)
+{
+    // the tree sorts the points itself and searches them in parallel
+    std::vector<Base::Vector3f> pnts(points, points + count);
+    std::vector<unsigned long> indices;
+    std::vector<float> sqrDistances;
+    _pTree->FindNearest(pnts, 1, indices, &sqrDistances);
+    for (unsigned long index = 0; index < count; index++) {
+        if (indices[index] == Points::PointsKdTree::NoPoint)
+            distances[index] = FLT_MAX;
+        else
+            distances[index] = sqrt(sqrDistances[index]);
+    }
 }
 
 // ----------------------------------------------------------------
 
-InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float /*radius*/)
+InspectNominalShape::InspectNominalShape(const TopoDS_Shape& shape, float radius)
     : _rShape(shape)
     , isSolid(false)
+    , _mesh(0)
+    , _pBVH(0)
+    , _radius(radius)
+    , _deflection(0)
 {
-    distss = new BRepExtrema_DistShapeShape();
-    distss->LoadS1(_rShape);
-
     // When having a solid then use its shell because otherwise the distance
     // for inner points will always be zero
     if (!_rShape.IsNull() && _rShape.ShapeType() == TopAbs_SOLID) {
-        TopExp_Explorer xp;
-        xp.Init(_rShape, TopAbs_SHELL);
-        if (xp.More()) {
-           distss->LoadS1(xp.Current());
-           isSolid = true;
+        TopExp_Explorer xp(_rShape, TopAbs_SHELL);
+        isSolid = xp.More();
+    }
+
+    distss = new BRepExtrema_DistShapeShape();
+    loadShape(*distss);
+    //distss->SetDeflection(radius);
+
+    // Tessellate the shape to estimate the distances of many points at once.
+    // If the tessellation is coarse compared to the search radius it is refined
+    // because otherwise hardly any point can be decided by the estimate.
+    if (!_rShape.IsNull()) {
+        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath
+            ("User parameter:BaseApp/Preferences/Mod/Part");
+        float deviation = hGrp->GetFloat("MeshDeviation",0.2);
+
+        Part::TopoShape topo(_rShape);
+        Base::BoundBox3d bbox = topo.getBoundBox();
+        double deflection = (bbox.LengthX() + bbox.LengthY() + bbox.LengthZ())/300.0 * deviation;
+        deflection = std::min<double>(deflection, std::max<double>(radius, deflection/10.0));
+
+        if (deflection > 0) {
+            // the faces are tessellated one by one to know the face of each facet
+            BRepMesh_IncrementalMesh aMesh(_rShape, deflection);
+            std::vector<Base::Vector3d> points;
+            std::vector<Data::ComplexGeoData::Facet> facets;
+            int faceIndex = 0;
+            for (TopExp_Explorer xp(_rShape, TopAbs_FACE); xp.More(); xp.Next(), faceIndex++) {
+                std::vector<Data::ComplexGeoData::Domain> domains;
+                Part::TopoShape(xp.Current()).getDomains(domains);
+                for (std::vector<Data::ComplexGeoData::Domain>::iterator it = domains.begin(); it != domains.end(); ++it) {
+                    uint32_t offset = static_cast<uint32_t>(points.size());
+                    points.insert(points.end(), it->points.begin(), it->points.end());
+                    for (std::vector<Data::ComplexGeoData::Facet>::iterator jt = it->facets.begin(); jt != it->facets.end(); ++jt) {
+                        Data::ComplexGeoData::Facet facet = *jt;
+                        facet.I1 += offset;
+                        facet.I2 += offset;
+                        facet.I3 += offset;
+                        facets.push_back(facet);
+                        _facetFaces.push_back(faceIndex);
+                    }
+                }
+            }
+
+            if (!facets.empty()) {
+                _mesh = new Mesh::MeshObject();
+                _mesh->setFacets(facets, points);
+                _pBVH = new MeshCore::MeshFacetBVH(_mesh->getKernel());
+                // the tessellation may deviate a bit more than requested
+                _deflection = 2.0f * (float)deflection;
+            }
         }
+    }
+}
 
+void InspectNominalShape::loadShape(BRepExtrema_DistShapeShape& dist) const
+{
+    if (isSolid) {
+        TopExp_Explorer xp(_rShape, TopAbs_SHELL);
+        dist.LoadS1(xp.Current());
+    }
+    else {
+        dist.LoadS1(_rShape);
     }
-    //distss->SetDeflection(radius);
 }
 
 InspectNominalShape::~InspectNominalShape()
 {
     delete distss;
+    delete _pBVH;
+    delete _mesh;
 }
 
 float InspectNominalShape::getDistance(const Base::Vector3f& point)
 {
-    gp_Pnt pnt3d(point.x,point.y,point.z);
+    return getDistance(*distss, gp_Pnt(point.x,point.y,point.z));
+}
+
+float InspectNominalShape::getDistance(BRepExtrema_DistShapeShape& dist, const gp_Pnt& pnt3d) const
+{
     BRepBuilderAPI_MakeVertex mkVert(pnt3d);
-    distss->LoadS2(mkVert.Vertex());
+    dist.LoadS2(mkVert.Vertex());
 
     float fMinDist=FLT_MAX;
-    if (distss->Perform() && distss->NbSolution() > 0) {
-        fMinDist = (float)distss->Value();
+    if (dist.Perform() && dist.NbSolution() > 0) {
+        fMinDist = (float)dist.Value();
         // the shape is a solid, check if the vertex is inside
         if (isSolid) {
             const Standard_Real tol = 0.001;
@@ -468,12 +755,12 @@ float InspectNominalShape::getDistance(const Base::Vector3f& point)
         }
         else if (fMinDist > 0) {
             // check if the distance was compued from a face
-            for (Standard_Integer index = 1; index <= distss->NbSolution(); index++) {
-                if (distss->SupportTypeShape1(index) == BRepExtrema_IsInFace) {
-                    TopoDS_Shape face = distss->SupportOnShape1(index);
+            for (Standard_Integer index = 1; index <= dist.NbSolution(); index++) {
+                if (dist.SupportTypeShape1(index) == BRepExtrema_IsInFace) {
+                    TopoDS_Shape face = dist.SupportOnShape1(index);
                     Standard_Real u, v;
-                    distss->ParOnFaceS1(index, u, v);
-                    //gp_Pnt pnt = distss->PointOnShape1(index);
+                    dist.ParOnFaceS1(index, u, v);
+                    //gp_Pnt pnt = dist.PointOnShape1(index);
                     BRepGProp_Face props(TopoDS::Face(face));
                     gp_Vec normal;
                     gp_Pnt center;
@@ -491,6 +778,87 @@ float InspectNominalShape::getDistance(const Base::Vector3f& point)
     return fMinDist;
 }
 
+// Computes the distances of points exactly, each thread with its own extrema algorithm
+struct InspectNominalShape::ExactDistances
+{
+    ExactDistances(const InspectNominalShape& nominal, const std::vector<unsigned long>& indices,
+                   const Base::Vector3f* points, float* distances)
+      : nominal(nominal), indices(indices), points(points), distances(distances)
+    {
+    }
+    void operator()(unsigned long begin, unsigned long end, int) const
+    {
+        BRepExtrema_DistShapeShape dist;
+        nominal.loadShape(dist);
+        for (unsigned long pos = begin; pos < end; pos++) {
+            const Base::Vector3f& point = points[indices[pos]];
+            distances[indices[pos]] = nominal.getDistance(dist, gp_Pnt(point.x, point.y, point.z));
+        }
+    }
+
+    const InspectNominalShape& nominal;
+    const std::vector<unsigned long>& indices;
+    const Base::Vector3f* points;
+    float* distances;
+};
+
+/**
+ * The distances are estimated with the tessellation. Whether a point lies
+ * within the search radius can only be decided exactly if its estimate is
+ * close to the radius, so only these points are computed exactly. The
+ * estimates inside the radius are refined by projecting the points onto
+ * the faces, the points outside keep their estimate.
+ */
+void InspectNominalShape::getDistances(const Base::Vector3f* points, unsigned long count, float* distances)
+{
+    if (!_pBVH) {
+        InspectNominalGeometry::getDistances(points, count, distances);
+        return;
+    }
+
+    std::fill(distances, distances + count, FLT_MAX);
+
+    std::vector<unsigned long> order = SpatialOrder(points, count);
+    if (order.empty())
+        return;
+
+    std::vector<unsigned long> nearest(count, ULONG_MAX);
+    MeshCore::MeshFacetIterator iter(_mesh->getKernel());
+    MeshCore::parallel_blocks(order.size(), CountBlocks(order),
+                              NearestFacets(*_pBVH, iter, 0, order, points, distances, &nearest[0]));
+
+    std::vector<unsigned long> exact, refine;
+    for (std::vector<unsigned long>::iterator it = order.begin(); it != order.end(); ++it) {
+        if (nearest[*it] == ULONG_MAX)
+            continue;
+        float dist = fabs(distances[*it]);
+        if (fabs(dist - _radius) <= _deflection)
+            exact.push_back(*it);
+        else if (dist < _radius)
+            refine.push_back(*it);
+    }
+
+    if (!refine.empty()) {
+        std::vector<TopoDS_Face> faces;
+        for (TopExp_Explorer xp(_rShape, TopAbs_FACE); xp.More(); xp.Next())
+            faces.push_back(TopoDS::Face(xp.Current()));
+
+        std::vector<char> failed(refine.size(), 0);
+        MeshCore::parallel_blocks(refine.size(), CountBlocks(refine),
+                                  ProjectOnFaces(faces, _facetFaces, refine, nearest, points,
+                                                 _deflection, distances, failed));
+        for (std::size_t pos = 0; pos < refine.size(); pos++) {
+            if (failed[pos])
+                exact.push_back(refine[pos]);
+        }
+    }
+
+    if (!exact.empty()) {
+        MeshCore::parallel_blocks(exact.size(), MeshCore::count_blocks(exact.size(), 2),
+                                  ExactDistances(*this, exact, points, distances));
+    }
+}
+
 // ----------------------------------------------------------------
 
 TYPESYSTEM_SOURCE(Inspection::PropertyDistanceList, App::PropertyLists);
@@ -638,39 +1006,6 @@ unsigned int PropertyDistanceList::getMemSize (void) const
 
 // ----------------------------------------------------------------
 
-// helper class to use Qt's concurrent framework
-struct DistanceInspection
-{
-
-    DistanceInspection(float radius, InspectActualGeometry*  a,
-                       std::vector<InspectNominalGeometry*> n)
-                    : radius(radius), actual(a), nominal(n)
-    {
-    }
-    float mapped(unsigned long index)
-    {
-        Base::Vector3f pnt = actual->getPoint(index);
-
-        float fMinDist=FLT_MAX;
-        for (std::vector<InspectNominalGeometry*>::iterator it = nominal.begin(); it != nominal.end(); ++it) {
-            float fDist = (*it)->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist))
-                fMinDist = fDist;
-        }
-
-        if (fMinDist > this->radius)
-            fMinDist = FLT_MAX;
-        else if (-fMinDist > this->radius)
-            fMinDist = -FLT_MAX;
-
-        return fMinDist;
-    }
-
-    float radius;
-    InspectActualGeometry*  actual;
-    std::vector<InspectNominalGeometry*> nominal;
-};
-
 PROPERTY_SOURCE(Inspection::Feature, App::DocumentObject)
 
 Feature::Feature()
@@ -744,52 +1079,43 @@ App::DocumentObjectExecReturn* Feature::execute(void)
             inspectNominal.push_back(nominal);
     }
 
-#if 0 // test with some huge data sets
-    Standard::SetReentrant(Standard_True);
-    std::vector<unsigned long> index(actual->countPoints());
-    std::generate(index.begin(), index.end(), Base::iotaGen<unsigned long>(0));
-    DistanceInspection check(this->SearchRadius.getValue(), actual, inspectNominal);
-    QFuture<float> future = QtConcurrent::mapped
-        (index, boost::bind(&DistanceInspection::mapped, &check, _1));
-    //future.waitForFinished(); // blocks the GUI
-    Base::FutureWatcherProgress progress("Inspecting...", actual->countPoints());
-    QFutureWatcher<float> watcher;
-    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)),
-                     &progress, SLOT(progressValueChanged(int)));
-    watcher.setFuture(future);
-
-    // keep it responsive during computation
-    QEventLoop loop;
-    QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
-    loop.exec();
-
-    std::vector<float> vals;
-    vals.insert(vals.end(), future.begin(), future.end());
-#else
     unsigned long count = actual->countPoints();
     std::stringstream str;
     str << "Inspecting " << this->Label.getValue() << "...";
-    Base::SequencerLauncher seq(str.str().c_str(), count);
 
-    std::vector<float> vals(count);
-    for (unsigned long index = 0; index < count; index++) {
-        Base::Vector3f pnt = actual->getPoint(index);
+    // the points are passed in chunks to the nominals to show the progress
+    const unsigned long chunkSize = 65536;
+    Base::SequencerLauncher seq(str.str().c_str(), (count + chunkSize - 1) / chunkSize);
 
-        float fMinDist=FLT_MAX;
+    float radius = this->SearchRadius.getValue();
+    std::vector<float> vals(count);
+    std::vector<Base::Vector3f> pnts;
+    std::vector<float> dists;
+    for (unsigned long chunk = 0; chunk < count; chunk += chunkSize) {
+        unsigned long size = std::min<unsigned long>(chunkSize, count - chunk);
+        pnts.resize(size);
+        for (unsigned long index = 0; index < size; index++)
+            pnts[index] = actual->getPoint(chunk + index);
+
+        float* fMinDists = &vals[chunk];
+        std::fill(fMinDists, fMinDists + size, FLT_MAX);
+        dists.resize(size);
         for (std::vector<InspectNominalGeometry*>::iterator it = inspectNominal.begin(); it != inspectNominal.end(); ++it) {
-            float fDist = (*it)->getDistance(pnt);
-            if (fabs(fDist) < fabs(fMinDist))
-                fMinDist = fDist;
+            (*it)->getDistances(&pnts[0], size, &dists[0]);
+            for (unsigned long index = 0; index < size; index++) {
+                if (fabs(dists[index]) < fabs(fMinDists[index]))
+                    fMinDists[index] = dists[index];
+            }
         }
 
-        if (fMinDist > this->SearchRadius.getValue())
-            fMinDist = FLT_MAX;
-        else if (-fMinDist > this->SearchRadius.getValue())
-            fMinDist = -FLT_MAX;
-        vals[index] = fMinDist;
+        for (unsigned long index = 0; index < size; index++) {
+            if (fMinDists[index] > radius)
+                fMinDists[index] = FLT_MAX;
+            else if (-fMinDists[index] > radius)
+                fMinDists[index] = -FLT_MAX;
+        }
         seq.next();
     }
-#endif
 
     Distances.setValues(vals);
 
@@ -24,6 +24,8 @@
 #ifndef INSPECTION_FEATURE_H
 #define INSPECTION_FEATURE_H
 
+#include <set>
+
 #include <App/DocumentObject.h>
 #include <App/PropertyLinks.h>
 #include <App/DocumentObjectGroup.h>
@@ -32,15 +34,17 @@
 #include <Mod/Points/App/Points.h>
 
 class TopoDS_Shape;
+class gp_Pnt;
 class BRepExtrema_DistShapeShape;
 
 namespace MeshCore {
 class MeshKernel;
 class MeshGrid;
+class MeshFacetBVH;
 }
 
 namespace Mesh   { class MeshObject; }
-namespace Points { class PointsGrid; }
+namespace Points { class PointsKdTree; }
 namespace Part   { class TopoShape;  }
 
 namespace Inspection
@@ -100,6 +104,11 @@ public:
     InspectNominalGeometry() {}
     virtual ~InspectNominalGeometry() {}
     virtual float getDistance(const Base::Vector3f&) = 0;
+    /** Computes the distances of \a count points at once. The default calls
+     * getDistance() for each point, the subclasses process the points in
+     * spatial order to reuse their search structures.
+     */
+    virtual void getDistances(const Base::Vector3f* points, unsigned long count, float* distances);
 };
 
 class InspectionExport InspectNominalMesh : public InspectNominalGeometry
@@ -108,10 +117,11 @@ public:
     InspectNominalMesh(const Mesh::MeshObject& rMesh, float offset);
     ~InspectNominalMesh();
     virtual float getDistance(const Base::Vector3f&);
+    virtual void getDistances(const Base::Vector3f* points, unsigned long count, float* distances);
 
 private:
     MeshCore::MeshFacetIterator _iter;
-    MeshCore::MeshGrid* _pGrid;
+    MeshCore::MeshFacetBVH* _pBVH;
     Base::BoundBox3f _box;
 };
 
@@ -121,6 +131,12 @@ public:
     InspectNominalFastMesh(const Mesh::MeshObject& rMesh, float offset);
     ~InspectNominalFastMesh();
     virtual float getDistance(const Base::Vector3f&);
+    virtual void getDistances(const Base::Vector3f* points, unsigned long count, float* distances);
+
+protected:
+    void getFacets(unsigned long ulX, unsigned long ulY, unsigned long ulZ,
+                   std::set<unsigned long>& indices) const;
+    float distanceToFacets(const Base::Vector3f&, const std::set<unsigned long>& indices);
 
 protected:
     MeshCore::MeshFacetIterator _iter;
@@ -135,10 +151,11 @@ public:
     InspectNominalPoints(const Points::PointKernel&, float offset);
     ~InspectNominalPoints();
     virtual float getDistance(const Base::Vector3f&);
+    virtual void getDistances(const Base::Vector3f* points, unsigned long count, float* distances);
 
 private:
     const Points::PointKernel& _rKernel;
-    Points::PointsGrid* _pGrid;
+    Points::PointsKdTree* _pTree;
 };
 
 class InspectionExport InspectNominalShape : public InspectNominalGeometry
@@ -147,11 +164,29 @@ public:
     InspectNominalShape(const TopoDS_Shape&, float offset);
     ~InspectNominalShape();
     virtual float getDistance(const Base::Vector3f&);
+    /** Estimates the distances with a tessellation of the shape. Only the
+     * points whose estimate is close to the search radius are computed
+     * exactly, the points inside are projected onto the face of their
+     * nearest facet.
+     */
+    virtual void getDistances(const Base::Vector3f* points, unsigned long count, float* distances);
+
+private:
+    struct ExactDistances;
+    void loadShape(BRepExtrema_DistShapeShape&) const;
+    float getDistance(BRepExtrema_DistShapeShape&, const gp_Pnt&) const;
 
 private:
     BRepExtrema_DistShapeShape* distss;
     const TopoDS_Shape& _rShape;
     bool isSolid;
+    // the tessellation estimates the distances of the points far away
+    Mesh::MeshObject* _mesh;
+    MeshCore::MeshFacetBVH* _pBVH;
+    // index of the face of each facet of the tessellation
+    std::vector<int> _facetFaces;
+    float _radius;
+    float _deflection;
 };
 
 class InspectionExport PropertyDistanceList: public App::PropertyLists
@@ -0,0 +1,124 @@
+#**************************************************************************
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, unittest, math, Mesh, Points, Part
+from FreeCAD import Vector
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD inspection module
+#---------------------------------------------------------------------------
+
+
+class InspectionTestCases(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("InspectionTest")
+        self.radius = 0.5
+        # signed offsets of the actual points from the nominal geometry,
+        # several of them close to the search radius
+        self.offsets = [-0.45, -0.2, 0.0, 0.05, 0.3, 0.49, 0.499, 0.501, 0.51, 0.8]
+        # positions on the plane z=0 that are no mesh or grid points
+        self.positions = [(2.3, 4.1), (5.0, 5.0), (7.7, 3.2)]
+
+    def inspect(self, nominal, points):
+        actual = self.Doc.addObject("Points::Feature", "Actual")
+        actual.Points = Points.Points(points)
+        feature = self.Doc.addObject("Inspection::Feature", "Inspect")
+        feature.Actual = actual
+        feature.Nominals = [nominal]
+        feature.SearchRadius = self.radius
+        self.Doc.recompute()
+        return feature.Distances
+
+    def checkDistances(self, distances, expected):
+        self.assertEqual(len(distances), len(expected))
+        for dist, value in zip(distances, expected):
+            if abs(value) > self.radius:
+                self.assertGreater(abs(dist), 1.0e30)
+            else:
+                self.assertAlmostEqual(dist, value, places=4)
+
+    def testNominalMesh(self):
+        # a plane of 10x10 with the normals pointing to +z
+        triangles = []
+        for x in range(10):
+            for y in range(10):
+                triangles += [(x, y, 0), (x + 1, y, 0), (x + 1, y + 1, 0)]
+                triangles += [(x, y, 0), (x + 1, y + 1, 0), (x, y + 1, 0)]
+        nominal = self.Doc.addObject("Mesh::Feature", "Nominal")
+        nominal.Mesh = Mesh.Mesh(triangles)
+
+        points = []
+        expected = []
+        for x, y in self.positions:
+            for offset in self.offsets:
+                points.append(Vector(x, y, offset))
+                expected.append(offset)
+        self.checkDistances(self.inspect(nominal, points), expected)
+
+    def testNominalPoints(self):
+        grid = []
+        for i in range(41):
+            for j in range(41):
+                grid.append(Vector(i * 0.25, j * 0.25, 0))
+        nominal = self.Doc.addObject("Points::Feature", "Nominal")
+        nominal.Points = Points.Points(grid)
+
+        # the distances to points are unsigned
+        points = []
+        expected = []
+        for x, y in [(2.25, 4.0), (5.0, 5.0), (7.75, 3.25)]:
+            for offset in self.offsets:
+                points.append(Vector(x, y, offset))
+                expected.append(abs(offset))
+        self.checkDistances(self.inspect(nominal, points), expected)
+
+    def testNominalSolid(self):
+        # inside the solid the distances are negative
+        nominal = self.Doc.addObject("Part::Feature", "Nominal")
+        nominal.Shape = Part.makeSphere(5.0)
+
+        points = []
+        expected = []
+        for theta in range(0, 360, 25):
+            for phi in (-40, 0, 30):
+                direction = Vector(math.cos(math.radians(theta)) * math.cos(math.radians(phi)),
+                                   math.sin(math.radians(theta)) * math.cos(math.radians(phi)),
+                                   math.sin(math.radians(phi)))
+                for offset in self.offsets:
+                    points.append(direction * (5.0 + offset))
+                    expected.append(offset)
+        self.checkDistances(self.inspect(nominal, points), expected)
+
+    def testNominalFace(self):
+        # the distances to a face are signed by its normal
+        nominal = self.Doc.addObject("Part::Feature", "Nominal")
+        nominal.Shape = Part.makePlane(10.0, 10.0)
+
+        points = []
+        expected = []
+        for x, y in self.positions:
+            for offset in self.offsets:
+                points.append(Vector(x, y, offset))
+                expected.append(offset)
+        self.checkDistances(self.inspect(nominal, points), expected)
+
+    def tearDown(self):
+        FreeCAD.closeDocument("InspectionTest")
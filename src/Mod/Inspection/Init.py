@@ -24,3 +24,5 @@
 #*                                                                         *
 #*   Juergen Riegel 2002                                                   *
 #***************************************************************************/
+
+FreeCAD.__unit_test__ += [ "InspectionTestsApp" ]
@@ -90,6 +90,7 @@ PyMOD_INIT_FUNC(Mesh)
     Mesh::FixDegenerations      ::init();
     Mesh::FixDeformations       ::init();
     Mesh::FixIndices            ::init();
+    Mesh::FixAllDefects         ::init();
     Mesh::FillHoles             ::init();
     Mesh::RemoveComponents      ::init();
 
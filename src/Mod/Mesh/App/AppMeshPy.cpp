@@ -41,12 +41,14 @@
 
 #include <Base/GeometryPyCXX.h>
 #include <Base/VectorPy.h>
+#include <Base/MatrixPy.h>
 
 #include "Core/MeshKernel.h"
 #include "Core/MeshIO.h"
 #include "Core/Evaluation.h"
 #include "Core/Iterator.h"
 #include "Core/Approximation.h"
+#include "Core/ChunkedKernel.h"
 
 #include "WildMagic4/Wm4ContBox3.h"
 
@@ -125,6 +127,28 @@ public:
             "tuple of seven items:\n"
             "    center, u, v, w directions and the lengths of the three vectors.\n"
         );
+        add_varargs_method("createChunked",&Module::createChunked,
+            "createChunked(stl, file, [facetsPerChunk=1000000])\n"
+            "Sorts the facets of a binary STL file into chunks and writes them\n"
+            "to a chunk file. Neither file needs to fit into memory.\n"
+        );
+        add_varargs_method("readChunk",&Module::readChunk,
+            "readChunk(file, index) -- Returns the given chunk of a chunk file as Mesh object."
+        );
+        add_varargs_method("countChunks",&Module::countChunks,
+            "countChunks(file) -- Returns the number of chunks of a chunk file."
+        );
+        add_varargs_method("transformChunked",&Module::transformChunked,
+            "transformChunked(file, Matrix) -- Transforms the points of a chunk file in place."
+        );
+        add_varargs_method("decimateChunked",&Module::decimateChunked,
+            "decimateChunked(file, output, tolerance, reduction)\n"
+            "Simplifies a chunk file chunk by chunk and writes the result to\n"
+            "a new chunk file.\n"
+        );
+        add_varargs_method("exportChunked",&Module::exportChunked,
+            "exportChunked(file, stl) -- Writes a chunk file as binary STL file."
+        );
         initialize("The functions in this module allow working with mesh objects.\n"
                    "A set of functions are provided for reading in registered mesh\n"
                    "file formats to either a new or existing document.\n"
@@ -668,6 +692,109 @@ private:
 
         return result;
     }
+    Py::Object createChunked(const Py::Tuple& args)
+    {
+        char* stl;
+        char* file;
+        unsigned long facetsPerChunk = 1000000;
+        if (!PyArg_ParseTuple(args.ptr(), "etet|k","utf-8",&stl,"utf-8",&file,&facetsPerChunk))
+            throw Py::Exception();
+        std::string EncodedStl = std::string(stl);
+        PyMem_Free(stl);
+        std::string EncodedFile = std::string(file);
+        PyMem_Free(file);
+
+        if (facetsPerChunk == 0)
+            throw Py::ValueError("Number of facets per chunk must be positive");
+        if (!MeshChunkedKernel::Create(EncodedStl, EncodedFile, facetsPerChunk))
+            throw Py::RuntimeError("Failed to create chunk file");
+        return Py::None();
+    }
+    Py::Object readChunk(const Py::Tuple& args)
+    {
+        char* file;
+        unsigned long index;
+        if (!PyArg_ParseTuple(args.ptr(), "etk","utf-8",&file,&index))
+            throw Py::Exception();
+        std::string EncodedFile = std::string(file);
+        PyMem_Free(file);
+
+        MeshChunkedKernel chunks;
+        if (!chunks.Open(EncodedFile))
+            throw Py::RuntimeError("Failed to open chunk file");
+        if (index >= chunks.CountChunks())
+            throw Py::IndexError("Chunk index out of range");
+
+        std::unique_ptr<MeshObject> mesh(new MeshObject);
+        chunks.GetChunk(index, mesh->getKernel());
+        return Py::asObject(new MeshPy(mesh.release()));
+    }
+    Py::Object countChunks(const Py::Tuple& args)
+    {
+        char* file;
+        if (!PyArg_ParseTuple(args.ptr(), "et","utf-8",&file))
+            throw Py::Exception();
+        std::string EncodedFile = std::string(file);
+        PyMem_Free(file);
+
+        MeshChunkedKernel chunks;
+        if (!chunks.Open(EncodedFile))
+            throw Py::RuntimeError("Failed to open chunk file");
+        return Py::Long(chunks.CountChunks());
+    }
+    Py::Object transformChunked(const Py::Tuple& args)
+    {
+        char* file;
+        PyObject* mat;
+        if (!PyArg_ParseTuple(args.ptr(), "etO!","utf-8",&file,&(Base::MatrixPy::Type),&mat))
+            throw Py::Exception();
+        std::string EncodedFile = std::string(file);
+        PyMem_Free(file);
+
+        MeshChunkedKernel chunks;
+        if (!chunks.Open(EncodedFile, true))
+            throw Py::RuntimeError("Failed to open chunk file");
+        if (!chunks.Transform(static_cast<Base::MatrixPy*>(mat)->value()))
+            throw Py::RuntimeError("Failed to transform chunk file");
+        return Py::None();
+    }
+    Py::Object decimateChunked(const Py::Tuple& args)
+    {
+        char* file;
+        char* output;
+        float tolerance, reduction;
+        if (!PyArg_ParseTuple(args.ptr(), "etetff","utf-8",&file,"utf-8",&output,&tolerance,&reduction))
+            throw Py::Exception();
+        std::string EncodedFile = std::string(file);
+        PyMem_Free(file);
+        std::string EncodedOutput = std::string(output);
+        PyMem_Free(output);
+
+        MeshChunkedKernel chunks;
+        if (!chunks.Open(EncodedFile))
+            throw Py::RuntimeError("Failed to open chunk file");
+        if (!chunks.Decimate(EncodedOutput, tolerance, reduction))
+            throw Py::RuntimeError("Failed to decimate chunk file");
+        return Py::None();
+    }
+    Py::Object exportChunked(const Py::Tuple& args)
+    {
+        char* file;
+        char* stl;
+        if (!PyArg_ParseTuple(args.ptr(), "etet","utf-8",&file,"utf-8",&stl))
+            throw Py::Exception();
+        std::string EncodedFile = std::string(file);
+        PyMem_Free(file);
+        std::string EncodedStl = std::string(stl);
+        PyMem_Free(stl);
+
+        MeshChunkedKernel chunks;
+        if (!chunks.Open(EncodedFile))
+            throw Py::RuntimeError("Failed to open chunk file");
+        if (!chunks.SaveBinarySTL(EncodedStl))
+            throw Py::RuntimeError("Failed to write STL file");
+        return Py::None();
+    }
 };
 
 PyObject* initModule()
@@ -0,0 +1,282 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <atomic>
+# include <iterator>
+#endif
+
+#include "Adjacency.h"
+#include "Elements.h"
+#include "Functional.h"
+
+using namespace MeshCore;
+
+namespace {
+
+// smaller numbers of elements are handled by the calling thread
+const unsigned long MinParallelCount = 10000;
+
+typedef std::vector<std::atomic<unsigned long> > AtomicArray;
+
+// The emitters pass the (row, index) pairs of a facet to a sink
+struct PointToFacetsEmitter
+{
+    template <class Sink>
+    void operator()(const MeshFacet& rFacet, unsigned long ulIndex, Sink& sink) const
+    {
+        sink(rFacet._aulPoints[0], ulIndex);
+        sink(rFacet._aulPoints[1], ulIndex);
+        sink(rFacet._aulPoints[2], ulIndex);
+    }
+};
+
+struct PointToPointsEmitter
+{
+    template <class Sink>
+    void operator()(const MeshFacet& rFacet, unsigned long, Sink& sink) const
+    {
+        for (int i=0; i<3; i++) {
+            sink(rFacet._aulPoints[i], rFacet._aulPoints[(i+1)%3]);
+            sink(rFacet._aulPoints[i], rFacet._aulPoints[(i+2)%3]);
+        }
+    }
+};
+
+struct CountSink
+{
+    CountSink(AtomicArray& counts) : counts(&counts) {}
+    void operator()(unsigned long row, unsigned long)
+    {
+        (*counts)[row].fetch_add(1, std::memory_order_relaxed);
+    }
+    AtomicArray* counts;
+};
+
+struct FillSink
+{
+    FillSink(AtomicArray& cursors, unsigned long* indices) : cursors(&cursors), indices(indices) {}
+    void operator()(unsigned long row, unsigned long index)
+    {
+        indices[(*cursors)[row].fetch_add(1, std::memory_order_relaxed)] = index;
+    }
+    AtomicArray* cursors;
+    unsigned long* indices;
+};
+
+template <class Emitter, class Sink>
+struct EmitFacets
+{
+    typedef void result_type;
+    EmitFacets(const MeshFacetArray& rFacets, const Sink& sink) : facets(&rFacets), sink(sink) {}
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        Emitter emit;
+        Sink local(sink);
+        for (unsigned long i = begin; i < end; i++)
+            emit((*facets)[i], i, local);
+    }
+    const MeshFacetArray* facets;
+    Sink sink;
+};
+
+// Counts the entries of each row, computes the offsets and fills in the indices.
+// The order of the indices within a row is arbitrary.
+template <class Emitter>
+void FillRows(const MeshFacetArray& rFacets, unsigned long ulCtRows,
+              std::vector<unsigned long>& offsets, std::vector<unsigned long>& indices)
+{
+    unsigned long ulCtFacets = static_cast<unsigned long>(rFacets.size());
+    AtomicArray counts(ulCtRows);
+    parallel_for(ulCtFacets, MinParallelCount, EmitFacets<Emitter, CountSink>(rFacets, CountSink(counts)));
+
+    // the counters are re-used as the insert positions of each row
+    offsets.resize(ulCtRows + 1);
+    offsets[0] = 0;
+    for (unsigned long i = 0; i < ulCtRows; i++) {
+        offsets[i+1] = offsets[i] + counts[i].load(std::memory_order_relaxed);
+        counts[i].store(offsets[i], std::memory_order_relaxed);
+    }
+
+    indices.resize(offsets[ulCtRows]);
+    parallel_for(ulCtFacets, MinParallelCount, EmitFacets<Emitter, FillSink>(rFacets, FillSink(counts, indices.data())));
+}
+
+struct SortRowRange
+{
+    typedef void result_type;
+    SortRowRange(const std::vector<unsigned long>& offsets, unsigned long* indices, unsigned long* sizes)
+      : offsets(&offsets), indices(indices), sizes(sizes) {}
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        for (unsigned long i = begin; i < end; i++) {
+            unsigned long* first = indices + (*offsets)[i];
+            unsigned long* last = indices + (*offsets)[i+1];
+            std::sort(first, last);
+            sizes[i] = static_cast<unsigned long>(std::unique(first, last) - first);
+        }
+    }
+    const std::vector<unsigned long>* offsets;
+    unsigned long* indices;
+    unsigned long* sizes;
+};
+
+// Collects the facets around the points of each facet. Without offsets only the
+// number of facets is written to 'output'.
+struct FacetNeighbours
+{
+    typedef void result_type;
+    FacetNeighbours(const MeshFacetArray& rFacets, const MeshAdjacency& rPointToFacets,
+                    const std::vector<unsigned long>* offsets, unsigned long* output)
+      : facets(&rFacets), pointToFacets(&rPointToFacets), offsets(offsets), output(output) {}
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        std::vector<unsigned long> tmp, merged;
+        for (unsigned long i = begin; i < end; i++) {
+            const MeshFacet& rFacet = (*facets)[i];
+            MeshIndexRange r0 = (*pointToFacets)[rFacet._aulPoints[0]];
+            MeshIndexRange r1 = (*pointToFacets)[rFacet._aulPoints[1]];
+            MeshIndexRange r2 = (*pointToFacets)[rFacet._aulPoints[2]];
+            tmp.clear();
+            std::set_union(r0.begin(), r0.end(), r1.begin(), r1.end(), std::back_inserter(tmp));
+            merged.clear();
+            std::set_union(tmp.begin(), tmp.end(), r2.begin(), r2.end(), std::back_inserter(merged));
+            if (offsets)
+                std::copy(merged.begin(), merged.end(), output + (*offsets)[i]);
+            else
+                output[i] = static_cast<unsigned long>(merged.size());
+        }
+    }
+    const MeshFacetArray* facets;
+    const MeshAdjacency* pointToFacets;
+    const std::vector<unsigned long>* offsets;
+    unsigned long* output;
+};
+
+}
+
+void MeshAdjacency::SetPointToFacets (const MeshFacetArray& rFacets, unsigned long ulCtPoints)
+{
+    FillRows<PointToFacetsEmitter>(rFacets, ulCtPoints, _offsets, _indices);
+    SortRows();
+}
+
+void MeshAdjacency::SetPointToPoints (const MeshFacetArray& rFacets, unsigned long ulCtPoints)
+{
+    FillRows<PointToPointsEmitter>(rFacets, ulCtPoints, _offsets, _indices);
+    SortRows();
+}
+
+void MeshAdjacency::SetFacetToFacets (const MeshFacetArray& rFacets, const MeshAdjacency& rPointToFacets)
+{
+    unsigned long ulCtFacets = static_cast<unsigned long>(rFacets.size());
+    std::vector<unsigned long> sizes(ulCtFacets);
+    parallel_for(ulCtFacets, MinParallelCount, FacetNeighbours(rFacets, rPointToFacets, 0, sizes.data()));
+
+    _offsets.resize(ulCtFacets + 1);
+    _offsets[0] = 0;
+    for (unsigned long i = 0; i < ulCtFacets; i++)
+        _offsets[i+1] = _offsets[i] + sizes[i];
+
+    _indices.resize(_offsets[ulCtFacets]);
+    parallel_for(ulCtFacets, MinParallelCount, FacetNeighbours(rFacets, rPointToFacets, &_offsets, _indices.data()));
+}
+
+void MeshAdjacency::SortRows ()
+{
+    unsigned long ulCtRows = CountRows();
+    std::vector<unsigned long> sizes(ulCtRows);
+    parallel_for(ulCtRows, MinParallelCount, SortRowRange(_offsets, _indices.data(), sizes.data()));
+
+    // move the rows together to remove the gaps left by duplicates
+    unsigned long pos = 0;
+    for (unsigned long i = 0; i < ulCtRows; i++) {
+        unsigned long first = _offsets[i];
+        _offsets[i] = pos;
+        if (pos != first)
+            std::copy(_indices.begin() + first, _indices.begin() + first + sizes[i], _indices.begin() + pos);
+        pos += sizes[i];
+    }
+    _offsets[ulCtRows] = pos;
+
+    if (pos < _indices.size()) {
+        _indices.resize(pos);
+        _indices.shrink_to_fit();
+    }
+}
+
+void MeshAdjacency::Clear ()
+{
+    std::vector<unsigned long>().swap(_offsets);
+    std::vector<unsigned long>().swap(_indices);
+}
+
+void MeshAdjacency::Swap (MeshAdjacency& rAdjacency)
+{
+    _offsets.swap(rAdjacency._offsets);
+    _indices.swap(rAdjacency._indices);
+}
+
+// ----------------------------------------------------------------------------
+
+void MeshDynamicAdjacency::Assign (MeshAdjacency& rAdjacency)
+{
+    _adjacency.Swap(rAdjacency);
+    _modified.clear();
+}
+
+void MeshDynamicAdjacency::Clear ()
+{
+    _adjacency.Clear();
+    _modified.clear();
+}
+
+std::vector<unsigned long>& MeshDynamicAdjacency::ModifyRow (unsigned long row)
+{
+    std::map<unsigned long, std::vector<unsigned long> >::iterator it = _modified.find(row);
+    if (it == _modified.end()) {
+        MeshIndexRange range = _adjacency[row];
+        it = _modified.insert(std::make_pair(row, std::vector<unsigned long>(range.begin(), range.end()))).first;
+    }
+    return it->second;
+}
+
+void MeshDynamicAdjacency::Add (unsigned long row, unsigned long index)
+{
+    if ((*this)[row].count(index) > 0)
+        return;
+    std::vector<unsigned long>& indices = ModifyRow(row);
+    indices.insert(std::lower_bound(indices.begin(), indices.end(), index), index);
+}
+
+void MeshDynamicAdjacency::Remove (unsigned long row, unsigned long index)
+{
+    if ((*this)[row].count(index) == 0)
+        return;
+    std::vector<unsigned long>& indices = ModifyRow(row);
+    indices.erase(std::lower_bound(indices.begin(), indices.end(), index));
+}
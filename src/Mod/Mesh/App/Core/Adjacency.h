@@ -0,0 +1,157 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef MESH_ADJACENCY_H
+#define MESH_ADJACENCY_H
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace MeshCore
+{
+
+class MeshFacetArray;
+
+/**
+ * The MeshIndexRange class is a read-only view on the sorted indices of one
+ * row of a MeshAdjacency. It provides the part of the std::set interface that
+ * is needed to iterate over and search for adjacent elements.
+ */
+class MeshExport MeshIndexRange
+{
+public:
+    typedef unsigned long value_type;
+    typedef std::size_t size_type;
+    typedef const unsigned long* const_iterator;
+    typedef const_iterator iterator;
+
+    MeshIndexRange() : _begin(0), _end(0) {}
+    MeshIndexRange(const_iterator begin, const_iterator end) : _begin(begin), _end(end) {}
+
+    const_iterator begin() const { return _begin; }
+    const_iterator end() const { return _end; }
+    size_type size() const { return static_cast<size_type>(_end - _begin); }
+    bool empty() const { return _begin == _end; }
+    /// Returns the position of \a index or end() if it's not part of the range.
+    const_iterator find(unsigned long index) const
+    {
+        const_iterator it = std::lower_bound(_begin, _end, index);
+        return (it != _end && *it == index) ? it : _end;
+    }
+    size_type count(unsigned long index) const
+    { return find(index) != _end ? 1 : 0; }
+
+private:
+    const_iterator _begin;
+    const_iterator _end;
+};
+
+/**
+ * The MeshAdjacency class stores for every element of a mesh (a row) the sorted
+ * indices of its adjacent elements in compressed row storage, i.e. all indices
+ * are kept in one array and a second array holds the start of each row.
+ * Compared to a std::set per row this needs a fraction of the memory and the
+ * indices of a row are close together in memory.
+ *
+ * The structure is built with several threads by counting the entries of each
+ * row, computing the row offsets and filling in the indices. Once built it
+ * cannot be changed, see MeshDynamicAdjacency for this purpose.
+ */
+class MeshExport MeshAdjacency
+{
+public:
+    MeshAdjacency() {}
+    ~MeshAdjacency() {}
+
+    /// Sets for each of the \a ulCtPoints points the facets referencing it.
+    void SetPointToFacets (const MeshFacetArray& rFacets, unsigned long ulCtPoints);
+    /// Sets for each of the \a ulCtPoints points the points sharing an edge with it.
+    void SetPointToPoints (const MeshFacetArray& rFacets, unsigned long ulCtPoints);
+    /// Sets for each facet all facets sharing at least one point with it, including
+    /// the facet itself. \a rPointToFacets must have been set for the same facets.
+    void SetFacetToFacets (const MeshFacetArray& rFacets, const MeshAdjacency& rPointToFacets);
+    void Clear ();
+    void Swap (MeshAdjacency&);
+
+    /// Returns the number of rows.
+    unsigned long CountRows () const
+    { return _offsets.empty() ? 0 : static_cast<unsigned long>(_offsets.size() - 1); }
+    /// Returns the number of indices of all rows.
+    std::size_t CountIndices () const
+    { return _indices.size(); }
+    MeshIndexRange operator[] (unsigned long row) const
+    { return MeshIndexRange(_indices.data() + _offsets[row], _indices.data() + _offsets[row+1]); }
+
+private:
+    void SortRows ();
+
+private:
+    std::vector<unsigned long> _offsets; /**< Start of each row, plus the end of the last one. */
+    std::vector<unsigned long> _indices; /**< Indices of all rows. */
+};
+
+/**
+ * The MeshDynamicAdjacency class is a MeshAdjacency whose rows can be changed
+ * while the topology of the mesh gets edited. A modified row is copied out of
+ * the compact storage and kept apart, so few edits on a big mesh stay cheap.
+ */
+class MeshExport MeshDynamicAdjacency
+{
+public:
+    MeshDynamicAdjacency() {}
+    ~MeshDynamicAdjacency() {}
+
+    /// Replaces the content with \a rAdjacency and clears all modifications.
+    void Assign (MeshAdjacency& rAdjacency);
+    void Clear ();
+
+    unsigned long CountRows () const
+    { return _adjacency.CountRows(); }
+    MeshIndexRange operator[] (unsigned long row) const
+    {
+        if (!_modified.empty()) {
+            std::map<unsigned long, std::vector<unsigned long> >::const_iterator it = _modified.find(row);
+            if (it != _modified.end())
+                return MeshIndexRange(it->second.data(), it->second.data() + it->second.size());
+        }
+        return _adjacency[row];
+    }
+    /// Adds \a index to the row if not already there. Ranges returned for this
+    /// row before become invalid.
+    void Add (unsigned long row, unsigned long index);
+    /// Removes \a index from the row.
+    void Remove (unsigned long row, unsigned long index);
+
+private:
+    std::vector<unsigned long>& ModifyRow (unsigned long row);
+
+private:
+    MeshAdjacency _adjacency;
+    std::map<unsigned long, std::vector<unsigned long> > _modified;
+};
+
+} // namespace MeshCore
+
+#endif // MESH_ADJACENCY_H
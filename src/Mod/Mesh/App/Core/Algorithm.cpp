@@ -29,6 +29,7 @@
 
 #include "Algorithm.h"
 #include "Approximation.h"
+#include "BVH.h"
 #include "Elements.h"
 #include "Iterator.h"
 #include "Grid.h"
@@ -140,6 +141,13 @@ bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::
     return false;
 }
 
+bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const MeshFacetBVH &rclBVH,
+                                       Base::Vector3f &rclRes, unsigned long &rulFacet) const
+{
+    assert(rclBVH.CountFacets() == _rclMesh.CountFacets());
+    return rclBVH.NearestFacetOnRay(rclPt, rclDir, rclRes, rulFacet);
+}
+
 bool MeshAlgorithm::NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const std::vector<unsigned long> &raulFacets,
                                        Base::Vector3f &rclRes, unsigned long &rulFacet) const
 {
@@ -636,8 +644,8 @@ bool MeshAlgorithm::FillupHole(const std::vector<unsigned long>& boundary,
     unsigned long refPoint0 = *(boundary.begin());
     unsigned long refPoint1 = *(boundary.begin()+1);
     if (pP2FStructure) {
-        const std::set<unsigned long>& ring1 = (*pP2FStructure)[refPoint0];
-        const std::set<unsigned long>& ring2 = (*pP2FStructure)[refPoint1];
+        MeshIndexRange ring1 = (*pP2FStructure)[refPoint0];
+        MeshIndexRange ring2 = (*pP2FStructure)[refPoint1];
         std::vector<unsigned long> f_int;
         std::set_intersection(ring1.begin(), ring1.end(), ring2.begin(), ring2.end(),
             std::back_insert_iterator<std::vector<unsigned long> >(f_int));
@@ -1690,26 +1698,19 @@ float MeshAlgorithm::CalculateMinimumGridLength(float fLength, const Base::Bound
 
 void MeshRefPointToFacets::Rebuild (void)
 {
-    _map.clear();
+    _map.Clear();
 
-    const MeshPointArray& rPoints = _rclMesh.GetPoints();
-    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
-    _map.resize(rPoints.size());
-
-    MeshFacetArray::_TConstIterator pFBegin = rFacets.begin();
-    for (MeshFacetArray::_TConstIterator pFIter = rFacets.begin(); pFIter != rFacets.end(); ++pFIter) {
-        _map[pFIter->_aulPoints[0]].insert(pFIter - pFBegin);
-        _map[pFIter->_aulPoints[1]].insert(pFIter - pFBegin);
-        _map[pFIter->_aulPoints[2]].insert(pFIter - pFBegin);
-    }
+    MeshAdjacency adjacency;
+    adjacency.SetPointToFacets(_rclMesh.GetFacets(), _rclMesh.CountPoints());
+    _map.Assign(adjacency);
 }
 
 Base::Vector3f MeshRefPointToFacets::GetNormal(unsigned long pos) const
 {
-    const std::set<unsigned long>& n = _map[pos];
+    MeshIndexRange n = _map[pos];
     Base::Vector3f normal;
     MeshGeomFacet f;
-    for (std::set<unsigned long>::const_iterator it = n.begin(); it != n.end(); ++it) {
+    for (MeshIndexRange::const_iterator it = n.begin(); it != n.end(); ++it) {
         f = _rclMesh.GetFacet(*it);
         normal += f.Area() * f.GetNormal();
     }
@@ -1727,8 +1728,8 @@ std::set<unsigned long> MeshRefPointToFacets::NeighbourPoints(const std::vector<
     for (int i=0; i < level; i++) {
         std::set<unsigned long> cur;
         for (std::set<unsigned long>::iterator it = lp.begin(); it != lp.end(); ++it) {
-            const std::set<unsigned long>& ft = (*this)[*it];
-            for (std::set<unsigned long>::const_iterator jt = ft.begin(); jt != ft.end(); ++jt) {
+            MeshIndexRange ft = (*this)[*it];
+            for (MeshIndexRange::const_iterator jt = ft.begin(); jt != ft.end(); ++jt) {
                 for (int j = 0; j < 3; j++) {
                     unsigned long index = f_it[*jt]._aulPoints[j];
                     if (cp.find(index) == cp.end() && nb.find(index) == nb.end()) {
@@ -1768,9 +1769,9 @@ void MeshRefPointToFacets::SearchNeighbours(const MeshFacetArray& rFacets, unsig
     visited.insert(index);
     collect.Append(_rclMesh, index);
     for (int i = 0; i < 3; i++) {
-        const std::set<unsigned long> &f = (*this)[face._aulPoints[i]];
+        MeshIndexRange f = (*this)[face._aulPoints[i]];
 
-        for (std::set<unsigned long>::const_iterator j = f.begin(); j != f.end(); ++j) {
+        for (MeshIndexRange::const_iterator j = f.begin(); j != f.end(); ++j) {
             SearchNeighbours(rFacets, *j, rclCenter, fMaxDist2, visited, collect);
         }
     }
@@ -1782,7 +1783,7 @@ MeshRefPointToFacets::GetFacet (unsigned long index) const
     return _rclMesh.GetFacets().begin() + index;
 }
 
-const std::set<unsigned long>&
+MeshIndexRange
 MeshRefPointToFacets::operator[] (unsigned long pos) const
 {
     return _map[pos];
@@ -1790,12 +1791,12 @@ MeshRefPointToFacets::operator[] (unsigned long pos) const
 
 void MeshRefPointToFacets::AddNeighbour(unsigned long pos, unsigned long facet)
 {
-    _map[pos].insert(facet);
+    _map.Add(pos, facet);
 }
 
 void MeshRefPointToFacets::RemoveNeighbour(unsigned long pos, unsigned long facet)
 {
-    _map[pos].erase(facet);
+    _map.Remove(pos, facet);
 }
 
 void MeshRefPointToFacets::RemoveFacet(unsigned long facetIndex)
@@ -1803,32 +1804,24 @@ void MeshRefPointToFacets::RemoveFacet(unsigned long facetIndex)
     unsigned long p0, p1, p2;
     _rclMesh.GetFacetPoints(facetIndex, p0, p1, p2);
 
-    _map[p0].erase(facetIndex);
-    _map[p1].erase(facetIndex);
-    _map[p2].erase(facetIndex);
+    _map.Remove(p0, facetIndex);
+    _map.Remove(p1, facetIndex);
+    _map.Remove(p2, facetIndex);
 }
 
 //----------------------------------------------------------------------------
 
 void MeshRefFacetToFacets::Rebuild (void)
 {
-    _map.clear();
+    _map.Clear();
 
     const MeshFacetArray& rFacets = _rclMesh.GetFacets();
-    _map.resize(rFacets.size());
-
-    MeshRefPointToFacets  vertexFace(_rclMesh);
-    MeshFacetArray::_TConstIterator pFBegin = rFacets.begin();
-    for (MeshFacetArray::_TConstIterator pFIter = pFBegin; pFIter != rFacets.end(); ++pFIter) {
-        for (int i = 0; i < 3; i++) {
-            const std::set<unsigned long>& faces = vertexFace[pFIter->_aulPoints[i]];
-            for (std::set<unsigned long>::const_iterator it = faces.begin(); it != faces.end(); ++it)
-                _map[pFIter - pFBegin].insert(*it);
-        }
-    }
+    MeshAdjacency vertexFace;
+    vertexFace.SetPointToFacets(rFacets, _rclMesh.CountPoints());
+    _map.SetFacetToFacets(rFacets, vertexFace);
 }
 
-const std::set<unsigned long>&
+MeshIndexRange
 MeshRefFacetToFacets::operator[] (unsigned long pos) const
 {
     return _map[pos];
@@ -1838,24 +1831,11 @@ MeshRefFacetToFacets::operator[] (unsigned long pos) const
 
 void MeshRefPointToPoints::Rebuild (void)
 {
-    _map.clear();
+    _map.Clear();
 
-    const MeshPointArray& rPoints = _rclMesh.GetPoints();
-    _map.resize(rPoints.size());
-
-    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
-    for (MeshFacetArray::_TConstIterator pFIter = rFacets.begin(); pFIter != rFacets.end(); ++pFIter) {
-        unsigned long ulP0 = pFIter->_aulPoints[0];
-        unsigned long ulP1 = pFIter->_aulPoints[1];
-        unsigned long ulP2 = pFIter->_aulPoints[2];
-
-        _map[ulP0].insert(ulP1);
-        _map[ulP0].insert(ulP2);
-        _map[ulP1].insert(ulP0);
-        _map[ulP1].insert(ulP2);
-        _map[ulP2].insert(ulP0);
-        _map[ulP2].insert(ulP1);
-    }
+    MeshAdjacency adjacency;
+    adjacency.SetPointToPoints(_rclMesh.GetFacets(), _rclMesh.CountPoints());
+    _map.Assign(adjacency);
 }
 
 Base::Vector3f MeshRefPointToPoints::GetNormal(unsigned long pos) const
@@ -1864,8 +1844,8 @@ Base::Vector3f MeshRefPointToPoints::GetNormal(unsigned long pos) const
     MeshCore::PlaneFit pf;
     pf.AddPoint(rPoints[pos]);
     MeshCore::MeshPoint center = rPoints[pos];
-    const std::set<unsigned long>& cv = _map[pos];
-    for (std::set<unsigned long>::const_iterator cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
+    MeshIndexRange cv = _map[pos];
+    for (MeshIndexRange::const_iterator cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
         pf.AddPoint(rPoints[*cv_it]);
         center += rPoints[*cv_it];
     }
@@ -1881,15 +1861,15 @@ float MeshRefPointToPoints::GetAverageEdgeLength(unsigned long index) const
 {
     const MeshPointArray& rPoints = _rclMesh.GetPoints();
     float len=0.0f;
-    const std::set<unsigned long>& n = (*this)[index];
+    MeshIndexRange n = (*this)[index];
     const Base::Vector3f& p = rPoints[index];
-    for (std::set<unsigned long>::const_iterator it = n.begin(); it != n.end(); ++it) {
+    for (MeshIndexRange::const_iterator it = n.begin(); it != n.end(); ++it) {
         len += Base::Distance(p, rPoints[*it]);
     }
     return (len/n.size());
 }
 
-const std::set<unsigned long>&
+MeshIndexRange
 MeshRefPointToPoints::operator[] (unsigned long pos) const
 {
     return _map[pos];
@@ -1897,12 +1877,12 @@ MeshRefPointToPoints::operator[] (unsigned long pos) const
 
 void MeshRefPointToPoints::AddNeighbour(unsigned long pos, unsigned long facet)
 {
-    _map[pos].insert(facet);
+    _map.Add(pos, facet);
 }
 
 void MeshRefPointToPoints::RemoveNeighbour(unsigned long pos, unsigned long facet)
 {
-    _map[pos].erase(facet);
+    _map.Remove(pos, facet);
 }
 
 //----------------------------------------------------------------------------
@@ -30,6 +30,7 @@
 
 #include "MeshKernel.h"
 #include "Elements.h"
+#include "Adjacency.h"
 #include <Base/Vector3D.h>
 
 // forward declarations
@@ -45,6 +46,7 @@ class MeshGeomFacet;
 class MeshGeomEdge;
 class MeshKernel;
 class MeshFacetGrid;
+class MeshFacetBVH;
 class MeshFacetArray;
 class MeshRefPointToFacets;
 class AbstractPolygonTriangulator;
@@ -100,6 +102,16 @@ public:
    */
   bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, float fMaxSearchArea,
                           const MeshFacetGrid &rclGrid, Base::Vector3f &rclRes, unsigned long &rulFacet) const;
+  /**
+   * Searches for the nearest facet hit by the ray defined by (\a rclPt, \a rclDir).
+   * The point \a rclRes holds the intersection point with the ray and the
+   * nearest facet with index \a rulFacet.
+   * \note This method uses a bounding volume hierarchy which must have been built
+   * for the attached mesh. Unlike the grid it doesn't depend on a uniform
+   * distribution of the facets.
+   */
+  bool NearestFacetOnRay (const Base::Vector3f &rclPt, const Base::Vector3f &rclDir, const MeshFacetBVH &rclBVH,
+                          Base::Vector3f &rclRes, unsigned long &rulFacet) const;
   /**
    * Searches for the first facet of the grid element (\a rclGrid) in that the point \a rclPt lies into which is a distance not
    * higher than \a fMaxDistance. Of no such facet is found \a rulFacet is undefined and false is returned, otherwise true.
@@ -356,7 +368,7 @@ private:
 
 /**
  * The MeshRefPointToFacets builds up a structure to have access to all facets indexing
- * a point.
+ * a point. The facet indices of a point are returned sorted in ascending order.
  * \note If the underlying mesh kernel gets changed this structure becomes invalid and must
  * be rebuilt.
  */
@@ -372,7 +384,7 @@ public:
 
     /// Rebuilds up data structure
     void Rebuild (void);
-    const std::set<unsigned long>& operator[] (unsigned long) const;
+    MeshIndexRange operator[] (unsigned long) const;
     MeshFacetArray::_TConstIterator GetFacet (unsigned long) const;
     std::set<unsigned long> NeighbourPoints(const std::vector<unsigned long>& , int level) const;
     void Neighbours (unsigned long ulFacetInd, float fMaxDist, MeshCollector& collect) const;
@@ -387,7 +399,7 @@ protected:
 
 protected:
     const MeshKernel  &_rclMesh; /**< The mesh kernel. */
-    std::vector<std::set<unsigned long> > _map;
+    MeshDynamicAdjacency _map;
 };
 
 /**
@@ -408,13 +420,13 @@ public:
     /// Rebuilds up data structure
     void Rebuild (void);
 
-    /// Returns a set of facets sharing one or more points with the facet with
+    /// Returns the sorted facets sharing one or more points with the facet with
     /// index \a ulFacetIndex.
-    const std::set<unsigned long>& operator[] (unsigned long) const;
+    MeshIndexRange operator[] (unsigned long) const;
 
 protected:
     const MeshKernel  &_rclMesh; /**< The mesh kernel. */
-    std::vector<std::set<unsigned long> > _map;
+    MeshAdjacency _map;
 };
 
 /**
@@ -435,7 +447,7 @@ public:
 
     /// Rebuilds up data structure
     void Rebuild (void);
-    const std::set<unsigned long>& operator[] (unsigned long) const;
+    MeshIndexRange operator[] (unsigned long) const;
     Base::Vector3f GetNormal(unsigned long) const;
     float GetAverageEdgeLength(unsigned long) const;
     void AddNeighbour(unsigned long, unsigned long);
@@ -443,7 +455,7 @@ public:
 
 protected:
     const MeshKernel  &_rclMesh; /**< The mesh kernel. */
-    std::vector<std::set<unsigned long> > _map;
+    MeshDynamicAdjacency _map;
 };
 
 /**
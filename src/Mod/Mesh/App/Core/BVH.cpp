@@ -0,0 +1,527 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
+# include <climits>
+# include <cmath>
+# include <vector>
+#endif
+
+#include "BVH.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+namespace {
+// Maximum number of facets in a leaf, all of them are stored in one packet
+const int PacketSize = 4;
+// Number of bins to evaluate the surface area heuristic
+const int NumBins = 16;
+
+float SurfaceArea(const Base::BoundBox3f& box)
+{
+    if (!box.IsValid())
+        return 0.0f;
+    float dx = box.LengthX();
+    float dy = box.LengthY();
+    float dz = box.LengthZ();
+    return 2.0f * (dx * dy + dy * dz + dz * dx);
+}
+
+float Coord(const Base::Vector3f& v, int axis)
+{
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+struct BuildItem
+{
+    Base::BoundBox3f box;
+    Base::Vector3f center;
+    unsigned long facet;
+};
+
+struct BuildTask
+{
+    std::size_t begin, end;
+    std::size_t parent;
+};
+
+Base::Vector3f ClosestPointOnSegment(const Base::Vector3f& p, const Base::Vector3f& a, const Base::Vector3f& b)
+{
+    Base::Vector3f ab = b - a;
+    float len = ab * ab;
+    if (len <= 0.0f)
+        return a;
+    float t = std::max<float>(0.0f, std::min<float>(1.0f, ((p - a) * ab) / len));
+    return a + t * ab;
+}
+
+// Computes the closest point of the triangle (a, a + ab, a + ac) to the point p
+// (see Christer Ericson, Real-Time Collision Detection)
+Base::Vector3f ClosestPointOnTriangle(const Base::Vector3f& p, const Base::Vector3f& a,
+                                      const Base::Vector3f& ab, const Base::Vector3f& ac)
+{
+    Base::Vector3f ap = p - a;
+    float d1 = ab * ap;
+    float d2 = ac * ap;
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    Base::Vector3f bp = ap - ab;
+    float d3 = ab * bp;
+    float d4 = ac * bp;
+    if (d3 >= 0.0f && d4 <= d3)
+        return a + ab;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + (d1 / (d1 - d3)) * ab;
+
+    Base::Vector3f cp = ap - ac;
+    float d5 = ab * cp;
+    float d6 = ac * cp;
+    if (d6 >= 0.0f && d5 <= d6)
+        return a + ac;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + (d2 / (d2 - d6)) * ac;
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return a + ab + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (ac - ab);
+
+    float sum = va + vb + vc;
+    if (sum <= 0.0f) {
+        // degenerated facet
+        Base::Vector3f b = a + ab, c = a + ac;
+        Base::Vector3f p1 = ClosestPointOnSegment(p, a, b);
+        Base::Vector3f p2 = ClosestPointOnSegment(p, b, c);
+        Base::Vector3f p3 = ClosestPointOnSegment(p, c, a);
+        float l1 = Base::DistanceP2(p, p1);
+        float l2 = Base::DistanceP2(p, p2);
+        float l3 = Base::DistanceP2(p, p3);
+        if (l1 <= l2 && l1 <= l3)
+            return p1;
+        return l2 <= l3 ? p2 : p3;
+    }
+
+    float v = vb / sum;
+    float w = vc / sum;
+    return a + v * ab + w * ac;
+}
+}
+
+class MeshFacetBVH::Private
+{
+public:
+    struct Node
+    {
+        float min[3];
+        float max[3];
+        // index of the packet for a leaf, index of the second child for an inner node
+        // (the first child directly follows its parent)
+        unsigned long offset;
+        int count; // number of facets of a leaf, zero for inner nodes
+        int axis;  // split axis of an inner node
+    };
+
+    // The facets of a leaf as structure of arrays. Unused slots repeat the first facet.
+    struct Packet
+    {
+        float v0[3][PacketSize];
+        float e1[3][PacketSize];
+        float e2[3][PacketSize];
+        unsigned long facet[PacketSize];
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Packet> packets;
+    unsigned long countFacets;
+
+    Private() : countFacets(0)
+    {
+    }
+
+    static float BoxDistance2(const Node& node, const Base::Vector3f& p)
+    {
+        float d = 0.0f;
+        float c[3] = {p.x, p.y, p.z};
+        for (int i = 0; i < 3; i++) {
+            float v = 0.0f;
+            if (c[i] < node.min[i])
+                v = node.min[i] - c[i];
+            else if (c[i] > node.max[i])
+                v = c[i] - node.max[i];
+            d += v * v;
+        }
+        return d;
+    }
+
+    static bool IntersectBox(const Node& node, const float org[3], const float inv[3], float tmax)
+    {
+        float t0 = 0.0f, t1 = tmax;
+        for (int i = 0; i < 3; i++) {
+            float tn = (node.min[i] - org[i]) * inv[i];
+            float tf = (node.max[i] - org[i]) * inv[i];
+            if (tn > tf)
+                std::swap(tn, tf);
+            t0 = std::max<float>(t0, tn);
+            t1 = std::min<float>(t1, tf);
+            if (t0 > t1)
+                return false;
+        }
+        return true;
+    }
+};
+
+MeshFacetBVH::MeshFacetBVH(const MeshKernel& rclMesh)
+  : d(new Private)
+{
+    Build(rclMesh, 0);
+}
+
+MeshFacetBVH::MeshFacetBVH(const MeshKernel& rclMesh, const Base::Matrix4D& rclMat)
+  : d(new Private)
+{
+    Build(rclMesh, &rclMat);
+}
+
+MeshFacetBVH::~MeshFacetBVH()
+{
+    delete d;
+}
+
+void MeshFacetBVH::Build(const MeshKernel& rclMesh, const Base::Matrix4D* pclMat)
+{
+    const MeshPointArray& rPoints = rclMesh.GetPoints();
+    const MeshFacetArray& rFacets = rclMesh.GetFacets();
+    d->countFacets = rFacets.size();
+    if (rFacets.empty())
+        return;
+
+    std::vector<Base::Vector3f> points(rPoints.begin(), rPoints.end());
+    if (pclMat) {
+        for (std::vector<Base::Vector3f>::iterator it = points.begin(); it != points.end(); ++it)
+            *it = (*pclMat) * (*it);
+    }
+
+    std::vector<BuildItem> items(rFacets.size());
+    for (std::size_t i = 0; i < rFacets.size(); i++) {
+        BuildItem& item = items[i];
+        for (int j = 0; j < 3; j++)
+            item.box.Add(points[rFacets[i]._aulPoints[j]]);
+        item.center = 0.5f * (Base::Vector3f(item.box.MinX, item.box.MinY, item.box.MinZ) +
+                              Base::Vector3f(item.box.MaxX, item.box.MaxY, item.box.MaxZ));
+        item.facet = i;
+    }
+
+    d->nodes.reserve(2 * (items.size() / PacketSize + 1));
+    d->packets.reserve(items.size() / PacketSize + 1);
+
+    // The tree is built without recursion in depth-first order so that the first
+    // child of a node always directly follows its parent
+    std::vector<BuildTask> tasks;
+    BuildTask root = {0, items.size(), ULONG_MAX};
+    tasks.push_back(root);
+    while (!tasks.empty()) {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        std::size_t index = d->nodes.size();
+        if (task.parent != ULONG_MAX)
+            d->nodes[task.parent].offset = index;
+        d->nodes.push_back(Private::Node());
+        Private::Node& node = d->nodes.back();
+
+        Base::BoundBox3f box, centers;
+        for (std::size_t i = task.begin; i < task.end; i++) {
+            box.Add(items[i].box);
+            centers.Add(items[i].center);
+        }
+        node.min[0] = box.MinX; node.min[1] = box.MinY; node.min[2] = box.MinZ;
+        node.max[0] = box.MaxX; node.max[1] = box.MaxY; node.max[2] = box.MaxZ;
+
+        std::size_t count = task.end - task.begin;
+        if (count <= static_cast<std::size_t>(PacketSize)) {
+            node.offset = d->packets.size();
+            node.count = static_cast<int>(count);
+            node.axis = 0;
+
+            Private::Packet packet;
+            for (int k = 0; k < PacketSize; k++) {
+                std::size_t i = task.begin + (static_cast<std::size_t>(k) < count ? k : 0);
+                const MeshFacet& facet = rFacets[items[i].facet];
+                const Base::Vector3f& p0 = points[facet._aulPoints[0]];
+                Base::Vector3f e1 = points[facet._aulPoints[1]] - p0;
+                Base::Vector3f e2 = points[facet._aulPoints[2]] - p0;
+                packet.v0[0][k] = p0.x; packet.v0[1][k] = p0.y; packet.v0[2][k] = p0.z;
+                packet.e1[0][k] = e1.x; packet.e1[1][k] = e1.y; packet.e1[2][k] = e1.z;
+                packet.e2[0][k] = e2.x; packet.e2[1][k] = e2.y; packet.e2[2][k] = e2.z;
+                packet.facet[k] = items[i].facet;
+            }
+            d->packets.push_back(packet);
+            continue;
+        }
+
+        // find the split with the lowest cost using the surface area heuristic
+        int bestAxis = -1;
+        int bestBin = 0;
+        float bestCost = FLT_MAX;
+        float cmin[3] = {centers.MinX, centers.MinY, centers.MinZ};
+        float cext[3] = {centers.LengthX(), centers.LengthY(), centers.LengthZ()};
+        for (int axis = 0; axis < 3; axis++) {
+            if (cext[axis] <= 0.0f)
+                continue;
+            Base::BoundBox3f binBoxes[NumBins];
+            std::size_t binCounts[NumBins] = {0};
+            float scale = NumBins / cext[axis];
+            for (std::size_t i = task.begin; i < task.end; i++) {
+                int bin = std::min<int>(NumBins - 1, static_cast<int>((Coord(items[i].center, axis) - cmin[axis]) * scale));
+                binBoxes[bin].Add(items[i].box);
+                binCounts[bin]++;
+            }
+
+            float rightArea[NumBins];
+            std::size_t rightCount[NumBins];
+            Base::BoundBox3f right;
+            std::size_t countRight = 0;
+            for (int bin = NumBins - 1; bin > 0; bin--) {
+                right.Add(binBoxes[bin]);
+                countRight += binCounts[bin];
+                rightArea[bin] = SurfaceArea(right);
+                rightCount[bin] = countRight;
+            }
+
+            Base::BoundBox3f left;
+            std::size_t countLeft = 0;
+            for (int bin = 0; bin < NumBins - 1; bin++) {
+                left.Add(binBoxes[bin]);
+                countLeft += binCounts[bin];
+                if (countLeft == 0 || rightCount[bin + 1] == 0)
+                    continue;
+                float cost = countLeft * SurfaceArea(left) + rightCount[bin + 1] * rightArea[bin + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = bin;
+                }
+            }
+        }
+
+        std::size_t mid = task.begin + count / 2;
+        if (bestAxis >= 0) {
+            float scale = NumBins / cext[bestAxis];
+            float base = cmin[bestAxis];
+            int axis = bestAxis;
+            int split = bestBin;
+            std::vector<BuildItem>::iterator it = std::partition(items.begin() + task.begin, items.begin() + task.end,
+                [axis, split, scale, base](const BuildItem& item) {
+                    int bin = std::min<int>(NumBins - 1, static_cast<int>((Coord(item.center, axis) - base) * scale));
+                    return bin <= split;
+                });
+            std::size_t pos = it - items.begin();
+            if (pos > task.begin && pos < task.end)
+                mid = pos;
+            node.axis = bestAxis;
+        }
+        else {
+            // all centers coincide, so simply split in the middle
+            node.axis = 0;
+        }
+
+        node.count = 0;
+        node.offset = 0;
+
+        // push the second child first so that the first child is processed next
+        BuildTask second = {mid, task.end, index};
+        BuildTask first = {task.begin, mid, ULONG_MAX};
+        tasks.push_back(second);
+        tasks.push_back(first);
+    }
+}
+
+unsigned long MeshFacetBVH::CountFacets() const
+{
+    return d->countFacets;
+}
+
+Base::BoundBox3f MeshFacetBVH::GetBoundBox() const
+{
+    Base::BoundBox3f box;
+    if (!d->nodes.empty()) {
+        const Private::Node& node = d->nodes.front();
+        box.Add(Base::Vector3f(node.min[0], node.min[1], node.min[2]));
+        box.Add(Base::Vector3f(node.max[0], node.max[1], node.max[2]));
+    }
+    return box;
+}
+
+bool MeshFacetBVH::NearestFacetOnRay(const Base::Vector3f& rclPt, const Base::Vector3f& rclDir,
+                                     Base::Vector3f& rclRes, unsigned long& rulFacet) const
+{
+    if (d->nodes.empty())
+        return false;
+
+    const float eps = 1e-06f;
+    float org[3] = {rclPt.x, rclPt.y, rclPt.z};
+    float dir[3] = {rclDir.x, rclDir.y, rclDir.z};
+    float inv[3];
+    for (int i = 0; i < 3; i++) {
+        // avoid 0 * inf when the ray starts on a box plane
+        float di = std::fabs(dir[i]) < 1e-30f ? 1e-30f : dir[i];
+        inv[i] = 1.0f / di;
+    }
+    float dd = rclDir * rclDir;
+
+    float tBest = FLT_MAX;
+    unsigned long ulBest = ULONG_MAX;
+
+    std::vector<unsigned long> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Private::Node& node = d->nodes[stack.back()];
+        std::size_t index = stack.back();
+        stack.pop_back();
+        if (!Private::IntersectBox(node, org, inv, tBest))
+            continue;
+
+        if (node.count > 0) {
+            // Moeller-Trumbore test of all facets of the packet
+            const Private::Packet& packet = d->packets[node.offset];
+            float t[PacketSize];
+            bool hit[PacketSize];
+            for (int k = 0; k < PacketSize; k++) {
+                float e1x = packet.e1[0][k], e1y = packet.e1[1][k], e1z = packet.e1[2][k];
+                float e2x = packet.e2[0][k], e2y = packet.e2[1][k], e2z = packet.e2[2][k];
+                float px = dir[1] * e2z - dir[2] * e2y;
+                float py = dir[2] * e2x - dir[0] * e2z;
+                float pz = dir[0] * e2y - dir[1] * e2x;
+                float det = e1x * px + e1y * py + e1z * pz;
+                // the normal is e1 x e2, its squared length is needed to reject
+                // rays nearly parallel to the facet like MeshGeomFacet::Foraminate()
+                float nx = e1y * e2z - e1z * e2y;
+                float ny = e1z * e2x - e1x * e2z;
+                float nz = e1x * e2y - e1y * e2x;
+                float nn = nx * nx + ny * ny + nz * nz;
+                float inv_det = 1.0f / (det != 0.0f ? det : 1.0f);
+                float sx = org[0] - packet.v0[0][k];
+                float sy = org[1] - packet.v0[1][k];
+                float sz = org[2] - packet.v0[2][k];
+                float u = (sx * px + sy * py + sz * pz) * inv_det;
+                float qx = sy * e1z - sz * e1y;
+                float qy = sz * e1x - sx * e1z;
+                float qz = sx * e1y - sy * e1x;
+                float v = (dir[0] * qx + dir[1] * qy + dir[2] * qz) * inv_det;
+                t[k] = (e2x * qx + e2y * qy + e2z * qz) * inv_det;
+                hit[k] = (det * det > eps * dd * nn) && (u >= 0.0f) && (v >= 0.0f) &&
+                         (u + v <= 1.0f) && (t[k] >= 0.0f);
+            }
+            for (int k = 0; k < node.count; k++) {
+                if (hit[k] && t[k] < tBest) {
+                    tBest = t[k];
+                    ulBest = packet.facet[k];
+                }
+            }
+        }
+        else {
+            // visit the nearer child first
+            std::size_t first = index + 1;
+            std::size_t second = node.offset;
+            if (dir[node.axis] < 0.0f)
+                std::swap(first, second);
+            stack.push_back(second);
+            stack.push_back(first);
+        }
+    }
+
+    if (ulBest == ULONG_MAX)
+        return false;
+    rclRes = rclPt + tBest * rclDir;
+    rulFacet = ulBest;
+    return true;
+}
+
+bool MeshFacetBVH::NearestFacetToPoint(const Base::Vector3f& rclPt, Base::Vector3f& rclRes,
+                                       unsigned long& rulFacet) const
+{
+    return NearestFacetToPoint(rclPt, FLT_MAX, rclRes, rulFacet);
+}
+
+bool MeshFacetBVH::NearestFacetToPoint(const Base::Vector3f& rclPt, float fMaxDist,
+                                       Base::Vector3f& rclRes, unsigned long& rulFacet) const
+{
+    if (d->nodes.empty())
+        return false;
+
+    float fBest = fMaxDist < FLT_MAX ? fMaxDist * fMaxDist : FLT_MAX;
+    unsigned long ulBest = ULONG_MAX;
+
+    std::vector<unsigned long> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        std::size_t index = stack.back();
+        stack.pop_back();
+        const Private::Node& node = d->nodes[index];
+        if (Private::BoxDistance2(node, rclPt) > fBest)
+            continue;
+
+        if (node.count > 0) {
+            const Private::Packet& packet = d->packets[node.offset];
+            for (int k = 0; k < node.count; k++) {
+                Base::Vector3f a(packet.v0[0][k], packet.v0[1][k], packet.v0[2][k]);
+                Base::Vector3f ab(packet.e1[0][k], packet.e1[1][k], packet.e1[2][k]);
+                Base::Vector3f ac(packet.e2[0][k], packet.e2[1][k], packet.e2[2][k]);
+                Base::Vector3f p = ClosestPointOnTriangle(rclPt, a, ab, ac);
+                float dist = Base::DistanceP2(rclPt, p);
+                if (dist <= fBest) {
+                    fBest = dist;
+                    ulBest = packet.facet[k];
+                    rclRes = p;
+                }
+            }
+        }
+        else {
+            // visit the nearer child first
+            std::size_t first = index + 1;
+            std::size_t second = node.offset;
+            float d1 = Private::BoxDistance2(d->nodes[first], rclPt);
+            float d2 = Private::BoxDistance2(d->nodes[second], rclPt);
+            if (d2 < d1)
+                std::swap(first, second);
+            stack.push_back(second);
+            stack.push_back(first);
+        }
+    }
+
+    if (ulBest == ULONG_MAX)
+        return false;
+    rulFacet = ulBest;
+    return true;
+}
@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include "Elements.h"
+#include <Base/BoundBox.h>
+#include <Base/Matrix.h>
+
+namespace MeshCore
+{
+
+class MeshKernel;
+
+/**
+ * The MeshFacetBVH class is a bounding volume hierarchy over the facets of a
+ * mesh. The tree is built with the surface area heuristic and therefore also
+ * works well for meshes with a very non-uniform distribution of the facets
+ * where a MeshFacetGrid either gets too big or has too many facets per cell.
+ *
+ * The nodes are stored in a flat array and the facets of a leaf are kept
+ * together in a structure-of-arrays block so that they can be tested in
+ * one loop the compiler can vectorize.
+ *
+ * Once built the hierarchy is not changed, so it can be queried from several
+ * threads at the same time. It must be rebuilt if the mesh gets modified.
+ */
+class MeshExport MeshFacetBVH
+{
+public:
+    /// Builds the hierarchy for the facets of the mesh.
+    MeshFacetBVH(const MeshKernel&);
+    /// Builds the hierarchy for the facets of the mesh transformed by \a rclMat.
+    MeshFacetBVH(const MeshKernel&, const Base::Matrix4D& rclMat);
+    ~MeshFacetBVH();
+
+    /// Returns the number of facets of the hierarchy.
+    unsigned long CountFacets() const;
+    /// Returns the bounding box of all facets.
+    Base::BoundBox3f GetBoundBox() const;
+
+    /**
+     * Searches for the nearest facet hit by the ray starting at \a rclPt in
+     * direction \a rclDir. Unlike MeshGeomFacet::Foraminate() only intersection
+     * points in direction of the ray are taken into account.
+     * The point \a rclRes holds the intersection point and \a rulFacet the index
+     * of the facet. If no facet is hit false is returned.
+     */
+    bool NearestFacetOnRay(const Base::Vector3f& rclPt, const Base::Vector3f& rclDir,
+                           Base::Vector3f& rclRes, unsigned long& rulFacet) const;
+    /**
+     * Searches for the facet with the shortest distance to \a rclPt.
+     * The point \a rclRes holds the nearest point on the facet and \a rulFacet
+     * the index of the facet. If the mesh is empty false is returned.
+     */
+    bool NearestFacetToPoint(const Base::Vector3f& rclPt, Base::Vector3f& rclRes,
+                             unsigned long& rulFacet) const;
+    /**
+     * Does basically the same as the method above but only considers facets
+     * with a distance not higher than \a fMaxDist.
+     */
+    bool NearestFacetToPoint(const Base::Vector3f& rclPt, float fMaxDist,
+                             Base::Vector3f& rclRes, unsigned long& rulFacet) const;
+
+private:
+    void Build(const MeshKernel&, const Base::Matrix4D*);
+
+private:
+    class Private;
+    Private* d;
+
+    MeshFacetBVH(const MeshFacetBVH&);
+    void operator= (const MeshFacetBVH&);
+};
+
+} // namespace MeshCore
+
+
+#endif  // MESH_BVH_H
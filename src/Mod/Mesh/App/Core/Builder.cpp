@@ -40,18 +40,16 @@ using namespace MeshCore;
 
 MeshBuilder::MeshBuilder (MeshKernel& kernel) : _meshKernel(kernel), _seq(0), _ptIdx(0)
 {
-    _fSaveTolerance = MeshDefinitions::_fMinPointDistanceD1;
 }
 
 MeshBuilder::~MeshBuilder (void)
 {
-    MeshDefinitions::_fMinPointDistanceD1 = _fSaveTolerance;
     delete this->_seq;
 }
 
 void MeshBuilder::SetTolerance(float fTol)
 {
-    MeshDefinitions::_fMinPointDistanceD1 = fTol;
+    _points = std::set<MeshPoint, MeshPoint_Less>(MeshPoint_Less(fTol));
 }
 
 void MeshBuilder::Initialize (unsigned long ctFacets, bool deletion)
@@ -133,7 +131,7 @@ void MeshBuilder::AddFacet (Base::Vector3f* facetPoints, unsigned char flag, uns
     for (i = 0; i < 3; i++)
     {
         MeshPoint pt(facetPoints[i]);
-        std::set<MeshPoint>::iterator p = _points.find(pt);
+        std::set<MeshPoint, MeshPoint_Less>::iterator p = _points.find(pt);
         if (p == _points.end())
         {
             mf._aulPoints[i] = _ptIdx;
@@ -320,6 +318,22 @@ void MeshFastBuilder::AddFacet (const MeshGeomFacet& facetPoints)
     }
 }
 
+void MeshFastBuilder::Resize (unsigned long ctFacets)
+{
+    p->verts.resize(ctFacets * 3);
+}
+
+void MeshFastBuilder::SetFacet (unsigned long index, const Base::Vector3f* facetPoints)
+{
+    // the vector isn't shared so that data() never detaches
+    Private::Vertex* v = p->verts.data() + 3 * index;
+    for (int i=0; i<3; i++) {
+        v[i].x = facetPoints[i].x;
+        v[i].y = facetPoints[i].y;
+        v[i].z = facetPoints[i].z;
+    }
+}
+
 void MeshFastBuilder::Finish ()
 {
     QVector<Private::Vertex>& verts = p->verts;
@@ -99,11 +99,11 @@ private:
     //@}
 
     MeshKernel& _meshKernel;
-    std::set<MeshPoint> _points;
+    std::set<MeshPoint, MeshPoint_Less> _points;
     Base::SequencerLauncher* _seq;
 
     // keep an array of iterators pointing to the vertex inside the set to save memory
-    typedef std::pair<std::set<MeshPoint>::iterator, bool> MeshPointIterator;
+    typedef std::pair<std::set<MeshPoint, MeshPoint_Less>::iterator, bool> MeshPointIterator;
     std::vector<MeshPointIterator> _pointsIterator;
     unsigned long _ptIdx;
 
@@ -117,6 +117,7 @@ public:
 
     /**
      * Set the tolerance for the comparison of points. Normally you don't need to set the tolerance.
+     * It only affects this builder and must be set before Initialize() is called.
      */
     void SetTolerance(float);
 
@@ -159,9 +160,6 @@ public:
     void Finish (bool freeMemory=false);
 
     friend class MeshKernel;
-
-private:
-    float _fSaveTolerance;
 };
 
 /**
@@ -200,6 +198,14 @@ public:
     /** Add new facet
      */
     void AddFacet (const MeshGeomFacet& facetPoints);
+    /** Allocates space for \a ctFacets facets whose points are set with SetFacet() afterwards.
+     * This is an alternative to Initialize() and AddFacet().
+     */
+    void Resize (unsigned long ctFacets);
+    /** Sets the points of the facet with the given index. Different facets can be set
+     * by several threads at the same time.
+     */
+    void SetFacet (unsigned long index, const Base::Vector3f* facetPoints);
 
     /** Finishes building up the mesh structure. Must be done after adding facets.
      */
@@ -0,0 +1,787 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <cstring>
+# include <limits>
+#endif
+
+#include <QFile>
+#include <QFuture>
+#include <QList>
+#include <QTemporaryFile>
+#include <QThread>
+#include <QtConcurrentRun>
+
+#include "ChunkedKernel.h"
+#include "Curvature.h"
+#include "Decimation.h"
+#include "MeshKernel.h"
+
+using namespace MeshCore;
+
+namespace {
+
+/*
+ * A chunk file starts with a ChunkHeader followed by a ChunkEntry for each
+ * chunk. Then come the points (three floats each) and the facets (three
+ * point indices into the chunk each) of the chunks.
+ */
+const uint32_t ChunkMagic = 0x4b4d4346; // "FCMK"
+const uint32_t ChunkVersion = 1;
+
+struct ChunkHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t numChunks;
+    uint64_t numPoints;
+    uint64_t numFacets;
+    float box[6];
+};
+
+struct ChunkEntry
+{
+    uint64_t offset;
+    uint64_t numPoints;
+    uint64_t numFacets;
+    float box[6];
+};
+
+void SetBox(float* dst, const Base::BoundBox3f& box)
+{
+    dst[0] = box.MinX; dst[1] = box.MinY; dst[2] = box.MinZ;
+    dst[3] = box.MaxX; dst[4] = box.MaxY; dst[5] = box.MaxZ;
+}
+
+Base::BoundBox3f GetBox(const float* src)
+{
+    return Base::BoundBox3f(src[0], src[1], src[2], src[3], src[4], src[5]);
+}
+
+// exact comparison, points of different chunks are shared if they are equal
+struct VertexLess
+{
+    bool operator()(const Base::Vector3f& a, const Base::Vector3f& b) const
+    {
+        if (a.x != b.x)
+            return a.x < b.x;
+        if (a.y != b.y)
+            return a.y < b.y;
+        return a.z < b.z;
+    }
+};
+
+struct VertexEqual
+{
+    bool operator()(const Base::Vector3f& a, const Base::Vector3f& b) const
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+};
+
+struct MeshChunk
+{
+    std::vector<Base::Vector3f> points;
+    std::vector<uint32_t> facets;
+
+    // builds the chunk from three corners per facet
+    void SetCorners(const std::vector<Base::Vector3f>& corners)
+    {
+        points = corners;
+        std::sort(points.begin(), points.end(), VertexLess());
+        points.erase(std::unique(points.begin(), points.end(), VertexEqual()), points.end());
+        facets.resize(corners.size());
+        for (std::size_t i = 0; i < corners.size(); i++) {
+            facets[i] = static_cast<uint32_t>(std::lower_bound(points.begin(), points.end(),
+                corners[i], VertexLess()) - points.begin());
+        }
+    }
+
+    void SetKernel(const MeshKernel& kernel)
+    {
+        const MeshPointArray& p = kernel.GetPoints();
+        const MeshFacetArray& f = kernel.GetFacets();
+        points.assign(p.begin(), p.end());
+        facets.resize(f.size() * 3);
+        for (std::size_t i = 0; i < f.size(); i++) {
+            for (int j = 0; j < 3; j++)
+                facets[3*i+j] = static_cast<uint32_t>(f[i]._aulPoints[j]);
+        }
+    }
+
+    void Clear()
+    {
+        std::vector<Base::Vector3f>().swap(points);
+        std::vector<uint32_t>().swap(facets);
+    }
+};
+
+/*
+ * Writes the chunks one after another and the header and the table of the
+ * chunks at the end when all sizes are known.
+ */
+class ChunkWriter
+{
+public:
+    ChunkWriter(const std::string& fn, std::size_t numChunks)
+      : file(QString::fromUtf8(fn.c_str())), ok(false)
+    {
+        std::memset(&header, 0, sizeof(header));
+        header.magic = ChunkMagic;
+        header.version = ChunkVersion;
+        entries.reserve(numChunks);
+        box.SetVoid();
+        qint64 start = sizeof(ChunkHeader) + numChunks * sizeof(ChunkEntry);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            ok = file.resize(start) && file.seek(start);
+    }
+    bool IsOpen() const
+    {
+        return ok;
+    }
+    bool Add(const MeshChunk& chunk)
+    {
+        ChunkEntry entry;
+        entry.offset = file.pos();
+        entry.numPoints = chunk.points.size();
+        entry.numFacets = chunk.facets.size() / 3;
+        Base::BoundBox3f chunkBox;
+        for (std::vector<Base::Vector3f>::const_iterator it = chunk.points.begin(); it != chunk.points.end(); ++it)
+            chunkBox.Add(*it);
+        SetBox(entry.box, chunkBox);
+        box.Add(chunkBox);
+        entries.push_back(entry);
+        header.numPoints += entry.numPoints;
+        header.numFacets += entry.numFacets;
+
+        ok = ok && Write(chunk.points.empty() ? 0 : &chunk.points[0].x, chunk.points.size() * 3 * sizeof(float));
+        ok = ok && Write(chunk.facets.empty() ? 0 : &chunk.facets[0], chunk.facets.size() * sizeof(uint32_t));
+        return ok;
+    }
+    bool Finish()
+    {
+        header.numChunks = entries.size();
+        SetBox(header.box, box);
+        ok = ok && file.seek(0) && Write(&header, sizeof(header));
+        ok = ok && Write(entries.empty() ? 0 : &entries[0], entries.size() * sizeof(ChunkEntry));
+        file.close();
+        return ok;
+    }
+
+private:
+    bool Write(const void* data, std::size_t size)
+    {
+        return size == 0 || file.write(static_cast<const char*>(data), size) == static_cast<qint64>(size);
+    }
+
+private:
+    QFile file;
+    ChunkHeader header;
+    std::vector<ChunkEntry> entries;
+    Base::BoundBox3f box;
+    bool ok;
+};
+
+// the corners of a facet of a binary STL file, \a stl points behind the count of facets
+void GetCorners(const uchar* stl, std::size_t index, Base::Vector3f* corners)
+{
+    float v[9];
+    std::memcpy(v, stl + 50 * index + 12, sizeof(v));
+    for (int i = 0; i < 3; i++)
+        corners[i].Set(v[3*i], v[3*i+1], v[3*i+2]);
+}
+
+/*
+ * The facets are sorted into the cells of a regular grid along a Z-order
+ * curve so that consecutive cells lie close together.
+ */
+class MortonGrid
+{
+public:
+    MortonGrid(const Base::BoundBox3f& box, std::size_t numFacets)
+      : box(box), bits(1)
+    {
+        // about 16 facets per cell but not more than 2^21 cells
+        while (bits < 7 && (std::size_t(1) << (3 * bits)) * 16 < numFacets)
+            bits++;
+        float cells = static_cast<float>(1 << bits);
+        scale[0] = box.LengthX() > 0 ? cells / box.LengthX() : 0;
+        scale[1] = box.LengthY() > 0 ? cells / box.LengthY() : 0;
+        scale[2] = box.LengthZ() > 0 ? cells / box.LengthZ() : 0;
+    }
+    std::size_t CountCells() const
+    {
+        return std::size_t(1) << (3 * bits);
+    }
+    uint32_t Cell(const Base::Vector3f* corners) const
+    {
+        Base::Vector3f center = (corners[0] + corners[1] + corners[2]) / 3.0f;
+        const float min[3] = {box.MinX, box.MinY, box.MinZ};
+        int maxIndex = (1 << bits) - 1;
+        uint32_t index[3];
+        for (int i = 0; i < 3; i++) {
+            int k = static_cast<int>((center[i] - min[i]) * scale[i]);
+            index[i] = static_cast<uint32_t>(std::max(0, std::min(k, maxIndex)));
+        }
+        uint32_t code = 0;
+        for (int b = 0; b < bits; b++) {
+            for (int i = 0; i < 3; i++)
+                code |= ((index[i] >> b) & 1) << (3 * b + i);
+        }
+        return code;
+    }
+
+private:
+    Base::BoundBox3f box;
+    float scale[3];
+    int bits;
+};
+
+void GatherChunk(const uchar* stl, const uint32_t* order, std::size_t begin, std::size_t end, MeshChunk* chunk)
+{
+    std::vector<Base::Vector3f> corners((end - begin) * 3);
+    for (std::size_t i = begin; i < end; i++)
+        GetCorners(stl, order[i], &corners[3 * (i - begin)]);
+    chunk->SetCorners(corners);
+}
+
+void TransformChunks(uchar* map, const Base::Matrix4D* mat, std::size_t begin, std::size_t end)
+{
+    ChunkEntry* entries = reinterpret_cast<ChunkEntry*>(map + sizeof(ChunkHeader));
+    for (std::size_t i = begin; i < end; i++) {
+        ChunkEntry& entry = entries[i];
+        float* points = reinterpret_cast<float*>(map + entry.offset);
+        Base::BoundBox3f box;
+        for (uint64_t j = 0; j < entry.numPoints; j++, points += 3) {
+            Base::Vector3f p = (*mat) * Base::Vector3f(points[0], points[1], points[2]);
+            points[0] = p.x;
+            points[1] = p.y;
+            points[2] = p.z;
+            box.Add(p);
+        }
+        SetBox(entry.box, box);
+    }
+}
+
+}
+
+MeshChunkedKernel::MeshChunkedKernel()
+  : _file(0), _map(0), _writable(false)
+{
+}
+
+MeshChunkedKernel::~MeshChunkedKernel()
+{
+    Close();
+}
+
+bool MeshChunkedKernel::Create(const std::string& stl, const std::string& file, unsigned long facetsPerChunk)
+{
+    QFile input(QString::fromUtf8(stl.c_str()));
+    if (!input.open(QIODevice::ReadOnly))
+        return false;
+    qint64 size = input.size();
+    if (size < 84 || static_cast<quint64>(size) > std::numeric_limits<std::size_t>::max())
+        return false;
+    uchar* map = input.map(0, size);
+    if (!map)
+        return false;
+
+    uint32_t count;
+    std::memcpy(&count, map + 80, sizeof(count));
+    std::size_t numFacets = count;
+    if (static_cast<quint64>(size) < 84 + 50 * static_cast<quint64>(numFacets)) {
+        input.unmap(map);
+        return false;
+    }
+    const uchar* facets = map + 84;
+    facetsPerChunk = std::max<unsigned long>(facetsPerChunk, 1);
+
+    // the first pass gets the bounding box, the second one counts the facets per cell
+    Base::BoundBox3f box;
+    Base::Vector3f corners[3];
+    for (std::size_t i = 0; i < numFacets; i++) {
+        GetCorners(facets, i, corners);
+        for (int j = 0; j < 3; j++)
+            box.Add(corners[j]);
+    }
+
+    MortonGrid grid(box, numFacets);
+    std::vector<std::size_t> cursor(grid.CountCells(), 0);
+    for (std::size_t i = 0; i < numFacets; i++) {
+        GetCorners(facets, i, corners);
+        cursor[grid.Cell(corners)]++;
+    }
+
+    // consecutive cells are joined to chunks of about facetsPerChunk facets
+    std::vector<std::size_t> splits(1, 0);
+    std::size_t start = 0, chunkFacets = 0;
+    for (std::vector<std::size_t>::iterator it = cursor.begin(); it != cursor.end(); ++it) {
+        std::size_t cellFacets = *it;
+        *it = start;
+        start += cellFacets;
+        chunkFacets += cellFacets;
+        if (chunkFacets >= facetsPerChunk) {
+            splits.push_back(start);
+            chunkFacets = 0;
+        }
+    }
+    if (chunkFacets > 0)
+        splits.push_back(start);
+
+    ChunkWriter writer(file, splits.size() - 1);
+    bool ok = writer.IsOpen();
+    if (ok && numFacets > 0) {
+        // the facet indices sorted by cells may not fit into memory either
+        QTemporaryFile temp(QString::fromUtf8(file.c_str()) + QLatin1String(".XXXXXX"));
+        qint64 orderSize = numFacets * sizeof(uint32_t);
+        uchar* orderMap = 0;
+        if (temp.open() && temp.resize(orderSize))
+            orderMap = temp.map(0, orderSize);
+        ok = orderMap != 0;
+
+        if (ok) {
+            uint32_t* order = reinterpret_cast<uint32_t*>(orderMap);
+            for (std::size_t i = 0; i < numFacets; i++) {
+                GetCorners(facets, i, corners);
+                order[cursor[grid.Cell(corners)]++] = static_cast<uint32_t>(i);
+            }
+            std::vector<std::size_t>().swap(cursor);
+
+            // every thread gathers one chunk, the chunks are written in order
+            std::size_t numChunks = splits.size() - 1;
+            std::size_t threads = std::max(1, QThread::idealThreadCount());
+            std::vector<MeshChunk> batch(std::min(threads, numChunks));
+            for (std::size_t i = 0; ok && i < numChunks; i += batch.size()) {
+                std::size_t n = std::min(batch.size(), numChunks - i);
+                QList<QFuture<void> > futures;
+                for (std::size_t k = 0; k < n; k++)
+                    futures << QtConcurrent::run(&GatherChunk, facets, order, splits[i+k], splits[i+k+1], &batch[k]);
+                for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+                    it->waitForFinished();
+                for (std::size_t k = 0; ok && k < n; k++) {
+                    ok = writer.Add(batch[k]);
+                    batch[k].Clear();
+                }
+            }
+
+            temp.unmap(orderMap);
+        }
+    }
+
+    input.unmap(map);
+    return writer.Finish() && ok;
+}
+
+bool MeshChunkedKernel::Open(const std::string& file, bool writable)
+{
+    Close();
+
+    QFile* input = new QFile(QString::fromUtf8(file.c_str()));
+    if (!input->open(writable ? QIODevice::ReadWrite : QIODevice::ReadOnly)) {
+        delete input;
+        return false;
+    }
+
+    qint64 size = input->size();
+    uchar* map = 0;
+    if (size >= static_cast<qint64>(sizeof(ChunkHeader)) &&
+        static_cast<quint64>(size) <= std::numeric_limits<std::size_t>::max())
+        map = input->map(0, size);
+
+    // check that all chunks lie inside the file and that their facets only
+    // refer to their own points
+    bool ok = map != 0;
+    if (ok) {
+        const ChunkHeader* header = reinterpret_cast<const ChunkHeader*>(map);
+        quint64 fileSize = static_cast<quint64>(size);
+        ok = header->magic == ChunkMagic && header->version == ChunkVersion &&
+             header->numChunks <= (fileSize - sizeof(ChunkHeader)) / sizeof(ChunkEntry);
+        const ChunkEntry* entries = reinterpret_cast<const ChunkEntry*>(map + sizeof(ChunkHeader));
+        for (uint64_t i = 0; ok && i < header->numChunks; i++) {
+            const ChunkEntry& entry = entries[i];
+            quint64 maxCount = entry.offset <= fileSize ? (fileSize - entry.offset) / (3 * sizeof(float)) : 0;
+            ok = entry.offset <= fileSize && entry.offset % sizeof(float) == 0 &&
+                 entry.numPoints <= maxCount && entry.numFacets <= maxCount - entry.numPoints;
+            if (!ok)
+                break;
+
+            const uint32_t* f = reinterpret_cast<const uint32_t*>(map + entry.offset + 3 * sizeof(float) * entry.numPoints);
+            for (uint64_t j = 0; j < 3 * entry.numFacets; j++) {
+                if (f[j] >= entry.numPoints) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (!ok) {
+        if (map)
+            input->unmap(map);
+        delete input;
+        return false;
+    }
+
+    _file = input;
+    _map = map;
+    _writable = writable;
+    return true;
+}
+
+void MeshChunkedKernel::Close()
+{
+    if (_file) {
+        _file->unmap(_map);
+        delete _file;
+        _file = 0;
+        _map = 0;
+        _writable = false;
+    }
+}
+
+bool MeshChunkedKernel::IsOpen() const
+{
+    return _map != 0;
+}
+
+unsigned long MeshChunkedKernel::CountChunks() const
+{
+    return _map ? reinterpret_cast<const ChunkHeader*>(_map)->numChunks : 0;
+}
+
+unsigned long MeshChunkedKernel::CountPoints() const
+{
+    return _map ? reinterpret_cast<const ChunkHeader*>(_map)->numPoints : 0;
+}
+
+unsigned long MeshChunkedKernel::CountFacets() const
+{
+    return _map ? reinterpret_cast<const ChunkHeader*>(_map)->numFacets : 0;
+}
+
+unsigned long MeshChunkedKernel::CountPoints(unsigned long chunk) const
+{
+    return reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader))[chunk].numPoints;
+}
+
+unsigned long MeshChunkedKernel::CountFacets(unsigned long chunk) const
+{
+    return reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader))[chunk].numFacets;
+}
+
+Base::BoundBox3f MeshChunkedKernel::GetBoundBox() const
+{
+    if (!_map)
+        return Base::BoundBox3f();
+    return GetBox(reinterpret_cast<const ChunkHeader*>(_map)->box);
+}
+
+Base::BoundBox3f MeshChunkedKernel::GetBoundBox(unsigned long chunk) const
+{
+    return GetBox(reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader))[chunk].box);
+}
+
+void MeshChunkedKernel::GetPoints(unsigned long chunk, std::vector<Base::Vector3f>& points) const
+{
+    const ChunkEntry& entry = reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader))[chunk];
+    const float* p = reinterpret_cast<const float*>(_map + entry.offset);
+    points.resize(entry.numPoints);
+    for (std::size_t i = 0; i < points.size(); i++, p += 3)
+        points[i].Set(p[0], p[1], p[2]);
+}
+
+void MeshChunkedKernel::GetChunk(unsigned long chunk, MeshKernel& kernel) const
+{
+    const ChunkEntry& entry = reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader))[chunk];
+    const float* p = reinterpret_cast<const float*>(_map + entry.offset);
+    const uint32_t* f = reinterpret_cast<const uint32_t*>(p + 3 * entry.numPoints);
+
+    MeshPointArray points;
+    points.resize(entry.numPoints);
+    for (std::size_t i = 0; i < points.size(); i++, p += 3)
+        points[i].Set(p[0], p[1], p[2]);
+
+    MeshFacetArray facets;
+    facets.resize(entry.numFacets);
+    for (std::size_t i = 0; i < facets.size(); i++, f += 3) {
+        for (int j = 0; j < 3; j++)
+            facets[i]._aulPoints[j] = f[j];
+    }
+
+    kernel.Adopt(points, facets, true);
+}
+
+bool MeshChunkedKernel::Transform(const Base::Matrix4D& mat)
+{
+    if (!_map || !_writable)
+        return false;
+
+    std::size_t numChunks = CountChunks();
+    std::size_t threads = std::max(1, QThread::idealThreadCount());
+    threads = std::min(threads, numChunks);
+
+    QList<QFuture<void> > futures;
+    for (std::size_t i = 0; i < threads; i++) {
+        futures << QtConcurrent::run(&TransformChunks, _map, &mat,
+                                     numChunks * i / threads, numChunks * (i + 1) / threads);
+    }
+    for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+        it->waitForFinished();
+
+    Base::BoundBox3f box;
+    for (std::size_t i = 0; i < numChunks; i++)
+        box.Add(GetBoundBox(i));
+    SetBox(reinterpret_cast<ChunkHeader*>(_map)->box, box);
+    return true;
+}
+
+/*
+ * Collects the corners of the facets of the other chunks that share a point
+ * with \a points. \a points must be sorted and lie inside \a box.
+ */
+void MeshChunkedKernel::GetNeighbourFacets(unsigned long chunk, const std::vector<Base::Vector3f>& points,
+                                           const Base::BoundBox3f& box, std::vector<Base::Vector3f>& corners) const
+{
+    const ChunkEntry* entries = reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader));
+    std::vector<bool> shared;
+    for (unsigned long i = 0; i < CountChunks(); i++) {
+        const ChunkEntry& entry = entries[i];
+        if (i == chunk || !(GetBox(entry.box) && box))
+            continue;
+
+        const float* p = reinterpret_cast<const float*>(_map + entry.offset);
+        const uint32_t* f = reinterpret_cast<const uint32_t*>(p + 3 * entry.numPoints);
+        shared.assign(entry.numPoints, false);
+        bool any = false;
+        for (uint64_t j = 0; j < entry.numPoints; j++) {
+            Base::Vector3f v(p[3*j], p[3*j+1], p[3*j+2]);
+            if (box.IsInBox(v) && std::binary_search(points.begin(), points.end(), v, VertexLess())) {
+                shared[j] = true;
+                any = true;
+            }
+        }
+        if (!any)
+            continue;
+
+        for (uint64_t j = 0; j < entry.numFacets; j++, f += 3) {
+            if (shared[f[0]] || shared[f[1]] || shared[f[2]]) {
+                for (int k = 0; k < 3; k++)
+                    corners.push_back(Base::Vector3f(p[3*f[k]], p[3*f[k]+1], p[3*f[k]+2]));
+            }
+        }
+    }
+}
+
+void MeshChunkedKernel::ComputeCurvature(unsigned long chunk, std::vector<CurvatureInfo>& curvature) const
+{
+    std::vector<Base::Vector3f> points;
+    GetPoints(chunk, points);
+    std::size_t numPoints = points.size();
+
+    // the curvature of a point depends on the normals of its neighbours, so
+    // two rings of facets of the other chunks are needed
+    std::vector<Base::Vector3f> sorted(points), ring;
+    std::sort(sorted.begin(), sorted.end(), VertexLess());
+    Base::BoundBox3f box = GetBoundBox(chunk);
+    GetNeighbourFacets(chunk, sorted, box, ring);
+    sorted.insert(sorted.end(), ring.begin(), ring.end());
+    std::sort(sorted.begin(), sorted.end(), VertexLess());
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), VertexEqual()), sorted.end());
+    for (std::vector<Base::Vector3f>::const_iterator it = ring.begin(); it != ring.end(); ++it)
+        box.Add(*it);
+    ring.clear();
+    GetNeighbourFacets(chunk, sorted, box, ring);
+    std::vector<Base::Vector3f>().swap(sorted);
+
+    // the points of the chunk keep their indices, the others are appended
+    std::vector<std::pair<Base::Vector3f, unsigned long> > index;
+    index.reserve(numPoints + ring.size());
+    for (std::size_t i = 0; i < numPoints; i++)
+        index.push_back(std::make_pair(points[i], i));
+    struct PairLess {
+        bool operator()(const std::pair<Base::Vector3f, unsigned long>& a,
+                        const std::pair<Base::Vector3f, unsigned long>& b) const
+        {
+            return VertexLess()(a.first, b.first);
+        }
+    };
+    std::sort(index.begin(), index.end(), PairLess());
+    for (std::vector<Base::Vector3f>::const_iterator it = ring.begin(); it != ring.end(); ++it) {
+        std::pair<Base::Vector3f, unsigned long> key(*it, 0);
+        if (!std::binary_search(index.begin(), index.begin() + numPoints, key, PairLess()))
+            points.push_back(*it);
+    }
+    std::sort(points.begin() + numPoints, points.end(), VertexLess());
+    points.erase(std::unique(points.begin() + numPoints, points.end(), VertexEqual()), points.end());
+    for (std::size_t i = numPoints; i < points.size(); i++)
+        index.push_back(std::make_pair(points[i], i));
+    std::inplace_merge(index.begin(), index.begin() + numPoints, index.end(), PairLess());
+
+    MeshPointArray meshPoints;
+    meshPoints.resize(points.size());
+    for (std::size_t i = 0; i < points.size(); i++)
+        meshPoints[i] = points[i];
+    std::vector<Base::Vector3f>().swap(points);
+
+    const ChunkEntry& entry = reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader))[chunk];
+    const uint32_t* f = reinterpret_cast<const uint32_t*>(_map + entry.offset + 3 * sizeof(float) * entry.numPoints);
+    MeshFacetArray meshFacets;
+    meshFacets.resize(entry.numFacets + ring.size() / 3);
+    for (uint64_t i = 0; i < entry.numFacets; i++, f += 3) {
+        for (int j = 0; j < 3; j++)
+            meshFacets[i]._aulPoints[j] = f[j];
+    }
+    for (std::size_t i = 0; i < ring.size(); i++) {
+        std::pair<Base::Vector3f, unsigned long> key(ring[i], 0);
+        meshFacets[entry.numFacets + i / 3]._aulPoints[i % 3] =
+            std::lower_bound(index.begin(), index.end(), key, PairLess())->second;
+    }
+
+    MeshKernel kernel;
+    kernel.Adopt(meshPoints, meshFacets, true);
+    MeshCurvature meshCurv(kernel);
+    meshCurv.ComputePerVertex();
+    const std::vector<CurvatureInfo>& info = meshCurv.GetCurvature();
+    curvature.assign(info.begin(), info.begin() + numPoints);
+}
+
+/*
+ * Gets the indices of the points of the chunk that are shared with other chunks.
+ */
+void MeshChunkedKernel::GetBorderPoints(unsigned long chunk, std::vector<unsigned long>& indices) const
+{
+    std::vector<Base::Vector3f> points;
+    GetPoints(chunk, points);
+    std::vector<Base::Vector3f> sorted(points);
+    std::sort(sorted.begin(), sorted.end(), VertexLess());
+
+    std::vector<bool> border(sorted.size(), false);
+    const ChunkEntry* entries = reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader));
+    Base::BoundBox3f box = GetBoundBox(chunk);
+    for (unsigned long i = 0; i < CountChunks(); i++) {
+        const ChunkEntry& entry = entries[i];
+        if (i == chunk || !(GetBox(entry.box) && box))
+            continue;
+        const float* p = reinterpret_cast<const float*>(_map + entry.offset);
+        for (uint64_t j = 0; j < entry.numPoints; j++, p += 3) {
+            Base::Vector3f v(p[0], p[1], p[2]);
+            if (!box.IsInBox(v))
+                continue;
+            std::vector<Base::Vector3f>::iterator it = std::lower_bound(sorted.begin(), sorted.end(), v, VertexLess());
+            if (it != sorted.end() && VertexEqual()(*it, v))
+                border[it - sorted.begin()] = true;
+        }
+    }
+
+    indices.clear();
+    for (std::size_t i = 0; i < points.size(); i++) {
+        std::size_t pos = std::lower_bound(sorted.begin(), sorted.end(), points[i], VertexLess()) - sorted.begin();
+        if (border[pos])
+            indices.push_back(i);
+    }
+}
+
+void MeshChunkedKernel::DecimateChunk(unsigned long chunk, float tolerance, float reduction, MeshKernel* kernel) const
+{
+    GetChunk(chunk, *kernel);
+    std::vector<unsigned long> border;
+    GetBorderPoints(chunk, border);
+    MeshSimplify simplify(*kernel);
+    simplify.simplify(tolerance, reduction, border);
+}
+
+bool MeshChunkedKernel::Decimate(const std::string& file, float tolerance, float reduction) const
+{
+    if (!_map)
+        return false;
+
+    std::size_t numChunks = CountChunks();
+    ChunkWriter writer(file, numChunks);
+    bool ok = writer.IsOpen();
+
+    // every thread simplifies one chunk, the chunks are written in order
+    std::size_t threads = std::max(1, QThread::idealThreadCount());
+    std::vector<MeshKernel> batch(std::min(threads, numChunks));
+    MeshChunk chunk;
+    for (std::size_t i = 0; ok && i < numChunks; i += batch.size()) {
+        std::size_t n = std::min(batch.size(), numChunks - i);
+        QList<QFuture<void> > futures;
+        for (std::size_t k = 0; k < n; k++)
+            futures << QtConcurrent::run(this, &MeshChunkedKernel::DecimateChunk, i + k, tolerance, reduction, &batch[k]);
+        for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+            it->waitForFinished();
+        for (std::size_t k = 0; ok && k < n; k++) {
+            chunk.SetKernel(batch[k]);
+            batch[k].Clear();
+            ok = writer.Add(chunk);
+        }
+    }
+
+    return writer.Finish() && ok;
+}
+
+bool MeshChunkedKernel::SaveBinarySTL(const std::string& file) const
+{
+    if (!_map || CountFacets() > std::numeric_limits<uint32_t>::max())
+        return false;
+
+    QFile output(QString::fromUtf8(file.c_str()));
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    char header[80];
+    std::memset(header, ' ', sizeof(header));
+    std::memcpy(header, "MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-", 40);
+    uint32_t count = static_cast<uint32_t>(CountFacets());
+    bool ok = output.write(header, sizeof(header)) == sizeof(header) &&
+              output.write(reinterpret_cast<const char*>(&count), sizeof(count)) == sizeof(count);
+
+    std::vector<char> buffer;
+    for (unsigned long i = 0; ok && i < CountChunks(); i++) {
+        const ChunkEntry& entry = reinterpret_cast<const ChunkEntry*>(_map + sizeof(ChunkHeader))[i];
+        const float* p = reinterpret_cast<const float*>(_map + entry.offset);
+        const uint32_t* f = reinterpret_cast<const uint32_t*>(p + 3 * entry.numPoints);
+
+        buffer.assign(entry.numFacets * 50, 0);
+        char* data = buffer.empty() ? 0 : &buffer[0];
+        for (uint64_t j = 0; j < entry.numFacets; j++, f += 3, data += 50) {
+            Base::Vector3f corners[3];
+            for (int k = 0; k < 3; k++)
+                corners[k].Set(p[3*f[k]], p[3*f[k]+1], p[3*f[k]+2]);
+            Base::Vector3f normal = (corners[1] - corners[0]) % (corners[2] - corners[0]);
+            normal.Normalize();
+            std::memcpy(data, &normal.x, 3 * sizeof(float));
+            for (int k = 0; k < 3; k++)
+                std::memcpy(data + 12 * (k + 1), &corners[k].x, 3 * sizeof(float));
+        }
+        ok = output.write(buffer.empty() ? 0 : &buffer[0], buffer.size()) == static_cast<qint64>(buffer.size());
+    }
+
+    output.close();
+    return ok;
+}
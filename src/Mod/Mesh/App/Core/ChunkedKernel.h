@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef MESHCORE_CHUNKEDKERNEL_H
+#define MESHCORE_CHUNKEDKERNEL_H
+
+#include <string>
+#include <vector>
+#include <Base/BoundBox.h>
+#include <Base/Matrix.h>
+
+class QFile;
+
+namespace MeshCore {
+
+class MeshKernel;
+struct CurvatureInfo;
+
+/**
+ * The MeshChunkedKernel class gives access to meshes that are too big to be
+ * kept in memory. The mesh is stored in a file that is split into chunks of
+ * facets lying close together. The file is mapped into memory so that the
+ * operating system only has to load the chunks that are being processed.
+ *
+ * Every chunk has its own points, i.e. a point used by facets of several
+ * chunks is stored once in each of them. The file is written in the byte
+ * order of the machine that created it.
+ * @author FreeCAD Developers
+ */
+class MeshExport MeshChunkedKernel
+{
+public:
+    MeshChunkedKernel();
+    ~MeshChunkedKernel();
+
+    /** Sorts the facets of the binary STL file \a stl into chunks of about
+     * \a facetsPerChunk facets and writes them to \a file. The STL file is
+     * read through a file mapping and needs not to fit into memory.
+     */
+    static bool Create(const std::string& stl, const std::string& file,
+                       unsigned long facetsPerChunk = 1000000);
+
+    /** Maps the chunk file \a file into memory. The file must be opened
+     * \a writable to be transformed.
+     */
+    bool Open(const std::string& file, bool writable = false);
+    void Close();
+    bool IsOpen() const;
+
+    /** @name Information */
+    //@{
+    unsigned long CountChunks() const;
+    /// The number of points, the points shared by several chunks are counted more than once.
+    unsigned long CountPoints() const;
+    unsigned long CountFacets() const;
+    unsigned long CountPoints(unsigned long chunk) const;
+    unsigned long CountFacets(unsigned long chunk) const;
+    Base::BoundBox3f GetBoundBox() const;
+    Base::BoundBox3f GetBoundBox(unsigned long chunk) const;
+    //@}
+
+    /** @name Algorithms */
+    //@{
+    /// Copies the points and facets of the given chunk into \a kernel.
+    void GetChunk(unsigned long chunk, MeshKernel& kernel) const;
+    /// Transforms all points in place with several threads. The file must be opened writable.
+    bool Transform(const Base::Matrix4D& mat);
+    /** Computes the curvature of the points of the given chunk in the order
+     * of GetChunk(). The facets of the neighbouring chunks around the chunk
+     * border are taken into account.
+     */
+    void ComputeCurvature(unsigned long chunk, std::vector<CurvatureInfo>& curvature) const;
+    /** Simplifies the chunks one by one and writes the result to \a file.
+     * The points on the chunk borders are kept so that the chunks still fit
+     * together. \see MeshSimplify
+     */
+    bool Decimate(const std::string& file, float tolerance, float reduction) const;
+    /// Writes the mesh as binary STL file chunk by chunk.
+    bool SaveBinarySTL(const std::string& file) const;
+    //@}
+
+private:
+    void GetPoints(unsigned long chunk, std::vector<Base::Vector3f>& points) const;
+    void GetNeighbourFacets(unsigned long chunk, const std::vector<Base::Vector3f>& points,
+                            const Base::BoundBox3f& box, std::vector<Base::Vector3f>& corners) const;
+    void GetBorderPoints(unsigned long chunk, std::vector<unsigned long>& indices) const;
+    void DecimateChunk(unsigned long chunk, float tolerance, float reduction, MeshKernel* kernel) const;
+
+private:
+    MeshChunkedKernel(const MeshChunkedKernel&);
+    void operator = (const MeshChunkedKernel&);
+
+private:
+    QFile* _file;
+    unsigned char* _map;
+    bool _writable;
+};
+
+} // namespace MeshCore
+
+#endif // MESHCORE_CHUNKEDKERNEL_H
@@ -35,7 +35,7 @@
 #include <Eigen/Eigenvalues>
 #else
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
-#include <Mod/Mesh/App/WildMagic4/Wm4MeshCurvature.h>
+#include <Mod/Mesh/App/WildMagic4/Wm4Matrix3.h>
 #endif
 
 #include "Curvature.h"
@@ -44,6 +44,7 @@
 #include "MeshKernel.h"
 #include "Iterator.h"
 #include "Tools.h"
+#include "Functional.h"
 #include <Base/Sequencer.h>
 #include <Base/Tools.h>
 
@@ -89,6 +90,12 @@ void MeshCurvature::ComputePerFace(bool parallel)
     }
 }
 
+void MeshCurvature::ComputePerVertex()
+{
+    MeshRefPointToFacets search(myKernel);
+    ComputePerVertex(search);
+}
+
 #ifdef OPTIMIZE_CURVATURE
 namespace MeshCore {
 void GenerateComplementBasis (Eigen::Vector3f& rkU, Eigen::Vector3f& rkV,
@@ -121,12 +128,11 @@ void GenerateComplementBasis (Eigen::Vector3f& rkU, Eigen::Vector3f& rkV,
 }
 }
 
-void MeshCurvature::ComputePerVertex()
+void MeshCurvature::ComputePerVertex(const MeshRefPointToFacets& pt2f)
 {
     // get all points
     const MeshPointArray& pts = myKernel.GetPoints();
 
-    MeshCore::MeshRefPointToFacets pt2f(myKernel);
     MeshCore::MeshRefPointToPoints pt2p(myKernel);
     unsigned long numPoints = myKernel.CountPoints();
 
@@ -161,8 +167,8 @@ void MeshCurvature::ComputePerVertex()
 
         int iV0 = i;
         int iV1;
-        const std::set<unsigned long>& nb = pt2p[i];
-        for (std::set<unsigned long>::const_iterator it = nb.begin(); it != nb.end(); ++it) {
+        MeshCore::MeshIndexRange nb = pt2p[i];
+        for (MeshCore::MeshIndexRange::const_iterator it = nb.begin(); it != nb.end(); ++it) {
             iV1 = *it;
 
             // Compute edge from V0 to V1, project to tangent plane of vertex,
@@ -288,51 +294,180 @@ void MeshCurvature::ComputePerVertex()
     }
 }
 #else
-void MeshCurvature::ComputePerVertex()
+namespace {
+
+// smaller numbers of points are handled by the calling thread
+const unsigned long MinParallelCount = 5000;
+
+inline Wm4::Vector3<double> ToVector(const Base::Vector3f& p)
 {
-    myCurvature.clear();
+    return Wm4::Vector3<double>(p.x, p.y, p.z);
+}
 
-    // get all points
-    std::vector< Wm4::Vector3<double> > aPnts;
-    aPnts.reserve(myKernel.CountPoints());
-    MeshPointIterator cPIt(myKernel);
-    for (cPIt.Init(); cPIt.More(); cPIt.Next()) {
-        Wm4::Vector3<double> cP(cPIt->x, cPIt->y, cPIt->z);
-        aPnts.push_back(cP);
+// The normal of a vertex is the area weighted sum of the normals of its facets
+struct VertexNormals
+{
+    typedef void result_type;
+    VertexNormals(const MeshKernel& kernel, const MeshRefPointToFacets& search,
+                  std::vector< Wm4::Vector3<double> >& normals)
+      : kernel(&kernel), search(&search), normals(&normals) {}
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        const MeshPointArray& points = kernel->GetPoints();
+        const MeshFacetArray& facets = kernel->GetFacets();
+        for (unsigned long i = begin; i < end; i++) {
+            Wm4::Vector3<double> kNormal(0.0, 0.0, 0.0);
+            MeshIndexRange nf = (*search)[i];
+            for (MeshIndexRange::const_iterator it = nf.begin(); it != nf.end(); ++it) {
+                const MeshFacet& face = facets[*it];
+                Wm4::Vector3<double> kV0 = ToVector(points[face._aulPoints[0]]);
+                Wm4::Vector3<double> kEdge1 = ToVector(points[face._aulPoints[1]]) - kV0;
+                Wm4::Vector3<double> kEdge2 = ToVector(points[face._aulPoints[2]]) - kV0;
+                kNormal += kEdge1.Cross(kEdge2);
+            }
+            kNormal.Normalize();
+            (*normals)[i] = kNormal;
+        }
     }
+    const MeshKernel* kernel;
+    const MeshRefPointToFacets* search;
+    std::vector< Wm4::Vector3<double> >* normals;
+};
 
-    // get all point connections
-    std::vector<int> aIdx;
-    aIdx.reserve(3*myKernel.CountFacets());
-    const MeshFacetArray& raFts = myKernel.GetFacets();
-    for (MeshFacetArray::const_iterator jt = raFts.begin(); jt != raFts.end(); ++jt) {
-        for (int i=0; i<3; i++) {
-            aIdx.push_back((int)jt->_aulPoints[i]);
+// This is the same computation as done by Wm4::MeshCurvature but instead of
+// scattering the contributions of each triangle to its vertices they are
+// gathered for each vertex, so the vertices can be handled independently.
+struct VertexCurvature
+{
+    typedef void result_type;
+    VertexCurvature(const MeshKernel& kernel, const MeshRefPointToFacets& search,
+                    const std::vector< Wm4::Vector3<double> >& normals,
+                    std::vector<CurvatureInfo>& curvature)
+      : kernel(&kernel), search(&search), normals(&normals), curvature(&curvature) {}
+    void AddEdge(unsigned long iV0, unsigned long iV1,
+                 Wm4::Matrix3<double>& akWWTrn, Wm4::Matrix3<double>& akDWTrn) const
+    {
+        const MeshPointArray& points = kernel->GetPoints();
+        const Wm4::Vector3<double>& kN0 = (*normals)[iV0];
+
+        // Compute edge from V0 to V1, project to tangent plane of vertex,
+        // and compute difference of adjacent normals.
+        Wm4::Vector3<double> kE = ToVector(points[iV1]) - ToVector(points[iV0]);
+        Wm4::Vector3<double> kW = kE - (kE.Dot(kN0))*kN0;
+        Wm4::Vector3<double> kD = (*normals)[iV1] - kN0;
+        for (int iRow = 0; iRow < 3; iRow++) {
+            for (int iCol = 0; iCol < 3; iCol++) {
+                akWWTrn[iRow][iCol] += kW[iRow]*kW[iCol];
+                akDWTrn[iRow][iCol] += kD[iRow]*kW[iCol];
+            }
         }
     }
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        const MeshFacetArray& facets = kernel->GetFacets();
+        for (unsigned long i = begin; i < end; i++) {
+            Wm4::Matrix3<double> akWWTrn(true);
+            Wm4::Matrix3<double> akDWTrn(true);
+            MeshIndexRange nf = (*search)[i];
+            for (MeshIndexRange::const_iterator it = nf.begin(); it != nf.end(); ++it) {
+                const MeshFacet& face = facets[*it];
+                for (int j = 0; j < 3; j++) {
+                    if (face._aulPoints[j] == i) {
+                        AddEdge(i, face._aulPoints[(j+1)%3], akWWTrn, akDWTrn);
+                        AddEdge(i, face._aulPoints[(j+2)%3], akWWTrn, akDWTrn);
+                    }
+                }
+            }
+
+            // Add in N*N^T to W*W^T for numerical stability.  In theory 0*0^T gets
+            // added to D*W^T, but of course no update needed in the implementation.
+            // Compute the matrix of normal derivatives.
+            const Wm4::Vector3<double>& kN = (*normals)[i];
+            for (int iRow = 0; iRow < 3; iRow++) {
+                for (int iCol = 0; iCol < 3; iCol++) {
+                    akWWTrn[iRow][iCol] = 0.5*akWWTrn[iRow][iCol] + kN[iRow]*kN[iCol];
+                    akDWTrn[iRow][iCol] *= 0.5;
+                }
+            }
+            Wm4::Matrix3<double> akDNormal = akDWTrn*akWWTrn.Inverse();
+
+            // compute U and V given N, see Wm4::MeshCurvature for the details
+            Wm4::Vector3<double> kU, kV;
+            Wm4::Vector3<double>::GenerateComplementBasis(kU,kV,kN);
+
+            // Compute S = J^T * dN/dX * J.  In theory S is symmetric, but
+            // because we have estimated dN/dX, we must slightly adjust our
+            // calculations to make sure S is symmetric.
+            double fS01 = kU.Dot(akDNormal*kV);
+            double fS10 = kV.Dot(akDNormal*kU);
+            double fSAvr = 0.5*(fS01+fS10);
+            double fS00 = kU.Dot(akDNormal*kU);
+            double fS11 = kV.Dot(akDNormal*kV);
+
+            // compute the eigenvalues of S (min and max curvatures)
+            double fTrace = fS00 + fS11;
+            double fDet = fS00*fS11 - fSAvr*fSAvr;
+            double fDiscr = fTrace*fTrace - 4.0*fDet;
+            double fRootDiscr = sqrt(fabs(fDiscr));
+            double fMinCurvature = 0.5*(fTrace - fRootDiscr);
+            double fMaxCurvature = 0.5*(fTrace + fRootDiscr);
+
+            CurvatureInfo& ci = (*curvature)[i];
+            ci.fMinCurvature = (float)fMinCurvature;
+            ci.fMaxCurvature = (float)fMaxCurvature;
+            ci.cMinCurvDir = EigenVector(fS00, fSAvr, fS11, fMinCurvature, kU, kV);
+            ci.cMaxCurvDir = EigenVector(fS00, fSAvr, fS11, fMaxCurvature, kU, kV);
+        }
+    }
+    // compute the eigenvector of S for the eigenvalue fK
+    static Base::Vector3f EigenVector(double fS00, double fS01, double fS11, double fK,
+                                      const Wm4::Vector3<double>& kU, const Wm4::Vector3<double>& kV)
+    {
+        double fW0x = fS01, fW0y = fK-fS00;
+        double fW1x = fK-fS11, fW1y = fS01;
+        double fX, fY;
+        if (fW0x*fW0x + fW0y*fW0y >= fW1x*fW1x + fW1y*fW1y) {
+            fX = fW0x; fY = fW0y;
+        }
+        else {
+            fX = fW1x; fY = fW1y;
+        }
+        double fLength = sqrt(fX*fX + fY*fY);
+        if (fLength > Wm4::Math<double>::ZERO_TOLERANCE) {
+            double fInvLength = 1.0/fLength;
+            fX *= fInvLength;
+            fY *= fInvLength;
+        }
+        else {
+            fX = 0.0;
+            fY = 0.0;
+        }
+        Wm4::Vector3<double> kDir = fX*kU + fY*kV;
+        return Base::Vector3f((float)kDir.X(), (float)kDir.Y(), (float)kDir.Z());
+    }
+    const MeshKernel* kernel;
+    const MeshRefPointToFacets* search;
+    const std::vector< Wm4::Vector3<double> >* normals;
+    std::vector<CurvatureInfo>* curvature;
+};
+
+}
+
+void MeshCurvature::ComputePerVertex(const MeshRefPointToFacets& search)
+{
+    myCurvature.clear();
 
     // in case of an empty mesh no curvature can be calculated
     if (myKernel.CountPoints() == 0 || myKernel.CountFacets() == 0)
         return;
 
     // compute vertex based curvatures
-    Wm4::MeshCurvature<double> meshCurv(myKernel.CountPoints(), &(aPnts[0]), myKernel.CountFacets(), &(aIdx[0]));
-
-    // get curvature information now
-    const Wm4::Vector3<double>* aMaxCurvDir = meshCurv.GetMaxDirections();
-    const Wm4::Vector3<double>* aMinCurvDir = meshCurv.GetMinDirections();
-    const double* aMaxCurv = meshCurv.GetMaxCurvatures();
-    const double* aMinCurv = meshCurv.GetMinCurvatures();
+    unsigned long numPoints = myKernel.CountPoints();
+    std::vector< Wm4::Vector3<double> > normals(numPoints);
+    parallel_for(numPoints, MinParallelCount, VertexNormals(myKernel, search, normals));
 
-    myCurvature.reserve(myKernel.CountPoints());
-    for (unsigned long i=0; i<myKernel.CountPoints(); i++) {
-        CurvatureInfo ci;
-        ci.cMaxCurvDir = Base::Vector3f((float)aMaxCurvDir[i].X(), (float)aMaxCurvDir[i].Y(), (float)aMaxCurvDir[i].Z());
-        ci.cMinCurvDir = Base::Vector3f((float)aMinCurvDir[i].X(), (float)aMinCurvDir[i].Y(), (float)aMinCurvDir[i].Z());
-        ci.fMaxCurvature = (float)aMaxCurv[i];
-        ci.fMinCurvature = (float)aMinCurv[i];
-        myCurvature.push_back(ci);
-    }
+    myCurvature.resize(numPoints);
+    parallel_for(numPoints, MinParallelCount, VertexCurvature(myKernel, search, normals, myCurvature));
 }
 #endif // OPTIMIZE_CURVATURE
 
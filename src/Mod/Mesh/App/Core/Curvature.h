@@ -59,7 +59,10 @@ public:
     float GetRadius() const { return myRadius; }
     void SetRadius(float r) { myRadius = r; }
     void ComputePerFace(bool parallel);
+    /// Computes the principal curvatures and directions of all points with several threads.
     void ComputePerVertex();
+    /// Same as above but re-uses an existing point to facets structure of the mesh.
+    void ComputePerVertex(const MeshRefPointToFacets&);
     const std::vector<CurvatureInfo>& GetCurvature() const { return myCurvature; }
 
 private:
@@ -23,21 +23,202 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <climits>
 #endif
 
+#include <QFuture>
+#include <QList>
+#include <QThread>
+#include <QtConcurrentRun>
+
 #include "Decimation.h"
 #include "MeshKernel.h"
 #include "Algorithm.h"
 #include "Iterator.h"
 #include "TopoAlgorithm.h"
+#include <Base/Exception.h>
 #include <Base/Tools.h>
 #include "Simplify.h"
 
 
 using namespace MeshCore;
 
+namespace {
+
+// meshes with fewer facets per thread are simplified as a whole
+const std::size_t MinBlockFacets = 100000;
+
+/*
+ * A block is a set of facets lying close together that is simplified
+ * independently of the other blocks. The points shared with other blocks are
+ * locked so that the blocks still fit together afterwards.
+ */
+struct MeshBlock
+{
+    std::vector<unsigned long> facets;
+    int target;
+    Simplify alg;
+};
+
+void SimplifyBlock(const MeshKernel* kernel, const std::vector<int>* pointBlocks,
+                   MeshBlock* block, float tolerance)
+{
+    const MeshPointArray& points = kernel->GetPoints();
+    const MeshFacetArray& facets = kernel->GetFacets();
+
+    // sorted global indices of the points of the block
+    std::vector<unsigned long> indices;
+    indices.reserve(block->facets.size() * 3);
+    for (std::vector<unsigned long>::const_iterator it = block->facets.begin(); it != block->facets.end(); ++it) {
+        for (int j = 0; j < 3; j++)
+            indices.push_back(facets[*it]._aulPoints[j]);
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    Simplify& alg = block->alg;
+    alg.vertices.resize(indices.size());
+    for (std::size_t i = 0; i < indices.size(); i++) {
+        Simplify::Vertex& v = alg.vertices[i];
+        v.p = points[indices[i]];
+        // a locked point remembers its global index
+        v.locked = (*pointBlocks)[indices[i]] < 0 ? static_cast<int>(indices[i]) + 1 : 0;
+    }
+
+    alg.triangles.resize(block->facets.size());
+    for (std::size_t i = 0; i < block->facets.size(); i++) {
+        const MeshFacet& face = facets[block->facets[i]];
+        for (int j = 0; j < 3; j++) {
+            alg.triangles[i].v[j] = static_cast<int>(std::lower_bound(indices.begin(), indices.end(),
+                face._aulPoints[j]) - indices.begin());
+        }
+    }
+
+    std::vector<unsigned long>().swap(block->facets);
+    std::vector<unsigned long>().swap(indices);
+
+    alg.simplify_mesh(block->target, tolerance);
+}
+
+/*
+ * Splits the facets into slabs of equal size along the longest side of the
+ * bounding box, simplifies the slabs in parallel and merges the results
+ * into \a alg.
+ */
+void SimplifyBlocks(const MeshKernel& kernel, int numBlocks, int target, float tolerance, Simplify& alg)
+{
+    const MeshPointArray& points = kernel.GetPoints();
+    const MeshFacetArray& facets = kernel.GetFacets();
+    std::size_t numFacets = facets.size();
+
+    Base::BoundBox3f box = kernel.GetBoundBox();
+    int axis = 0;
+    if (box.LengthY() > box.LengthX() && box.LengthY() >= box.LengthZ())
+        axis = 1;
+    else if (box.LengthZ() > box.LengthX() && box.LengthZ() > box.LengthY())
+        axis = 2;
+
+    std::vector<float> keys(numFacets);
+    for (std::size_t i = 0; i < numFacets; i++) {
+        const MeshFacet& face = facets[i];
+        keys[i] = points[face._aulPoints[0]][axis] +
+                  points[face._aulPoints[1]][axis] +
+                  points[face._aulPoints[2]][axis];
+    }
+
+    struct KeyLess {
+        KeyLess(const std::vector<float>& k) : keys(k) {}
+        bool operator()(unsigned long a, unsigned long b) const { return keys[a] < keys[b]; }
+        const std::vector<float>& keys;
+    };
+
+    std::vector<unsigned long> order(numFacets);
+    for (std::size_t i = 0; i < numFacets; i++)
+        order[i] = i;
+    std::vector<std::size_t> splits(numBlocks + 1);
+    for (int i = 0; i <= numBlocks; i++)
+        splits[i] = numFacets * i / numBlocks;
+    for (int i = 1; i < numBlocks; i++) {
+        std::nth_element(order.begin() + splits[i-1], order.begin() + splits[i],
+                         order.end(), KeyLess(keys));
+    }
+    std::vector<float>().swap(keys);
+
+    // points used by facets of different blocks are marked with -1
+    std::vector<int> pointBlocks(points.size(), INT_MAX);
+    std::vector<MeshBlock> blocks(numBlocks);
+    for (int i = 0; i < numBlocks; i++) {
+        MeshBlock& block = blocks[i];
+        block.facets.assign(order.begin() + splits[i], order.begin() + splits[i+1]);
+        block.target = static_cast<int>(static_cast<double>(target) * block.facets.size() / numFacets);
+        for (std::vector<unsigned long>::const_iterator it = block.facets.begin(); it != block.facets.end(); ++it) {
+            for (int j = 0; j < 3; j++) {
+                int& pointBlock = pointBlocks[facets[*it]._aulPoints[j]];
+                if (pointBlock == INT_MAX)
+                    pointBlock = i;
+                else if (pointBlock != i)
+                    pointBlock = -1;
+            }
+        }
+    }
+    std::vector<unsigned long>().swap(order);
+
+    QList<QFuture<void> > futures;
+    for (int i = 0; i < numBlocks; i++)
+        futures << QtConcurrent::run(&SimplifyBlock, &kernel, &pointBlocks, &blocks[i], tolerance);
+    for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+        it->waitForFinished();
+
+    // merge the blocks, the locked points are shared
+    std::size_t numVertices = 0, numTriangles = 0;
+    for (int i = 0; i < numBlocks; i++) {
+        numVertices += blocks[i].alg.vertices.size();
+        numTriangles += blocks[i].alg.triangles.size();
+    }
+    alg.vertices.reserve(numVertices);
+    alg.triangles.reserve(numTriangles);
+
+    std::vector<int> lockedIndex(points.size(), -1);
+    std::vector<int> blockIndex;
+    for (int i = 0; i < numBlocks; i++) {
+        Simplify& part = blocks[i].alg;
+        blockIndex.resize(part.vertices.size());
+        for (std::size_t j = 0; j < part.vertices.size(); j++) {
+            Simplify::Vertex& v = part.vertices[j];
+            if (v.locked) {
+                int& index = lockedIndex[v.locked - 1];
+                if (index < 0) {
+                    index = static_cast<int>(alg.vertices.size());
+                    v.locked = 0;
+                    alg.vertices.push_back(v);
+                }
+                blockIndex[j] = index;
+            }
+            else {
+                blockIndex[j] = static_cast<int>(alg.vertices.size());
+                alg.vertices.push_back(v);
+            }
+        }
+
+        for (std::size_t j = 0; j < part.triangles.size(); j++) {
+            Simplify::Triangle t;
+            for (int k = 0; k < 3; k++)
+                t.v[k] = blockIndex[part.triangles[j].v[k]];
+            alg.triangles.push_back(t);
+        }
+
+        std::vector<Simplify::Vertex>().swap(part.vertices);
+        std::vector<Simplify::Triangle>().swap(part.triangles);
+        std::vector<Simplify::Ref>().swap(part.refs);
+    }
+}
+
+}
+
 MeshSimplify::MeshSimplify(MeshKernel& mesh)
   : myKernel(mesh)
+  , numBlocks(0)
 {
 }
 
@@ -46,28 +227,72 @@ MeshSimplify::~MeshSimplify()
 }
 
 void MeshSimplify::simplify(float tolerance, float reduction)
+{
+    std::size_t numFacets = myKernel.CountFacets();
+    int target_count = static_cast<int>(static_cast<float>(numFacets) * (1.0f-reduction));
+    decimate(target_count, tolerance, std::vector<unsigned long>());
+}
+
+void MeshSimplify::simplify(int targetSize)
+{
+    // a tolerance of zero doesn't restrict the error
+    decimate(targetSize, 0.0f, std::vector<unsigned long>());
+}
+
+void MeshSimplify::simplify(float tolerance, float reduction, const std::vector<unsigned long>& locked)
+{
+    std::size_t numFacets = myKernel.CountFacets();
+    int target_count = static_cast<int>(static_cast<float>(numFacets) * (1.0f-reduction));
+    decimate(target_count, tolerance, locked);
+}
+
+void MeshSimplify::setBlockCount(int count)
+{
+    numBlocks = count;
+}
+
+void MeshSimplify::decimate(int targetSize, float tolerance, const std::vector<unsigned long>& locked)
 {
     Simplify alg;
 
-    const MeshPointArray& points = myKernel.GetPoints();
-    for (std::size_t i = 0; i < points.size(); i++) {
-        Simplify::Vertex v;
-        v.p = points[i];
-        alg.vertices.push_back(v);
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    unsigned long countPoints = myKernel.CountPoints();
+    for (std::vector<unsigned long>::const_iterator it = locked.begin(); it != locked.end(); ++it) {
+        if (*it >= countPoints)
+            throw Base::IndexError("Point index out of range");
     }
 
-    const MeshFacetArray& facets = myKernel.GetFacets();
-    for (std::size_t i = 0; i < facets.size(); i++) {
-        Simplify::Triangle t;
-        for (int j = 0; j < 3; j++)
-            t.v[j] = facets[i]._aulPoints[j];
-        alg.triangles.push_back(t);
+    int threads = std::min<int>(numBlocks, static_cast<int>(facets.size()));
+    if (threads <= 0) {
+        threads = std::max(1, QThread::idealThreadCount());
+        threads = std::min<int>(threads, static_cast<int>(facets.size() / MinBlockFacets));
     }
 
-    int target_count = static_cast<int>(static_cast<float>(facets.size()) * (1.0f-reduction));
+    // the blocks lock their own border points only
+    if (threads > 1 && locked.empty() && static_cast<std::size_t>(targetSize) < facets.size()) {
+        // the blocks do most of the work, the last run removes the
+        // remaining facets along the block borders
+        SimplifyBlocks(myKernel, threads, targetSize, tolerance, alg);
+    }
+    else {
+        const MeshPointArray& points = myKernel.GetPoints();
+        alg.vertices.resize(points.size());
+        for (std::size_t i = 0; i < points.size(); i++) {
+            alg.vertices[i].p = points[i];
+            alg.vertices[i].locked = 0;
+        }
+        for (std::vector<unsigned long>::const_iterator it = locked.begin(); it != locked.end(); ++it)
+            alg.vertices[*it].locked = 1;
+
+        alg.triangles.resize(facets.size());
+        for (std::size_t i = 0; i < facets.size(); i++) {
+            for (int j = 0; j < 3; j++)
+                alg.triangles[i].v[j] = facets[i]._aulPoints[j];
+        }
+    }
 
     // Simplification starts
-    alg.simplify_mesh(target_count, tolerance);
+    alg.simplify_mesh(targetSize, tolerance);
 
     // Simplification done
     MeshPointArray new_points;
@@ -75,6 +300,8 @@ void MeshSimplify::simplify(float tolerance, float reduction)
     for (std::size_t i = 0; i < alg.vertices.size(); i++) {
         new_points.push_back(alg.vertices[i].p);
     }
+    std::vector<Simplify::Vertex>().swap(alg.vertices);
+    std::vector<Simplify::Ref>().swap(alg.refs);
 
     std::size_t numFacets = 0;
     for (std::size_t i = 0; i < alg.triangles.size(); i++) {
@@ -92,6 +319,7 @@ void MeshSimplify::simplify(float tolerance, float reduction)
             new_facets.push_back(face);
         }
     }
+    std::vector<Simplify::Triangle>().swap(alg.triangles);
 
     myKernel.Adopt(new_points, new_facets, true);
 }
@@ -24,6 +24,7 @@
 #ifndef MESH_DECIMATION_H
 #define MESH_DECIMATION_H
 
+#include <vector>
 
 namespace MeshCore
 {
@@ -34,10 +35,25 @@ class MeshExport MeshSimplify
 public:
     MeshSimplify(MeshKernel&);
     ~MeshSimplify();
+    /// Removes up to the fraction \a reduction of the facets as long as the
+    /// quadric error of the removed edges is below \a tolerance.
     void simplify(float tolerance, float reduction);
+    /// Removes facets until about \a targetSize facets are left.
+    void simplify(int targetSize);
+    /// Same as simplify(float, float) but the points with the indices
+    /// \a locked are neither moved nor removed. Throws Base::IndexError
+    /// if an index is out of range.
+    void simplify(float tolerance, float reduction, const std::vector<unsigned long>& locked);
+    /// Sets the number of blocks that are simplified in parallel. By default
+    /// it depends on the number of threads and the size of the mesh.
+    void setBlockCount(int count);
+
+private:
+    void decimate(int targetSize, float tolerance, const std::vector<unsigned long>& locked);
 
 private:
     MeshKernel& myKernel;
+    int numBlocks;
 };
 
 } // namespace MeshCore
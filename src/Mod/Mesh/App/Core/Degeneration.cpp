@@ -570,7 +570,8 @@ bool MeshRemoveNeedles::Fixup()
         if (neighbour != ULONG_MAX)
             ce._removeFacets.push_back(neighbour);
 
-        std::set<unsigned long> vf = vf_it[ce._fromPoint];
+        MeshIndexRange faces = vf_it[ce._fromPoint];
+        std::set<unsigned long> vf(faces.begin(), faces.end());
         vf.erase(faceedge.first);
         if (neighbour != ULONG_MAX)
             vf.erase(neighbour);
@@ -660,8 +661,8 @@ bool MeshRemoveNeedles::Fixup()
 
             // Redirect all point-indices to the new neighbour point of all facets referencing the
             // deleted point
-            const std::set<unsigned long>& faces = clPt2Facets[pI->second];
-            for (std::set<unsigned long>::const_iterator pF = faces.begin(); pF != faces.end(); ++pF) {
+            MeshIndexRange faces = clPt2Facets[pI->second];
+            for (MeshIndexRange::const_iterator pF = faces.begin(); pF != faces.end(); ++pF) {
                 const MeshFacet &rclF = f_beg[*pF];
 
                 for (int i = 0; i < 3; i++) {
@@ -876,9 +877,9 @@ bool MeshFixMergeFacets::Fixup()
         if (vv_it[i].size() == 3 && vf_it[i].size() == 3) {
             VertexCollapse vc;
             vc._point = i;
-            const std::set<unsigned long>& adjPts = vv_it[i];
+            MeshIndexRange adjPts = vv_it[i];
             vc._circumPoints.insert(vc._circumPoints.begin(), adjPts.begin(), adjPts.end());
-            const std::set<unsigned long>& adjFts = vf_it[i];
+            MeshIndexRange adjFts = vf_it[i];
             vc._circumFacets.insert(vc._circumFacets.begin(), adjFts.begin(), adjFts.end());
             topAlg.CollapseVertex(vc);
         }
@@ -906,11 +907,11 @@ bool MeshEvalDentsOnSurface::Evaluate()
 
         // get the local neighbourhood of the point
         std::set<unsigned long> nb = clPt2Facets.NeighbourPoints(point,1);
-        const std::set<unsigned long>& faces = clPt2Facets[index];
+        MeshIndexRange faces = clPt2Facets[index];
 
         for (std::set<unsigned long>::iterator pt = nb.begin(); pt != nb.end(); ++pt) {
             const MeshPoint& mp = rPntAry[*pt];
-            for (std::set<unsigned long>::const_iterator
+            for (MeshIndexRange::const_iterator
                 ft = faces.begin(); ft != faces.end(); ++ft) {
                     // the point must not be part of the facet we test
                     if (f_beg[*ft]._aulPoints[0] == *pt)
@@ -922,7 +923,7 @@ bool MeshEvalDentsOnSurface::Evaluate()
                     // is the point projectable onto the facet?
                     rTriangle = _rclMesh.GetFacet(f_beg[*ft]);
                     if (rTriangle.IntersectWithLine(mp,rTriangle.GetNormal(),tmp)) {
-                        const std::set<unsigned long>& f = clPt2Facets[*pt];
+                        MeshIndexRange f = clPt2Facets[*pt];
                         this->indices.insert(this->indices.end(), f.begin(), f.end());
                         break;
                     }
@@ -147,6 +147,37 @@ public:
   unsigned long _ulProp; /**< Free usable property */
 };
 
+/**
+ * The MeshPoint_Less class orders points like MeshPoint::operator< but uses
+ * its own tolerance instead of MeshDefinitions::_fMinPointDistanceD1. This way
+ * an algorithm can merge points with a different tolerance without touching the
+ * global settings.
+ */
+class MeshPoint_Less : public std::binary_function<const MeshPoint&, const MeshPoint&, bool>
+{
+public:
+  /// Uses the current tolerance of MeshDefinitions
+  MeshPoint_Less () : _fTolerance(MeshDefinitions::_fMinPointDistanceD1) { }
+  /// Coordinates that differ by less than \a fTolerance are considered equal
+  explicit MeshPoint_Less (float fTolerance) : _fTolerance(fTolerance) { }
+
+  bool operator () (const MeshPoint& rclP, const MeshPoint& rclQ) const
+  {
+    if (fabs ( rclP.x - rclQ.x ) >= _fTolerance)
+        return rclP.x < rclQ.x;
+    if (fabs ( rclP.y - rclQ.y ) >= _fTolerance)
+        return rclP.y < rclQ.y;
+    if (fabs ( rclP.z - rclQ.z ) >= _fTolerance)
+        return rclP.z < rclQ.z;
+    return false; // points are considered to be equal
+  }
+  float GetTolerance () const
+  { return _fTolerance; }
+
+private:
+  float _fTolerance;
+};
+
 /**
  * The MeshGeomEdge class is geometric counterpart to MeshEdge that holds the 
  * geometric data points of an edge.
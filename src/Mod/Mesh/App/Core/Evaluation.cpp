@@ -25,13 +25,20 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <atomic>
 # include <vector>
 #endif
 
+#include <QFuture>
+#include <QList>
+#include <QThread>
+#include <QtConcurrentRun>
+
 #include <Mod/Mesh/App/WildMagic4/Wm4Matrix3.h>
 #include <Mod/Mesh/App/WildMagic4/Wm4Vector3.h>
 
 #include "Evaluation.h"
+#include "Degeneration.h"
 #include "Iterator.h"
 #include "Algorithm.h"
 #include "Approximation.h"
@@ -46,6 +53,13 @@
 
 using namespace MeshCore;
 
+namespace {
+
+// smaller numbers of elements are handled by the calling thread
+const unsigned long MinParallelCount = 1000;
+
+}
+
 
 MeshOrientationVisitor::MeshOrientationVisitor() : _nonuniformOrientation(false)
 {
@@ -474,10 +488,10 @@ bool MeshEvalPointManifolds::Evaluate ()
     unsigned long ctPoints = _rclMesh.CountPoints();
     for (unsigned long index=0; index < ctPoints; index++) {
         // get the local neighbourhood of the point
-        const std::set<unsigned long>& nf = vf_it[index];
-        const std::set<unsigned long>& np = vv_it[index];
+        MeshCore::MeshIndexRange nf = vf_it[index];
+        MeshCore::MeshIndexRange np = vv_it[index];
 
-        std::set<unsigned long>::size_type sp, sf;
+        MeshCore::MeshIndexRange::size_type sp, sf;
         sp = np.size();
         sf = nf.size();
         // for an inner point the number of adjacent points is equal to the number of shared faces
@@ -757,6 +771,116 @@ void MeshEvalSelfIntersection::GetIntersections(std::vector<std::pair<unsigned l
     }
 }
 
+namespace {
+
+// Intersects each facet of a range with all facets of a higher index that are
+// registered in the same grid cells. Pairs of facets sharing a vertex are skipped,
+// see MeshEvalSelfIntersection::Evaluate().
+struct SelfIntersections
+{
+    typedef void result_type;
+    SelfIntersections(const MeshKernel& mesh, const MeshFacetGrid& grid,
+                      std::vector< std::vector<std::pair<unsigned long, unsigned long> > >& result,
+                      std::atomic<unsigned long>& progress, const std::atomic<bool>& canceled)
+      : mesh(&mesh), grid(&grid), result(&result), progress(&progress), canceled(&canceled) {}
+    void operator()(unsigned long begin, unsigned long end, int block) const
+    {
+        std::vector<std::pair<unsigned long, unsigned long> >& pairs = (*result)[block];
+        const MeshFacetArray& rFaces = mesh->GetFacets();
+        std::vector<unsigned long> candidates;
+        Base::Vector3f pt1, pt2;
+        for (unsigned long i = begin; i < end; i++) {
+            if ((i - begin) % ProgressStep == 0 && i > begin) {
+                progress->fetch_add(ProgressStep);
+                if (*canceled)
+                    return;
+            }
+            MeshGeomFacet facet1 = mesh->GetFacet(i);
+            Base::BoundBox3f box1 = facet1.GetBoundBox();
+            const MeshFacet& rface1 = rFaces[i];
+            grid->Inside(box1, candidates);
+            for (std::vector<unsigned long>::iterator it = candidates.begin(); it != candidates.end(); ++it) {
+                if (*it <= i)
+                    continue;
+                const MeshFacet& rface2 = rFaces[*it];
+                bool common = false;
+                for (int j = 0; j < 3 && !common; j++) {
+                    if (rface1._aulPoints[j] == rface2._aulPoints[0] ||
+                        rface1._aulPoints[j] == rface2._aulPoints[1] ||
+                        rface1._aulPoints[j] == rface2._aulPoints[2])
+                        common = true;
+                }
+                if (common)
+                    continue; // ignore facets sharing a common vertex
+
+                MeshGeomFacet facet2 = mesh->GetFacet(rface2);
+                if (box1 && facet2.GetBoundBox()) {
+                    if (facet1.IntersectWithFacet(facet2, pt1, pt2) == 2)
+                        pairs.push_back(std::make_pair(i, *it));
+                }
+            }
+        }
+    }
+
+    const MeshKernel* mesh;
+    const MeshFacetGrid* grid;
+    std::vector< std::vector<std::pair<unsigned long, unsigned long> > >* result;
+    std::atomic<unsigned long>* progress;
+    const std::atomic<bool>* canceled;
+    // the number of facets after which a block reports its progress
+    static const unsigned long ProgressStep = 256;
+};
+
+// Passes the progress of the blocks to the sequencer in the calling thread
+struct SelfIntersectionProgress
+{
+    SelfIntersectionProgress(Base::SequencerLauncher& seq, const std::atomic<unsigned long>& progress,
+                             std::atomic<bool>& canceled)
+      : seq(seq), progress(progress), canceled(canceled), reported(0) {}
+    void operator()()
+    {
+        try {
+            unsigned long count = progress;
+            for (; reported < count; reported++)
+                seq.next(true);
+        }
+        catch (...) {
+            // let the blocks stop early
+            canceled = true;
+            throw;
+        }
+    }
+
+    Base::SequencerLauncher& seq;
+    const std::atomic<unsigned long>& progress;
+    std::atomic<bool>& canceled;
+    unsigned long reported;
+};
+
+}
+
+void MeshEvalSelfIntersection::GetIntersections(const MeshFacetGrid& rGrid,
+                                                std::vector<std::pair<unsigned long, unsigned long> >& intersection) const
+{
+    // the facets are split into blocks and the results are merged in facet order
+    // so that the outcome doesn't depend on the number of threads
+    unsigned long numFacets = _rclMesh.CountFacets();
+    int blocks = count_blocks(numFacets, MinParallelCount);
+    std::vector< std::vector<std::pair<unsigned long, unsigned long> > > result(blocks);
+
+    // the sequencer isn't thread-safe, so the blocks only count their progress
+    // and the calling thread reports it and throws an AbortException if the
+    // user cancels the operation
+    Base::SequencerLauncher seq("Checking for self-intersections...", numFacets);
+    std::atomic<unsigned long> progress(0);
+    std::atomic<bool> canceled(false);
+    SelfIntersectionProgress poll(seq, progress, canceled);
+    parallel_blocks(numFacets, blocks, SelfIntersections(_rclMesh, rGrid, result, progress, canceled), poll);
+
+    for (std::vector< std::vector<std::pair<unsigned long, unsigned long> > >::iterator it = result.begin(); it != result.end(); ++it)
+        intersection.insert(intersection.end(), it->begin(), it->end());
+}
+
 std::vector<unsigned long> MeshFixSelfIntersection::GetFacets() const
 {
     std::vector<unsigned long> indices;
@@ -1029,6 +1153,273 @@ void MeshKernel::RebuildNeighbours (void)
 
 // ----------------------------------------------------------------
 
+namespace {
+
+// Returns the position of a MeshEvalHealth::Check flag in the array of results
+int CheckPosition(int check)
+{
+    int pos = 0;
+    while (check > 1) {
+        check >>= 1;
+        pos++;
+    }
+    return pos;
+}
+
+void WaitForFinished(QList<QFuture<void> >& futures)
+{
+    for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+        it->waitForFinished();
+}
+
+}
+
+MeshEvalHealth::MeshEvalHealth (const MeshKernel &rclB, int checks, float fEps)
+  : MeshEvaluation(rclB), _checks(checks), _defects(0), _fEpsilon(fEps), _indexDefect(NoIndexDefect)
+{
+}
+
+MeshEvalHealth::~MeshEvalHealth()
+{
+}
+
+const std::vector<unsigned long>& MeshEvalHealth::GetIndices (Check check) const
+{
+    return _indices[CheckPosition(check)];
+}
+
+std::vector<unsigned long>& MeshEvalHealth::Result (Check check)
+{
+    return _indices[CheckPosition(check)];
+}
+
+bool MeshEvalHealth::Evaluate ()
+{
+    _defects = 0;
+    _indexDefect = NoIndexDefect;
+    for (int i=0; i<9; i++)
+        _indices[i].clear();
+    _neighbours.clear();
+
+    // The orientation check sets the flags of the facets, so it must be done
+    // before the other checks read the facets.
+    if (_checks & Orientation)
+        CheckOrientation();
+
+    // Each task only writes its own results. No sequencer is used by the
+    // tasks because they don't run in the GUI thread.
+    QList<QFuture<void> > futures;
+    if (_checks & (NonManifolds | Indices))
+        futures << QtConcurrent::run(this, &MeshEvalHealth::CheckEdges);
+    if (_checks & NonManifoldPoints)
+        futures << QtConcurrent::run(this, &MeshEvalHealth::CheckNonManifoldPoints);
+    if (_checks & Indices)
+        futures << QtConcurrent::run(this, &MeshEvalHealth::CheckRanges);
+    if (_checks & Degenerations)
+        futures << QtConcurrent::run(this, &MeshEvalHealth::CheckDegenerations);
+    if (_checks & DuplicatedFacets)
+        futures << QtConcurrent::run(this, &MeshEvalHealth::CheckDuplicatedFacets);
+    if (_checks & DuplicatedPoints)
+        futures << QtConcurrent::run(this, &MeshEvalHealth::CheckDuplicatedPoints);
+    if (_checks & Folds)
+        futures << QtConcurrent::run(this, &MeshEvalHealth::CheckFolds);
+
+    // The check for self-intersections splits up its work itself and may be
+    // aborted by the user. The tasks still use this object, so they must have
+    // finished before the exception is passed on.
+    try {
+        if (_checks & SelfIntersections)
+            CheckSelfIntersections();
+    }
+    catch (...) {
+        WaitForFinished(futures);
+        throw;
+    }
+
+    WaitForFinished(futures);
+
+    // invalid neighbour indices are reported last because the other index
+    // defects usually cause them, too
+    if (_indexDefect == NoIndexDefect && !_neighbours.empty()) {
+        _indexDefect = InvalidNeighbourIndices;
+        Result(Indices).swap(_neighbours);
+    }
+    if (_indexDefect != NoIndexDefect)
+        _defects |= Indices;
+
+    static const Check found[] = {NonManifolds, NonManifoldPoints, Degenerations,
+        DuplicatedFacets, DuplicatedPoints, SelfIntersections, Folds};
+    for (std::size_t i = 0; i < sizeof(found) / sizeof(found[0]); i++) {
+        if (!GetIndices(found[i]).empty())
+            _defects |= found[i];
+    }
+
+    return _defects == 0;
+}
+
+void MeshEvalHealth::CheckEdges ()
+{
+    // The sorted edge list serves the non-manifold and the neighbourhood check,
+    // see MeshEvalTopology and MeshEvalNeighbourhood
+    const MeshFacetArray& rFacets = _rclMesh.GetFacets();
+    std::vector<Edge_Index> edges;
+    edges.reserve(3*rFacets.size());
+    for (MeshFacetArray::_TConstIterator pI = rFacets.begin(); pI != rFacets.end(); ++pI) {
+        for (int i = 0; i < 3; i++) {
+            Edge_Index item;
+            item.p0 = std::min<unsigned long>(pI->_aulPoints[i], pI->_aulPoints[(i+1)%3]);
+            item.p1 = std::max<unsigned long>(pI->_aulPoints[i], pI->_aulPoints[(i+1)%3]);
+            item.f  = pI - rFacets.begin();
+            edges.push_back(item);
+        }
+    }
+
+    int threads = std::max(1, QThread::idealThreadCount());
+    MeshCore::parallel_sort(edges.begin(), edges.end(), Edge_Less(), threads);
+
+    std::vector<unsigned long>& nonManifolds = Result(NonManifolds);
+    std::vector<Edge_Index>::iterator pE = edges.begin();
+    while (pE != edges.end()) {
+        std::vector<Edge_Index>::iterator pN = pE + 1;
+        while (pN != edges.end() && pN->p0 == pE->p0 && pN->p1 == pE->p1)
+            ++pN;
+
+        std::ptrdiff_t count = pN - pE;
+        if (count > 2) {
+            // edge that is shared by more than two facets
+            if (_checks & NonManifolds) {
+                nonManifolds.push_back(pE->p0);
+                nonManifolds.push_back(pE->p1);
+            }
+        }
+        else if (count == 2) {
+            // both facets must reference each other as neighbours
+            unsigned long f0 = pE->f, f1 = (pE+1)->f;
+            const MeshFacet& rFace0 = rFacets[f0];
+            const MeshFacet& rFace1 = rFacets[f1];
+            unsigned short side0 = rFace0.Side(pE->p0, pE->p1);
+            unsigned short side1 = rFace1.Side(pE->p0, pE->p1);
+            if (rFace0._aulNeighbours[side0] != f1 || rFace1._aulNeighbours[side1] != f0) {
+                _neighbours.push_back(f0);
+                _neighbours.push_back(f1);
+            }
+        }
+        else {
+            // should be "open edge"
+            const MeshFacet& rFace = rFacets[pE->f];
+            unsigned short side = rFace.Side(pE->p0, pE->p1);
+            if (rFace._aulNeighbours[side] != ULONG_MAX)
+                _neighbours.push_back(pE->f);
+        }
+
+        pE = pN;
+    }
+
+    if (_checks & Indices) {
+        std::sort(_neighbours.begin(), _neighbours.end());
+        _neighbours.erase(std::unique(_neighbours.begin(), _neighbours.end()), _neighbours.end());
+    }
+    else {
+        _neighbours.clear();
+    }
+}
+
+void MeshEvalHealth::CheckNonManifoldPoints ()
+{
+    MeshEvalPointManifolds eval(_rclMesh);
+    if (!eval.Evaluate())
+        Result(NonManifoldPoints) = eval.GetIndices();
+}
+
+void MeshEvalHealth::CheckRanges ()
+{
+    MeshEvalRangeFacet rf(_rclMesh);
+    MeshEvalRangePoint rp(_rclMesh);
+    MeshEvalCorruptedFacets cf(_rclMesh);
+    if (!rf.Evaluate()) {
+        _indexDefect = InvalidFacetIndices;
+        Result(Indices) = rf.GetIndices();
+    }
+    else if (!rp.Evaluate()) {
+        _indexDefect = InvalidPointIndices;
+        Result(Indices) = rp.GetIndices();
+    }
+    else if (!cf.Evaluate()) {
+        _indexDefect = CorruptedFacets;
+        Result(Indices) = cf.GetIndices();
+    }
+}
+
+void MeshEvalHealth::CheckDegenerations ()
+{
+    MeshEvalDegeneratedFacets eval(_rclMesh, _fEpsilon);
+    Result(Degenerations) = eval.GetIndices();
+}
+
+void MeshEvalHealth::CheckDuplicatedFacets ()
+{
+    MeshEvalDuplicateFacets eval(_rclMesh);
+    Result(DuplicatedFacets) = eval.GetIndices();
+}
+
+void MeshEvalHealth::CheckDuplicatedPoints ()
+{
+    MeshEvalDuplicatePoints eval(_rclMesh);
+    Result(DuplicatedPoints) = eval.GetIndices();
+}
+
+void MeshEvalHealth::CheckFolds ()
+{
+    MeshEvalFoldsOnSurface s_eval(_rclMesh);
+    MeshEvalFoldsOnBoundary b_eval(_rclMesh);
+    MeshEvalFoldOversOnSurface f_eval(_rclMesh);
+
+    std::vector<unsigned long>& inds = Result(Folds);
+    if (!f_eval.Evaluate())
+        inds = f_eval.GetIndices();
+    if (!s_eval.Evaluate()) {
+        std::vector<unsigned long> inds1 = s_eval.GetIndices();
+        inds.insert(inds.end(), inds1.begin(), inds1.end());
+    }
+    if (!b_eval.Evaluate()) {
+        std::vector<unsigned long> inds2 = b_eval.GetIndices();
+        inds.insert(inds.end(), inds2.begin(), inds2.end());
+    }
+
+    // remove duplicates
+    std::sort(inds.begin(), inds.end());
+    inds.erase(std::unique(inds.begin(), inds.end()), inds.end());
+}
+
+void MeshEvalHealth::CheckOrientation ()
+{
+    MeshEvalOrientation eval(_rclMesh);
+    if (!eval.Evaluate()) {
+        _defects |= Orientation;
+        Result(Orientation) = eval.GetIndices();
+    }
+}
+
+void MeshEvalHealth::CheckSelfIntersections ()
+{
+    unsigned long ulX, ulY, ulZ;
+    MeshFacetGrid::CalculateGridSize(_rclMesh, ulX, ulY, ulZ);
+    MeshFacetGrid grid(_rclMesh, ulX, ulY, ulZ);
+
+    std::vector<std::pair<unsigned long, unsigned long> > pairs;
+    MeshEvalSelfIntersection eval(_rclMesh);
+    eval.GetIntersections(grid, pairs);
+
+    std::vector<unsigned long>& inds = Result(SelfIntersections);
+    inds.reserve(2*pairs.size());
+    for (std::vector<std::pair<unsigned long, unsigned long> >::iterator it = pairs.begin(); it != pairs.end(); ++it) {
+        inds.push_back(it->first);
+        inds.push_back(it->second);
+    }
+}
+
+// ----------------------------------------------------------------
+
 MeshEigensystem::MeshEigensystem (const MeshKernel &rclB)
   : MeshEvaluation(rclB), _cU(1.0f, 0.0f, 0.0f), _cV(0.0f, 1.0f, 0.0f), _cW(0.0f, 0.0f, 1.0f)
 {
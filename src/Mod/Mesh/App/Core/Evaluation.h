@@ -32,6 +32,8 @@
 
 namespace MeshCore {
 
+class MeshFacetGrid;
+
 /**
  * The MeshEvaluation class checks the mesh kernel for correctness with respect to a
  * certain criterion, such as manifoldness, self-intersections, etc.
@@ -297,6 +299,13 @@ public:
         std::vector<std::pair<Base::Vector3f, Base::Vector3f> >&) const;
     /// collect the index of all facets with self intersections
     void GetIntersections(std::vector<std::pair<unsigned long, unsigned long> >&) const;
+    /**
+     * Collects the index of all facets with self intersections using the
+     * already built grid \a rGrid. The grid cells are checked in parallel
+     * and each pair of facets is reported only once.
+     */
+    void GetIntersections(const MeshFacetGrid& rGrid,
+        std::vector<std::pair<unsigned long, unsigned long> >&) const;
 };
 
 /**
@@ -346,6 +355,88 @@ public:
 
 // ----------------------------------------------------
 
+/**
+ * The MeshEvalHealth class runs several of the above checks in one go.
+ * The data structures that are needed by more than one check, i.e. the
+ * sorted edge list and the facet grid, are only built once and all
+ * enabled checks run in parallel. Afterwards the result of each check can
+ * be queried with HasDefect() and GetIndices().
+ * @author Werner Mayer
+ */
+class MeshExport MeshEvalHealth : public MeshEvaluation
+{
+public:
+  enum Check {
+    Orientation       = 0x001, /**< flipped normals (facet indices) */
+    NonManifolds      = 0x002, /**< non-manifold edges (pairs of point indices) */
+    NonManifoldPoints = 0x004, /**< non-manifold points (point indices) */
+    Indices           = 0x008, /**< invalid indices (facet indices), see GetIndexDefect() */
+    Degenerations     = 0x010, /**< degenerated facets (facet indices) */
+    DuplicatedFacets  = 0x020, /**< duplicated facets (facet indices) */
+    DuplicatedPoints  = 0x040, /**< duplicated points (point indices) */
+    SelfIntersections = 0x080, /**< self-intersections (pairs of facet indices) */
+    Folds             = 0x100, /**< folds on the surface (facet indices) */
+    AllChecks         = 0x1ff
+  };
+  /** The first defect found by the Indices check. */
+  enum IndexDefect {
+    NoIndexDefect,
+    InvalidFacetIndices,     /**< see MeshEvalRangeFacet */
+    InvalidPointIndices,     /**< see MeshEvalRangePoint */
+    CorruptedFacets,         /**< see MeshEvalCorruptedFacets */
+    InvalidNeighbourIndices  /**< see MeshEvalNeighbourhood */
+  };
+
+  /**
+   * Construction. \a checks is a combination of Check flags and \a fEps is
+   * the tolerance passed to MeshEvalDegeneratedFacets.
+   */
+  MeshEvalHealth (const MeshKernel &rclB, int checks = AllChecks, float fEps = 0.0f);
+  ~MeshEvalHealth ();
+  /** Sets the checks that are run by the next call of Evaluate(). */
+  void SetChecks (int checks) { _checks = checks; }
+  int GetChecks () const { return _checks; }
+  /**
+   * Runs all enabled checks and returns true if none of them has found a defect.
+   * The orientation check uses the flags of the mesh kernel and therefore runs
+   * in the calling thread while the other checks run in worker threads.
+   */
+  bool Evaluate ();
+  /** Returns the combination of all checks that have found a defect. */
+  int GetDefects () const { return _defects; }
+  bool HasDefect (Check check) const { return (_defects & check) != 0; }
+  /**
+   * Returns the indices found by the given check. For NonManifolds and
+   * SelfIntersections the index pairs are stored one after another.
+   */
+  const std::vector<unsigned long>& GetIndices (Check check) const;
+  IndexDefect GetIndexDefect () const { return _indexDefect; }
+  /** Returns the number of non-manifold edges. */
+  unsigned long CountNonManifolds () const { return GetIndices(NonManifolds).size() / 2; }
+
+private:
+  void CheckEdges ();
+  void CheckNonManifoldPoints ();
+  void CheckRanges ();
+  void CheckDegenerations ();
+  void CheckDuplicatedFacets ();
+  void CheckDuplicatedPoints ();
+  void CheckFolds ();
+  void CheckOrientation ();
+  void CheckSelfIntersections ();
+  std::vector<unsigned long>& Result (Check check);
+
+private:
+  int _checks;
+  int _defects;
+  float _fEpsilon;
+  IndexDefect _indexDefect;
+  std::vector<unsigned long> _indices[9];
+  std::vector<unsigned long> _neighbours;
+};
+
+// ----------------------------------------------------
+
 /**
  * The MeshEigensystem class actually does not try to check for or fix errors but
  * it provides methods to calculate the mesh's local coordinate system with the center
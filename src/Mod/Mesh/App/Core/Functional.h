@@ -25,12 +25,157 @@
 #define MESH_FUNCTIONAL_H
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <thread>
+#include <vector>
 #include <QtConcurrentRun>
 #include <QFuture>
+#include <QList>
 #include <QThread>
 
 namespace MeshCore
 {
+    namespace detail
+    {
+        // Runs a block and keeps the exception it throws for the calling thread
+        template <class Func>
+        struct BlockTask
+        {
+            typedef void result_type;
+            BlockTask(const Func& func, std::exception_ptr* error)
+              : func(func), error(error)
+            {
+            }
+            void operator()(unsigned long begin, unsigned long end, int block) const
+            {
+                try {
+                    func(begin, end, block);
+                }
+                catch (...) {
+                    *error = std::current_exception();
+                }
+            }
+            Func func;
+            std::exception_ptr* error;
+        };
+
+        // Adapts a functor taking a range to parallel_blocks()
+        template <class Func>
+        struct RangeTask
+        {
+            RangeTask(const Func& func) : func(func)
+            {
+            }
+            void operator()(unsigned long begin, unsigned long end, int) const
+            {
+                func(begin, end);
+            }
+            Func func;
+        };
+    }
+
+    /**
+     * Returns the number of blocks parallel_blocks() should split \a count
+     * elements into: one per thread, or a single block that the calling thread
+     * processes if there are fewer than \a minCount elements.
+     */
+    inline int count_blocks(unsigned long count, unsigned long minCount)
+    {
+        return count < minCount ? 1 : std::max(1, QThread::idealThreadCount());
+    }
+
+    /**
+     * Calls func(begin, end, block) for \a blocks consecutive ranges of [0, count).
+     * The blocks are run by the global thread pool, so more blocks than threads
+     * balance uneven work. A single block is run by the calling thread.
+     * If a block throws an exception the first one is rethrown after all
+     * blocks have finished.
+     */
+    template <class Func>
+    void parallel_blocks(unsigned long count, int blocks, const Func& func)
+    {
+        if (blocks <= 1) {
+            func(0, count, 0);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(blocks);
+        QList<QFuture<void> > futures;
+        for (int i=0; i<blocks; i++) {
+            unsigned long begin = static_cast<unsigned long>((static_cast<uint64_t>(count) * i) / blocks);
+            unsigned long end = static_cast<unsigned long>((static_cast<uint64_t>(count) * (i + 1)) / blocks);
+            futures << QtConcurrent::run(detail::BlockTask<Func>(func, &errors[i]), begin, end, i);
+        }
+        for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+            it->waitForFinished();
+        for (std::vector<std::exception_ptr>::iterator it = errors.begin(); it != errors.end(); ++it) {
+            if (*it)
+                std::rethrow_exception(*it);
+        }
+    }
+
+    /**
+     * Like parallel_blocks() but the calling thread calls poll() every few
+     * milliseconds until all blocks have finished, e.g. to report the progress
+     * of the blocks to the sequencer which is not thread-safe. If poll() throws,
+     * e.g. because the user canceled the operation, it isn't called any more and
+     * its exception is rethrown after the blocks have finished. The blocks should
+     * check a flag that poll() sets in this case to stop early.
+     * A single block is run by the calling thread without polling.
+     */
+    template <class Func, class Poll>
+    void parallel_blocks(unsigned long count, int blocks, const Func& func, Poll& poll)
+    {
+        if (blocks <= 1) {
+            func(0, count, 0);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(blocks);
+        QList<QFuture<void> > futures;
+        for (int i=0; i<blocks; i++) {
+            unsigned long begin = static_cast<unsigned long>((static_cast<uint64_t>(count) * i) / blocks);
+            unsigned long end = static_cast<unsigned long>((static_cast<uint64_t>(count) * (i + 1)) / blocks);
+            futures << QtConcurrent::run(detail::BlockTask<Func>(func, &errors[i]), begin, end, i);
+        }
+
+        std::exception_ptr pollError;
+        for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ) {
+            if (it->isFinished()) {
+                ++it;
+                continue;
+            }
+            if (!pollError) {
+                try {
+                    poll();
+                }
+                catch (...) {
+                    pollError = std::current_exception();
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        if (pollError)
+            std::rethrow_exception(pollError);
+        for (std::vector<std::exception_ptr>::iterator it = errors.begin(); it != errors.end(); ++it) {
+            if (*it)
+                std::rethrow_exception(*it);
+        }
+    }
+
+    /**
+     * Calls func(begin, end) for consecutive ranges of [0, count) with one
+     * thread per range, see count_blocks().
+     */
+    template <class Func>
+    void parallel_for(unsigned long count, unsigned long minCount, const Func& func)
+    {
+        parallel_blocks(count, count_blocks(count, minCount), detail::RangeTask<Func>(func));
+    }
+
     template <class Iter, class Pred>
     static void parallel_sort(Iter begin, Iter end, Pred comp, int threads)
     {
@@ -27,6 +27,11 @@
 # include <algorithm>
 #endif
 
+#include <QFuture>
+#include <QList>
+#include <QThread>
+#include <QtConcurrentRun>
+
 #include "Grid.h"
 #include "Iterator.h"
 
@@ -636,6 +641,53 @@ unsigned long MeshGrid::GetElements(const Base::Vector3f &rclPoint, std::vector<
   return aulFacets.size();
 }
 
+bool MeshGrid::RebuildGridParallel (void)
+{
+  unsigned long ulCtElements = HasElements();
+  int threads = std::max(1, QThread::idealThreadCount());
+  if (threads < 2 || ulCtElements < MESH_MIN_PARALLEL_GRID || _ulCtGridsX < 2)
+    return false;
+
+  // First pass: each thread computes the grid indices for a range of the elements
+  std::size_t ctSlabs = std::min<std::size_t>(threads, _ulCtGridsX);
+  std::vector<std::vector<GridElementList> > elements(threads, std::vector<GridElementList>(ctSlabs));
+  unsigned long ulStep = (ulCtElements + threads - 1) / threads;
+  QList<QFuture<void> > futures;
+  for (int i = 0; i < threads; i++) {
+    unsigned long ulBegin = std::min<unsigned long>(i * ulStep, ulCtElements);
+    unsigned long ulEnd = std::min<unsigned long>(ulBegin + ulStep, ulCtElements);
+    futures << QtConcurrent::run(this, &MeshGrid::CollectElements, ulBegin, ulEnd, &elements[i]);
+  }
+  for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+    it->waitForFinished();
+
+  // Second pass: each thread fills the grid elements of a slab in x direction
+  futures.clear();
+  for (std::size_t i = 0; i < ctSlabs; i++)
+    futures << QtConcurrent::run(this, &MeshGrid::FillSlab, &elements, i);
+  for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+    it->waitForFinished();
+
+  return true;
+}
+
+void MeshGrid::FillSlab (const std::vector<std::vector<GridElementList> >* pElements, std::size_t slab)
+{
+  // The element indices are ascending for all threads, so they can be appended
+  // at the end of the sets in constant time
+  unsigned long ulCtXY = _ulCtGridsX * _ulCtGridsY;
+  for (std::vector<std::vector<GridElementList> >::const_iterator it = pElements->begin(); it != pElements->end(); ++it) {
+    const GridElementList& rList = (*it)[slab];
+    for (GridElementList::const_iterator jt = rList.begin(); jt != rList.end(); ++jt) {
+      unsigned long ulX = jt->first % _ulCtGridsX;
+      unsigned long ulY = (jt->first / _ulCtGridsX) % _ulCtGridsY;
+      unsigned long ulZ = jt->first / ulCtXY;
+      std::set<unsigned long>& rSet = _aulGrid[ulX][ulY][ulZ];
+      rSet.insert(rSet.end(), jt->second);
+    }
+  }
+}
+
 unsigned long MeshGrid::GetIndexToPosition(unsigned long ulX, unsigned long ulY, unsigned long ulZ) const
 {
   if ( !CheckPos(ulX, ulY, ulZ) )
@@ -689,6 +741,32 @@ MeshFacetGrid::MeshFacetGrid (const MeshKernel &rclM, float fGridLen)
           std::max<unsigned long>((unsigned long)(clBBMesh.LengthZ() / fGridLen), 1));
 }
 
+void MeshFacetGrid::CalculateGridSize (const MeshKernel &rclM, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ)
+{
+  const MeshPointArray& rPoints = rclM.GetPoints();
+  const MeshFacetArray& rFacets = rclM.GetFacets();
+  double length = 0.0;
+  for (MeshFacetArray::_TConstIterator it = rFacets.begin(); it != rFacets.end(); ++it) {
+    for (int i=0; i<3; i++)
+      length += Base::Distance(rPoints[it->_aulPoints[i]], rPoints[it->_aulPoints[(i+1)%3]]);
+  }
+
+  rulX = rulY = rulZ = 1;
+  if (rFacets.empty() || length <= 0.0)
+    return;
+
+  Base::BoundBox3f clBBMesh = rclM.GetBoundBox();
+  double cellLen = 2.0 * length / (3.0 * rFacets.size());
+  double maxCells = std::max<double>(MESH_MAX_GRIDS, rFacets.size());
+  double numCells = (clBBMesh.LengthX() / cellLen + 1.0) * (clBBMesh.LengthY() / cellLen + 1.0) * (clBBMesh.LengthZ() / cellLen + 1.0);
+  if (numCells > maxCells)
+    cellLen *= pow(numCells / maxCells, 1.0 / 3.0);
+
+  rulX = std::max<unsigned long>(static_cast<unsigned long>(clBBMesh.LengthX() / cellLen), 1);
+  rulY = std::max<unsigned long>(static_cast<unsigned long>(clBBMesh.LengthY() / cellLen), 1);
+  rulZ = std::max<unsigned long>(static_cast<unsigned long>(clBBMesh.LengthZ() / cellLen), 1);
+}
+
 void MeshFacetGrid::Validate (const MeshKernel &rclMesh)
 {
   if (_pclMesh != &rclMesh)
@@ -735,6 +813,9 @@ void MeshFacetGrid::RebuildGrid (void)
   _ulCtElements = _pclMesh->CountFacets();
 
   InitGrid();
+
+  if (RebuildGridParallel())
+    return;
  
   // Daten-Struktur fuellen
   MeshFacetIterator clFIter(*_pclMesh);
@@ -748,6 +829,40 @@ void MeshFacetGrid::RebuildGrid (void)
 
 }
 
+void MeshFacetGrid::CollectElements (unsigned long ulBegin, unsigned long ulEnd,
+                                     std::vector<GridElementList>* pElements) const
+{
+  // see AddFacet()
+  std::size_t ctSlabs = pElements->size();
+  for (unsigned long ulFacet = ulBegin; ulFacet < ulEnd; ulFacet++) {
+    MeshGeomFacet clFacet = _pclMesh->GetFacet(ulFacet);
+
+    Base::BoundBox3f clBB;
+    clBB.Add(clFacet._aclPoints[0]);
+    clBB.Add(clFacet._aclPoints[1]);
+    clBB.Add(clFacet._aclPoints[2]);
+
+    unsigned long ulX1, ulY1, ulZ1, ulX2, ulY2, ulZ2;
+    Pos(Base::Vector3f(clBB.MinX,clBB.MinY,clBB.MinZ), ulX1, ulY1, ulZ1);
+    Pos(Base::Vector3f(clBB.MaxX,clBB.MaxY,clBB.MaxZ), ulX2, ulY2, ulZ2);
+
+    if ((ulX1 < ulX2) || (ulY1 < ulY2) || (ulZ1 < ulZ2)) {
+      for (unsigned long ulX = ulX1; ulX <= ulX2; ulX++) {
+        GridElementList& rList = (*pElements)[GetSlab(ulX, ctSlabs)];
+        for (unsigned long ulY = ulY1; ulY <= ulY2; ulY++) {
+          for (unsigned long ulZ = ulZ1; ulZ <= ulZ2; ulZ++) {
+            if (clFacet.IntersectBoundingBox(GetBoundBox(ulX, ulY, ulZ)))
+              rList.push_back(std::make_pair(GetIndexToPosition(ulX, ulY, ulZ), ulFacet));
+          }
+        }
+      }
+    }
+    else {
+      (*pElements)[GetSlab(ulX1, ctSlabs)].push_back(std::make_pair(GetIndexToPosition(ulX1, ulY1, ulZ1), ulFacet));
+    }
+  }
+}
+
 unsigned long MeshFacetGrid::SearchNearestFromPoint (const Base::Vector3f &rclPt) const
 {
   unsigned long ulFacetInd = ULONG_MAX;
@@ -1001,6 +1116,21 @@ void MeshPointGrid::AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, f
     _aulGrid[ulX][ulY][ulZ].insert(ulPtIndex);
 }
 
+void MeshPointGrid::CollectElements (unsigned long ulBegin, unsigned long ulEnd,
+                                     std::vector<GridElementList>* pElements) const
+{
+  // see AddPoint()
+  std::size_t ctSlabs = pElements->size();
+  const MeshPointArray& rPoints = _pclMesh->GetPoints();
+  for (unsigned long ulPoint = ulBegin; ulPoint < ulEnd; ulPoint++) {
+    const MeshPoint& rclPt = rPoints[ulPoint];
+    unsigned long ulX, ulY, ulZ;
+    Pos(Base::Vector3f(rclPt.x, rclPt.y, rclPt.z), ulX, ulY, ulZ);
+    if ( (ulX < _ulCtGridsX) && (ulY < _ulCtGridsY) && (ulZ < _ulCtGridsZ) )
+      (*pElements)[GetSlab(ulX, ctSlabs)].push_back(std::make_pair(GetIndexToPosition(ulX, ulY, ulZ), ulPoint));
+  }
+}
+
 void MeshPointGrid::Validate (const MeshKernel &rclMesh)
 {
   if (_pclMesh != &rclMesh)
@@ -1047,6 +1177,9 @@ void MeshPointGrid::RebuildGrid (void)
   _ulCtElements = _pclMesh->CountPoints();
 
   InitGrid();
+
+  if (RebuildGridParallel())
+    return;
  
   // Daten-Struktur fuellen
 
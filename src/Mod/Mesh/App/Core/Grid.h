@@ -33,6 +33,7 @@
 #define  MESH_CT_GRID          256     // Default value for number of elements per grid
 #define  MESH_MAX_GRIDS        100000  // Default value for maximum number of grids
 #define  MESH_CT_GRID_PER_AXIS 20
+#define  MESH_MIN_PARALLEL_GRID 100000 // Minimum number of elements to build a grid in parallel
 
 
 namespace MeshCore {
@@ -156,6 +157,25 @@ protected:
   /** Returns the number of stored elements. Must be implemented in sub-classes. */
   virtual unsigned long HasElements (void) const = 0;
 
+  /** List of pairs of a grid index (see GetIndexToPosition()) and an element index. */
+  typedef std::vector<std::pair<unsigned long, unsigned long> > GridElementList;
+  /** Fills the grid structure with several threads. Each thread collects the grid elements
+   * of a range of the elements with CollectElements(), then each thread inserts the elements
+   * of a slab of the grid in x direction. Returns false if there are too few elements to do
+   * this in parallel and nothing is done.
+   * @note InitGrid() must be called before.
+   */
+  bool RebuildGridParallel (void);
+  /** Collects the grid indices of the elements in the range [\a ulBegin, \a ulEnd) sorted by
+   * the slabs in x direction, see GetSlab(). Must be implemented in sub-classes. */
+  virtual void CollectElements (unsigned long ulBegin, unsigned long ulEnd,
+                                std::vector<GridElementList>* pElements) const = 0;
+  /** Inserts the collected elements of the given slab into the grid structure. */
+  void FillSlab (const std::vector<std::vector<GridElementList> >* pElements, std::size_t slab);
+  /** Returns the slab of the grid in x direction for the position \a ulX. */
+  std::size_t GetSlab (unsigned long ulX, std::size_t ctSlabs) const
+  { return static_cast<std::size_t>(ulX) * ctSlabs / _ulCtGridsX; }
+
 protected:
   std::vector<std::vector<std::vector<std::set<unsigned long> > > >  _aulGrid;   /**< Grid data structure. */
   const MeshKernel* _pclMesh;     /**< The mesh kernel. */
@@ -196,6 +216,11 @@ public:
   /// Destruction
   virtual ~MeshFacetGrid (void) { }
   //@}
+
+  /** Computes the number of grid cells per axis so that the cells are about twice as
+   * long as the edges of the facets of \a rclM. The total number of cells is limited
+   * to the number of facets or MESH_MAX_GRIDS, whichever is higher. */
+  static void CalculateGridSize (const MeshKernel &rclM, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ);
  
   /** @name Search */
   //@{
@@ -228,6 +253,9 @@ protected:
    * the corresponding index in the mesh kernel. The facet is added to each grid element that intersects 
    * the facet. */
   inline void AddFacet (const MeshGeomFacet &rclFacet, unsigned long ulFacetIndex, float fEpsilon = 0.0f);
+  /** Collects the grid indices of the facets in the given range, see AddFacet(). */
+  virtual void CollectElements (unsigned long ulBegin, unsigned long ulEnd,
+                                std::vector<GridElementList>* pElements) const;
   /** Returns the number of stored elements. */
   unsigned long HasElements (void) const
   { return _pclMesh->CountFacets(); }
@@ -271,6 +299,9 @@ protected:
   /** Adds a new point element to the grid structure. \a rclPt is the geometric point and \a ulPtIndex 
    * the corresponding index in the mesh kernel. */
   void AddPoint (const MeshPoint &rclPt, unsigned long ulPtIndex, float fEpsilon = 0.0f);
+  /** Collects the grid indices of the points in the given range, see AddPoint(). */
+  virtual void CollectElements (unsigned long ulBegin, unsigned long ulEnd,
+                                std::vector<GridElementList>* pElements) const;
   /** Returns the grid numbers to the given point \a rclPoint. */
   void Pos(const Base::Vector3f &rclPoint, unsigned long &rulX, unsigned long &rulY, unsigned long &rulZ) const;
   /** Returns the number of stored elements. */
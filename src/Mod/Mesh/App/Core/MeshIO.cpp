@@ -40,15 +40,23 @@
 #include <Base/Stream.h>
 #include <Base/Placement.h>
 #include <Base/Tools.h>
+#include <Base/Swap.h>
 #include <zipios++/gzipoutputstream.h>
 
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <QFile>
+#include <QFuture>
+#include <QList>
+#include <QThread>
+#include <QtConcurrentRun>
 
 
 using namespace MeshCore;
@@ -148,6 +156,20 @@ bool MeshInput::LoadAny(const char* FileName)
     if (!fi.isReadable())
         throw Base::FileException("No permission on the file",FileName);
 
+    // try to parse the formats which support it directly from memory first
+    if (fi.hasExtension("stl")) {
+        if (LoadMapped(FileName, MeshIO::BSTL))
+            return true;
+    }
+    else if (fi.hasExtension("obj")) {
+        if (LoadMapped(FileName, MeshIO::OBJ))
+            return true;
+    }
+    else if (fi.hasExtension("ply")) {
+        if (LoadMapped(FileName, MeshIO::PLY))
+            return true;
+    }
+
     Base::ifstream str(fi, std::ios::in | std::ios::binary);
 
     if (fi.hasExtension("bms")) {
@@ -216,6 +238,42 @@ bool  MeshInput::LoadFormat(std::istream &str, MeshIO::Format fmt)
     }
 }
 
+bool MeshInput::LoadMapped(const char* FileName, MeshIO::Format fmt)
+{
+    if (fmt != MeshIO::BSTL && fmt != MeshIO::OBJ && fmt != MeshIO::PLY)
+        return false;
+
+    QFile file(QString::fromUtf8(FileName));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    qint64 size = file.size();
+    if (size <= 0 || static_cast<quint64>(size) > std::numeric_limits<std::size_t>::max())
+        return false;
+    // on systems with a small address space mapping a big file may fail
+    uchar* map = file.map(0, size);
+    if (!map)
+        return false;
+
+    bool ok = false;
+    const char* data = reinterpret_cast<const char*>(map);
+    try {
+        if (fmt == MeshIO::BSTL)
+            ok = LoadMappedSTL(data, static_cast<std::size_t>(size));
+        else if (fmt == MeshIO::OBJ)
+            ok = LoadMappedOBJ(data, static_cast<std::size_t>(size));
+        else
+            ok = LoadMappedPLY(data, static_cast<std::size_t>(size));
+    }
+    catch (...) {
+        file.unmap(map);
+        _rclMesh.Clear();
+        throw;
+    }
+
+    file.unmap(map);
+    return ok;
+}
+
 /** Loads an STL file either in binary or ASCII format.
  * Therefore the file header gets checked to decide if the file is binary or not.
  */
@@ -660,6 +718,9 @@ namespace MeshCore {
         enum Number {
             int8, uint8, int16, uint16, int32, uint32, float32, float64
         };
+        enum Format {
+            unknown, ascii, binary_little_endian, binary_big_endian
+        };
         struct Property : public std::binary_function<std::pair<std::string, Number>,
                                                       std::string, bool>
         {
@@ -669,28 +730,27 @@ namespace MeshCore {
                 return x.first == y;
             }
         };
+        struct Header
+        {
+            Header() : format(unknown), v_count(0), f_count(0), colors(false) {}
+
+            Format format;
+            std::size_t v_count, f_count;
+            std::vector<std::pair<std::string, Number> > vertex_props;
+            std::vector<Number> face_props;
+            bool colors;
+        };
+
+        /** Reads the header of a PLY file up to and including the 'end_header' line.
+         * False is returned if the header is invalid or doesn't describe 3d points.
+         */
+        bool ReadHeader(std::istream &inp, Header& header);
     }
     using namespace Ply;
 }
 
-bool MeshInput::LoadPLY (std::istream &inp)
+bool Ply::ReadHeader(std::istream &inp, Header& header)
 {
-    // http://local.wasp.uwa.edu.au/~pbourke/dataformats/ply/
-    std::size_t v_count=0, f_count=0;
-    MeshPointArray meshPoints;
-    MeshFacetArray meshFacets;
-
-    enum {
-        unknown, ascii, binary_little_endian, binary_big_endian
-    } format = unknown;
-
-    if (!inp || inp.bad() == true)
-        return false;
-
-    std::streambuf* buf = inp.rdbuf();
-    if (!buf)
-        return false;
-
     // read in the first three characters
     char ply[3];
     inp.read(ply, 3);
@@ -700,11 +760,10 @@ bool MeshInput::LoadPLY (std::istream &inp)
     if ((ply[0] != 'p') || (ply[1] != 'l') || (ply[2] != 'y'))
         return false; // wrong header
 
-    std::vector<std::pair<std::string, Ply::Number> > vertex_props;
-    std::vector<Ply::Number> face_props;
+    std::vector<std::pair<std::string, Number> >& vertex_props = header.vertex_props;
+    std::vector<Number>& face_props = header.face_props;
     std::string line, element;
 
-    MeshIO::Binding rgb_value = MeshIO::OVERALL;
     while (std::getline(inp, line)) {
         std::istringstream str(line);
         str.unsetf(std::ios_base::skipws);
@@ -725,13 +784,13 @@ bool MeshInput::LoadPLY (std::istream &inp)
                 return false;
             }
             if (format_string == "ascii") {
-                format = ascii;
+                header.format = ascii;
             }
             else if (format_string == "binary_big_endian") {
-                format = binary_big_endian;
+                header.format = binary_big_endian;
             }
             else if (format_string == "binary_little_endian") {
-                format = binary_little_endian;
+                header.format = binary_little_endian;
             }
             else {
                 // wrong format version
@@ -756,13 +815,11 @@ bool MeshInput::LoadPLY (std::istream &inp)
             }
             else if (name == "vertex") {
                 element = name;
-                v_count = count;
-                meshPoints.reserve(count);
+                header.v_count = count;
             }
             else if (name == "face") {
                 element = name;
-                f_count = count;
-                meshFacets.reserve(count);
+                header.f_count = count;
             }
             else {
                 element.clear();
@@ -775,7 +832,7 @@ bool MeshInput::LoadPLY (std::istream &inp)
                 str >> space >> std::ws
                     >> type >> space >> std::ws >> name >> std::ws;
 
-                Ply::Number number;
+                Number number;
                 if (type == "char" || type == "int8") {
                     number = int8;
                 }
@@ -879,7 +936,7 @@ bool MeshInput::LoadPLY (std::istream &inp)
     if (num_z != 1)
         return false;
 
-    for (std::vector<std::pair<std::string, Ply::Number> >::iterator it =
+    for (std::vector<std::pair<std::string, Number> >::iterator it =
         vertex_props.begin(); it != vertex_props.end(); ++it) {
         if (it->first == "diffuse_red")
             it->first = "red";
@@ -900,8 +957,40 @@ bool MeshInput::LoadPLY (std::istream &inp)
     if (rgb_colors != 0 && rgb_colors != 3)
         return false;
 
+    header.colors = (rgb_colors == 3);
+    return true;
+}
+
+bool MeshInput::LoadPLY (std::istream &inp)
+{
+    // http://local.wasp.uwa.edu.au/~pbourke/dataformats/ply/
+    MeshPointArray meshPoints;
+    MeshFacetArray meshFacets;
+
+    if (!inp || inp.bad() == true)
+        return false;
+
+    std::streambuf* buf = inp.rdbuf();
+    if (!buf)
+        return false;
+
+    Ply::Header header;
+    if (!Ply::ReadHeader(inp, header))
+        return false;
+
+    Ply::Format format = header.format;
+    std::size_t v_count = header.v_count, f_count = header.f_count;
+    std::vector<std::pair<std::string, Ply::Number> >& vertex_props = header.vertex_props;
+    std::vector<Ply::Number>& face_props = header.face_props;
+    std::string line;
+
+    meshPoints.reserve(v_count);
+    meshFacets.reserve(f_count);
+
+    MeshIO::Binding rgb_value = MeshIO::OVERALL;
+
     // only if set per vertex
-    if (rgb_colors == 3) {
+    if (header.colors) {
         rgb_value = MeshIO::PER_VERTEX;
         if (_material) {
             _material->binding = MeshIO::PER_VERTEX;
@@ -1320,6 +1409,773 @@ bool MeshInput::LoadBinarySTL (std::istream &rstrIn)
     return true;
 }
 
+// --------------------------------------------------------------
+
+namespace {
+
+// The loaders of mapped files split the data at line or record boundaries
+// into chunks which are parsed by separate threads.
+
+int MappedChunkCount(std::size_t size)
+{
+    // it doesn't pay off to start threads for small files
+    const std::size_t minChunkSize = 1 << 20;
+    std::size_t chunks = std::max<std::size_t>(1, size / minChunkSize);
+    int threads = std::max(1, QThread::idealThreadCount());
+    return static_cast<int>(std::min<std::size_t>(threads, chunks));
+}
+
+std::vector<const char*> SplitLines(const char* begin, const char* end, int count)
+{
+    std::vector<const char*> bounds;
+    bounds.push_back(begin);
+    std::size_t size = end - begin;
+    for (int i=1; i<count; i++) {
+        const char* pos = std::max(begin + (size * i) / count, bounds.back());
+        const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        bounds.push_back(eol ? eol + 1 : end);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+// Copies the line starting at pos without the line break and returns the start of the next line
+const char* NextLine(const char* pos, const char* end, std::string& line)
+{
+    const char* eol = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    if (!eol)
+        eol = end;
+    line.assign(pos, eol);
+    return eol < end ? eol + 1 : end;
+}
+
+inline bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Splits the line into tokens by terminating each of them in place
+void SplitTokens(std::string& line, std::vector<char*>& tokens)
+{
+    tokens.clear();
+    bool token = false;
+    for (std::string::iterator it = line.begin(); it != line.end(); ++it) {
+        if (IsBlank(*it)) {
+            *it = '\0';
+            token = false;
+        }
+        else if (!token) {
+            tokens.push_back(&*it);
+            token = true;
+        }
+    }
+}
+
+// Checks for the number format [-+]?[0-9]*\.?[0-9]+([eE][-+]?[0-9]+)? accepted by LoadOBJ
+bool IsFloatToken(const char* s)
+{
+    if (*s == '-' || *s == '+')
+        s++;
+    const char* digits = s;
+    while (IsDigit(*s))
+        s++;
+    if (*s == '.') {
+        const char* fraction = ++s;
+        while (IsDigit(*s))
+            s++;
+        if (s == fraction)
+            return false;
+    }
+    else if (s == digits) {
+        return false;
+    }
+    if (*s == 'e' || *s == 'E') {
+        if (*++s == '-' || *s == '+')
+            s++;
+        const char* exponent = s;
+        while (IsDigit(*s))
+            s++;
+        if (s == exponent)
+            return false;
+    }
+    return *s == '\0';
+}
+
+bool IsColorToken(const char* s)
+{
+    std::size_t len = 0;
+    while (IsDigit(s[len]))
+        len++;
+    return len >= 1 && len <= 3 && s[len] == '\0';
+}
+
+// Reads the vertex index of a face token and ignores texture and normal indices
+bool ReadFaceIndex(const char* s, int& index)
+{
+    const char* p = s;
+    if (*p == '-' || *p == '+')
+        p++;
+    const char* digits = p;
+    while (IsDigit(*p))
+        p++;
+    if (p == digits)
+        return false;
+    index = std::atoi(s);
+    for (int i=0; i<2; i++) {
+        if (*p == '/')
+            p++;
+        if (*p == '-' || *p == '+')
+            p++;
+        while (IsDigit(*p))
+            p++;
+    }
+    return *p == '\0';
+}
+
+struct ObjChunk
+{
+    ObjChunk() : colors(false), newSegment(false) {}
+
+    MeshPointArray points;
+    MeshFacetArray facets;
+    // facet corners (3 * facet + corner) with an index relative to the first point of the chunk
+    std::vector<std::size_t> relative;
+    // first facet and group name of the segments started in this chunk
+    std::vector<std::pair<std::size_t, std::string> > segments;
+    bool colors;
+    // a group starts after the last facet of the chunk
+    bool newSegment;
+    std::string groupName;
+};
+
+// Parses the lines of an OBJ file the same way as MeshInput::LoadOBJ does. The property of a
+// facet is set to the number of segments started in the chunk so far.
+void ReadOBJChunk(const char* begin, const char* end, ObjChunk* chunk)
+{
+    std::string line;
+    std::vector<char*> tokens;
+    int index[4];
+
+    while (begin < end) {
+        begin = NextLine(begin, end, line);
+        if (line.empty())
+            continue;
+
+        // the keyword must start the line
+        char kw = static_cast<char>(tolower(line[0]));
+        if (kw != 'v' && kw != 'f' && kw != 'g')
+            continue;
+        SplitTokens(line, tokens);
+        if (tokens[0][1] != '\0')
+            continue;
+
+        if (kw == 'v') {
+            std::size_t num = tokens.size();
+            if (num != 4 && num != 7)
+                continue;
+            if (!IsFloatToken(tokens[1]) || !IsFloatToken(tokens[2]) || !IsFloatToken(tokens[3]))
+                continue;
+
+            MeshPoint pt((float)std::atof(tokens[1]),
+                         (float)std::atof(tokens[2]),
+                         (float)std::atof(tokens[3]));
+            if (num == 7) {
+                float r, g, b;
+                if (IsColorToken(tokens[4]) && IsColorToken(tokens[5]) && IsColorToken(tokens[6])) {
+                    r = std::min<int>(std::atof(tokens[4]),255) / 255.0f;
+                    g = std::min<int>(std::atof(tokens[5]),255) / 255.0f;
+                    b = std::min<int>(std::atof(tokens[6]),255) / 255.0f;
+                }
+                else if (IsFloatToken(tokens[4]) && IsFloatToken(tokens[5]) && IsFloatToken(tokens[6])) {
+                    r = static_cast<float>(std::atof(tokens[4]));
+                    g = static_cast<float>(std::atof(tokens[5]));
+                    b = static_cast<float>(std::atof(tokens[6]));
+                }
+                else {
+                    continue;
+                }
+
+                App::Color c(r,g,b);
+                pt.SetProperty(static_cast<uint32_t>(c.getPackedValue()));
+                chunk->colors = true;
+            }
+            chunk->points.push_back(pt);
+        }
+        else if (kw == 'g') {
+            if (tokens.size() != 2)
+                continue;
+            std::string name = tokens[1];
+            bool valid = true;
+            for (std::string::iterator it = name.begin(); it != name.end(); ++it) {
+                if (*it < 0x21 || *it > 0x7e)
+                    valid = false;
+                // like LoadOBJ only keep the case of the name if the keyword is lower case
+                else if (line[0] == 'G')
+                    *it = tolower(*it);
+            }
+            if (!valid)
+                continue;
+
+            chunk->newSegment = true;
+            chunk->groupName = name;
+        }
+        else {
+            std::size_t num = tokens.size() - 1;
+            if (num != 3 && num != 4)
+                continue;
+            bool valid = true;
+            for (std::size_t i=0; i<num; i++) {
+                if (!ReadFaceIndex(tokens[i+1], index[i]))
+                    valid = false;
+            }
+            if (!valid)
+                continue;
+
+            if (chunk->newSegment) {
+                chunk->segments.push_back(std::make_pair(chunk->facets.size(), chunk->groupName));
+                chunk->groupName.clear();
+                chunk->newSegment = false;
+            }
+
+            // negative indices count backwards from the current point which is resolved
+            // once the number of points of the previous chunks is known
+            unsigned long corner[4];
+            bool relative[4];
+            for (std::size_t i=0; i<num; i++) {
+                relative[i] = index[i] <= 0;
+                if (relative[i])
+                    corner[i] = static_cast<unsigned long>(index[i] + static_cast<long>(chunk->points.size()));
+                else
+                    corner[i] = static_cast<unsigned long>(index[i] - 1);
+            }
+
+            static const int triangles[2][3] = {{0,1,2},{2,3,0}};
+            for (std::size_t t=0; t<num-2; t++) {
+                MeshFacet item;
+                item.SetVertices(corner[triangles[t][0]], corner[triangles[t][1]], corner[triangles[t][2]]);
+                item.SetProperty(chunk->segments.size());
+                for (int i=0; i<3; i++) {
+                    if (relative[triangles[t][i]])
+                        chunk->relative.push_back(3 * chunk->facets.size() + i);
+                }
+                chunk->facets.push_back(item);
+            }
+        }
+    }
+}
+
+void ReadBinarySTLChunk(const char* data, MeshFastBuilder* builder, unsigned long begin, unsigned long end)
+{
+    float coords[12];
+    Base::Vector3f points[3];
+    for (unsigned long i = begin; i < end; i++) {
+        // normal and points, followed by 2 bytes attribute
+        std::memcpy(coords, data + 84 + 50 * static_cast<std::size_t>(i), sizeof(coords));
+        // same order of points as in LoadBinarySTL()
+        points[0].Set(coords[9], coords[10], coords[11]);
+        points[1].Set(coords[3], coords[4], coords[5]);
+        points[2].Set(coords[6], coords[7], coords[8]);
+        builder->SetFacet(i, points);
+    }
+}
+
+std::size_t PlyNumberSize(Ply::Number number)
+{
+    switch (number) {
+    case Ply::int8:
+    case Ply::uint8:
+        return 1;
+    case Ply::int16:
+    case Ply::uint16:
+        return 2;
+    case Ply::int32:
+    case Ply::uint32:
+    case Ply::float32:
+        return 4;
+    case Ply::float64:
+        return 8;
+    }
+    return 0;
+}
+
+template <typename T>
+inline T ReadBinaryValue(const char* data, bool swap)
+{
+    T v;
+    std::memcpy(&v, data, sizeof(T));
+    if (swap)
+        Base::SwapEndian<T>(v);
+    return v;
+}
+
+float ReadBinaryNumber(const char* data, Ply::Number number, bool swap)
+{
+    switch (number) {
+    case Ply::int8:
+        return static_cast<float>(ReadBinaryValue<int8_t>(data, swap));
+    case Ply::uint8:
+        return static_cast<float>(ReadBinaryValue<uint8_t>(data, swap));
+    case Ply::int16:
+        return static_cast<float>(ReadBinaryValue<int16_t>(data, swap));
+    case Ply::uint16:
+        return static_cast<float>(ReadBinaryValue<uint16_t>(data, swap));
+    case Ply::int32:
+        return static_cast<float>(ReadBinaryValue<int32_t>(data, swap));
+    case Ply::uint32:
+        return static_cast<float>(ReadBinaryValue<uint32_t>(data, swap));
+    case Ply::float32:
+        return ReadBinaryValue<float>(data, swap);
+    case Ply::float64:
+        return static_cast<float>(ReadBinaryValue<double>(data, swap));
+    }
+    return 0.0f;
+}
+
+bool ReadAsciiNumber(const char* s, Ply::Number number, float& value)
+{
+    char* end;
+    switch (number) {
+    case Ply::int8:
+    case Ply::int16:
+    case Ply::int32:
+        value = static_cast<float>(std::strtol(s, &end, 10));
+        break;
+    case Ply::uint8:
+    case Ply::uint16:
+    case Ply::uint32:
+        if (!IsDigit(*s))
+            return false;
+        value = static_cast<float>(std::strtoul(s, &end, 10));
+        break;
+    default:
+        value = static_cast<float>(std::strtod(s, &end));
+        break;
+    }
+    return end != s && *end == '\0';
+}
+
+// The vertex and face elements of a PLY file and where to store them
+struct PlyElements
+{
+    PlyElements(const Ply::Header& header)
+      : header(header), stride(0), swap(header.format == Ply::binary_big_endian)
+      , points(0), colors(0)
+    {
+        for (int i=0; i<6; i++)
+            index[i] = -1;
+        static const char* names[6] = {"x", "y", "z", "red", "green", "blue"};
+        for (std::size_t i=0; i<header.vertex_props.size(); i++) {
+            for (int j=0; j<6; j++) {
+                if (header.vertex_props[i].first == names[j])
+                    index[j] = static_cast<int>(i);
+            }
+            offsets.push_back(stride);
+            stride += PlyNumberSize(header.vertex_props[i].second);
+        }
+    }
+
+    const Ply::Header& header;
+    // offsets of the vertex properties in a binary vertex record
+    std::vector<std::size_t> offsets;
+    std::size_t stride;
+    // property indices of x, y, z, red, green, blue
+    int index[6];
+    bool swap;
+    MeshPointArray* points;
+    std::vector<App::Color>* colors;
+};
+
+void ReadBinaryPLYVertices(const PlyElements* elements, const char* data, std::size_t begin, std::size_t end)
+{
+    const std::vector<std::pair<std::string, Ply::Number> >& props = elements->header.vertex_props;
+    float values[6];
+    int num = elements->colors ? 6 : 3;
+    for (std::size_t i = begin; i < end; i++) {
+        const char* record = data + i * elements->stride;
+        for (int j=0; j<num; j++) {
+            int k = elements->index[j];
+            values[j] = ReadBinaryNumber(record + elements->offsets[k], props[k].second, elements->swap);
+        }
+
+        (*elements->points)[i].Set(values[0], values[1], values[2]);
+        if (elements->colors)
+            (*elements->colors)[i] = App::Color(values[3] / 255.0f, values[4] / 255.0f, values[5] / 255.0f);
+    }
+}
+
+// Reads the faces until the end of the data and ignores the faces that aren't triangles
+void ReadBinaryPLYFaces(const PlyElements* elements, const char* data, const char* end, MeshFacetArray& facets)
+{
+    const Ply::Header& header = elements->header;
+    for (std::size_t i = 0; i < header.f_count; i++) {
+        if (data >= end)
+            return;
+        std::size_t n = static_cast<unsigned char>(*data++);
+        if (static_cast<std::size_t>(end - data) < 4 * n)
+            return;
+        if (n == 3) {
+            uint32_t f1 = ReadBinaryValue<uint32_t>(data, elements->swap);
+            uint32_t f2 = ReadBinaryValue<uint32_t>(data + 4, elements->swap);
+            uint32_t f3 = ReadBinaryValue<uint32_t>(data + 8, elements->swap);
+            if (f1 < header.v_count && f2 < header.v_count && f3 < header.v_count)
+                facets.push_back(MeshFacet(f1,f2,f3));
+        }
+        data += 4 * n;
+
+        // skip the other face properties
+        for (std::vector<Ply::Number>::const_iterator it = header.face_props.begin(); it != header.face_props.end(); ++it) {
+            std::size_t size = PlyNumberSize(*it);
+            if (*it == Ply::float32 || *it == Ply::float64) {
+                if (data >= end)
+                    return;
+                size *= static_cast<unsigned char>(*data++);
+            }
+            if (static_cast<std::size_t>(end - data) < size)
+                return;
+            data += size;
+        }
+    }
+}
+
+struct PlyAsciiChunk
+{
+    PlyAsciiChunk() : begin(0), end(0), firstLine(0), numLines(0), valid(true) {}
+
+    const char* begin;
+    const char* end;
+    std::size_t firstLine;
+    std::size_t numLines;
+    MeshFacetArray facets;
+    bool valid;
+};
+
+void CountPLYLines(PlyAsciiChunk* chunk)
+{
+    chunk->numLines = std::count(chunk->begin, chunk->end, '\n');
+    if (chunk->begin < chunk->end && *(chunk->end - 1) != '\n')
+        chunk->numLines++;
+}
+
+// Parses vertex and face lines of an ASCII PLY file. Lines before 'v_count' are vertices,
+// the following 'f_count' lines are faces.
+void ReadAsciiPLYChunk(const PlyElements* elements, PlyAsciiChunk* chunk)
+{
+    const Ply::Header& header = elements->header;
+    std::string line;
+    std::vector<char*> tokens;
+    float values[6];
+    int num = elements->colors ? 6 : 3;
+
+    const char* pos = chunk->begin;
+    for (std::size_t i = chunk->firstLine; pos < chunk->end; i++) {
+        pos = NextLine(pos, chunk->end, line);
+        if (i < header.v_count) {
+            SplitTokens(line, tokens);
+            if (tokens.size() < header.vertex_props.size()) {
+                chunk->valid = false;
+                return;
+            }
+            for (int j=0; j<num; j++) {
+                int k = elements->index[j];
+                if (!ReadAsciiNumber(tokens[k], header.vertex_props[k].second, values[j])) {
+                    chunk->valid = false;
+                    return;
+                }
+            }
+
+            (*elements->points)[i].Set(values[0], values[1], values[2]);
+            if (elements->colors)
+                (*elements->colors)[i] = App::Color(values[3] / 255.0f, values[4] / 255.0f, values[5] / 255.0f);
+        }
+        else if (i < header.v_count + header.f_count) {
+            SplitTokens(line, tokens);
+            if (tokens.size() < 4 || std::strcmp(tokens[0], "3") != 0)
+                continue;
+            unsigned long f[3];
+            bool valid = true;
+            for (int j=0; j<3; j++) {
+                char* end;
+                f[j] = std::strtoul(tokens[j+1], &end, 10);
+                if (!IsDigit(*tokens[j+1]) || *end != '\0')
+                    valid = false;
+            }
+            if (valid)
+                chunk->facets.push_back(MeshFacet(f[0],f[1],f[2]));
+        }
+        else {
+            break;
+        }
+    }
+}
+
+}
+
+/** Loads a binary STL file from memory. */
+bool MeshInput::LoadMappedSTL (const char* data, std::size_t size)
+{
+    char szBuf[101];
+    uint32_t ulCt, ulBytes=50;
+
+    if (size < 84)
+        return false;
+    std::memcpy(&ulCt, data + 80, sizeof(ulCt));
+    if (ulCt > 1)
+        ulBytes = 100;
+    if (size < 84 + ulBytes)
+        return false;
+    std::memcpy(szBuf, data + 84, ulBytes);
+    szBuf[ulBytes] = 0;
+    upper(szBuf);
+
+    // ASCII files are left to LoadSTL()
+    if ((strstr(szBuf, "SOLID") != NULL)  || (strstr(szBuf, "FACET") != NULL)    || (strstr(szBuf, "NORMAL") != NULL) ||
+        (strstr(szBuf, "VERTEX") != NULL) || (strstr(szBuf, "ENDFACET") != NULL) || (strstr(szBuf, "ENDLOOP") != NULL))
+        return false;
+
+    // compare the number of facets with the file size
+    if (ulCt > (size - (80 + sizeof(uint32_t))) / 50)
+        return false;
+
+    MeshFastBuilder builder(this->_rclMesh);
+    builder.Resize(ulCt);
+
+    int threads = MappedChunkCount(size);
+    QList<QFuture<void> > futures;
+    for (int i=0; i<threads; i++) {
+        unsigned long ulBegin = (static_cast<uint64_t>(ulCt) * i) / threads;
+        unsigned long ulEnd = (static_cast<uint64_t>(ulCt) * (i + 1)) / threads;
+        futures << QtConcurrent::run(ReadBinarySTLChunk, data, &builder, ulBegin, ulEnd);
+    }
+    for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+        it->waitForFinished();
+
+    // the duplicated points are merged by sorting them with several threads
+    builder.Finish();
+
+    return true;
+}
+
+/** Loads an OBJ file from memory. */
+bool MeshInput::LoadMappedOBJ (const char* data, std::size_t size)
+{
+    std::vector<const char*> bounds = SplitLines(data, data + size, MappedChunkCount(size));
+    std::vector<ObjChunk> chunks(bounds.size() - 1);
+
+    QList<QFuture<void> > futures;
+    for (std::size_t i=0; i<chunks.size(); i++)
+        futures << QtConcurrent::run(ReadOBJChunk, bounds[i], bounds[i+1], &chunks[i]);
+    for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+        it->waitForFinished();
+
+    std::size_t numPoints = 0, numFacets = 0;
+    for (std::vector<ObjChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        numPoints += it->points.size();
+        numFacets += it->facets.size();
+    }
+
+    MeshPointArray meshPoints;
+    MeshFacetArray meshFacets;
+    meshPoints.reserve(numPoints);
+    meshFacets.reserve(numFacets);
+
+    // join the chunks and number the segments through
+    MeshIO::Binding rgb_value = MeshIO::OVERALL;
+    unsigned long segment = 0;
+    bool new_segment = true;
+    std::string groupName;
+
+    for (std::vector<ObjChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+        // facets in front of the first group of the chunk continue the last segment
+        std::size_t numContinued = it->segments.empty() ? it->facets.size() : it->segments.front().first;
+        if (numContinued > 0 && new_segment) {
+            if (!groupName.empty())
+                _groupNames.push_back(Base::Tools::escapedUnicodeToUtf8(groupName));
+            groupName.clear();
+            new_segment = false;
+            segment++;
+        }
+
+        unsigned long firstSegment = segment;
+        for (std::vector<std::pair<std::size_t, std::string> >::iterator jt = it->segments.begin(); jt != it->segments.end(); ++jt) {
+            if (!jt->second.empty())
+                _groupNames.push_back(Base::Tools::escapedUnicodeToUtf8(jt->second));
+            segment++;
+        }
+        if (!it->segments.empty()) {
+            groupName.clear();
+            new_segment = false;
+        }
+        if (it->newSegment) {
+            groupName = it->groupName;
+            new_segment = true;
+        }
+
+        unsigned long offset = meshPoints.size();
+        for (std::vector<std::size_t>::iterator jt = it->relative.begin(); jt != it->relative.end(); ++jt)
+            it->facets[*jt / 3]._aulPoints[*jt % 3] += offset;
+        for (MeshFacetArray::iterator jt = it->facets.begin(); jt != it->facets.end(); ++jt)
+            jt->SetProperty(firstSegment + jt->_ulProp);
+        if (it->colors)
+            rgb_value = MeshIO::PER_VERTEX;
+
+        meshPoints.insert(meshPoints.end(), it->points.begin(), it->points.end());
+        meshFacets.insert(meshFacets.end(), it->facets.begin(), it->facets.end());
+        MeshPointArray().swap(it->points);
+        MeshFacetArray().swap(it->facets);
+    }
+
+    // now get back the colors from the vertex property
+    if (rgb_value == MeshIO::PER_VERTEX) {
+        if (_material) {
+            _material->binding = MeshIO::PER_VERTEX;
+            _material->diffuseColor.reserve(meshPoints.size());
+
+            for (MeshPointArray::iterator it = meshPoints.begin(); it != meshPoints.end(); ++it) {
+                unsigned long prop = it->_ulProp;
+                App::Color c;
+                c.setPackedValue(static_cast<uint32_t>(prop));
+                _material->diffuseColor.push_back(c);
+            }
+        }
+    }
+
+    this->_rclMesh.Clear(); // remove all data before
+
+    MeshCleanup meshCleanup(meshPoints,meshFacets);
+    if (_material)
+        meshCleanup.SetMaterial(_material);
+    meshCleanup.RemoveInvalids();
+    MeshPointFacetAdjacency meshAdj(meshPoints.size(),meshFacets);
+    meshAdj.SetFacetNeighbourhood();
+    this->_rclMesh.Adopt(meshPoints,meshFacets);
+
+    return true;
+}
+
+/** Loads a PLY file from memory. */
+bool MeshInput::LoadMappedPLY (const char* data, std::size_t size)
+{
+    // the header ends with the first line starting with 'end_header'
+    static const char end_header[] = "end_header";
+    const char* end = data + size;
+    const char* pos = data;
+    while (true) {
+        pos = std::search(pos, end, end_header, end_header + sizeof(end_header) - 1);
+        if (pos == end)
+            return false;
+        if (pos == data || *(pos - 1) == '\n')
+            break;
+        pos++;
+    }
+    pos = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    if (!pos)
+        return false;
+    pos++;
+
+    std::istringstream str(std::string(data, pos));
+    Ply::Header header;
+    if (!Ply::ReadHeader(str, header))
+        return false;
+
+    MeshPointArray meshPoints;
+    MeshFacetArray meshFacets;
+    std::vector<App::Color> colors;
+
+    PlyElements elements(header);
+    elements.points = &meshPoints;
+    if (header.colors && _material)
+        elements.colors = &colors;
+
+    if (header.format == Ply::ascii) {
+        std::vector<const char*> bounds = SplitLines(pos, end, MappedChunkCount(end - pos));
+        std::vector<PlyAsciiChunk> chunks(bounds.size() - 1);
+        for (std::size_t i=0; i<chunks.size(); i++) {
+            chunks[i].begin = bounds[i];
+            chunks[i].end = bounds[i+1];
+        }
+
+        // count the lines of each chunk to know which elements it contains
+        QList<QFuture<void> > futures;
+        for (std::size_t i=0; i<chunks.size(); i++)
+            futures << QtConcurrent::run(CountPLYLines, &chunks[i]);
+        for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+            it->waitForFinished();
+
+        std::size_t numLines = 0;
+        for (std::vector<PlyAsciiChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            it->firstLine = numLines;
+            numLines += it->numLines;
+        }
+
+        std::size_t v_count = std::min(header.v_count, numLines);
+        meshPoints.resize(v_count);
+        if (elements.colors)
+            colors.resize(v_count);
+
+        futures.clear();
+        for (std::size_t i=0; i<chunks.size(); i++)
+            futures << QtConcurrent::run(ReadAsciiPLYChunk, &elements, &chunks[i]);
+        for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+            it->waitForFinished();
+
+        for (std::vector<PlyAsciiChunk>::iterator it = chunks.begin(); it != chunks.end(); ++it) {
+            if (!it->valid)
+                return false;
+            meshFacets.insert(meshFacets.end(), it->facets.begin(), it->facets.end());
+        }
+    }
+    else {
+        // every vertex has the same size, the counts of the header are
+        // checked by division so that a huge count cannot overflow
+        std::size_t avail = static_cast<std::size_t>(end - pos);
+        if (elements.stride > 0 && header.v_count > avail / elements.stride)
+            return false;
+        std::size_t v_size = elements.stride * header.v_count;
+        // a face takes at least one byte for the number of its points
+        if (header.f_count > avail - v_size)
+            return false;
+        meshPoints.resize(header.v_count);
+        if (elements.colors)
+            colors.resize(header.v_count);
+
+        int threads = MappedChunkCount(v_size);
+        QList<QFuture<void> > futures;
+        for (int i=0; i<threads; i++) {
+            std::size_t first = (header.v_count * i) / threads;
+            std::size_t last = (header.v_count * (i + 1)) / threads;
+            futures << QtConcurrent::run(ReadBinaryPLYVertices, &elements, pos, first, last);
+        }
+        for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+            it->waitForFinished();
+
+        // faces may have different sizes and are read in one go
+        meshFacets.reserve(header.f_count);
+        ReadBinaryPLYFaces(&elements, pos + v_size, end, meshFacets);
+    }
+
+    if (elements.colors) {
+        _material->binding = MeshIO::PER_VERTEX;
+        _material->diffuseColor.insert(_material->diffuseColor.end(), colors.begin(), colors.end());
+    }
+
+    this->_rclMesh.Clear(); // remove all data before
+
+    MeshCleanup meshCleanup(meshPoints,meshFacets);
+    if (_material)
+        meshCleanup.SetMaterial(_material);
+    meshCleanup.RemoveInvalids();
+    MeshPointFacetAdjacency meshAdj(meshPoints.size(),meshFacets);
+    meshAdj.SetFacetNeighbourhood();
+    this->_rclMesh.Adopt(meshPoints,meshFacets);
+
+    return true;
+}
+
 /** Loads the mesh object from an XML file. */
 void MeshInput::LoadXML (Base::XMLReader &reader)
 {
@@ -100,6 +100,12 @@ public:
     bool LoadAny(const char* FileName);
     /// Loads from a stream and the given format
     bool LoadFormat(std::istream &str, MeshIO::Format fmt);
+    /** Loads a binary STL, an OBJ or a PLY file by mapping it into memory and parsing
+     * the data with several threads.
+     * If the file cannot be mapped or has a format not handled here false is returned
+     * and the stream based methods must be used instead.
+     */
+    bool LoadMapped(const char* FileName, MeshIO::Format fmt);
     /** Loads an STL file either in binary or ASCII format. 
      * Therefore the file header gets checked to decide if the file is binary or not.
      */
@@ -127,6 +133,11 @@ public:
     /** Loads a Cadmould FE file. */
     bool LoadCadmouldFE (std::ifstream &rstrIn);
 
+private:
+    bool LoadMappedSTL (const char* data, std::size_t size);
+    bool LoadMappedOBJ (const char* data, std::size_t size);
+    bool LoadMappedPLY (const char* data, std::size_t size);
+
 protected:
     MeshKernel &_rclMesh;   /**< reference to mesh data structure */
     Material* _material;
@@ -38,6 +38,7 @@
 #include "Algorithm.h"
 #include "Approximation.h"
 #include "Helpers.h"
+#include "Functional.h"
 #include "MeshKernel.h"
 #include "Iterator.h"
 #include "Evaluation.h"
@@ -791,6 +792,89 @@ MeshFacetArray MeshKernel::GetFacets(const std::vector<unsigned long>& indices)
     return ary;
 }
 
+namespace {
+// Since version 2 of the binary format the points, the point indices and the
+// neighbour indices of the facets are stored as contiguous blocks. They are
+// converted in chunks of this number of elements to keep the buffers small.
+const std::size_t BlockSize = 65536;
+
+template <typename T>
+void writeBlock(std::ostream& out, const std::vector<T>& data)
+{
+    if (!data.empty())
+        out.write(reinterpret_cast<const char*>(&data[0]), data.size() * sizeof(T));
+}
+
+template <typename T>
+void readBlock(std::istream& in, std::vector<T>& data, std::size_t count, bool swap)
+{
+    data.resize(count);
+    if (count == 0)
+        return;
+    in.read(reinterpret_cast<char*>(&data[0]), count * sizeof(T));
+    if (!in || static_cast<std::size_t>(in.gcount()) != count * sizeof(T))
+        throw Base::BadFormatError("Reading from stream failed");
+    if (swap) {
+        for (typename std::vector<T>::iterator it = data.begin(); it != data.end(); ++it)
+            Base::SwapEndian<T>(*it);
+    }
+}
+
+void readBlocks(std::istream& in, uint32_t uCtPts, uint32_t uCtFts, bool swap,
+                MeshPointArray& pointArray, MeshFacetArray& facetArray)
+{
+    const uint32_t open_edge = 0xffffffff; // value to mark an open edge
+
+    pointArray.resize(uCtPts);
+    std::vector<float> coords;
+    for (std::size_t i = 0; i < uCtPts; i += BlockSize) {
+        std::size_t end = std::min<std::size_t>(i + BlockSize, uCtPts);
+        readBlock(in, coords, 3 * (end - i), swap);
+        std::vector<float>::const_iterator jt = coords.begin();
+        for (std::size_t j = i; j < end; j++) {
+            MeshPoint& p = pointArray[j];
+            p.x = *jt++;
+            p.y = *jt++;
+            p.z = *jt++;
+        }
+    }
+
+    facetArray.resize(uCtFts);
+    std::vector<uint32_t> indices;
+    for (std::size_t i = 0; i < uCtFts; i += BlockSize) {
+        std::size_t end = std::min<std::size_t>(i + BlockSize, uCtFts);
+        readBlock(in, indices, 3 * (end - i), swap);
+        std::vector<uint32_t>::const_iterator jt = indices.begin();
+        for (std::size_t j = i; j < end; j++) {
+            MeshFacet& f = facetArray[j];
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = *jt++;
+                // make sure to have valid indices
+                if (v >= uCtPts)
+                    throw Base::BadFormatError("Invalid data structure");
+                f._aulPoints[k] = v;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < uCtFts; i += BlockSize) {
+        std::size_t end = std::min<std::size_t>(i + BlockSize, uCtFts);
+        readBlock(in, indices, 3 * (end - i), swap);
+        std::vector<uint32_t>::const_iterator jt = indices.begin();
+        for (std::size_t j = i; j < end; j++) {
+            MeshFacet& f = facetArray[j];
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = *jt++;
+                // make sure to have valid indices
+                if (v >= uCtFts && v < open_edge)
+                    throw Base::BadFormatError("Invalid data structure");
+                // the empty neighbour must be explicitly set to 'ULONG_MAX'
+                f._aulNeighbours[k] = (v < open_edge ? v : ULONG_MAX);
+            }
+        }
+    }
+}
+}
+
 void MeshKernel::Write (std::ostream &rclOut) const 
 {
     if (!rclOut || rclOut.bad())
@@ -800,7 +884,7 @@ void MeshKernel::Write (std::ostream &rclOut) const
 
     // Write a header with a "magic number" and a version
     str << (uint32_t)0xA0B0C0D0;
-    str << (uint32_t)0x010000;
+    str << (uint32_t)0x020000;
 
     char szInfo[257]; // needs an additional byte for zero-termination
     strcpy(szInfo, "MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-MESH-"
@@ -812,18 +896,45 @@ void MeshKernel::Write (std::ostream &rclOut) const
     // write the number of points and facets
     str << (uint32_t)CountPoints() << (uint32_t)CountFacets();
 
-    // write the data
-    for (MeshPointArray::_TConstIterator it = _aclPointArray.begin(); it != _aclPointArray.end(); ++it) {
-        str << it->x << it->y << it->z;
+    // write the data as blocks of point coordinates, point indices and neighbour indices
+    std::vector<float> coords;
+    coords.reserve(3 * std::min<std::size_t>(BlockSize, _aclPointArray.size()));
+    for (std::size_t i = 0; i < _aclPointArray.size(); i += BlockSize) {
+        std::size_t end = std::min<std::size_t>(i + BlockSize, _aclPointArray.size());
+        coords.clear();
+        for (std::size_t j = i; j < end; j++) {
+            const MeshPoint& p = _aclPointArray[j];
+            coords.push_back(p.x);
+            coords.push_back(p.y);
+            coords.push_back(p.z);
+        }
+        writeBlock(rclOut, coords);
     }
 
-    for (MeshFacetArray::_TConstIterator it = _aclFacetArray.begin(); it != _aclFacetArray.end(); ++it) {
-        str << (uint32_t)it->_aulPoints[0] 
-            << (uint32_t)it->_aulPoints[1] 
-            << (uint32_t)it->_aulPoints[2];
-        str << (uint32_t)it->_aulNeighbours[0] 
-            << (uint32_t)it->_aulNeighbours[1] 
-            << (uint32_t)it->_aulNeighbours[2];
+    // Note: An open edge (ULONG_MAX) is stored as 0xffffffff
+    std::vector<uint32_t> indices;
+    indices.reserve(3 * std::min<std::size_t>(BlockSize, _aclFacetArray.size()));
+    for (std::size_t i = 0; i < _aclFacetArray.size(); i += BlockSize) {
+        std::size_t end = std::min<std::size_t>(i + BlockSize, _aclFacetArray.size());
+        indices.clear();
+        for (std::size_t j = i; j < end; j++) {
+            const MeshFacet& f = _aclFacetArray[j];
+            indices.push_back((uint32_t)f._aulPoints[0]);
+            indices.push_back((uint32_t)f._aulPoints[1]);
+            indices.push_back((uint32_t)f._aulPoints[2]);
+        }
+        writeBlock(rclOut, indices);
+    }
+    for (std::size_t i = 0; i < _aclFacetArray.size(); i += BlockSize) {
+        std::size_t end = std::min<std::size_t>(i + BlockSize, _aclFacetArray.size());
+        indices.clear();
+        for (std::size_t j = i; j < end; j++) {
+            const MeshFacet& f = _aclFacetArray[j];
+            indices.push_back((uint32_t)f._aulNeighbours[0]);
+            indices.push_back((uint32_t)f._aulNeighbours[1]);
+            indices.push_back((uint32_t)f._aulNeighbours[2]);
+        }
+        writeBlock(rclOut, indices);
     }
 
     str << _clBoundBox.MinX << _clBoundBox.MaxX;
@@ -847,12 +958,19 @@ void MeshKernel::Read (std::istream &rclIn)
     uint32_t open_edge = 0xffffffff; // value to mark an open edge
 
     // is it the new or old format?
+    // Version 1 stores the facets element by element, version 2 stores
+    // the data as contiguous blocks
     bool new_format = false;
-    if (magic == 0xA0B0C0D0 && version == 0x010000) {
+    bool block_format = false;
+    bool swap = false;
+    if (magic == 0xA0B0C0D0 && (version == 0x010000 || version == 0x020000)) {
         new_format = true;
+        block_format = (version == 0x020000);
     }
-    else if (swap_magic == 0xA0B0C0D0 && swap_version == 0x010000) {
+    else if (swap_magic == 0xA0B0C0D0 && (swap_version == 0x010000 || swap_version == 0x020000)) {
         new_format = true;
+        block_format = (swap_version == 0x020000);
+        swap = true;
         str.setByteOrder(Base::Stream::BigEndian);
     }
 
@@ -864,6 +982,26 @@ void MeshKernel::Read (std::istream &rclIn)
         uint32_t uCtPts=0, uCtFts=0;
         str >> uCtPts >> uCtFts;
 
+        if (block_format) {
+            MeshPointArray pointArray;
+            MeshFacetArray facetArray;
+            try {
+                readBlocks(rclIn, uCtPts, uCtFts, swap, pointArray, facetArray);
+            }
+            catch (std::exception&) {
+                // Special handling of std::length_error
+                throw Base::BadFormatError("Reading from stream failed");
+            }
+
+            str >> _clBoundBox.MinX >> _clBoundBox.MaxX;
+            str >> _clBoundBox.MinY >> _clBoundBox.MaxY;
+            str >> _clBoundBox.MinZ >> _clBoundBox.MaxZ;
+
+            _aclPointArray.swap(pointArray);
+            _aclFacetArray.swap(facetArray);
+            return;
+        }
+
         try {
             // read the data
             MeshPointArray pointArray;
@@ -1008,17 +1146,91 @@ void MeshKernel::operator *= (const Base::Matrix4D &rclMat)
     this->Transform(rclMat);
 }
 
-void MeshKernel::Transform (const Base::Matrix4D &rclMat)
+namespace {
+// The points stay an array of MeshPoint structs in single precision because
+// all algorithms work on MeshPoint references. The bulk passes over them are
+// split into blocks for several threads instead.
+// transforming points is cheap, small meshes are handled by the calling thread
+const unsigned long MinParallelCount = 100000;
+
+// Passes the bounding box of its block to a functor of ParallelBoundBox()
+template <class Func>
+struct BoundBoxBlock
 {
-    MeshPointArray::_TIterator  clPIter = _aclPointArray.begin(), clPEIter = _aclPointArray.end();
-    Base::Matrix4D clMatrix(rclMat);
+    BoundBoxBlock(const Func& func, Base::BoundBox3f* boxes)
+      : func(func), boxes(boxes) {}
+    void operator()(unsigned long begin, unsigned long end, int block) const
+    {
+        func(begin, end, boxes + block);
+    }
 
-    _clBoundBox.SetVoid();
-    while (clPIter < clPEIter) {
-        *clPIter *= clMatrix;
-        _clBoundBox.Add(*clPIter);
-        clPIter++;
+    Func func;
+    Base::BoundBox3f* boxes;
+};
+
+// Calls func(begin, end, box) for consecutive ranges of the points with several
+// threads and merges the bounding boxes the ranges compute into \a box.
+template <class Func>
+void ParallelBoundBox(unsigned long count, const Func& func, Base::BoundBox3f& box)
+{
+    std::vector<Base::BoundBox3f> boxes(count_blocks(count, MinParallelCount));
+    parallel_blocks(count, static_cast<int>(boxes.size()), BoundBoxBlock<Func>(func, &boxes[0]));
+
+    box.SetVoid();
+    for (std::vector<Base::BoundBox3f>::iterator it = boxes.begin(); it != boxes.end(); ++it)
+        box.Add(*it);
+}
+
+struct TransformPoints
+{
+    typedef void result_type;
+    TransformPoints(MeshPointArray& points, const Base::Matrix4D& mat)
+      : points(&points), mat(&mat) {}
+    void operator()(unsigned long begin, unsigned long end, Base::BoundBox3f* box) const
+    {
+        MeshPointArray& rPoints = *points;
+        for (unsigned long i = begin; i < end; i++) {
+            rPoints[i] *= *mat;
+            box->Add(rPoints[i]);
+        }
     }
+
+    MeshPointArray* points;
+    const Base::Matrix4D* mat;
+};
+
+struct BoundPoints
+{
+    typedef void result_type;
+    BoundPoints(const MeshPointArray& points)
+      : points(&points) {}
+    void operator()(unsigned long begin, unsigned long end, Base::BoundBox3f* box) const
+    {
+        const MeshPointArray& rPoints = *points;
+        // the branch free min/max can be vectorized unlike BoundBox3f::Add
+        float minX = FLOAT_MAX, minY = FLOAT_MAX, minZ = FLOAT_MAX;
+        float maxX = -FLOAT_MAX, maxY = -FLOAT_MAX, maxZ = -FLOAT_MAX;
+        for (unsigned long i = begin; i < end; i++) {
+            const MeshPoint& p = rPoints[i];
+            minX = p.x < minX ? p.x : minX;
+            minY = p.y < minY ? p.y : minY;
+            minZ = p.z < minZ ? p.z : minZ;
+            maxX = p.x > maxX ? p.x : maxX;
+            maxY = p.y > maxY ? p.y : maxY;
+            maxZ = p.z > maxZ ? p.z : maxZ;
+        }
+        if (begin < end)
+            *box = Base::BoundBox3f(minX, minY, minZ, maxX, maxY, maxZ);
+    }
+
+    const MeshPointArray* points;
+};
+}
+
+void MeshKernel::Transform (const Base::Matrix4D &rclMat)
+{
+    ParallelBoundBox(static_cast<unsigned long>(_aclPointArray.size()),
+                     TransformPoints(_aclPointArray, rclMat), _clBoundBox);
 }
 
 void MeshKernel::Smooth(int iterations, float stepsize)
@@ -1029,9 +1241,8 @@ void MeshKernel::Smooth(int iterations, float stepsize)
 
 void MeshKernel::RecalcBoundBox (void)
 {
-    _clBoundBox.SetVoid();
-    for (MeshPointArray::_TConstIterator pI = _aclPointArray.begin(); pI != _aclPointArray.end(); pI++)
-        _clBoundBox.Add(*pI);
+    ParallelBoundBox(static_cast<unsigned long>(_aclPointArray.size()),
+                     BoundPoints(_aclPointArray), _clBoundBox);
 }
 
 std::vector<Base::Vector3f> MeshKernel::CalcVertexNormals() const
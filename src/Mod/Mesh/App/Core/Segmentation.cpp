@@ -23,8 +23,16 @@
 #include "PreCompiled.h"
 #ifndef _PreComp_
 #include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
 #endif
 
+#include <QFuture>
+#include <QList>
+#include <QThread>
+#include <QtConcurrentRun>
+
 #include "Segmentation.h"
 #include "Algorithm.h"
 #include "Approximation.h"
@@ -44,6 +52,11 @@ void MeshSurfaceSegment::AddFacet(const MeshFacet&)
 {
 }
 
+MeshSurfaceSegment* MeshSurfaceSegment::Clone() const
+{
+    return nullptr;
+}
+
 void MeshSurfaceSegment::AddSegment(const std::vector<unsigned long>& segm)
 {
     if (segm.size() >= minFacets) {
@@ -104,6 +117,11 @@ void MeshDistancePlanarSegment::AddFacet(const MeshFacet& face)
     fitter->AddPoint(triangle.GetGravityPoint());
 }
 
+MeshSurfaceSegment* MeshDistancePlanarSegment::Clone() const
+{
+    return new MeshDistancePlanarSegment(kernel, minFacets, tolerance);
+}
+
 // --------------------------------------------------------
 
 PlaneSurfaceFit::PlaneSurfaceFit()
@@ -171,6 +189,14 @@ float PlaneSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
         return fitter->GetDistanceToPlane(pnt);
 }
 
+AbstractSurfaceFit* PlaneSurfaceFit::Clone() const
+{
+    if (!fitter)
+        return new PlaneSurfaceFit(basepoint, normal);
+    else
+        return new PlaneSurfaceFit();
+}
+
 // --------------------------------------------------------
 
 CylinderSurfaceFit::CylinderSurfaceFit()
@@ -200,6 +226,10 @@ CylinderSurfaceFit::~CylinderSurfaceFit()
 void CylinderSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
+        // don't keep the cylinder of the previous segment
+        basepoint.Set(0,0,0);
+        axis.Set(0,0,0);
+        radius = FLOAT_MAX;
         fitter->Clear();
         fitter->AddPoint(tria._aclPoints[0]);
         fitter->AddPoint(tria._aclPoints[1]);
@@ -257,6 +287,14 @@ float CylinderSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
     return (dist - radius);
 }
 
+AbstractSurfaceFit* CylinderSurfaceFit::Clone() const
+{
+    if (!fitter)
+        return new CylinderSurfaceFit(basepoint, axis, radius);
+    else
+        return new CylinderSurfaceFit();
+}
+
 // --------------------------------------------------------
 
 SphereSurfaceFit::SphereSurfaceFit()
@@ -282,6 +320,9 @@ SphereSurfaceFit::~SphereSurfaceFit()
 void SphereSurfaceFit::Initialize(const MeshCore::MeshGeomFacet& tria)
 {
     if (fitter) {
+        // don't keep the sphere of the previous segment
+        center.Set(0,0,0);
+        radius = FLOAT_MAX;
         fitter->Clear();
         fitter->AddPoint(tria._aclPoints[0]);
         fitter->AddPoint(tria._aclPoints[1]);
@@ -332,6 +373,14 @@ float SphereSurfaceFit::GetDistanceToSurface(const Base::Vector3f& pnt) const
     return (dist - radius);
 }
 
+AbstractSurfaceFit* SphereSurfaceFit::Clone() const
+{
+    if (!fitter)
+        return new SphereSurfaceFit(center, radius);
+    else
+        return new SphereSurfaceFit();
+}
+
 // --------------------------------------------------------
 
 MeshDistanceGenericSurfaceFitSegment::MeshDistanceGenericSurfaceFitSegment(AbstractSurfaceFit* fit,
@@ -383,6 +432,14 @@ void MeshDistanceGenericSurfaceFitSegment::AddFacet(const MeshFacet& face)
     fitter->AddTriangle(triangle);
 }
 
+MeshSurfaceSegment* MeshDistanceGenericSurfaceFitSegment::Clone() const
+{
+    AbstractSurfaceFit* fit = fitter->Clone();
+    if (!fit)
+        return nullptr;
+    return new MeshDistanceGenericSurfaceFitSegment(fit, kernel, minFacets, tolerance);
+}
+
 // --------------------------------------------------------
 
 bool MeshCurvaturePlanarSegment::TestFacet (const MeshFacet &rclFacet) const
@@ -471,8 +528,13 @@ bool MeshSurfaceVisitor::Visit (const MeshFacet & face, const MeshFacet &,
 
 // --------------------------------------------------------
 
-void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegment*>& segm)
+void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegment*>& segm, bool parallel)
 {
+    if (parallel) {
+        FindSegmentsParallel(segm);
+        return;
+    }
+
     // reset VISIT flags
     unsigned long startFacet;
     MeshCore::MeshAlgorithm cAlgo(myKernel);
@@ -521,3 +583,230 @@ void MeshSegmentAlgorithm::FindSegments(std::vector<MeshSurfaceSegment*>& segm)
         }
     }
 }
+
+// --------------------------------------------------------
+
+namespace {
+
+// A region grown from a seed facet with its own copy of the surface segment
+struct SegmentRegion
+{
+    SegmentRegion() : seed(0), aborted(false) {}
+
+    unsigned long seed;
+    bool aborted;
+    std::vector<unsigned long> facets;
+};
+
+/*
+ * Grows the regions of a batch of seed facets at once. The regions are grown
+ * as if they were the next one of the serial loop, i.e. only the facets used
+ * before the batch are blocked. A region gives up as soon as it runs into a
+ * facet that a region of a lower seed has already taken because it then
+ * can't be the region of the serial loop.
+ */
+class RegionGrowing
+{
+public:
+    RegionGrowing(const MeshKernel& kernel, MeshSurfaceSegment* surface, bool clone,
+                  const std::vector<char>& visited, std::vector<std::atomic<uint64_t> >& owner)
+      : kernel(kernel), surface(surface), clone(clone), visited(visited), owner(owner)
+      , firstId(0), nextRegion(0)
+    {
+    }
+    void Grow(const std::vector<unsigned long>& seeds, uint64_t id)
+    {
+        firstId = id;
+        regions.clear();
+        regions.resize(seeds.size());
+        for (std::size_t i = 0; i < seeds.size(); i++)
+            regions[i].seed = seeds[i];
+        nextRegion = 0;
+
+        int threads = clone ? std::max(1, QThread::idealThreadCount()) : 1;
+        QList<QFuture<void> > futures;
+        for (int i = 1; i < threads; i++)
+            futures << QtConcurrent::run(this, &RegionGrowing::Run);
+        Run();
+        for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+            it->waitForFinished();
+    }
+    /// Grows the region again when all regions of lower seeds are accepted
+    void Regrow(SegmentRegion& region, uint64_t id)
+    {
+        firstId = id;
+        region.aborted = false;
+        region.facets.clear();
+        if (clone) {
+            std::unique_ptr<MeshSurfaceSegment> copy(surface->Clone());
+            GrowRegion(region, id, copy.get());
+        }
+        else {
+            GrowRegion(region, id, surface);
+        }
+    }
+
+public:
+    std::vector<SegmentRegion> regions;
+
+private:
+    void Run()
+    {
+        for (;;) {
+            std::size_t index = nextRegion++;
+            if (index >= regions.size())
+                break;
+            if (clone) {
+                std::unique_ptr<MeshSurfaceSegment> copy(surface->Clone());
+                GrowRegion(regions[index], firstId + index, copy.get());
+            }
+            else {
+                GrowRegion(regions[index], firstId + index, surface);
+            }
+        }
+    }
+    // Returns false if a region of a lower seed has already taken the facet
+    bool Claim(unsigned long index, uint64_t id, bool& claimed)
+    {
+        uint64_t other = owner[index].load();
+        for (;;) {
+            if (other >= firstId && other < id)
+                return false;
+            if (other == id) {
+                claimed = false;
+                return true;
+            }
+            if (owner[index].compare_exchange_weak(other, id)) {
+                claimed = true;
+                return true;
+            }
+        }
+    }
+    void GrowRegion(SegmentRegion& region, uint64_t id, MeshSurfaceSegment* segm)
+    {
+        const MeshFacetArray& facets = kernel.GetFacets();
+        unsigned long count = facets.size();
+        unsigned long seed = region.seed;
+        bool claimed;
+        if (!Claim(seed, id, claimed)) {
+            region.aborted = true;
+            return;
+        }
+
+        segm->Initialize(seed);
+        if (segm->TestInitialFacet(seed))
+            region.facets.push_back(seed);
+
+        // visit the neighbours level by level like MeshKernel::VisitNeighbourFacets
+        std::vector<unsigned long> worklist(1, seed);
+        for (std::size_t i = 0; i < worklist.size(); i++) {
+            const MeshFacet& face = facets[worklist[i]];
+            for (int j = 0; j < 3; j++) {
+                unsigned long index = face._aulNeighbours[j];
+                if (index >= count || visited[index])
+                    continue;
+                const MeshFacet& next = facets[index];
+                if (!segm->TestFacet(next))
+                    continue;
+                if (!Claim(index, id, claimed)) {
+                    region.aborted = true;
+                    return;
+                }
+                if (claimed) {
+                    region.facets.push_back(index);
+                    segm->AddFacet(next);
+                    worklist.push_back(index);
+                }
+            }
+        }
+    }
+
+private:
+    const MeshKernel& kernel;
+    MeshSurfaceSegment* surface;
+    bool clone;
+    const std::vector<char>& visited;
+    std::vector<std::atomic<uint64_t> >& owner;
+    uint64_t firstId;
+    std::atomic<std::size_t> nextRegion;
+};
+
+}
+
+void MeshSegmentAlgorithm::FindSegmentsParallel(std::vector<MeshSurfaceSegment*>& segm)
+{
+    const MeshFacetArray& facets = myKernel.GetFacets();
+    unsigned long count = facets.size();
+
+    // the facets used by the segments so far, like the VISIT flag of the serial loop
+    std::vector<char> visited(count, 0);
+    // the id of the region that has tentatively taken a facet, the ids grow
+    // from batch to batch so that the ids of older batches need not be reset
+    std::vector<std::atomic<uint64_t> > owner(count);
+    for (std::vector<std::atomic<uint64_t> >::iterator it = owner.begin(); it != owner.end(); ++it)
+        it->store(std::numeric_limits<uint64_t>::max());
+    uint64_t nextId = 0;
+
+    // the result doesn't depend on the number of seeds per batch
+    std::size_t minBatchSize = 4 * static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    std::size_t maxBatchSize = 256 * minBatchSize;
+    std::size_t batchSize = minBatchSize;
+    std::vector<unsigned long> resetVisited;
+
+    for (std::vector<MeshSurfaceSegment*>::iterator it = segm.begin(); it != segm.end(); ++it) {
+        for (std::vector<unsigned long>::iterator jt = resetVisited.begin(); jt != resetVisited.end(); ++jt)
+            visited[*jt] = 0;
+        resetVisited.clear();
+
+        // a surface that cannot be copied grows one region after the other
+        std::unique_ptr<MeshSurfaceSegment> probe((*it)->Clone());
+        bool clone = probe.get() != nullptr;
+        RegionGrowing growing(myKernel, *it, clone, visited, owner);
+
+        unsigned long start = 0;
+        for (;;) {
+            // the next free facets in the order the serial loop takes them as seeds
+            std::vector<unsigned long> seeds;
+            for (unsigned long i = start; i < count && seeds.size() < (clone ? batchSize : 1); i++) {
+                if (!visited[i])
+                    seeds.push_back(i);
+            }
+            if (seeds.empty())
+                break;
+
+            growing.Grow(seeds, nextId);
+            nextId += seeds.size();
+            start = seeds.back() + 1;
+
+            // accept the regions in the order of their seeds, a region that differs
+            // from the one the serial loop would grow is grown again
+            std::size_t regrown = 0;
+            std::vector<SegmentRegion>& regions = growing.regions;
+            for (std::vector<SegmentRegion>::iterator jt = regions.begin(); jt != regions.end(); ++jt) {
+                if (visited[jt->seed])
+                    continue;
+                bool ok = !jt->aborted;
+                for (std::vector<unsigned long>::iterator kt = jt->facets.begin(); ok && kt != jt->facets.end(); ++kt)
+                    ok = !visited[*kt];
+                if (!ok) {
+                    growing.Regrow(*jt, nextId++);
+                    regrown++;
+                }
+
+                visited[jt->seed] = 1;
+                for (std::vector<unsigned long>::iterator kt = jt->facets.begin(); kt != jt->facets.end(); ++kt)
+                    visited[*kt] = 1;
+                if (jt->facets.size() <= 1)
+                    resetVisited.push_back(jt->seed);
+                else
+                    (*it)->AddSegment(jt->facets);
+            }
+
+            // many small regions that don't overlap are grown in bigger batches
+            if (regrown == 0)
+                batchSize = std::min(2 * batchSize, maxBatchSize);
+            else if (4 * regrown > seeds.size())
+                batchSize = std::max(batchSize / 2, minBatchSize);
+        }
+    }
+}
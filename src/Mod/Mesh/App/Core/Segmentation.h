@@ -47,6 +47,9 @@ public:
     virtual void Initialize(unsigned long);
     virtual bool TestInitialFacet(unsigned long) const;
     virtual void AddFacet(const MeshFacet& rclFacet);
+    /// Returns a new object of the same type and parameters without any segments.
+    /// This is needed to grow several segments at once, the default returns null.
+    virtual MeshSurfaceSegment* Clone() const;
     void AddSegment(const std::vector<unsigned long>&);
     const std::vector<MeshSegment>& GetSegments() const { return segments; }
     MeshSegment FindSegment(unsigned long) const;
@@ -78,6 +81,7 @@ public:
     const char* GetType() const { return "Plane"; }
     void Initialize(unsigned long);
     void AddFacet(const MeshFacet& rclFacet);
+    MeshSurfaceSegment* Clone() const;
 
 protected:
     Base::Vector3f basepoint;
@@ -97,6 +101,8 @@ public:
     virtual bool Done() const = 0;
     virtual float Fit() = 0;
     virtual float GetDistanceToSurface(const Base::Vector3f&) const = 0;
+    /// Returns a new fit with the same pre-defined surface, the default returns null.
+    virtual AbstractSurfaceFit* Clone() const { return nullptr; }
 };
 
 class MeshExport PlaneSurfaceFit : public AbstractSurfaceFit
@@ -112,6 +118,7 @@ public:
     bool Done() const;
     float Fit();
     float GetDistanceToSurface(const Base::Vector3f&) const;
+    AbstractSurfaceFit* Clone() const;
 
 private:
     Base::Vector3f basepoint;
@@ -132,6 +139,7 @@ public:
     bool Done() const;
     float Fit();
     float GetDistanceToSurface(const Base::Vector3f&) const;
+    AbstractSurfaceFit* Clone() const;
 
 private:
     Base::Vector3f basepoint;
@@ -153,6 +161,7 @@ public:
     bool Done() const;
     float Fit();
     float GetDistanceToSurface(const Base::Vector3f&) const;
+    AbstractSurfaceFit* Clone() const;
 
 private:
     Base::Vector3f center;
@@ -171,6 +180,7 @@ public:
     void Initialize(unsigned long);
     bool TestInitialFacet(unsigned long) const;
     void AddFacet(const MeshFacet& rclFacet);
+    MeshSurfaceSegment* Clone() const;
 
 protected:
     AbstractSurfaceFit* fitter;
@@ -195,6 +205,8 @@ public:
         : MeshCurvatureSurfaceSegment(ci, minFacets), tolerance(tol) {}
     virtual bool TestFacet (const MeshFacet &rclFacet) const;
     virtual const char* GetType() const { return "Plane"; }
+    virtual MeshSurfaceSegment* Clone() const
+    { return new MeshCurvaturePlanarSegment(info, minFacets, tolerance); }
 
 private:
     float tolerance;
@@ -208,6 +220,8 @@ public:
         : MeshCurvatureSurfaceSegment(ci, minFacets), toleranceMin(tolMin), toleranceMax(tolMax) { curvature = curv;}
     virtual bool TestFacet (const MeshFacet &rclFacet) const;
     virtual const char* GetType() const { return "Cylinder"; }
+    virtual MeshSurfaceSegment* Clone() const
+    { return new MeshCurvatureCylindricalSegment(info, minFacets, toleranceMin, toleranceMax, curvature); }
 
 private:
     float curvature;
@@ -222,6 +236,8 @@ public:
         : MeshCurvatureSurfaceSegment(ci, minFacets), tolerance(tol) { curvature = curv;}
     virtual bool TestFacet (const MeshFacet &rclFacet) const;
     virtual const char* GetType() const { return "Sphere"; }
+    virtual MeshSurfaceSegment* Clone() const
+    { return new MeshCurvatureSphericalSegment(info, minFacets, tolerance, curvature); }
 
 private:
     float curvature;
@@ -237,6 +253,8 @@ public:
           toleranceMin(tolMin), toleranceMax(tolMax) {}
     virtual bool TestFacet (const MeshFacet &rclFacet) const;
     virtual const char* GetType() const { return "Freeform"; }
+    virtual MeshSurfaceSegment* Clone() const
+    { return new MeshCurvatureFreeformSegment(info, minFacets, toleranceMin, toleranceMax, c1, c2); }
 
 private:
     float c1, c2;
@@ -263,7 +281,17 @@ class MeshExport MeshSegmentAlgorithm
 {
 public:
     MeshSegmentAlgorithm(const MeshKernel& kernel) : myKernel(kernel) {}
-    void FindSegments(std::vector<MeshSurfaceSegment*>&);
+    /** Grows the segments of each surface type in the given order, a facet
+     * belongs to one segment at most. In \a parallel mode the segments of
+     * the next free facets are grown at once by different threads. They are
+     * accepted in the order of their start facets as long as they don't
+     * overlap, the others are grown again. So the result is the same as in
+     * serial mode. Surfaces that cannot be cloned are grown serially.
+     */
+    void FindSegments(std::vector<MeshSurfaceSegment*>&, bool parallel = false);
+
+private:
+    void FindSegmentsParallel(std::vector<MeshSurfaceSegment*>&);
 
 private:
     const MeshKernel& myKernel;
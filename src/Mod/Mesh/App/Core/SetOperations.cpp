@@ -20,11 +20,12 @@
  *                                                                         *
  ***************************************************************************/
 
-
 #include "PreCompiled.h"
 
 
 #ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
 # include <ios>
 #endif
 
@@ -41,21 +42,359 @@
 #include "Evaluation.h"
 #include "Definitions.h"
 #include "Triangulation.h"
+#include "Functional.h"
 
 #include <Base/Sequencer.h>
 #include <Base/Builder3D.h>
 #include <Base/Tools2D.h>
+#include <Base/Vector3D.h>
 
 using namespace Base;
 using namespace MeshCore;
 
+namespace {
+
+// smaller numbers of elements are handled by the calling thread
+const unsigned long MinParallelCount = 1000;
+
+// cut points closer than this are merged
+const float MinPointDistance = 0.000001f;
+
+inline Base::Vector3d ToVector(const Base::Vector3f& p)
+{
+    return Base::Vector3d(p.x, p.y, p.z);
+}
+
+// Returns the sign of the volume of the tetrahedron (a,b,c,d), i.e. on which
+// side of the plane through a, b and c the point d lies. The volume is computed
+// in double precision and if its magnitude is below the bound of the rounding
+// error (Shewchuk's orient3d filter) the point is considered to be in the plane.
+int Orientation(const Base::Vector3d& a, const Base::Vector3d& b, const Base::Vector3d& c,
+                const Base::Vector3d& d, double& det)
+{
+    Base::Vector3d ad = a - d, bd = b - d, cd = c - d;
+    double bc = bd.y * cd.z - bd.z * cd.y;
+    double ca = bd.z * cd.x - bd.x * cd.z;
+    double ab = bd.x * cd.y - bd.y * cd.x;
+    det = ad.x * bc + ad.y * ca + ad.z * ab;
+
+    double permanent = (fabs(bd.y * cd.z) + fabs(bd.z * cd.y)) * fabs(ad.x)
+                     + (fabs(bd.z * cd.x) + fabs(bd.x * cd.z)) * fabs(ad.y)
+                     + (fabs(bd.x * cd.y) + fabs(bd.y * cd.x)) * fabs(ad.z);
+    double errBound = 7.7715611723761027e-16 * permanent;
+    if (det > errBound)
+        return 1;
+    if (det < -errBound)
+        return -1;
+    return 0;
+}
+
+// Computes the points where the triangle crosses the plane of the other facet.
+// The signs and determinants are those of the corner points computed by Orientation().
+int PlaneSection(const Base::Vector3d* pts, const int* sign, const double* det, Base::Vector3d* sec)
+{
+    int count = 0;
+    for (int i=0; i<3 && count<2; i++) {
+        int j = (i+1)%3;
+        if (sign[i] == 0) {
+            sec[count++] = pts[i];
+        }
+        else if (sign[i] * sign[j] < 0) {
+            double t = det[i] / (det[i] - det[j]);
+            sec[count++] = pts[i] + (pts[j] - pts[i]) * t;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Computes the line segment where the two facets intersect. Unlike
+ * MeshGeomFacet::IntersectWithFacet() the sides of the corner points are
+ * determined with a filtered predicate, so that nearly co-planar facets don't
+ * give arbitrary cut lines. Facets in the same plane are not considered as
+ * intersecting because they don't separate the surfaces.
+ * Returns 0 if the facets don't intersect, 1 if they touch in a point and 2
+ * if they intersect in a line segment.
+ */
+int IntersectFacets(const MeshGeomFacet& f1, const MeshGeomFacet& f2, Base::Vector3f& rclPt0, Base::Vector3f& rclPt1)
+{
+    Base::Vector3d a[3], b[3];
+    for (int i=0; i<3; i++) {
+        a[i] = ToVector(f1._aclPoints[i]);
+        b[i] = ToVector(f2._aclPoints[i]);
+    }
+
+    int sa[3], sb[3];
+    double da[3], db[3];
+    for (int i=0; i<3; i++)
+        sa[i] = Orientation(b[0], b[1], b[2], a[i], da[i]);
+    if ((sa[0] > 0 && sa[1] > 0 && sa[2] > 0) || (sa[0] < 0 && sa[1] < 0 && sa[2] < 0))
+        return 0;
+    if (sa[0] == 0 && sa[1] == 0 && sa[2] == 0)
+        return 0; // co-planar
+
+    for (int i=0; i<3; i++)
+        sb[i] = Orientation(a[0], a[1], a[2], b[i], db[i]);
+    if ((sb[0] > 0 && sb[1] > 0 && sb[2] > 0) || (sb[0] < 0 && sb[1] < 0 && sb[2] < 0))
+        return 0;
+    if (sb[0] == 0 && sb[1] == 0 && sb[2] == 0)
+        return 0; // co-planar
+
+    Base::Vector3d secA[2], secB[2];
+    int numA = PlaneSection(a, sa, da, secA);
+    int numB = PlaneSection(b, sb, db, secB);
+    if (numA == 0 || numB == 0)
+        return 0;
+    if (numA == 1)
+        secA[1] = secA[0];
+    if (numB == 1)
+        secB[1] = secB[0];
+
+    // both sections lie on the line where the two planes meet
+    Base::Vector3d dir = ((a[1] - a[0]) % (a[2] - a[0])) % ((b[1] - b[0]) % (b[2] - b[0]));
+    double tA[2] = { dir * secA[0], dir * secA[1] };
+    double tB[2] = { dir * secB[0], dir * secB[1] };
+    if (tA[0] > tA[1]) {
+        std::swap(tA[0], tA[1]);
+        std::swap(secA[0], secA[1]);
+    }
+    if (tB[0] > tB[1]) {
+        std::swap(tB[0], tB[1]);
+        std::swap(secB[0], secB[1]);
+    }
+
+    if (tA[1] < tB[0] || tB[1] < tA[0])
+        return 0;
+
+    const Base::Vector3d& p0 = tA[0] > tB[0] ? secA[0] : secB[0];
+    const Base::Vector3d& p1 = tA[1] < tB[1] ? secA[1] : secB[1];
+    rclPt0.Set(static_cast<float>(p0.x), static_cast<float>(p0.y), static_cast<float>(p0.z));
+    rclPt1.Set(static_cast<float>(p1.x), static_cast<float>(p1.y), static_cast<float>(p1.z));
+    return rclPt0 == rclPt1 ? 1 : 2;
+}
+
+struct FacetCut
+{
+    unsigned long facet0, facet1;
+    Base::Vector3f pt0, pt1;
+};
+
+// Intersects the facets of the first mesh with the candidates found in the grid of the second mesh
+struct CutFacets
+{
+    typedef void result_type;
+    CutFacets(const MeshKernel& mesh0, const MeshKernel& mesh1, const MeshFacetGrid& grid1,
+              std::vector< std::vector<FacetCut> >& cuts)
+      : mesh0(&mesh0), mesh1(&mesh1), grid1(&grid1), cuts(&cuts) {}
+    void operator()(unsigned long begin, unsigned long end, int block) const
+    {
+        std::vector<FacetCut>& result = (*cuts)[block];
+        std::vector<unsigned long> candidates;
+        for (unsigned long i = begin; i < end; i++) {
+            MeshGeomFacet f1 = mesh0->GetFacet(i);
+            Base::BoundBox3f box1 = f1.GetBoundBox();
+            grid1->Inside(box1, candidates);
+
+            for (std::vector<unsigned long>::iterator it = candidates.begin(); it != candidates.end(); ++it) {
+                MeshGeomFacet f2 = mesh1->GetFacet(*it);
+                if (!box1.Intersect(f2.GetBoundBox()))
+                    continue;
+
+                FacetCut cut;
+                if (IntersectFacets(f1, f2, cut.pt0, cut.pt1) > 0) {
+                    cut.facet0 = i;
+                    cut.facet1 = *it;
+                    result.push_back(cut);
+                }
+            }
+        }
+    }
+
+    const MeshKernel* mesh0;
+    const MeshKernel* mesh1;
+    const MeshFacetGrid* grid1;
+    std::vector< std::vector<FacetCut> >* cuts;
+};
+
+// Re-triangulates a facet with the points where it is cut by the other mesh
+struct TriangulateFacets
+{
+    typedef std::set<MeshPoint, MeshPoint_Less> PointSet;
+    typedef std::map<unsigned long, std::list<PointSet::iterator> > FacetPoints;
+    typedef void result_type;
+    TriangulateFacets(const MeshKernel& mesh, const std::vector<FacetPoints::const_iterator>& cutFacets,
+                      float minDistanceToPoint, const MeshPoint_Less& pointLess,
+                      std::vector< std::vector<MeshGeomFacet> >& facets)
+      : mesh(&mesh), cutFacets(&cutFacets), minDistanceToPoint(minDistanceToPoint)
+      , pointLess(pointLess), facets(&facets) {}
+    void operator()(unsigned long begin, unsigned long end, int) const
+    {
+        for (unsigned long i = begin; i < end; i++) {
+            const FacetPoints::const_iterator& it1 = (*cutFacets)[i];
+            Triangulate(mesh->GetFacet(it1->first), it1->second, (*facets)[i]);
+        }
+    }
+    void Triangulate(const MeshGeomFacet& f, const std::list<PointSet::iterator>& cutPoints,
+                     std::vector<MeshGeomFacet>& result) const
+    {
+        std::vector<Vector3f> points;
+        PointSet              pointsSet(pointLess);
+
+        // facet corner points
+        int i;
+        for (i = 0; i < 3; i++)
+        {
+          pointsSet.insert(f._aclPoints[i]);
+          points.push_back(f._aclPoints[i]);
+        }
+
+        // triangulated facets
+        std::list<PointSet::iterator>::const_iterator it2;
+        for (it2 = cutPoints.begin(); it2 != cutPoints.end(); ++it2)
+        {
+          if (pointsSet.find(*(*it2)) == pointsSet.end())
+          {
+            pointsSet.insert(*(*it2));
+            points.push_back(*(*it2));
+          }
+        }
+
+        Vector3f normal = f.GetNormal();
+        Vector3f base = points[0];
+        Vector3f dirX = points[1] - points[0];
+        dirX.Normalize();
+        Vector3f dirY = dirX % normal;
+
+        // project points to 2D plane
+        std::vector<Vector3f>::iterator it;
+        std::vector<Vector3f> vertices;
+        for (it = points.begin(); it != points.end(); ++it)
+        {
+          Vector3f pv = *it;
+          pv.TransformToCoordinateSystem(base, dirX, dirY);
+          vertices.push_back(pv);
+        }
+
+        DelaunayTriangulator tria;
+        tria.SetTolerance(pointLess.GetTolerance());
+        tria.SetPolygon(vertices);
+        tria.TriangulatePolygon();
+
+        std::vector<MeshFacet> facets = tria.GetFacets();
+        for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
+        {
+          if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
+              (it->_aulPoints[1] == it->_aulPoints[2]) ||
+              (it->_aulPoints[2] == it->_aulPoints[0]))
+          { // two same triangle corner points
+            continue;
+          }
+
+          MeshGeomFacet facet(points[it->_aulPoints[0]],
+                              points[it->_aulPoints[1]],
+                              points[it->_aulPoints[2]]);
+
+          float dist0 = facet._aclPoints[0].DistanceToLine
+              (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
+          float dist1 = facet._aclPoints[1].DistanceToLine
+              (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
+          float dist2 = facet._aclPoints[2].DistanceToLine
+              (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
+
+          if ((dist0 < minDistanceToPoint) ||
+              (dist1 < minDistanceToPoint) ||
+              (dist2 < minDistanceToPoint))
+          {
+            continue;
+          }
+
+          facet.CalcNormal();
+          if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
+          { // adjust normal
+             std::swap(facet._aclPoints[0], facet._aclPoints[1]);
+             facet.CalcNormal();
+          }
+
+          result.push_back(facet);
+        }
+    }
+
+    const MeshKernel* mesh;
+    const std::vector<FacetPoints::const_iterator>* cutFacets;
+    float minDistanceToPoint;
+    MeshPoint_Less pointLess;
+    std::vector< std::vector<MeshGeomFacet> >* facets;
+};
+
+// Sums up the solid angles of the facets of a mesh as seen from each of the query points
+struct SolidAngles
+{
+    typedef void result_type;
+    SolidAngles(const MeshKernel& mesh, const std::vector<Base::Vector3d>& points,
+                std::vector< std::vector<double> >& angles)
+      : mesh(&mesh), points(&points), angles(&angles) {}
+    void operator()(unsigned long begin, unsigned long end, int block) const
+    {
+        const MeshPointArray& rPoints = mesh->GetPoints();
+        const MeshFacetArray& rFacets = mesh->GetFacets();
+        std::vector<double>& sum = (*angles)[block];
+        sum.resize(points->size(), 0.0);
+
+        for (unsigned long i = begin; i < end; i++) {
+            const MeshFacet& face = rFacets[i];
+            Base::Vector3d p0 = ToVector(rPoints[face._aulPoints[0]]);
+            Base::Vector3d p1 = ToVector(rPoints[face._aulPoints[1]]);
+            Base::Vector3d p2 = ToVector(rPoints[face._aulPoints[2]]);
+
+            // solid angle of the triangle by Van Oosterom and Strackee
+            for (std::size_t j = 0; j < points->size(); j++) {
+                const Base::Vector3d& q = (*points)[j];
+                Base::Vector3d a = p0 - q, b = p1 - q, c = p2 - q;
+                double la = a.Length(), lb = b.Length(), lc = c.Length();
+                double num = a * (b % c);
+                double den = la * lb * lc + (a * b) * lc + (b * c) * la + (c * a) * lb;
+                sum[j] += 2.0 * atan2(num, den);
+            }
+        }
+    }
+
+    const MeshKernel* mesh;
+    const std::vector<Base::Vector3d>* points;
+    std::vector< std::vector<double> >* angles;
+};
+
+// Computes the generalized winding numbers of the points with respect to the mesh.
+// For a closed mesh with outward normals it is 1 inside and 0 outside the mesh.
+std::vector<double> WindingNumbers(const MeshKernel& mesh, const std::vector<Base::Vector3d>& points)
+{
+    unsigned long numFacets = mesh.CountFacets();
+    int blocks = count_blocks(numFacets, MinParallelCount);
+    std::vector< std::vector<double> > angles(blocks);
+    parallel_blocks(numFacets, blocks, SolidAngles(mesh, points, angles));
+
+    std::vector<double> winding(points.size(), 0.0);
+    for (int i = 0; i < blocks; i++) {
+        for (std::size_t j = 0; j < angles[i].size(); j++)
+            winding[j] += angles[i][j];
+    }
+    for (std::size_t j = 0; j < winding.size(); j++)
+        winding[j] /= 4.0 * D_PI;
+    return winding;
+}
+
+}
+
 
 SetOperations::SetOperations (const MeshKernel &cutMesh1, const MeshKernel &cutMesh2, MeshKernel &result, OperationType opType, float minDistanceToPoint)
 : _cutMesh0(cutMesh1),
   _cutMesh1(cutMesh2),
   _resultMesh(result),
   _operationType(opType),
-  _minDistanceToPoint(minDistanceToPoint)
+  _minDistanceToPoint(minDistanceToPoint),
+  _pointLess(float(sqrt((MinPointDistance * MinPointDistance) / 3.0f))),
+  _cutPoints(_pointLess),
+  _edges(Edge_Less(_pointLess))
 {
 }
 
@@ -65,49 +404,13 @@ SetOperations::~SetOperations (void)
 
 void SetOperations::Do ()
 {
- _minDistanceToPoint = 0.000001f;
-  float saveMinMeshDistance = MeshDefinitions::_fMinPointDistance;
-  MeshDefinitions::SetMinPointDistance(0.000001f);
-
-//  Base::Sequencer().start("set operation", 5);
-
-  // _builder.clear();
+  _minDistanceToPoint = MinPointDistance;
 
-  //Base::Sequencer().next();
   std::set<unsigned long> facetsCuttingEdge0, facetsCuttingEdge1;
   Cut(facetsCuttingEdge0, facetsCuttingEdge1);
 
-  // no intersection curve of the meshes found
-  if (facetsCuttingEdge0.empty() || facetsCuttingEdge1.empty())
-  {
-    switch (_operationType)
-    {
-      case Union:
-          {
-            _resultMesh = _cutMesh0;
-            _resultMesh.Merge(_cutMesh1);
-          } break;
-      case Intersect:
-          {
-            _resultMesh.Clear();
-          } break;
-      case Difference:
-      case Inner:
-      case Outer:
-          {
-            _resultMesh = _cutMesh0;
-          } break;
-      default:
-          {
-            _resultMesh.Clear();
-            break;
-          }
-    }
-    
-    MeshDefinitions::SetMinPointDistance(saveMinMeshDistance);
-    return;
-  }
-
+  // If the meshes don't intersect the whole shells are classified below,
+  // so that e.g. a mesh enclosed by the other one is handled correctly.
   unsigned long i;
   for (i = 0; i < _cutMesh0.CountFacets(); i++)
   {
@@ -121,10 +424,7 @@ void SetOperations::Do ()
       _newMeshFacets[1].push_back(_cutMesh1.GetFacet(i));
   }
 
-  //Base::Sequencer().next();
   TriangulateMesh(_cutMesh0, 0);
-
-  //Base::Sequencer().next();
   TriangulateMesh(_cutMesh1, 1);
 
   float mult0, mult1;
@@ -138,9 +438,7 @@ void SetOperations::Do ()
     default:          mult0 =  0.0f; mult1 =  0.0f;  break;
   }
 
-  //Base::Sequencer().next();
   CollectFacets(0, mult0);
-  //Base::Sequencer().next();
   CollectFacets(1, mult1);
 
   std::vector<MeshGeomFacet> facets;
@@ -148,300 +446,167 @@ void SetOperations::Do ()
   std::vector<MeshGeomFacet>::iterator itf;
   for (itf = _facetsOf[0].begin(); itf != _facetsOf[0].end(); ++itf)
   {
-    if (_operationType == Difference)
-    { // toggle normal
-      std::swap(itf->_aclPoints[0], itf->_aclPoints[1]);
-      itf->CalcNormal();
-    }
-
     facets.push_back(*itf);
   }
 
   for (itf = _facetsOf[1].begin(); itf != _facetsOf[1].end(); ++itf)
   {
+    if (_operationType == Difference)
+    { // the part of the second mesh inside the first one bounds the result from inside
+      std::swap(itf->_aclPoints[0], itf->_aclPoints[1]);
+      itf->CalcNormal();
+    }
+
     facets.push_back(*itf);
   }
 
-  _resultMesh = facets;
-
-   //Base::Sequencer().stop();
-  // _builder.saveToFile("c:/temp/vdbg.iv");
-
-  MeshDefinitions::SetMinPointDistance(saveMinMeshDistance);
+  MeshBuilder builder(_resultMesh);
+  builder.SetTolerance(_pointLess.GetTolerance());
+  builder.Initialize(facets.size());
+  for (std::vector<MeshGeomFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
+    builder.AddFacet(*it);
+  builder.Finish();
 }
 
 void SetOperations::Cut (std::set<unsigned long>& facetsCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1)
 {
-  MeshFacetGrid grid1(_cutMesh0, 20);
-  MeshFacetGrid grid2(_cutMesh1, 20);
-
-  unsigned long ctGx1, ctGy1, ctGz1;
-  grid1.GetCtGrids(ctGx1, ctGy1, ctGz1);
-
-  unsigned long gx1;
-  for (gx1 = 0; gx1 < ctGx1; gx1++)  
+  // Search the intersecting facet pairs with several threads. Each thread handles
+  // a range of facets of the first mesh and looks up the candidates of the second
+  // mesh in its grid. The results are merged in facet order afterwards so that
+  // the outcome doesn't depend on the number of threads.
+  unsigned long ulX, ulY, ulZ;
+  MeshFacetGrid::CalculateGridSize(_cutMesh1, ulX, ulY, ulZ);
+  MeshFacetGrid grid1(_cutMesh1, ulX, ulY, ulZ);
+  unsigned long numFacets = _cutMesh0.CountFacets();
+  int blocks = count_blocks(numFacets, MinParallelCount);
+  std::vector< std::vector<FacetCut> > cuts(blocks);
+  parallel_blocks(numFacets, blocks, CutFacets(_cutMesh0, _cutMesh1, grid1, cuts));
+
+  for (std::vector< std::vector<FacetCut> >::iterator jt = cuts.begin(); jt != cuts.end(); ++jt)
   {
-    unsigned long gy1;
-    for (gy1 = 0; gy1 < ctGy1; gy1++)
+    for (std::vector<FacetCut>::iterator it = jt->begin(); it != jt->end(); ++it)
     {
-      unsigned long gz1;
-      for (gz1 = 0; gz1 < ctGz1; gz1++)
+      unsigned long fidx1 = it->facet0;
+      unsigned long fidx2 = it->facet1;
+      MeshGeomFacet f1 = _cutMesh0.GetFacet(fidx1);
+      MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
+      MeshPoint p0 = it->pt0, p1 = it->pt1;
+
+      // optimize cut line if distance to nearest point is too small
+      float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
+      MeshPoint np0 = p0, np1 = p1;
+      int i;
+      for (i = 0; i < 3; i++)
       {
-        if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
+        float d1 = (f1._aclPoints[i] - p0).Length();
+        float d2 = (f1._aclPoints[i] - p1).Length();
+        if (d1 < minDist1)
         {
-          std::vector<unsigned long> vecFacets2;
-          grid2.Inside(grid1.GetBoundBox(gx1, gy1, gz1), vecFacets2);
-      
-          if (vecFacets2.size() > 0)
-          {
-            std::set<unsigned long> vecFacets1;
-            grid1.GetElements(gx1, gy1, gz1, vecFacets1);
-            
-            std::set<unsigned long>::iterator it1;
-            for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
-            {
-              unsigned long fidx1 = *it1;
-              MeshGeomFacet f1 = _cutMesh0.GetFacet(*it1);
-              
-              std::vector<unsigned long>::iterator it2;
-              for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
-              {
-                unsigned long fidx2 = *it2;
-                MeshGeomFacet f2 = _cutMesh1.GetFacet(fidx2);
-
-                MeshPoint p0, p1;
-
-                int isect = f1.IntersectWithFacet(f2, p0, p1);
-                if (isect > 0)
-                { 
-                   // optimize cut line if distance to nearest point is too small
-                  float minDist1 = _minDistanceToPoint, minDist2 = _minDistanceToPoint;
-                  MeshPoint np0 = p0, np1 = p1;
-                  int i;
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f1._aclPoints[i] - p0).Length();
-                    float d2 = (f1._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f1._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      p1 = f1._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  // optimize cut line if distance to nearest point is too small
-                  for (i = 0; i < 3; i++)
-                  {
-                    float d1 = (f2._aclPoints[i] - p0).Length();
-                    float d2 = (f2._aclPoints[i] - p1).Length();
-                    if (d1 < minDist1)
-                    {
-                      minDist1 = d1;
-                      np0 = f2._aclPoints[i];
-                    }
-                    if (d2 < minDist2)
-                    {
-                      minDist2 = d2;
-                      np1 = f2._aclPoints[i];
-                    }
-                  } // for (int i = 0; i < 3; i++)
-
-                  MeshPoint mp0 = np0;
-                  MeshPoint mp1 = np1;
-
-                  if (mp0 != mp1)
-                  {
-                    facetsCuttingEdge0.insert(fidx1);
-                    facetsCuttingEdge1.insert(fidx2);
-
-                    _cutPoints.insert(mp0);
-                    _cutPoints.insert(mp1);
-
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit0 = _cutPoints.insert(mp0);
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit1 = _cutPoints.insert(mp1);
-
-                    _edges[Edge(mp0, mp1)] = EdgeInfo();
-
-                    _facet2points[0][fidx1].push_back(pit0.first);
-                    _facet2points[0][fidx1].push_back(pit1.first);
-                    _facet2points[1][fidx2].push_back(pit0.first);
-                    _facet2points[1][fidx2].push_back(pit1.first);
-
-                  }
-                  else
-                  {
-                    std::pair<std::set<MeshPoint>::iterator, bool> pit = _cutPoints.insert(mp0);
-
-                    // do not insert a facet when only one corner point cuts the edge
-                    // if (!((mp0 == f1._aclPoints[0]) || (mp0 == f1._aclPoints[1]) || (mp0 == f1._aclPoints[2])))
-                    {
-                      facetsCuttingEdge0.insert(fidx1);
-                      _facet2points[0][fidx1].push_back(pit.first);
-                    }
-
-                    // if (!((mp0 == f2._aclPoints[0]) || (mp0 == f2._aclPoints[1]) || (mp0 == f2._aclPoints[2])))
-                    {
-                      facetsCuttingEdge1.insert(fidx2);
-                      _facet2points[1][fidx2].push_back(pit.first);
-                    }
-                  }
-
-                 } // if (f1.IntersectWithFacet(f2, p0, p1))
-              } // for (it2 = vecFacets2.begin(); it2 != vecFacets2.end(); ++it2)
-            } // for (it1 = vecFacets1.begin(); it1 != vecFacets1.end(); ++it1)
-          } // if (vecFacets2.size() > 0)
-        } // if (grid1.GetCtElements(gx1, gy1, gz1) > 0)
-      } // for (gz1 = 0; gz1 < ctGz1; gz1++)
-    } // for (gy1 = 0; gy1 < ctGy1; gy1++)
-  } // for (gx1 = 0; gx1 < ctGx1; gx1++)  
-}
-
-void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
-{
-  // Triangulate Mesh 
-  std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> >::iterator it1;
-  for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
-  {
-    std::vector<Vector3f> points;
-    std::set<MeshPoint>   pointsSet;
-
-    unsigned long fidx = it1->first;
-    MeshGeomFacet f = cutMesh.GetFacet(fidx);
-
-    //if (side == 1)
-    //    _builder.addSingleTriangle(f._aclPoints[0], f._aclPoints[1], f._aclPoints[2], 3, 0, 1, 1);
+          minDist1 = d1;
+          np0 = f1._aclPoints[i];
+        }
+        if (d2 < minDist2)
+        {
+          minDist2 = d2;
+          np1 = f1._aclPoints[i];
+        }
+      } // for (int i = 0; i < 3; i++)
 
-     // facet corner points
-    //const MeshFacet& mf = cutMesh._aclFacetArray[fidx];
-    int i;
-    for (i = 0; i < 3; i++)
-    {
-      pointsSet.insert(f._aclPoints[i]);
-      points.push_back(f._aclPoints[i]);
-    }
-    
-    // triangulated facets
-    std::list<std::set<MeshPoint>::iterator>::iterator it2;
-    for (it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
-    {
-      if (pointsSet.find(*(*it2)) == pointsSet.end())
+      // optimize cut line if distance to nearest point is too small
+      for (i = 0; i < 3; i++)
       {
-        pointsSet.insert(*(*it2));
-        points.push_back(*(*it2));
-      }
+        float d1 = (f2._aclPoints[i] - p0).Length();
+        float d2 = (f2._aclPoints[i] - p1).Length();
+        if (d1 < minDist1)
+        {
+          minDist1 = d1;
+          np0 = f2._aclPoints[i];
+        }
+        if (d2 < minDist2)
+        {
+          minDist2 = d2;
+          np1 = f2._aclPoints[i];
+        }
+      } // for (int i = 0; i < 3; i++)
 
-    }
+      MeshPoint mp0 = np0;
+      MeshPoint mp1 = np1;
 
-    Vector3f normal = f.GetNormal();
-    Vector3f base = points[0];
-    Vector3f dirX = points[1] - points[0];
-    dirX.Normalize();
-    Vector3f dirY = dirX % normal;
+      if (_pointLess(mp0, mp1) || _pointLess(mp1, mp0))
+      {
+        facetsCuttingEdge0.insert(fidx1);
+        facetsCuttingEdge1.insert(fidx2);
 
-    // project points to 2D plane
-    std::vector<Vector3f>::iterator it;
-    std::vector<Vector3f> vertices;
-    for (it = points.begin(); it != points.end(); ++it)
-    {
-      Vector3f pv = *it;
-      pv.TransformToCoordinateSystem(base, dirX, dirY);
-      vertices.push_back(pv);
-    }
+        std::pair<std::set<MeshPoint, MeshPoint_Less>::iterator, bool> pit0 = _cutPoints.insert(mp0);
+        std::pair<std::set<MeshPoint, MeshPoint_Less>::iterator, bool> pit1 = _cutPoints.insert(mp1);
 
-    DelaunayTriangulator tria;
-    tria.SetPolygon(vertices);
-    tria.TriangulatePolygon();
+        _edges[Edge(mp0, mp1, _pointLess)] = EdgeInfo();
 
-    std::vector<MeshFacet> facets = tria.GetFacets();
-    for (std::vector<MeshFacet>::iterator it = facets.begin(); it != facets.end(); ++it)
-    {
-      if ((it->_aulPoints[0] == it->_aulPoints[1]) ||
-          (it->_aulPoints[1] == it->_aulPoints[2]) ||
-          (it->_aulPoints[2] == it->_aulPoints[0]))
-      { // two same triangle corner points
-        continue;
+        _facet2points[0][fidx1].push_back(pit0.first);
+        _facet2points[0][fidx1].push_back(pit1.first);
+        _facet2points[1][fidx2].push_back(pit0.first);
+        _facet2points[1][fidx2].push_back(pit1.first);
       }
-  
-      MeshGeomFacet facet(points[it->_aulPoints[0]],
-                          points[it->_aulPoints[1]],
-                          points[it->_aulPoints[2]]);
-
-      //if (side == 1)
-      // _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
-      //if (facet.Area() < 0.0001f)
-      //{ // too small facet
-      //  continue;
-      //}
-
-      float dist0 = facet._aclPoints[0].DistanceToLine
-          (facet._aclPoints[1],facet._aclPoints[1] - facet._aclPoints[2]);
-      float dist1 = facet._aclPoints[1].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[2]);
-      float dist2 = facet._aclPoints[2].DistanceToLine
-          (facet._aclPoints[0],facet._aclPoints[0] - facet._aclPoints[1]);
-
-      if ((dist0 < _minDistanceToPoint) ||
-          (dist1 < _minDistanceToPoint) ||
-          (dist2 < _minDistanceToPoint))
+      else
       {
-        continue;
-      }
+        std::pair<std::set<MeshPoint, MeshPoint_Less>::iterator, bool> pit = _cutPoints.insert(mp0);
 
-      //dist0 = (facet._aclPoints[0] - facet._aclPoints[1]).Length();
-      //dist1 = (facet._aclPoints[1] - facet._aclPoints[2]).Length();
-      //dist2 = (facet._aclPoints[2] - facet._aclPoints[3]).Length();
+        facetsCuttingEdge0.insert(fidx1);
+        _facet2points[0][fidx1].push_back(pit.first);
 
-      //if ((dist0 < _minDistanceToPoint) || (dist1 < _minDistanceToPoint) || (dist2 < _minDistanceToPoint))
-      //{
-      //  continue;
-      //}
-
-      facet.CalcNormal();
-      if ((facet.GetNormal() * f.GetNormal()) < 0.0f)
-      { // adjust normal
-         std::swap(facet._aclPoints[0], facet._aclPoints[1]);
-         facet.CalcNormal();
+        facetsCuttingEdge1.insert(fidx2);
+        _facet2points[1][fidx2].push_back(pit.first);
       }
+    }
+  }
+}
 
-
+void SetOperations::TriangulateMesh (const MeshKernel &cutMesh, int side)
+{
+  // Triangulate the cut facets with several threads
+  typedef TriangulateFacets::FacetPoints FacetPoints;
+  std::vector<FacetPoints::const_iterator> cutFacets;
+  cutFacets.reserve(_facet2points[side].size());
+  for (FacetPoints::const_iterator it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+    cutFacets.push_back(it1);
+
+  std::vector< std::vector<MeshGeomFacet> > triangulation(cutFacets.size());
+  parallel_blocks(cutFacets.size(), count_blocks(cutFacets.size(), MinParallelCount),
+                  TriangulateFacets(cutMesh, cutFacets, _minDistanceToPoint, _pointLess, triangulation));
+
+  for (std::size_t k = 0; k < cutFacets.size(); k++)
+  {
+    unsigned long fidx = cutFacets[k]->first;
+    std::vector<MeshGeomFacet>::iterator it;
+    for (it = triangulation[k].begin(); it != triangulation[k].end(); ++it)
+    {
+      MeshGeomFacet& facet = *it;
       int j;
       for (j = 0; j < 3; j++)
       {
-        std::map<Edge, EdgeInfo>::iterator eit = _edges.find(Edge(facet._aclPoints[j], facet._aclPoints[(j+1)%3]));
+        std::map<Edge, EdgeInfo, Edge_Less>::iterator eit = _edges.find(Edge(facet._aclPoints[j], facet._aclPoints[(j+1)%3], _pointLess));
 
         if (eit != _edges.end())
         {
-
           if (eit->second.fcounter[side] < 2)
           {
-            //if (side == 0)
-            //   _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3, 0, 1, 1);
-
             eit->second.facet[side] = fidx;
             eit->second.facets[side][eit->second.fcounter[side]] = facet;
             eit->second.fcounter[side]++;
             facet.SetFlag(MeshFacet::MARKED); // set all facets connected to an edge: MARKED
-
           }
         }
       }
 
       _newMeshFacets[side].push_back(facet);
-
-    } // for (i = 0; i < (out->numberoftriangles * 3); i += 3)
-  } // for (it1 = _facet2points[side].begin(); it1 != _facet2points[side].end(); ++it1)
+    }
+  }
 }
 
 void SetOperations::CollectFacets (int side, float mult)
 {
-  // float distSave = MeshDefinitions::_fMinPointDistance;
-  //MeshDefinitions::SetMinPointDistance(1.0e-4f);
+  if (mult == 0.0f)
+    return; // nothing of this mesh goes into the result
 
   MeshKernel mesh;
   MeshBuilder mb(mesh);
@@ -449,19 +614,18 @@ void SetOperations::CollectFacets (int side, float mult)
   std::vector<MeshGeomFacet>::iterator it;
   for (it = _newMeshFacets[side].begin(); it != _newMeshFacets[side].end(); ++it)
   {
-    //if (it->IsFlag(MeshFacet::MARKED))
-    //{
-    //  _builder.addSingleTriangle(it->_aclPoints[0], it->_aclPoints[1], it->_aclPoints[2], true, 3.0, 0.0, 1.0, 1.0);
-    //}
     mb.AddFacet(*it, true);
   }
   mb.Finish();
 
   MeshAlgorithm algo(mesh);
-  algo.ResetFacetFlag((MeshFacet::TFlagType)(MeshFacet::VISIT | MeshFacet::TMP0));
+  algo.ResetFacetFlag(MeshFacet::VISIT);
 
-  // bool hasFacetsNotVisited = true; // until facets not visited
-  // search for facet not visited
+  // The cut lines split the mesh into regions which are either completely
+  // inside or outside of the other mesh. Collect the regions and take a facet
+  // of each region far from the cut lines to classify it.
+  std::vector< std::vector<unsigned long> > regions;
+  std::vector<Base::Vector3d> samples;
   MeshFacetArray::_TConstIterator itf;
   const MeshFacetArray& rFacets = mesh.GetFacets();
   for (itf = rFacets.begin(); itf != rFacets.end(); ++itf)
@@ -470,38 +634,52 @@ void SetOperations::CollectFacets (int side, float mult)
     { // Facet found, visit neighbours
       std::vector<unsigned long> facets;
       facets.push_back(itf - rFacets.begin()); // add seed facet
-      CollectFacetVisitor visitor(mesh, facets, _edges, side, mult, _builder); 
+      CollectFacetVisitor visitor(mesh, facets, _edges);
       mesh.VisitNeighbourFacets(visitor, itf - rFacets.begin());
-      
-      if (visitor._addFacets == 0)
-      { // mark all facets to add it to the result
-        algo.SetFacetsFlag(facets, MeshFacet::TMP0);
+
+      // prefer the biggest facet not attached to a cut line
+      unsigned long sample = facets.front();
+      bool marked = true;
+      float area = -1.0f;
+      for (std::vector<unsigned long>::iterator jt = facets.begin(); jt != facets.end(); ++jt)
+      {
+        const MeshFacet& face = rFacets[*jt];
+        float size = mesh.GetFacet(face).Area();
+        bool isMarked = face.IsFlag(MeshFacet::MARKED);
+        if ((marked && !isMarked) || (marked == isMarked && size > area))
+        {
+          sample = *jt;
+          marked = isMarked;
+          area = size;
+        }
       }
+
+      samples.push_back(ToVector(mesh.GetFacet(sample).GetGravityPoint()));
+      regions.push_back(facets);
     }
   }
 
-  // add all facets to the result vector
-  for (itf = rFacets.begin(); itf != rFacets.end(); ++itf)
+  const MeshKernel& other = side == 0 ? _cutMesh1 : _cutMesh0;
+  std::vector<double> winding = WindingNumbers(other, samples);
+
+  // add all facets of the matching regions to the result vector
+  for (std::size_t k = 0; k < regions.size(); k++)
   {
-    if (itf->IsFlag(MeshFacet::TMP0))
+    bool inside = fabs(winding[k]) > 0.5;
+    if (inside == (mult > 0.0f))
     {
-      _facetsOf[side].push_back(mesh.GetFacet(*itf));
+      std::vector<unsigned long>::iterator jt;
+      for (jt = regions[k].begin(); jt != regions[k].end(); ++jt)
+        _facetsOf[side].push_back(mesh.GetFacet(*jt));
     }
   }
-
-  // MeshDefinitions::SetMinPointDistance(distSave);
 }
 
 SetOperations::CollectFacetVisitor::CollectFacetVisitor (const MeshKernel& mesh, std::vector<unsigned long>& facets,
-                                                         std::map<Edge, EdgeInfo>& edges, int side, float mult,
-                                                         Base::Builder3D& builder)
+                                                         const std::map<Edge, EdgeInfo, Edge_Less>& edges)
   : _facets(facets)
   , _mesh(mesh)
   , _edges(edges)
-  , _side(side)
-  , _mult(mult)
-  , _addFacets(-1)
-  ,_builder(builder)
 {
 }
 
@@ -515,7 +693,6 @@ bool SetOperations::CollectFacetVisitor::Visit (const MeshFacet &rclFacet, const
     return true;
 }
 
-//static int matchCounter = 0;
 bool SetOperations::CollectFacetVisitor::AllowVisit (const MeshFacet& rclFacet, const MeshFacet& rclFrom,
                                                      unsigned long ulFInd, unsigned long ulLevel,
                                                      unsigned short neighbourIndex)
@@ -523,97 +700,11 @@ bool SetOperations::CollectFacetVisitor::AllowVisit (const MeshFacet& rclFacet,
     (void)ulFInd;
     (void)ulLevel;
     if (rclFacet.IsFlag(MeshFacet::MARKED) && rclFrom.IsFlag(MeshFacet::MARKED)) {
-        // facet connected to an edge
+        // do not cross the cut lines
         unsigned long pt0 = rclFrom._aulPoints[neighbourIndex], pt1 = rclFrom._aulPoints[(neighbourIndex+1)%3];
-        Edge edge(_mesh.GetPoint(pt0), _mesh.GetPoint(pt1));
-
-        std::map<Edge, EdgeInfo>::iterator it = _edges.find(edge);
-
-        if (it != _edges.end()) {
-            if (_addFacets == -1) {
-                // determine if the facets should add or not only once
-                MeshGeomFacet facet = _mesh.GetFacet(rclFrom); // triangulated facet
-                MeshGeomFacet facetOther = it->second.facets[1-_side][0]; // triangulated facet from same edge and other mesh
-                Vector3f normalOther = facetOther.GetNormal();
-                //Vector3f normal = facet.GetNormal();
-
-                Vector3f edgeDir = it->first.pt1 - it->first.pt2;
-                Vector3f ocDir = (edgeDir % (facet.GetGravityPoint() - it->first.pt1)) % edgeDir;
-                ocDir.Normalize();
-                Vector3f ocDirOther = (edgeDir % (facetOther.GetGravityPoint() - it->first.pt1)) % edgeDir;
-                ocDirOther.Normalize();
-
-                //Vector3f dir = ocDir % normal;
-                //Vector3f dirOther = ocDirOther % normalOther;
-
-                bool match = ((ocDir * normalOther) * _mult) < 0.0f;
-
-                //if (matchCounter == 1)
-                //{
-                //  // _builder.addSingleArrow(it->second.pt1, it->second.pt1 + edgeDir, 3, 0.0, 1.0, 0.0);
-
-                //  _builder.addSingleTriangle(facet._aclPoints[0], facet._aclPoints[1], facet._aclPoints[2], true, 3.0, 1.0, 0.0, 0.0);
-                //  // _builder.addSingleArrow(facet.GetGravityPoint(), facet.GetGravityPoint() + ocDir, 3, 1.0, 0.0, 0.0);
-                //  _builder.addSingleArrow(facet.GetGravityPoint(), facet.GetGravityPoint() + normal, 3, 1.0, 0.5, 0.0);
-                //  // _builder.addSingleArrow(facet.GetGravityPoint(), facet.GetGravityPoint() + dir, 3, 1.0, 1.0, 0.0);
-
-                //  _builder.addSingleTriangle(facetOther._aclPoints[0], facetOther._aclPoints[1], facetOther._aclPoints[2], true, 3.0, 0.0, 0.0, 1.0);
-                //  // _builder.addSingleArrow(facetOther.GetGravityPoint(), facetOther.GetGravityPoint() + ocDirOther, 3, 0.0, 0.0, 1.0);
-                //  _builder.addSingleArrow(facetOther.GetGravityPoint(), facetOther.GetGravityPoint() + normalOther, 3, 0.0, 0.5, 1.0);
-                //  // _builder.addSingleArrow(facetOther.GetGravityPoint(), facetOther.GetGravityPoint() + dirOther, 3, 0.0, 1.0, 1.0);
-
-                //}
-
-                // float scalar = dir * dirOther * _mult;
-                // bool match = scalar > 0.0f;
-
-
-                //MeshPoint pt0 = it->first.pt1;
-                //MeshPoint pt1 = it->first.pt2;
-
-                //int i, n0 = -1, n1 = -1, m0 = -1, m1 = -1;
-                //for (i = 0; i < 3; i++)
-                //{
-                //  if ((n0 == -1) && (facet._aclPoints[i] == pt0))
-                //    n0 = i;
-                //  if ((n1 == -1) && (facet._aclPoints[i] == pt1))
-                //    n1 = i;
-                //  if ((m0 == -1) && (facetOther._aclPoints[i] == pt0))
-                //    m0 = i;
-                //  if ((m1 == -1) && (facetOther._aclPoints[i] == pt1))
-                //    m1 = i;
-                //}
-
-                //if ((n0 != -1) && (n1 != -1) && (m0 != -1) && (m1 != -1))
-                //{
-                //  bool orient_n = n1 > n0;
-                //  bool orient_m = m1 > m0;
-
-                //  Vector3f dirN = facet._aclPoints[n1] - facet._aclPoints[n0];
-                //  Vector3f dirM = facetOther._aclPoints[m1] - facetOther._aclPoints[m0];
-
-                //  if (matchCounter == 1)
-                //  {
-                //    _builder.addSingleArrow(facet.GetGravityPoint(), facet.GetGravityPoint() + dirN, 3, 1.0, 1.0, 0.0);
-                //    _builder.addSingleArrow(facetOther.GetGravityPoint(), facetOther.GetGravityPoint() + dirM, 3, 0.0, 1.0, 1.0);
-                //  }
-
-                //  if (_mult > 0.0)
-                //    match = orient_n == orient_m;
-                //  else
-                //    match = orient_n != orient_m;
-                //}
-
-                if (match)
-                    _addFacets = 0;
-                else
-                    _addFacets = 1;
-
-                //matchCounter++;
-            }
-
+        Edge edge(_mesh.GetPoint(pt0), _mesh.GetPoint(pt1), _edges.key_comp().pointLess);
+        if (_edges.find(edge) != _edges.end())
             return false;
-        }
     }
 
     return true;
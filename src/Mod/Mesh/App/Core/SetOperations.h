@@ -86,9 +86,9 @@ private:
       {
       }
 
-      Edge (MeshPoint p1, MeshPoint p2)
+      Edge (MeshPoint p1, MeshPoint p2, const MeshPoint_Less& less)
       {
-        if (p1 < p2)
+        if (less(p1, p2))
         {
           pt1 = p1;
           pt2 = p2;
@@ -100,14 +100,25 @@ private:
         }
       }
 
-      bool operator == (const Edge &edge) const
+  };
+
+  // Orders edges with the point tolerance of the set operation
+  class Edge_Less
+  {
+    public:
+      MeshPoint_Less    pointLess;
+
+      explicit Edge_Less (const MeshPoint_Less& less) : pointLess(less)
       {
-        return (pt1 == edge.pt1) && (pt2 == edge.pt2);
       }
 
-      bool operator < (const Edge &edge) const
+      bool operator () (const Edge &e1, const Edge &e2) const
       {
-        return (pt1 == edge.pt1) ? (pt2 < edge.pt2) : (pt1 < edge.pt1);
+        if (pointLess(e1.pt1, e2.pt1))
+          return true;
+        if (pointLess(e2.pt1, e1.pt1))
+          return false;
+        return pointLess(e1.pt2, e2.pt2);
       }
   };
 
@@ -143,38 +154,39 @@ private:
   //    bool AllowVisit (MeshFacet& rclFacet, MeshFacet& rclFrom, unsigned long ulFInd, unsigned long ulLevel, unsigned short neighbourIndex);
   //};
 
+  // Helper class collecting the facets of a region up to the cut lines
   class CollectFacetVisitor : public MeshFacetVisitor
   {
     public:
-      std::vector<unsigned long> &_facets;
-      const MeshKernel           &_mesh;
-      std::map<Edge, EdgeInfo>   &_edges;
-      int                         _side;
-      float                       _mult;
-      int                         _addFacets; // 0: add facets to the result 1: do not add facets to the result
-      Base::Builder3D& _builder;
-
-      CollectFacetVisitor (const MeshKernel& mesh, std::vector<unsigned long>& facets, std::map<Edge, EdgeInfo>& edges, int side, float mult, Base::Builder3D& builder);
+      std::vector<unsigned long>     &_facets;
+      const MeshKernel               &_mesh;
+      const std::map<Edge, EdgeInfo, Edge_Less> &_edges;
+
+      CollectFacetVisitor (const MeshKernel& mesh, std::vector<unsigned long>& facets, const std::map<Edge, EdgeInfo, Edge_Less>& edges);
       bool Visit (const MeshFacet &rclFacet, const MeshFacet &rclFrom, unsigned long ulFInd, unsigned long ulLevel);
       bool AllowVisit (const MeshFacet& rclFacet, const MeshFacet& rclFrom, unsigned long ulFInd, unsigned long ulLevel, unsigned short neighbourIndex);
   };
 
+  /** tolerance below which cut points are merged, independent of MeshDefinitions */
+  MeshPoint_Less            _pointLess;
   /** all points from cut */
-  std::set<MeshPoint>       _cutPoints;
+  std::set<MeshPoint, MeshPoint_Less>  _cutPoints;
   /** all edges */
-  std::map<Edge, EdgeInfo>  _edges;
+  std::map<Edge, EdgeInfo, Edge_Less>  _edges;
   /** map from facet index to his cutted points (mesh 1 and mesh 2) Key: Facet-Index  Value: List of iterators of set<MeshPoint> */
-  std::map<unsigned long, std::list<std::set<MeshPoint>::iterator> > _facet2points[2];
+  std::map<unsigned long, std::list<std::set<MeshPoint, MeshPoint_Less>::iterator> > _facet2points[2];
   /** Facets collected from region growing */
   std::vector<MeshGeomFacet> _facetsOf[2];
 
   std::vector<MeshGeomFacet> _newMeshFacets[2];
 
-  /** Cut mesh 1 with mesh 2 */
+  /** Cut mesh 1 with mesh 2. The intersecting facet pairs are searched with several threads. */
   void Cut (std::set<unsigned long>& facetsNotCuttingEdge0, std::set<unsigned long>& facetsCuttingEdge1);
-  /** Trianglute each facets cutted with his cutting points */
+  /** Trianglute each facets cutted with his cutting points (with several threads) */
   void TriangulateMesh (const MeshKernel &cutMesh, int side);
-  /** search facets for adding (with region growing) */
+  /** search facets for adding (with region growing). Each region is classified by
+   * the generalized winding number of one of its facets with respect to the other mesh.
+   */
   void CollectFacets (int side, float mult);
   /** close gap in the mesh */
   void CloseGaps (MeshBuilder& meshBuilder);
@@ -9,6 +9,7 @@
 // * Comment out printf statements
 // * Fix compiler warnings
 // * Remove macros loop,i,j,k
+// * Add locked vertices that are never moved by an edge collapse
 
 #include <vector>
 #include <Base/Vector3D.h>
@@ -82,7 +83,8 @@ class Simplify
 {
 public:
     struct Triangle { int v[3];double err[4];int deleted,dirty;vec3f n; };
-    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;};
+    // locked: 0 or a positive number chosen by the caller if the vertex must not be moved
+    struct Vertex { vec3f p;int tstart,tcount;SymmetricMatrix q;int border;int locked;};
     struct Ref { int tid,tvertex; }; 
     std::vector<Triangle> triangles;
     std::vector<Vertex> vertices;
@@ -195,6 +197,8 @@ void Simplify::simplify_mesh(int target_count, double tolerance, double aggressi
                     // Border check
                     if (v0.border != v1.border)
                         continue;
+                    if (v0.locked || v1.locked)
+                        continue;
 
                     // Compute vertex to collapse to
                     vec3f p;
@@ -478,6 +482,7 @@ void Simplify::compact_mesh()
         {
             vertices[i].tstart=dst;
             vertices[dst].p=vertices[i].p;
+            vertices[dst].locked=vertices[i].locked;
             dst++;
         }
     }
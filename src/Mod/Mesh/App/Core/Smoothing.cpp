@@ -23,9 +23,12 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <cfloat>
 #endif
 
 #include "Smoothing.h"
+#include "Functional.h"
 #include "MeshKernel.h"
 #include "Algorithm.h"
 #include "Elements.h"
@@ -35,54 +38,107 @@
 
 using namespace MeshCore;
 
+namespace {
 
-AbstractSmoothing::AbstractSmoothing(MeshKernel& m)
-  : kernel(m)
-  , tolerance(0)
-  , component(Normal)
-  , continuity(C0)
-{
-}
+// smaller numbers of points are handled by the calling thread
+const unsigned long MinParallelCount = 5000;
 
-AbstractSmoothing::~AbstractSmoothing()
+// The coordinates of the mesh points as structure of arrays
+struct PointBuffer
 {
-}
+    PointBuffer(const MeshPointArray& points)
+      : x(points.size()), y(points.size()), z(points.size())
+    {
+        for (std::size_t i = 0; i < points.size(); i++) {
+            x[i] = points[i].x;
+            y[i] = points[i].y;
+            z[i] = points[i].z;
+        }
+    }
 
-void AbstractSmoothing::initialize(Component comp, Continuity cont)
-{
-    this->component = comp;
-    this->continuity = cont;
-}
+    std::vector<float> x, y, z;
+};
 
-PlaneFitSmoothing::PlaneFitSmoothing(MeshKernel& m)
-  : AbstractSmoothing(m)
+// Sorted points without duplicates that have a closed ring of neighbours
+std::vector<unsigned long> InnerPoints(const std::vector<unsigned long>& points,
+                                       const MeshRefPointToPoints& vv_it,
+                                       const MeshRefPointToFacets& vf_it)
 {
-}
+    std::vector<unsigned long> inner;
+    inner.reserve(points.size());
+    for (std::vector<unsigned long>::const_iterator it = points.begin(); it != points.end(); ++it) {
+        MeshIndexRange::size_type count = vv_it[*it].size();
+        // do nothing for border points
+        if (count >= 3 && count == vf_it[*it].size())
+            inner.push_back(*it);
+    }
 
-PlaneFitSmoothing::~PlaneFitSmoothing()
-{
+    std::sort(inner.begin(), inner.end());
+    inner.erase(std::unique(inner.begin(), inner.end()), inner.end());
+    return inner;
 }
 
-void PlaneFitSmoothing::Smooth(unsigned int iterations)
+struct UmbrellaStep
 {
-    MeshCore::MeshPoint center;
-    MeshCore::MeshPointArray PointArray = kernel.GetPoints();
-
-    MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
+    typedef void result_type;
+    UmbrellaStep(const std::vector<unsigned long>& points, const MeshRefPointToPoints& vv_it,
+                 const PointBuffer& src, PointBuffer& dst, double stepsize)
+      : points(&points), vv_it(&vv_it), src(&src), dst(&dst), stepsize(stepsize) {}
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        const float* sx = src->x.data();
+        const float* sy = src->y.data();
+        const float* sz = src->z.data();
+        float* dx = dst->x.data();
+        float* dy = dst->y.data();
+        float* dz = dst->z.data();
+        for (unsigned long i = begin; i < end; i++) {
+            unsigned long pos = (*points)[i];
+            MeshIndexRange cv = (*vv_it)[pos];
+            const unsigned long* nb = cv.begin();
+            std::size_t n_count = cv.size();
+
+            double sumx=0.0,sumy=0.0,sumz=0.0;
+            for (std::size_t j = 0; j < n_count; j++) {
+                sumx += sx[nb[j]];
+                sumy += sy[nb[j]];
+                sumz += sz[nb[j]];
+            }
 
-    for (unsigned int i=0; i<iterations; i++) {
+            double w = 1.0/double(n_count);
+            dx[pos] = (float)(sx[pos]+stepsize*(w*sumx-sx[pos]));
+            dy[pos] = (float)(sy[pos]+stepsize*(w*sumy-sy[pos]));
+            dz[pos] = (float)(sz[pos]+stepsize*(w*sumz-sz[pos]));
+        }
+    }
+    const std::vector<unsigned long>* points;
+    const MeshRefPointToPoints* vv_it;
+    const PointBuffer* src;
+    PointBuffer* dst;
+    double stepsize;
+};
+
+struct PlaneFitStep
+{
+    typedef void result_type;
+    PlaneFitStep(const std::vector<unsigned long>& points, const MeshRefPointToPoints& vv_it,
+                 const MeshPointArray& src, MeshPointArray& dst, float maximum)
+      : points(&points), vv_it(&vv_it), src(&src), dst(&dst), maximum(maximum) {}
+    void operator()(unsigned long begin, unsigned long end) const
+    {
+        const MeshPointArray& v_beg = *src;
         Base::Vector3f N, L;
-        for (v_it.Begin(); v_it.More(); v_it.Next()) {
-            MeshCore::PlaneFit pf;
-            pf.AddPoint(*v_it);
-            center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
+        for (unsigned long i = begin; i < end; i++) {
+            unsigned long pos = (*points)[i];
+            const MeshPoint& v = v_beg[pos];
+            MeshIndexRange cv = (*vv_it)[pos];
             if (cv.size() < 3)
                 continue;
 
-            std::set<unsigned long>::const_iterator cv_it;
+            MeshCore::PlaneFit pf;
+            pf.AddPoint(v);
+            Base::Vector3f center = v;
+            MeshIndexRange::const_iterator cv_it;
             for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
                 pf.AddPoint(v_beg[*cv_it]);
                 center += v_beg[*cv_it];
@@ -97,75 +153,82 @@ void PlaneFitSmoothing::Smooth(unsigned int iterations)
             N.Normalize();
 
             // look in which direction we should move the vertex
-            L.Set(v_it->x - center.x, v_it->y - center.y, v_it->z - center.z);
+            L.Set(v.x - center.x, v.y - center.y, v.z - center.z);
             if (N*L < 0.0)
                 N.Scale(-1.0, -1.0, -1.0);
 
             // maximum value to move is distance to mean plane
-            float d = std::min<float>((float)fabs(this->tolerance),(float)fabs(N*L));
+            float d = std::min<float>((float)fabs(maximum),(float)fabs(N*L));
             N.Scale(d,d,d);
 
-            PointArray[v_it.Position()].Set(v_it->x - N.x, v_it->y - N.y, v_it->z - N.z);
-        }
-
-        // assign values without affecting iterators
-        unsigned long count = kernel.CountPoints();
-        for (unsigned long idx = 0; idx < count; idx++) {
-            kernel.SetPoint(idx, PointArray[idx]);
+            (*dst)[pos].Set(v.x - N.x, v.y - N.y, v.z - N.z);
         }
     }
+    const std::vector<unsigned long>* points;
+    const MeshRefPointToPoints* vv_it;
+    const MeshPointArray* src;
+    MeshPointArray* dst;
+    float maximum;
+};
+
+std::vector<unsigned long> AllPoints(const MeshKernel& kernel)
+{
+    std::vector<unsigned long> points(kernel.CountPoints());
+    for (unsigned long i = 0; i < points.size(); i++)
+        points[i] = i;
+    return points;
 }
 
-void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
-{
-    MeshCore::MeshPoint center;
-    MeshCore::MeshPointArray PointArray = kernel.GetPoints();
+}
 
-    MeshCore::MeshPointIterator v_it(kernel);
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshPointArray::_TConstIterator v_beg = kernel.GetPoints().begin();
 
-    for (unsigned int i=0; i<iterations; i++) {
-        Base::Vector3f N, L;
-        for (std::vector<unsigned long>::const_iterator it = point_indices.begin(); it != point_indices.end(); ++it) {
-            v_it.Set(*it);
-            MeshCore::PlaneFit pf;
-            pf.AddPoint(*v_it);
-            center = *v_it;
-            const std::set<unsigned long>& cv = vv_it[v_it.Position()];
-            if (cv.size() < 3)
-                continue;
+AbstractSmoothing::AbstractSmoothing(MeshKernel& m)
+  : kernel(m)
+  , tolerance(0)
+  , component(Normal)
+  , continuity(C0)
+{
+}
 
-            std::set<unsigned long>::const_iterator cv_it;
-            for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-                pf.AddPoint(v_beg[*cv_it]);
-                center += v_beg[*cv_it];
-            }
+AbstractSmoothing::~AbstractSmoothing()
+{
+}
 
-            float scale = 1.0f/((float)cv.size()+1.0f);
-            center.Scale(scale,scale,scale);
+void AbstractSmoothing::initialize(Component comp, Continuity cont)
+{
+    this->component = comp;
+    this->continuity = cont;
+}
 
-            // get the mean plane of the current vertex with the surrounding vertices
-            pf.Fit();
-            N = pf.GetNormal();
-            N.Normalize();
+PlaneFitSmoothing::PlaneFitSmoothing(MeshKernel& m)
+  : AbstractSmoothing(m), maximum(FLT_MAX)
+{
+}
 
-            // look in which direction we should move the vertex
-            L.Set(v_it->x - center.x, v_it->y - center.y, v_it->z - center.z);
-            if (N*L < 0.0)
-                N.Scale(-1.0, -1.0, -1.0);
+PlaneFitSmoothing::~PlaneFitSmoothing()
+{
+}
 
-            // maximum value to move is distance to mean plane
-            float d = std::min<float>((float)fabs(this->tolerance),(float)fabs(N*L));
-            N.Scale(d,d,d);
+void PlaneFitSmoothing::Smooth(unsigned int iterations)
+{
+    SmoothPoints(iterations, AllPoints(kernel));
+}
 
-            PointArray[v_it.Position()].Set(v_it->x - N.x, v_it->y - N.y, v_it->z - N.z);
-        }
+void PlaneFitSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
+{
+    MeshCore::MeshRefPointToPoints vv_it(kernel);
+    std::vector<unsigned long> points(point_indices);
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+
+    MeshCore::MeshPointArray PointArray = kernel.GetPoints();
+    for (unsigned int i=0; i<iterations; i++) {
+        parallel_for(static_cast<unsigned long>(points.size()), MinParallelCount,
+                     PlaneFitStep(points, vv_it, kernel.GetPoints(), PointArray, this->maximum));
 
         // assign values without affecting iterators
-        unsigned long count = kernel.CountPoints();
-        for (unsigned long idx = 0; idx < count; idx++) {
-            kernel.SetPoint(idx, PointArray[idx]);
+        for (std::vector<unsigned long>::const_iterator it = points.begin(); it != points.end(); ++it) {
+            kernel.SetPoint(*it, PointArray[*it]);
         }
     }
 }
@@ -180,84 +243,34 @@ LaplaceSmoothing::~LaplaceSmoothing()
 }
 
 void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize)
+                                const MeshRefPointToFacets& vf_it,
+                                const std::vector<unsigned long>& point_indices,
+                                const std::vector<double>& stepsizes,
+                                unsigned int iterations)
 {
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_it,
-    v_beg = points.begin(), v_end = points.end();
-
-    unsigned long pos = 0;
-    for (v_it = points.begin(); v_it != v_end; ++v_it,++pos) {
-        const std::set<unsigned long>& cv = vv_it[pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[pos].size()) {
-            // do nothing for border points
-            continue;
-        }
-
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
+    std::vector<unsigned long> points = InnerPoints(point_indices, vv_it, vf_it);
+    if (points.empty())
+        return;
 
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-v_it->x);
-            dely += w*((v_beg[*cv_it]).y-v_it->y);
-            delz += w*((v_beg[*cv_it]).z-v_it->z);
+    // the points that are not moved have the same coordinates in both buffers
+    PointBuffer src(kernel.GetPoints());
+    PointBuffer dst(src);
+    for (unsigned int i=0; i<iterations; i++) {
+        for (std::vector<double>::const_iterator it = stepsizes.begin(); it != stepsizes.end(); ++it) {
+            parallel_for(static_cast<unsigned long>(points.size()), MinParallelCount,
+                         UmbrellaStep(points, vv_it, src, dst, *it));
+            std::swap(src, dst);
         }
-
-        float x = (float)(v_it->x+stepsize*delx);
-        float y = (float)(v_it->y+stepsize*dely);
-        float z = (float)(v_it->z+stepsize*delz);
-        kernel.SetPoint(pos,x,y,z);
     }
-}
 
-void LaplaceSmoothing::Umbrella(const MeshRefPointToPoints& vv_it,
-                                const MeshRefPointToFacets& vf_it, double stepsize,
-                                const std::vector<unsigned long>& point_indices)
-{
-    const MeshCore::MeshPointArray& points = kernel.GetPoints();
-    MeshCore::MeshPointArray::_TConstIterator v_beg = points.begin();
-
-    for (std::vector<unsigned long>::const_iterator pos = point_indices.begin(); pos != point_indices.end(); ++pos) {
-        const std::set<unsigned long>& cv = vv_it[*pos];
-        if (cv.size() < 3)
-            continue;
-        if (cv.size() != vf_it[*pos].size()) {
-            // do nothing for border points
-            continue;
-        }
-
-        unsigned int n_count = cv.size();
-        double w;
-        w=1.0/double(n_count);
-
-        double delx=0.0,dely=0.0,delz=0.0;
-        std::set<unsigned long>::const_iterator cv_it;
-        for (cv_it = cv.begin(); cv_it !=cv.end(); ++cv_it) {
-            delx += w*((v_beg[*cv_it]).x-(v_beg[*pos]).x);
-            dely += w*((v_beg[*cv_it]).y-(v_beg[*pos]).y);
-            delz += w*((v_beg[*cv_it]).z-(v_beg[*pos]).z);
-        }
-
-        float x = (float)((v_beg[*pos]).x+stepsize*delx);
-        float y = (float)((v_beg[*pos]).y+stepsize*dely);
-        float z = (float)((v_beg[*pos]).z+stepsize*delz);
-        kernel.SetPoint(*pos,x,y,z);
+    for (std::vector<unsigned long>::const_iterator it = points.begin(); it != points.end(); ++it) {
+        kernel.SetPoint(*it, src.x[*it], src.y[*it], src.z[*it]);
     }
 }
 
 void LaplaceSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
-
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
-    }
+    SmoothPoints(iterations, AllPoints(kernel));
 }
 
 void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
@@ -265,9 +278,9 @@ void LaplaceSmoothing::SmoothPoints(unsigned int iterations, const std::vector<u
     MeshCore::MeshRefPointToPoints vv_it(kernel);
     MeshCore::MeshRefPointToFacets vf_it(kernel);
 
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
-    }
+    std::vector<double> stepsizes;
+    stepsizes.push_back(lambda);
+    Umbrella(vv_it, vf_it, point_indices, stepsizes, iterations);
 }
 
 TaubinSmoothing::TaubinSmoothing(MeshKernel& m)
@@ -281,28 +294,18 @@ TaubinSmoothing::~TaubinSmoothing()
 
 void TaubinSmoothing::Smooth(unsigned int iterations)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
-    MeshCore::MeshRefPointToPoints vv_it(kernel);
-    MeshCore::MeshRefPointToFacets vf_it(kernel);
-
-    // Theoretically Taubin does not shrink the surface
-    iterations = (iterations+1)/2; // two steps per iteration
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda);
-        Umbrella(vv_it, vf_it, -(lambda+micro));
-    }
+    SmoothPoints(iterations, AllPoints(kernel));
 }
 
 void TaubinSmoothing::SmoothPoints(unsigned int iterations, const std::vector<unsigned long>& point_indices)
 {
-    MeshCore::MeshPointArray::_TConstIterator v_it;
     MeshCore::MeshRefPointToPoints vv_it(kernel);
     MeshCore::MeshRefPointToFacets vf_it(kernel);
 
     // Theoretically Taubin does not shrink the surface
     iterations = (iterations+1)/2; // two steps per iteration
-    for (unsigned int i=0; i<iterations; i++) {
-        Umbrella(vv_it, vf_it, lambda, point_indices);
-        Umbrella(vv_it, vf_it, -(lambda+micro), point_indices);
-    }
+    std::vector<double> stepsizes;
+    stepsizes.push_back(lambda);
+    stepsizes.push_back(-(lambda+micro));
+    Umbrella(vv_it, vf_it, point_indices, stepsizes, iterations);
 }
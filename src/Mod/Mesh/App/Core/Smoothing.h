@@ -71,6 +71,11 @@ public:
     virtual ~PlaneFitSmoothing();
     void Smooth(unsigned int);
     void SmoothPoints(unsigned int, const std::vector<unsigned long>&);
+    /// Sets the maximum distance a point is moved per iteration, by default it's unlimited.
+    void SetMaximum(float max) { maximum = max; }
+
+private:
+    float maximum;
 };
 
 class MeshExport LaplaceSmoothing : public AbstractSmoothing
@@ -83,11 +88,16 @@ public:
     void SetLambda(double l) { lambda = l;}
 
 protected:
+    /** Moves the given points towards the centre of their neighbours. Each
+     * iteration performs one step for each of the step sizes. All points are
+     * updated from the positions of the previous step (Jacobi iteration) with
+     * several threads, so the result doesn't depend on the number of threads.
+     * Border points are not moved.
+     */
     void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double);
-    void Umbrella(const MeshRefPointToPoints&,
-                  const MeshRefPointToFacets&, double,
-                  const std::vector<unsigned long>&);
+                  const MeshRefPointToFacets&,
+                  const std::vector<unsigned long>&,
+                  const std::vector<double>&, unsigned int);
 
 protected:
     double lambda;
@@ -577,29 +577,36 @@ namespace MeshCore {
 namespace Triangulation {
 struct Vertex2d_Less  : public std::binary_function<const Base::Vector3f&, const Base::Vector3f&, bool>
 {
+    Vertex2d_Less() : tol(MeshDefinitions::_fMinPointDistanceD1) {}
+    explicit Vertex2d_Less(float t) : tol(t) {}
     bool operator()(const Base::Vector3f& p, const Base::Vector3f& q) const
     {
-        if (fabs(p.x - q.x) < MeshDefinitions::_fMinPointDistanceD1) {
-        if (fabs(p.y - q.y) < MeshDefinitions::_fMinPointDistanceD1) {
+        if (fabs(p.x - q.x) < tol) {
+        if (fabs(p.y - q.y) < tol) {
         return false; } else return p.y < q.y;
         } else return p.x < q.x; return true;
     }
+    float tol;
 };
 struct Vertex2d_EqualTo  : public std::binary_function<const Base::Vector3f&, const Base::Vector3f&, bool>
 {
+    Vertex2d_EqualTo() : tol(MeshDefinitions::_fMinPointDistanceD1) {}
+    explicit Vertex2d_EqualTo(float t) : tol(t) {}
     bool operator()(const Base::Vector3f& p, const Base::Vector3f& q) const
     {
-        if (fabs(p.x - q.x) < MeshDefinitions::_fMinPointDistanceD1 &&
-            fabs(p.y - q.y) < MeshDefinitions::_fMinPointDistanceD1)
+        if (fabs(p.x - q.x) < tol &&
+            fabs(p.y - q.y) < tol)
             return true;
 
         return false;
     }
+    float tol;
 };
 }
 }
 
 DelaunayTriangulator::DelaunayTriangulator()
+  : _fTolerance(MeshDefinitions::_fMinPointDistanceD1)
 {
 }
 
@@ -613,10 +620,10 @@ bool DelaunayTriangulator::Triangulate()
     // points are different
     std::vector<Base::Vector3f> aPoints = _points;
     // sort the points ascending x,y coordinates
-    std::sort(aPoints.begin(), aPoints.end(), Triangulation::Vertex2d_Less());
+    std::sort(aPoints.begin(), aPoints.end(), Triangulation::Vertex2d_Less(_fTolerance));
     // if there are two adjacent points whose distance is less then an epsilon
     if (std::adjacent_find(aPoints.begin(), aPoints.end(),
-        Triangulation::Vertex2d_EqualTo()) < aPoints.end())
+        Triangulation::Vertex2d_EqualTo(_fTolerance)) < aPoints.end())
         return false;
 
     _facets.clear();
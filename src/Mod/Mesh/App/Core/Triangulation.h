@@ -203,8 +203,17 @@ public:
     DelaunayTriangulator();
     ~DelaunayTriangulator();
 
+    /** Sets the tolerance below which two polygon points are considered equal.
+     * By default MeshDefinitions::_fMinPointDistanceD1 is used.
+     */
+    void SetTolerance(float fTol)
+    { _fTolerance = fTol; }
+
 protected:
     bool Triangulate();
+
+private:
+    float _fTolerance;
 };
 
 class MeshExport FlatTriangulator : public AbstractPolygonTriangulator
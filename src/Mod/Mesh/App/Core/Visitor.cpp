@@ -99,8 +99,8 @@ unsigned long MeshKernel::VisitNeighbourFacetsOverCorners (MeshFacetVisitor &rcl
         for (std::vector<unsigned long>::iterator pCurrFacet = aclCurrentLevel.begin(); pCurrFacet < aclCurrentLevel.end(); ++pCurrFacet) {
             for (int i = 0; i < 3; i++) {
                 const MeshFacet &rclFacet = raclFAry[*pCurrFacet];
-                const std::set<unsigned long>& raclNB = clRPF[rclFacet._aulPoints[i]];
-                for (std::set<unsigned long>::const_iterator pINb = raclNB.begin(); pINb != raclNB.end(); ++pINb) {
+                MeshIndexRange raclNB = clRPF[rclFacet._aulPoints[i]];
+                for (MeshIndexRange::const_iterator pINb = raclNB.begin(); pINb != raclNB.end(); ++pINb) {
                     if (pFBegin[*pINb].IsFlag(MeshFacet::VISIT) == false) {
                         // only visit if VISIT Flag not set
                         ulVisited++;
@@ -135,8 +135,8 @@ unsigned long MeshKernel::VisitNeighbourPoints (MeshPointVisitor &rclPVisitor, u
     while (aclCurrentLevel.size() > 0) {
         // visit all neighbours of the current level
         for (clCurrIter = aclCurrentLevel.begin(); clCurrIter < aclCurrentLevel.end(); ++clCurrIter) {
-            const std::set<unsigned long>& raclNB = clNPs[*clCurrIter];
-            for (std::set<unsigned long>::const_iterator pINb = raclNB.begin(); pINb != raclNB.end(); ++pINb) {
+            MeshIndexRange raclNB = clNPs[*clCurrIter];
+            for (MeshIndexRange::const_iterator pINb = raclNB.begin(); pINb != raclNB.end(); ++pINb) {
                 if (pPBegin[*pINb].IsFlag(MeshPoint::VISIT) == false) {
                     // only visit if VISIT Flag not set
                     ulVisited++;
@@ -53,6 +53,10 @@ public:
     /// recalculate the Feature
     App::DocumentObjectExecReturn *execute(void);
     short mustExecute() const;
+    /// only reads the source mesh and doesn't touch global state
+    bool isExecuteThreadSafe(void) const {
+        return true;
+    }
     /// returns the type name of the ViewProvider
     const char* getViewProviderName(void) const { 
         return "MeshGui::ViewProviderMeshCurvature"; 
@@ -29,6 +29,7 @@
 
 #include "FeatureMeshDefects.h"
 #include "Core/Degeneration.h"
+#include "Core/Evaluation.h"
 #include "Core/TopoAlgorithm.h"
 #include "Core/Triangulation.h"
 #include <Base/Tools.h>
@@ -293,6 +294,93 @@ App::DocumentObjectExecReturn *FixIndices::execute(void)
 
 // ----------------------------------------------------------------------
 
+PROPERTY_SOURCE(Mesh::FixAllDefects, Mesh::FixDefects)
+
+FixAllDefects::FixAllDefects()
+{
+    ADD_PROPERTY(RemoveFolds,(false));
+}
+
+FixAllDefects::~FixAllDefects()
+{
+}
+
+App::DocumentObjectExecReturn *FixAllDefects::execute(void)
+{
+    App::DocumentObject* link = Source.getValue();
+    if (!link) return new App::DocumentObjectExecReturn("No mesh linked");
+    App::Property* prop = link->getPropertyByName("Mesh");
+    if (prop && prop->getTypeId() == Mesh::PropertyMeshKernel::getClassTypeId()) {
+        Mesh::PropertyMeshKernel* kernel = static_cast<Mesh::PropertyMeshKernel*>(prop);
+        std::unique_ptr<MeshObject> mesh(new MeshObject);
+        *mesh = kernel->getValue();
+
+        typedef MeshCore::MeshEvalHealth Health;
+        float fEps = static_cast<float>(Epsilon.getValue());
+        int pending = Health::AllChecks & ~Health::NonManifoldPoints;
+        if (!RemoveFolds.getValue())
+            pending &= ~Health::Folds;
+
+        // same order as in the evaluation dialog
+        const Health::Check steps[] = {
+            Health::SelfIntersections, Health::Folds, Health::Orientation,
+            Health::NonManifolds, Health::Indices, Health::Degenerations,
+            Health::DuplicatedFacets, Health::DuplicatedPoints
+        };
+
+        Health eval(mesh->getKernel(), pending, fEps);
+        bool modified = true;
+        for (std::size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+            if (!(pending & steps[i]))
+                continue;
+            if (modified) {
+                eval.SetChecks(pending);
+                eval.Evaluate();
+                modified = false;
+            }
+            pending &= ~steps[i];
+            if (!eval.HasDefect(steps[i]))
+                continue;
+
+            switch (steps[i]) {
+            case Health::SelfIntersections:
+                mesh->removeSelfIntersections();
+                break;
+            case Health::Folds:
+                mesh->removeFoldsOnSurface();
+                break;
+            case Health::Orientation:
+                mesh->harmonizeNormals();
+                break;
+            case Health::NonManifolds:
+                mesh->removeNonManifolds();
+                break;
+            case Health::Indices:
+                mesh->validateIndices();
+                break;
+            case Health::Degenerations:
+                mesh->validateDegenerations(fEps);
+                break;
+            case Health::DuplicatedFacets:
+                mesh->removeDuplicatedFacets();
+                break;
+            case Health::DuplicatedPoints:
+                mesh->removeDuplicatedPoints();
+                break;
+            default:
+                break;
+            }
+            modified = true;
+        }
+
+        this->Mesh.setValuePtr(mesh.release());
+    }
+
+    return App::DocumentObject::StdReturn;
+}
+
+// ----------------------------------------------------------------------
+
 PROPERTY_SOURCE(Mesh::FillHoles, Mesh::FixDefects)
 
 FillHoles::FillHoles()
@@ -225,6 +225,32 @@ public:
   //@}
 };
 
+/**
+ * The FixAllDefects class repairs all kinds of defects that are detected by
+ * MeshCore::MeshEvalHealth. The checks are evaluated together and only the
+ * remaining checks are evaluated again after a repair has changed the mesh.
+ * @author Werner Mayer
+ */
+class MeshExport FixAllDefects : public Mesh::FixDefects
+{
+  PROPERTY_HEADER(Mesh::FixAllDefects);
+
+public:
+  /// Constructor
+  FixAllDefects(void);
+  virtual ~FixAllDefects();
+
+  /** @name Properties */
+  //@{
+  App::PropertyBool RemoveFolds; /**< Also remove folds on the surface */
+  //@}
+  /** @name methods override Feature */
+  //@{
+  /// recalculate the Feature
+  virtual App::DocumentObjectExecReturn *execute(void);
+  //@}
+};
+
 /**
  * The FillHoles class tries to fill up holes in the internal mesh data structure.
  * @author Werner Mayer
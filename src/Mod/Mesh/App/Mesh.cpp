@@ -39,6 +39,7 @@
 #include <Base/ViewProj.h>
 
 #include "Core/Builder.h"
+#include "Core/BVH.h"
 #include "Core/MeshKernel.h"
 #include "Core/Grid.h"
 #include "Core/Iterator.h"
@@ -949,6 +950,13 @@ void MeshObject::decimate(float fTolerance, float fReduction)
     dm.simplify(fTolerance, fReduction);
 }
 
+void MeshObject::decimate(int targetSize, int blocks)
+{
+    MeshCore::MeshSimplify dm(this->_kernel);
+    dm.setBlockCount(blocks);
+    dm.simplify(targetSize);
+}
+
 Base::Vector3d MeshObject::getPointNormal(unsigned long index) const
 {
     std::vector<Base::Vector3f> temp = _kernel.CalcVertexNormals();
@@ -995,6 +1003,32 @@ void MeshObject::crossSections(const std::vector<MeshObject::TPlane>& planes, st
     }
 }
 
+std::vector<MeshObject::TFacetPoint> MeshObject::nearestFacetsOnRays(const std::vector<MeshObject::TRay>& rays) const
+{
+    std::vector<TFacetPoint> result;
+    result.reserve(rays.size());
+    MeshCore::MeshFacetBVH bvh(_kernel);
+    for (std::vector<TRay>::const_iterator it = rays.begin(); it != rays.end(); ++it) {
+        TFacetPoint hit(ULONG_MAX, Base::Vector3f());
+        bvh.NearestFacetOnRay(it->first, it->second, hit.second, hit.first);
+        result.push_back(hit);
+    }
+    return result;
+}
+
+std::vector<MeshObject::TFacetPoint> MeshObject::nearestFacetsToPoints(const std::vector<Base::Vector3f>& points, float fMaxDist) const
+{
+    std::vector<TFacetPoint> result;
+    result.reserve(points.size());
+    MeshCore::MeshFacetBVH bvh(_kernel);
+    for (std::vector<Base::Vector3f>::const_iterator it = points.begin(); it != points.end(); ++it) {
+        TFacetPoint hit(ULONG_MAX, Base::Vector3f());
+        bvh.NearestFacetToPoint(*it, fMaxDist, hit.second, hit.first);
+        result.push_back(hit);
+    }
+    return result;
+}
+
 void MeshObject::cut(const Base::Polygon2d& polygon2d,
                      const Base::ViewProjMethod& proj, MeshObject::CutType type)
 {
@@ -1724,7 +1758,8 @@ MeshObject* MeshObject::meshFromSegment(const std::vector<unsigned long>& indice
 }
 
 std::vector<Segment> MeshObject::getSegmentsOfType(MeshObject::GeometryType type,
-                                                   float dev, unsigned long minFacets) const
+                                                   float dev, unsigned long minFacets,
+                                                   bool parallel) const
 {
     std::vector<Segment> segm;
     if (this->_kernel.CountFacets() == 0)
@@ -1753,7 +1788,7 @@ std::vector<Segment> MeshObject::getSegmentsOfType(MeshObject::GeometryType type
     if (surf.get()) {
         std::vector<MeshCore::MeshSurfaceSegment*> surfaces;
         surfaces.push_back(surf.get());
-        finder.FindSegments(surfaces);
+        finder.FindSegments(surfaces, parallel);
 
         const std::vector<MeshCore::MeshSegment>& data = surf->GetSegments();
         for (std::vector<MeshCore::MeshSegment>::const_iterator it = data.begin(); it != data.end(); ++it) {
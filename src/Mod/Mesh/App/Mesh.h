@@ -77,6 +77,9 @@ public:
     // typedef needed for cross-section
     typedef std::pair<Base::Vector3f, Base::Vector3f> TPlane;
     typedef std::list<std::vector<Base::Vector3f> > TPolylines;
+    // typedef needed for ray and distance queries
+    typedef std::pair<Base::Vector3f, Base::Vector3f> TRay;
+    typedef std::pair<unsigned long, Base::Vector3f> TFacetPoint;
 
     MeshObject();
     explicit MeshObject(const MeshCore::MeshKernel& Kernel);
@@ -217,10 +220,19 @@ public:
     void setPoint(unsigned long, const Base::Vector3d& v);
     void smooth(int iterations, float d_max);
     void decimate(float fTolerance, float fReduction);
+    void decimate(int targetSize, int blocks = 0);
     Base::Vector3d getPointNormal(unsigned long) const;
     std::vector<Base::Vector3d> getPointNormals() const;
     void crossSections(const std::vector<TPlane>&, std::vector<TPolylines> &sections,
                        float fMinEps = 1.0e-2f, bool bConnectPolygons = false) const;
+    /** Searches for the nearest facet hit by each ray (base point, direction).
+     * The facet index is ULONG_MAX if the ray misses the mesh.
+     */
+    std::vector<TFacetPoint> nearestFacetsOnRays(const std::vector<TRay>&) const;
+    /** Searches for the nearest facet and the nearest point on it to each point.
+     * The facet index is ULONG_MAX if there is no facet within the distance \a fMaxDist.
+     */
+    std::vector<TFacetPoint> nearestFacetsToPoints(const std::vector<Base::Vector3f>&, float fMaxDist) const;
     void cut(const Base::Polygon2d& polygon, const Base::ViewProjMethod& proj, CutType);
     void trim(const Base::Polygon2d& polygon, const Base::ViewProjMethod& proj, CutType);
     //@}
@@ -300,7 +312,9 @@ public:
     const Segment& getSegment(unsigned long) const;
     Segment& getSegment(unsigned long);
     MeshObject* meshFromSegment(const std::vector<unsigned long>&) const;
-    std::vector<Segment> getSegmentsOfType(GeometryType, float dev, unsigned long minFacets) const;
+    /// In \a parallel mode several segments are grown at once, the result is the same.
+    std::vector<Segment> getSegmentsOfType(GeometryType, float dev, unsigned long minFacets,
+                                           bool parallel = false) const;
     //@}
 
     /** @name Primitives */
@@ -25,6 +25,7 @@
 #ifndef _PreComp_
 #endif
 
+#include <boost/functional/hash.hpp>
 #include <CXX/Objects.hxx>
 #include <Base/Console.h>
 #include <Base/Exception.h>
@@ -436,6 +437,7 @@ PropertyMeshKernel::PropertyMeshKernel()
 
 PropertyMeshKernel::~PropertyMeshKernel()
 {
+    cancelDeferred();
     if (meshPyObject) {
         // Note: Do not call setInvalid() of the Python binding 
         // because the mesh should still be accessible afterwards.
@@ -450,13 +452,17 @@ void PropertyMeshKernel::setValuePtr(MeshObject* mesh)
     // before calling hasSetValue()
     Base::Reference<MeshObject> tmp(_meshObject);
     aboutToSetValue();
-    _meshObject = mesh;
+    cancelDeferred();
+    setMeshObject(mesh);
+    _sharedMesh.reset();
     hasSetValue();
 }
 
 void PropertyMeshKernel::setValue(const MeshObject& mesh)
 {
     aboutToSetValue();
+    cancelDeferred();
+    detachMesh(false);
     *_meshObject = mesh;
     hasSetValue();
 }
@@ -464,41 +470,92 @@ void PropertyMeshKernel::setValue(const MeshObject& mesh)
 void PropertyMeshKernel::setValue(const MeshCore::MeshKernel& mesh)
 {
     aboutToSetValue();
+    cancelDeferred();
+    detachMesh(false);
     _meshObject->setKernel(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshObject& mesh)
 {
+    restoreDeferred();
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->swap(mesh);
     hasSetValue();
 }
 
 void PropertyMeshKernel::swapMesh(MeshCore::MeshKernel& mesh)
 {
+    restoreDeferred();
     aboutToSetValue();
+    detachMesh(false);
     _meshObject->swap(mesh);
     hasSetValue();
 }
 
+void PropertyMeshKernel::detachMesh(bool copyData)
+{
+    // the mesh object is referenced by another property, e.g. a snapshot
+    // of the undo/redo stack, which must not see the modification
+    if (_sharedMesh && _sharedMesh.use_count() > 1) {
+        MeshObject* mesh;
+        if (copyData) {
+            mesh = new MeshObject(*_meshObject);
+        }
+        else {
+            mesh = new MeshObject();
+            mesh->setTransform(_meshObject->getTransform());
+        }
+        setMeshObject(mesh);
+    }
+
+    _sharedMesh.reset();
+}
+
+void PropertyMeshKernel::restoreDeferred() const
+{
+    if (_deferredFile && _deferredFile->isPending())
+        _deferredFile->restore();
+}
+
+void PropertyMeshKernel::cancelDeferred()
+{
+    if (_deferredFile) {
+        _deferredFile->cancel();
+        _deferredFile.reset();
+    }
+}
+
+void PropertyMeshKernel::setMeshObject(MeshObject* mesh)
+{
+    _meshObject = mesh;
+    // the Python wrapper must refer to the mesh object of this property
+    if (meshPyObject)
+        meshPyObject->_pcTwinPointer = mesh;
+}
+
 const MeshObject& PropertyMeshKernel::getValue(void)const 
 {
+    restoreDeferred();
     return *_meshObject;
 }
 
 const MeshObject* PropertyMeshKernel::getValuePtr(void)const 
 {
+    restoreDeferred();
     return (MeshObject*)_meshObject;
 }
 
 const Data::ComplexGeoData* PropertyMeshKernel::getComplexData() const
 {
+    restoreDeferred();
     return (MeshObject*)_meshObject;
 }
 
 Base::BoundBox3d PropertyMeshKernel::getBoundingBox() const
 {
+    restoreDeferred();
     return _meshObject->getBoundBox();
 }
 
@@ -510,9 +567,48 @@ unsigned int PropertyMeshKernel::getMemSize (void) const
     return size;
 }
 
+std::size_t PropertyMeshKernel::getOwnedMemSize (void) const
+{
+    // the mesh is still referenced by another copy of this property
+    if (_sharedMesh && _sharedMesh.use_count() > 1)
+        return 0;
+    return getMemSize();
+}
+
+bool PropertyMeshKernel::getValueHash(std::size_t& hash) const
+{
+    restoreDeferred();
+    hash = 0;
+    Base::Matrix4D mat = _meshObject->getTransform();
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++)
+            boost::hash_combine(hash, mat[i][j]);
+    }
+
+    const MeshCore::MeshKernel& kernel = _meshObject->getKernel();
+    const MeshCore::MeshPointArray& points = kernel.GetPoints();
+    const MeshCore::MeshFacetArray& facets = kernel.GetFacets();
+    boost::hash_combine(hash, points.size());
+    boost::hash_combine(hash, facets.size());
+    for (MeshCore::MeshPointArray::_TConstIterator it = points.begin(); it != points.end(); ++it) {
+        boost::hash_combine(hash, it->x);
+        boost::hash_combine(hash, it->y);
+        boost::hash_combine(hash, it->z);
+    }
+    for (MeshCore::MeshFacetArray::_TConstIterator it = facets.begin(); it != facets.end(); ++it) {
+        boost::hash_combine(hash, it->_aulPoints[0]);
+        boost::hash_combine(hash, it->_aulPoints[1]);
+        boost::hash_combine(hash, it->_aulPoints[2]);
+    }
+
+    return true;
+}
+
 MeshObject* PropertyMeshKernel::startEditing()
 {
+    restoreDeferred();
     aboutToSetValue();
+    detachMesh(true);
     return (MeshObject*)_meshObject;
 }
 
@@ -523,14 +619,18 @@ void PropertyMeshKernel::finishEditing()
 
 void PropertyMeshKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
+    restoreDeferred();
     aboutToSetValue();
+    detachMesh(true);
     _meshObject->transformGeometry(rclMat);
     hasSetValue();
 }
 
 void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned long, Base::Vector3f> >& inds)
 {
+    restoreDeferred();
     aboutToSetValue();
+    detachMesh(true);
     MeshCore::MeshKernel& kernel = _meshObject->getKernel();
     for (std::vector<std::pair<unsigned long, Base::Vector3f> >::const_iterator it = inds.begin(); it != inds.end(); ++it)
         kernel.SetPoint(it->first, it->second);
@@ -539,6 +639,7 @@ void PropertyMeshKernel::setPointIndices(const std::vector<std::pair<unsigned lo
 
 PyObject *PropertyMeshKernel::getPyObject(void)
 {
+    restoreDeferred();
     if (!meshPyObject) {
         meshPyObject = new MeshPy(&*_meshObject);
         meshPyObject->setConst(); // set immutable
@@ -574,6 +675,7 @@ void PropertyMeshKernel::setPyObject(PyObject *value)
 
 void PropertyMeshKernel::Save (Base::Writer &writer) const
 {
+    restoreDeferred();
     if (writer.isForceXML()) {
         writer.Stream() << writer.ind() << "<Mesh>" << std::endl;
         MeshCore::MeshOutput saver(_meshObject->getKernel());
@@ -602,6 +704,8 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
         kernel.Adopt(points, facets);
 
         aboutToSetValue();
+        cancelDeferred();
+        detachMesh(false);
         _meshObject->getKernel().Adopt(points, facets);
         hasSetValue();
     } 
@@ -613,29 +717,55 @@ void PropertyMeshKernel::Restore(Base::XMLReader &reader)
 
 void PropertyMeshKernel::SaveDocFile (Base::Writer &writer) const
 {
+    restoreDeferred();
     _meshObject->save(writer.Stream());
 }
 
 void PropertyMeshKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    cancelDeferred();
+    detachMesh(false);
     _meshObject->load(reader);
     hasSetValue();
 }
 
+bool PropertyMeshKernel::deferRestoreDocFile(const std::shared_ptr<Base::DeferredFile>& file)
+{
+    cancelDeferred();
+    detachMesh(false);
+    _deferredFile = file;
+    file->setHandler([this](Base::Reader& reader) {
+        // the mesh object is not shared yet because Copy() restores it first
+        _meshObject->load(reader);
+    });
+    return true;
+}
+
 App::Property *PropertyMeshKernel::Copy(void) const
 {
-    // Note: Copy the content, do NOT reference the same mesh object
+    restoreDeferred();
+    // Note: Reference the same mesh object, it gets copied before either
+    // of the two properties modifies it
+    if (!_sharedMesh)
+        _sharedMesh = std::make_shared<int>(0);
     PropertyMeshKernel *prop = new PropertyMeshKernel();
-    *(prop->_meshObject) = *(this->_meshObject);
+    prop->_meshObject = this->_meshObject;
+    prop->_sharedMesh = this->_sharedMesh;
     return prop;
 }
 
 void PropertyMeshKernel::Paste(const App::Property &from)
 {
-    // Note: Copy the content, do NOT reference the same mesh object
-    aboutToSetValue();
+    // Note: Reference the same mesh object, see Copy()
+    Base::Reference<MeshObject> tmp(_meshObject);
     const PropertyMeshKernel& prop = dynamic_cast<const PropertyMeshKernel&>(from);
-    *(this->_meshObject) = *(prop._meshObject);
+    prop.restoreDeferred();
+    aboutToSetValue();
+    cancelDeferred();
+    if (!prop._sharedMesh)
+        prop._sharedMesh = std::make_shared<int>(0);
+    setMeshObject(prop._meshObject);
+    _sharedMesh = prop._sharedMesh;
     hasSetValue();
 }
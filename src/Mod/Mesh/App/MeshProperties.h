@@ -29,6 +29,7 @@
 #include <set>
 #include <string>
 #include <map>
+#include <memory>
 
 #include <Base/Handle.h>
 #include <Base/Matrix.h>
@@ -40,6 +41,9 @@
 #include "Core/MeshKernel.h"
 #include "Mesh.h"
 
+namespace Base {
+class DeferredFile;
+}
 
 namespace Mesh
 {
@@ -190,7 +194,10 @@ public:
     void setValue(const MeshObject& m);
     /** This method sets the mesh by copying the data. */
     void setValue(const MeshCore::MeshKernel& m);
-    /** Swaps the mesh data structure. */
+    /** Swaps the mesh data structure.
+     * @note If the mesh is still shared with a copy of this property (e.g. kept
+     * by the undo/redo stack) the passed object gets an empty mesh.
+     */
     void swapMesh(MeshObject&);
     /** Swaps the mesh data structure. */
     void swapMesh(MeshCore::MeshKernel&);
@@ -200,6 +207,8 @@ public:
     const MeshObject &getValue(void) const;
     const MeshObject *getValuePtr(void) const;
     virtual unsigned int getMemSize (void) const;
+    /// Returns 0 as long as the mesh object is shared with another copy
+    virtual std::size_t getOwnedMemSize (void) const;
     //@}
 
     /** @name Getting basic geometric entities */
@@ -243,14 +252,37 @@ public:
     void Restore(Base::XMLReader &reader);
 
     void SaveDocFile (Base::Writer &writer) const;
+    bool isSaveDocFileThreadSafe() const { return true; }
     void RestoreDocFile(Base::Reader &reader);
+    /// The mesh is read on demand when accessed the first time
+    bool deferRestoreDocFile(const std::shared_ptr<Base::DeferredFile>&);
 
+    /** The copy shares the mesh object with this property until one of them
+     * gets modified (copy-on-write). This makes undo/redo snapshots cheap.
+     */
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
     //@}
 
+    /// Computes a hash of the points, facets and placement of the mesh
+    bool getValueHash(std::size_t& hash) const;
+
+private:
+    /** Makes sure that the mesh object is not shared with a copy of this property
+     * before it gets modified. If \a copyData is false the caller replaces the
+     * mesh data anyway and only the placement is kept.
+     */
+    void detachMesh(bool copyData);
+    void setMeshObject(MeshObject*);
+    /// reads the mesh if the document has been restored lazily
+    void restoreDeferred() const;
+    void cancelDeferred();
+
 private:
     Base::Reference<MeshObject> _meshObject;
+    /// shared by all copies of this property that reference the same mesh object
+    mutable std::shared_ptr<int> _sharedMesh;
+    std::shared_ptr<Base::DeferredFile> _deferredFile;
     MeshPy* meshPyObject;
 };
 
@@ -1726,14 +1726,26 @@ PyObject*  MeshPy::smooth(PyObject *args, PyObject *kwds)
 PyObject*  MeshPy::decimate(PyObject *args)
 {
     float fTol, fRed;
-    if (!PyArg_ParseTuple(args, "ff", &fTol,&fRed))
-        return NULL;
+    if (PyArg_ParseTuple(args, "ff", &fTol,&fRed)) {
+        PY_TRY {
+            getMeshObjectPtr()->decimate(fTol, fRed);
+        } PY_CATCH;
 
-    PY_TRY {
-        getMeshObjectPtr()->decimate(fTol, fRed);
-    } PY_CATCH;
+        Py_Return;
+    }
 
-    Py_Return;
+    PyErr_Clear();
+    int targetSize, blocks = 0;
+    if (PyArg_ParseTuple(args, "i|i", &targetSize, &blocks)) {
+        PY_TRY {
+            getMeshObjectPtr()->decimate(targetSize, blocks);
+        } PY_CATCH;
+
+        Py_Return;
+    }
+
+    PyErr_SetString(Base::BaseExceptionFreeCADError, "decimate(tolerance=float, reduction=float) or decimate(targetSize=int, [blocks=int])");
+    return 0;
 }
 
 PyObject* MeshPy::nearestFacetOnRay(PyObject *args)
@@ -1803,6 +1815,96 @@ PyObject* MeshPy::nearestFacetOnRay(PyObject *args)
     }
 }
 
+PyObject* MeshPy::nearestFacetsOnRays(PyObject *args)
+{
+    PyObject* pnts;
+    PyObject* dirs;
+    if (!PyArg_ParseTuple(args, "OO", &pnts, &dirs))
+        return NULL;
+
+    try {
+        Py::Sequence pnt_s(pnts);
+        Py::Sequence dir_s(dirs);
+        if (pnt_s.size() != dir_s.size()) {
+            PyErr_SetString(PyExc_ValueError, "Number of points and directions must be equal");
+            return 0;
+        }
+
+        std::vector<MeshObject::TRay> rays;
+        rays.reserve(pnt_s.size());
+        for (Py::Sequence::size_type i = 0; i < pnt_s.size(); i++) {
+            Base::Vector3d pnt = Py::Vector(pnt_s[i]).toVector();
+            Base::Vector3d dir = Py::Vector(dir_s[i]).toVector();
+            rays.push_back(std::make_pair(Base::convertTo<Base::Vector3f>(pnt),
+                                          Base::convertTo<Base::Vector3f>(dir)));
+        }
+
+        std::vector<MeshObject::TFacetPoint> hits = getMeshObjectPtr()->nearestFacetsOnRays(rays);
+        Py::List list;
+        for (std::vector<MeshObject::TFacetPoint>::iterator it = hits.begin(); it != hits.end(); ++it) {
+            if (it->first == ULONG_MAX) {
+                list.append(Py::None());
+            }
+            else {
+                Py::Tuple tuple(2);
+#if PY_MAJOR_VERSION >= 3
+                tuple.setItem(0, Py::Long(it->first));
+#else
+                tuple.setItem(0, Py::Int((int)it->first));
+#endif
+                tuple.setItem(1, Py::Vector(it->second));
+                list.append(tuple);
+            }
+        }
+
+        return Py::new_reference_to(list);
+    }
+    catch (const Py::Exception&) {
+        return 0;
+    }
+}
+
+PyObject* MeshPy::nearestFacetsToPoints(PyObject *args)
+{
+    PyObject* pnts;
+    float maxDist = FLT_MAX;
+    if (!PyArg_ParseTuple(args, "O|f", &pnts, &maxDist))
+        return NULL;
+
+    try {
+        Py::Sequence pnt_s(pnts);
+        std::vector<Base::Vector3f> points;
+        points.reserve(pnt_s.size());
+        for (Py::Sequence::iterator it = pnt_s.begin(); it != pnt_s.end(); ++it) {
+            Base::Vector3d pnt = Py::Vector(*it).toVector();
+            points.push_back(Base::convertTo<Base::Vector3f>(pnt));
+        }
+
+        std::vector<MeshObject::TFacetPoint> hits = getMeshObjectPtr()->nearestFacetsToPoints(points, maxDist);
+        Py::List list;
+        for (std::vector<MeshObject::TFacetPoint>::iterator it = hits.begin(); it != hits.end(); ++it) {
+            if (it->first == ULONG_MAX) {
+                list.append(Py::None());
+            }
+            else {
+                Py::Tuple tuple(2);
+#if PY_MAJOR_VERSION >= 3
+                tuple.setItem(0, Py::Long(it->first));
+#else
+                tuple.setItem(0, Py::Int((int)it->first));
+#endif
+                tuple.setItem(1, Py::Vector(it->second));
+                list.append(tuple);
+            }
+        }
+
+        return Py::new_reference_to(list);
+    }
+    catch (const Py::Exception&) {
+        return 0;
+    }
+}
+
 PyObject*  MeshPy::getPlanarSegments(PyObject *args)
 {
     float dev;
@@ -1836,7 +1938,8 @@ PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
     char* type;
     float dev;
     unsigned long minFacets=0;
-    if (!PyArg_ParseTuple(args, "sf|k",&type,&dev,&minFacets))
+    PyObject* parallel=Py_False;
+    if (!PyArg_ParseTuple(args, "sf|kO!",&type,&dev,&minFacets,&PyBool_Type,&parallel))
         return NULL;
 
     Mesh::MeshObject::GeometryType geoType;
@@ -1856,7 +1959,7 @@ PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
 
     Mesh::MeshObject* mesh = getMeshObjectPtr();
     std::vector<Mesh::Segment> segments = mesh->getSegmentsOfType
-        (geoType, dev, minFacets);
+        (geoType, dev, minFacets, PyObject_IsTrue(parallel) ? true : false);
 
     Py::List s;
     for (std::vector<Mesh::Segment>::iterator it = segments.begin(); it != segments.end(); ++it) {
@@ -1878,7 +1981,8 @@ PyObject*  MeshPy::getSegmentsOfType(PyObject *args)
 PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
 {
     PyObject* l;
-    if (!PyArg_ParseTuple(args, "O",&l))
+    PyObject* parallel=Py_False;
+    if (!PyArg_ParseTuple(args, "O|O!",&l,&PyBool_Type,&parallel))
         return NULL;
 
     const MeshCore::MeshKernel& kernel = getMeshObjectPtr()->getKernel();
@@ -1902,7 +2006,7 @@ PyObject*  MeshPy::getSegmentsByCurvature(PyObject *args)
         segm.push_back(new MeshCore::MeshCurvatureFreeformSegment(meshCurv.GetCurvature(), num, tol1, tol2, c1, c2));
     }
 
-    finder.FindSegments(segm);
+    finder.FindSegments(segm, PyObject_IsTrue(parallel) ? true : false);
 
     Py::List list;
     for (std::vector<MeshCore::MeshSurfaceSegment*>::iterator segmIt = segm.begin(); segmIt != segm.end(); ++segmIt) {
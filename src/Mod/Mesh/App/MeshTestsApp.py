@@ -225,3 +225,358 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+
+class MeshUndoRedoCases(unittest.TestCase):
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("MeshUndoRedoTest")
+        self.doc.UndoMode = 1
+
+    def testUndoRedoMesh(self):
+        feature = self.doc.addObject("Mesh::Feature","Mesh")
+        feature.Mesh = Mesh.createBox(1.0,1.0,1.0)
+        mesh = feature.Mesh
+        self.doc.openTransaction("Sphere")
+        feature.Mesh = Mesh.createSphere(1.0,20)
+        self.doc.commitTransaction()
+        count = feature.Mesh.CountFacets
+        self.failUnless(count > 12)
+        self.failUnless(self.doc.UndoRedoMemSize > 0)
+        self.doc.undo()
+        self.failUnless(feature.Mesh.CountFacets == 12)
+        # the Python object of the property must follow the undo
+        self.failUnless(mesh.CountFacets == 12)
+        self.doc.redo()
+        self.failUnless(feature.Mesh.CountFacets == count)
+        self.failUnless(mesh.CountFacets == count)
+
+    def tearDown(self):
+        FreeCAD.closeDocument("MeshUndoRedoTest")
+
+class MeshNearestFacetCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createBox(1.0,1.0,1.0)
+
+    def testNearestFacetsOnRays(self):
+        pnts = [FreeCAD.Vector(0,0,5), FreeCAD.Vector(0,0,5), FreeCAD.Vector(5,5,5)]
+        dirs = [FreeCAD.Vector(0,0,-1), FreeCAD.Vector(0,0,1), FreeCAD.Vector(0,0,-1)]
+        hits = self.mesh.nearestFacetsOnRays(pnts, dirs)
+        self.failUnless(len(hits) == 3)
+        self.failUnless(hits[0] is not None)
+        self.failUnless(abs(hits[0][1].z - 0.5) < 1e-6)
+        facet = self.mesh.Facets[hits[0][0]]
+        self.failUnless(facet.Normal.z > 0.99)
+        # only intersections in direction of the ray are considered
+        self.failUnless(hits[1] is None)
+        self.failUnless(hits[2] is None)
+
+    def testNearestFacetsToPoints(self):
+        pnts = [FreeCAD.Vector(0,0,2), FreeCAD.Vector(0.1,0.1,0.1), FreeCAD.Vector(5,0,0)]
+        hits = self.mesh.nearestFacetsToPoints(pnts)
+        self.failUnless(abs(hits[0][1].z - 0.5) < 1e-6)
+        self.failUnless(abs(hits[0][1].distanceToPoint(pnts[0]) - 1.5) < 1e-6)
+        self.failUnless(abs(hits[1][1].distanceToPoint(pnts[1]) - 0.4) < 1e-6)
+        self.failUnless(abs(hits[2][1].x - 0.5) < 1e-6)
+        hits = self.mesh.nearestFacetsToPoints(pnts, 1.0)
+        self.failUnless(hits[0] is None)
+        self.failUnless(hits[1] is not None)
+        self.failUnless(hits[2] is None)
+
+class MeshSmoothingCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0,50)
+
+    def testLaplace(self):
+        mesh = self.mesh.copy()
+        mesh.smooth(Method="Laplace", Iteration=10)
+        self.failUnless(mesh.CountPoints == self.mesh.CountPoints)
+        # a closed surface shrinks
+        for p in mesh.Points:
+            self.failUnless(p.Vector.Length < 1.0 + 1e-6)
+        other = self.mesh.copy()
+        other.smooth(Method="Laplace", Iteration=10)
+        self.failUnless(mesh.Topology == other.Topology)
+
+    def testTaubin(self):
+        laplace = self.mesh.copy()
+        laplace.smooth(Method="Laplace", Iteration=10)
+        taubin = self.mesh.copy()
+        taubin.smooth(Method="Taubin", Iteration=10)
+        # Taubin smoothing shrinks much less than Laplace
+        self.failUnless(taubin.Volume > laplace.Volume)
+
+    def testPlaneFit(self):
+        # a plane with noise, enough points to be smoothed by several threads
+        n = 100
+        def noise(i, j):
+            return 0.1 * (((i * 7919 + j * 104729) % 1000) / 1000.0 - 0.5)
+        pts = [[FreeCAD.Vector(i, j, noise(i, j)) for j in range(n)] for i in range(n)]
+        triangles = []
+        for i in range(n - 1):
+            for j in range(n - 1):
+                triangles.append([pts[i][j], pts[i+1][j], pts[i+1][j+1]])
+                triangles.append([pts[i][j], pts[i+1][j+1], pts[i][j+1]])
+        plane = Mesh.Mesh(triangles)
+        def rms(mesh):
+            return math.sqrt(sum([p.z * p.z for p in mesh.Points]) / mesh.CountPoints)
+
+        mesh = plane.copy()
+        mesh.smooth(Method="PlaneFit", Iteration=2)
+        self.failUnless(mesh.CountPoints == plane.CountPoints)
+        self.failUnless(rms(mesh) < 0.5 * rms(plane))
+        # the points are moved along the plane normal
+        for p, q in zip(mesh.Points, plane.Points):
+            self.failUnless(abs(p.x - q.x) < 0.05 and abs(p.y - q.y) < 0.05)
+
+class MeshCurvatureCases(unittest.TestCase):
+    def testSphere(self):
+        # both principal curvatures of a sphere are 1/radius
+        mesh = Mesh.createSphere(2.0,50)
+        segments = mesh.getSegmentsByCurvature([(0.5,0.5,0.1,0.1,10)])
+        count = 0
+        for segm in segments:
+            count += len(segm)
+        self.failUnless(count > 0.9 * mesh.CountFacets)
+
+class MeshSegmentationCases(unittest.TestCase):
+    def setUp(self):
+        # steps, a ramp and a spherical bump with a little noise
+        n = 60
+        def height(i, j):
+            x = 10.0 * i / n
+            y = 10.0 * j / n
+            if x < 3:
+                z = math.floor(y / 2)
+            elif x < 6:
+                z = 0.3 * x
+            else:
+                r = math.sqrt((x - 8) ** 2 + (y - 5) ** 2)
+                z = math.sqrt(4 - r * r) if r < 2 else 0
+            return FreeCAD.Vector(x, y, z + 0.01 * (((i * 7919 + j * 104729) % 1000) / 1000.0 - 0.5))
+        pts = [[height(i, j) for j in range(n)] for i in range(n)]
+        triangles = []
+        for i in range(n - 1):
+            for j in range(n - 1):
+                triangles.append([pts[i][j], pts[i+1][j], pts[i+1][j+1]])
+                triangles.append([pts[i][j], pts[i+1][j+1], pts[i][j+1]])
+        self.mesh = Mesh.Mesh(triangles)
+
+    def testCurvatureParallel(self):
+        types = [(0.0,0.0,0.3,0.3,20), (0.5,0.5,0.3,0.3,20), (1.0,0.0,0.2,0.2,5)]
+        serial = self.mesh.getSegmentsByCurvature(types)
+        self.failUnless(len(serial) > 1)
+        self.failUnless(self.mesh.getSegmentsByCurvature(types, True) == serial)
+
+    def testFitParallel(self):
+        for name in ["Plane", "Cylinder", "Sphere"]:
+            serial = self.mesh.getSegmentsOfType(name, 0.05, 10)
+            self.failUnless(self.mesh.getSegmentsOfType(name, 0.05, 10, True) == serial)
+        self.failUnless(len(self.mesh.getSegmentsOfType("Plane", 0.05, 10)) > 1)
+
+class MeshDecimationCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0,50)
+
+    def testTargetSize(self):
+        mesh = self.mesh.copy()
+        mesh.decimate(500)
+        self.failUnless(mesh.CountFacets <= 500)
+        self.failUnless(mesh.CountFacets > 400)
+        self.failUnless(mesh.isSolid())
+
+    def testReduction(self):
+        mesh = self.mesh.copy()
+        mesh.decimate(0.5, 0.5)
+        self.failUnless(mesh.CountFacets < self.mesh.CountFacets)
+        self.failUnless(mesh.isSolid())
+
+    def testBlocks(self):
+        # split the mesh into several blocks independent of the number of threads
+        for blocks in (2, 4, 7):
+            mesh = self.mesh.copy()
+            mesh.decimate(1000, blocks)
+            self.failUnless(mesh.CountFacets <= 1000)
+            self.failUnless(mesh.CountFacets > 800)
+            self.failUnless(mesh.isSolid())
+            self.failIf(mesh.hasNonManifolds())
+            self.failUnless(abs(mesh.Volume - self.mesh.Volume) < 0.02 * self.mesh.Volume)
+
+class MeshSetOperationsCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh1 = Mesh.createSphere(1.0,50)
+        self.mesh2 = Mesh.createSphere(1.0,50)
+        self.mesh2.translate(1.0,0.01,0.02)
+        self.volume = self.mesh1.Volume
+        self.lens = self.volume - self.mesh1.difference(self.mesh2).Volume
+
+    def testVolumes(self):
+        # the union and intersection add up to the two spheres
+        union = self.mesh1.unite(self.mesh2)
+        inter = self.mesh1.intersect(self.mesh2)
+        self.failUnless(union.isSolid())
+        self.failUnless(inter.isSolid())
+        self.failUnless(self.lens > 0.0)
+        self.failUnless(abs(inter.Volume - self.lens) < 1e-3)
+        self.failUnless(abs(union.Volume + inter.Volume - 2.0 * self.volume) < 1e-3)
+
+    def testNested(self):
+        # a sphere inside the other one doesn't intersect its surface
+        inner = Mesh.createSphere(0.3,50)
+        self.failUnless(abs(self.mesh1.unite(inner).Volume - self.volume) < 1e-3)
+        self.failUnless(abs(self.mesh1.difference(inner).Volume - (self.volume - inner.Volume)) < 1e-3)
+
+class MeshFixAllDefectsCases(unittest.TestCase):
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("MeshFixAllDefectsTest")
+
+    def testRepair(self):
+        box = Mesh.createBox(1.0,1.0,1.0)
+        triangles = [list(f.Points) for f in box.Facets]
+        triangles[0].reverse() # flipped normal
+        feature = self.doc.addObject("Mesh::Feature","Mesh")
+        feature.Mesh = Mesh.Mesh(triangles)
+        self.failUnless(feature.Mesh.countNonUniformOrientedFacets() > 0)
+        fix = self.doc.addObject("Mesh::FixAllDefects","Fix")
+        fix.Source = feature
+        self.doc.recompute()
+        self.failUnless(fix.Mesh.CountFacets == 12)
+        self.failUnless(fix.Mesh.countNonUniformOrientedFacets() == 0)
+        self.failUnless(not fix.Mesh.hasNonManifolds())
+        self.failUnless(fix.Mesh.isSolid())
+
+    def tearDown(self):
+        FreeCAD.closeDocument("MeshFixAllDefectsTest")
+
+class MeshBinaryFormatCases(unittest.TestCase):
+    def setUp(self):
+        self.fileName = tempfile.gettempdir() + os.sep + "MeshBinaryFormatTest.bms"
+
+    def testWriteRead(self):
+        mesh = Mesh.createSphere(1.0,20)
+        # remove a facet to have some open edges
+        mesh.removeFacets([0])
+        mesh.write(self.fileName)
+        other = Mesh.Mesh()
+        other.read(self.fileName)
+        self.failUnless(other.Topology == mesh.Topology)
+        self.failUnless(other.CountFacets == mesh.CountFacets)
+        self.failUnless(other.hasNonManifolds() == mesh.hasNonManifolds())
+        self.failUnless(other.isSolid() == mesh.isSolid())
+
+    def tearDown(self):
+        if os.path.exists(self.fileName):
+            os.remove(self.fileName)
+
+class MeshMappedReadCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = Mesh.createSphere(1.0,20)
+        self.fileNames = []
+
+    def checkWriteRead(self, ext):
+        fileName = tempfile.gettempdir() + os.sep + "MeshMappedReadTest." + ext
+        self.fileNames.append(fileName)
+        self.mesh.write(fileName)
+        other = Mesh.Mesh()
+        other.read(fileName)
+        self.failUnless(other.CountPoints == self.mesh.CountPoints)
+        self.failUnless(other.CountFacets == self.mesh.CountFacets)
+        self.failUnless(other.isSolid() == self.mesh.isSolid())
+
+    def testBinarySTL(self):
+        self.checkWriteRead("stl")
+
+    def testOBJ(self):
+        self.checkWriteRead("obj")
+
+    def testPLY(self):
+        self.checkWriteRead("ply")
+
+    def tearDown(self):
+        for fileName in self.fileNames:
+            if os.path.exists(fileName):
+                os.remove(fileName)
+
+class MeshLazyRestoreCases(unittest.TestCase):
+    def setUp(self):
+        self.param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+        self.lazy = self.param.GetBool("LazyRestore", False)
+        self.doc = FreeCAD.newDocument("MeshLazyRestoreTest")
+        self.fileName = tempfile.gettempdir() + os.sep + "MeshLazyRestoreTest.FCStd"
+
+    def testLazyRestore(self):
+        feature = self.doc.addObject("Mesh::Feature","Mesh")
+        feature.Mesh = Mesh.createSphere(1.0,20)
+        count = feature.Mesh.CountFacets
+        self.doc.saveAs(self.fileName)
+        FreeCAD.closeDocument(self.doc.Name)
+
+        self.param.SetBool("LazyRestore", True)
+        self.doc = FreeCAD.openDocument(self.fileName)
+        feature = self.doc.getObject("Mesh")
+        self.failUnless(feature.Mesh.CountFacets == count)
+        # saving again must write the mesh even if it hasn't been accessed
+        self.doc.save()
+        FreeCAD.closeDocument(self.doc.Name)
+        self.doc = FreeCAD.openDocument(self.fileName)
+        self.doc.save()
+        FreeCAD.closeDocument(self.doc.Name)
+        self.doc = FreeCAD.openDocument(self.fileName)
+        self.failUnless(self.doc.getObject("Mesh").Mesh.CountFacets == count)
+
+    def tearDown(self):
+        self.param.SetBool("LazyRestore", self.lazy)
+        FreeCAD.closeDocument(self.doc.Name)
+        if os.path.exists(self.fileName):
+            os.remove(self.fileName)
+
+class MeshChunkedKernelCases(unittest.TestCase):
+    def setUp(self):
+        tmp = tempfile.gettempdir() + os.sep
+        self.stlName = tmp + "MeshChunkedKernelTest.stl"
+        self.chunkName = tmp + "MeshChunkedKernelTest.chunks"
+        self.outName = tmp + "MeshChunkedKernelTestOut.stl"
+        self.mesh = Mesh.createSphere(1.0,50)
+        self.mesh.write(self.stlName)
+
+    def testRoundTrip(self):
+        Mesh.createChunked(self.stlName, self.chunkName, 500)
+        count = Mesh.countChunks(self.chunkName)
+        self.failUnless(count > 1)
+        facets = 0
+        for i in range(count):
+            facets += Mesh.readChunk(self.chunkName, i).CountFacets
+        self.failUnless(facets == self.mesh.CountFacets)
+
+        mat = FreeCAD.Matrix()
+        mat.rotateZ(0.5)
+        mat.move(FreeCAD.Vector(10,-5,2))
+        Mesh.transformChunked(self.chunkName, mat)
+        Mesh.exportChunked(self.chunkName, self.outName)
+
+        # only the order of the facets differs from the transformed input
+        other = Mesh.read(self.outName)
+        self.mesh.transform(mat)
+        self.failUnless(other.CountFacets == self.mesh.CountFacets)
+        self.failUnless(other.CountPoints == self.mesh.CountPoints)
+        self.failUnless(abs(other.Volume - self.mesh.Volume) < 1e-4)
+        box1 = other.BoundBox
+        box2 = self.mesh.BoundBox
+        self.failUnless(box1.Center.distanceToPoint(box2.Center) < 1e-4)
+        self.failUnless(abs(box1.DiagonalLength - box2.DiagonalLength) < 1e-4)
+
+    def testInvalidIndex(self):
+        import struct
+        Mesh.createChunked(self.stlName, self.chunkName, 500)
+        with open(self.chunkName, "r+b") as f:
+            # the 56 byte header is followed by the chunk entries which start
+            # with the offset and the number of points of the chunk
+            f.seek(56)
+            offset, numPoints = struct.unpack("=QQ", f.read(16))
+            f.seek(offset + 12 * numPoints)
+            f.write(struct.pack("=I", numPoints))
+        self.assertRaises(RuntimeError, Mesh.countChunks, self.chunkName)
+
+    def tearDown(self):
+        for fileName in [self.stlName, self.chunkName, self.outName]:
+            if os.path.exists(fileName):
+                os.remove(fileName)
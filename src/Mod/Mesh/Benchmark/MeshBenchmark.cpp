@@ -0,0 +1,618 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QThread>
+
+#include <Base/Exception.h>
+#include <Base/FileInfo.h>
+#include <Base/Stream.h>
+
+#include <Mod/Mesh/App/Core/Curvature.h>
+#include <Mod/Mesh/App/Core/Decimation.h>
+#include <Mod/Mesh/App/Core/Grid.h>
+#include <Mod/Mesh/App/Core/MeshIO.h>
+#include <Mod/Mesh/App/Core/MeshKernel.h>
+#include <Mod/Mesh/App/Core/SetOperations.h>
+#include <Mod/Mesh/App/Core/Smoothing.h>
+
+using namespace MeshCore;
+
+/*
+ * MeshBenchmark times the expensive algorithms of the mesh kernel on synthetic
+ * spheres of several sizes and on mesh files given on the command line. It
+ * doesn't need the GUI or the application framework and writes one line per
+ * dataset and operation as CSV or JSON, so that the results of different
+ * builds can be compared by scripts. Given the CSV output of an earlier run
+ * as baseline it reports the operations that became slower.
+ */
+
+namespace {
+
+struct Dataset
+{
+    std::string name;
+    MeshKernel mesh;
+};
+
+struct Result
+{
+    std::string dataset;
+    std::string operation;
+    unsigned long facets;
+    unsigned long points;
+    int repeat;
+    double minimum;
+    double median;
+    // the minimum time of the baseline, negative if there is none
+    double baseline;
+};
+
+struct Options
+{
+    Options() : level(-1), repeat(3), json(false), threshold(10.0) {}
+    std::vector<std::string> sizes;
+    std::vector<std::string> files;
+    std::vector<std::string> operations;
+    int level;
+    int repeat;
+    bool json;
+    std::string output;
+    std::string baseline;
+    double threshold;
+};
+
+// The minimum times of an earlier run by dataset and operation
+typedef std::map<std::pair<std::string, std::string>, double> Baseline;
+
+// Differences below this time in seconds are considered as noise
+const double MinDifference = 0.001;
+
+// The number of subdivisions of an icosahedron for the synthetic datasets
+// (20 * 4^n facets)
+int SubdivisionLevel(const std::string& size)
+{
+    if (size == "small")
+        return 4;   // 5120 facets
+    if (size == "medium")
+        return 6;   // 81920 facets
+    if (size == "large")
+        return 8;   // 1310720 facets
+    return -1;
+}
+
+// Creates a unit sphere by subdividing an icosahedron
+void CreateSphere(MeshKernel& mesh, int level, const Base::Vector3f& center, float radius)
+{
+    const float t = (1.0f + std::sqrt(5.0f)) / 2.0f;
+    const float coords[12][3] = {
+        {-1, t, 0}, { 1, t, 0}, {-1,-t, 0}, { 1,-t, 0},
+        { 0,-1, t}, { 0, 1, t}, { 0,-1,-t}, { 0, 1,-t},
+        { t, 0,-1}, { t, 0, 1}, {-t, 0,-1}, {-t, 0, 1}
+    };
+    const unsigned long faces[20][3] = {
+        {0,11,5}, {0,5,1}, {0,1,7}, {0,7,10}, {0,10,11},
+        {1,5,9}, {5,11,4}, {11,10,2}, {10,7,6}, {7,1,8},
+        {3,9,4}, {3,4,2}, {3,2,6}, {3,6,8}, {3,8,9},
+        {4,9,5}, {2,4,11}, {6,2,10}, {8,6,7}, {9,8,1}
+    };
+
+    std::vector<Base::Vector3f> points;
+    for (int i = 0; i < 12; i++) {
+        Base::Vector3f p(coords[i][0], coords[i][1], coords[i][2]);
+        points.push_back(p.Normalize());
+    }
+    std::vector<unsigned long> facets(&faces[0][0], &faces[0][0] + 60);
+
+    for (int l = 0; l < level; l++) {
+        std::map<std::pair<unsigned long, unsigned long>, unsigned long> midpoints;
+        std::vector<unsigned long> subdivided;
+        subdivided.reserve(facets.size() * 4);
+        for (std::size_t i = 0; i < facets.size(); i += 3) {
+            unsigned long mid[3];
+            for (int j = 0; j < 3; j++) {
+                unsigned long p = facets[i + j];
+                unsigned long q = facets[i + (j + 1) % 3];
+                std::pair<unsigned long, unsigned long> edge(std::min(p, q), std::max(p, q));
+                std::map<std::pair<unsigned long, unsigned long>, unsigned long>::iterator it = midpoints.find(edge);
+                if (it == midpoints.end()) {
+                    Base::Vector3f m = (points[p] + points[q]) / 2.0f;
+                    points.push_back(m.Normalize());
+                    it = midpoints.insert(std::make_pair(edge, static_cast<unsigned long>(points.size() - 1))).first;
+                }
+                mid[j] = it->second;
+            }
+
+            unsigned long a = facets[i], b = facets[i + 1], c = facets[i + 2];
+            unsigned long tria[12] = {a, mid[0], mid[2], b, mid[1], mid[0], c, mid[2], mid[1], mid[0], mid[1], mid[2]};
+            subdivided.insert(subdivided.end(), tria, tria + 12);
+        }
+        facets.swap(subdivided);
+    }
+
+    MeshPointArray rPoints;
+    rPoints.reserve(points.size());
+    for (std::vector<Base::Vector3f>::iterator it = points.begin(); it != points.end(); ++it)
+        rPoints.push_back(MeshPoint(center + *it * radius));
+    MeshFacetArray rFacets;
+    rFacets.reserve(facets.size() / 3);
+    for (std::size_t i = 0; i < facets.size(); i += 3)
+        rFacets.push_back(MeshFacet(facets[i], facets[i + 1], facets[i + 2]));
+    mesh.Adopt(rPoints, rFacets, true);
+}
+
+/*
+ * The operations get a copy of the dataset in \a mesh that they may change.
+ * The copy isn't part of the measured time, everything else of the operation is.
+ */
+typedef void (*Operation)(MeshKernel& mesh, const std::string& tempDir);
+
+void ExportSTL(MeshKernel& mesh, const std::string& tempDir)
+{
+    Base::FileInfo fi(tempDir + "MeshBenchmark.stl");
+    Base::ofstream str(fi, std::ios::out | std::ios::binary);
+    MeshOutput(mesh).SaveBinarySTL(str);
+}
+
+void ImportSTL(MeshKernel& mesh, const std::string& tempDir)
+{
+    Base::FileInfo fi(tempDir + "MeshBenchmark.stl");
+    Base::ifstream str(fi, std::ios::in | std::ios::binary);
+    if (!MeshInput(mesh).LoadSTL(str))
+        throw Base::FileException("Failed to read temporary STL file", fi);
+}
+
+void ExportOBJ(MeshKernel& mesh, const std::string& tempDir)
+{
+    Base::FileInfo fi(tempDir + "MeshBenchmark.obj");
+    Base::ofstream str(fi, std::ios::out | std::ios::binary);
+    MeshOutput(mesh).SaveOBJ(str);
+}
+
+void ImportOBJ(MeshKernel& mesh, const std::string& tempDir)
+{
+    Base::FileInfo fi(tempDir + "MeshBenchmark.obj");
+    Base::ifstream str(fi, std::ios::in | std::ios::binary);
+    if (!MeshInput(mesh).LoadOBJ(str))
+        throw Base::FileException("Failed to read temporary OBJ file", fi);
+}
+
+void BuildGrid(MeshKernel& mesh, const std::string&)
+{
+    MeshFacetGrid grid(mesh);
+    (void)grid;
+}
+
+void RebuildNeighbours(MeshKernel& mesh, const std::string&)
+{
+    mesh.RebuildNeighbours();
+}
+
+void Smooth(MeshKernel& mesh, const std::string&)
+{
+    LaplaceSmoothing(mesh).Smooth(3);
+}
+
+void Decimate(MeshKernel& mesh, const std::string&)
+{
+    MeshSimplify(mesh).simplify(0.1f, 0.5f);
+}
+
+void ComputeCurvature(MeshKernel& mesh, const std::string&)
+{
+    MeshCurvature(mesh).ComputePerVertex();
+}
+
+// The tool is the dataset moved by a fraction of its size so that both overlap
+void Union(MeshKernel& mesh, const std::string&)
+{
+    MeshKernel tool(mesh);
+    Base::BoundBox3f bbox = mesh.GetBoundBox();
+    Base::Matrix4D mat;
+    mat.move(Base::Vector3f(0.31f * bbox.LengthX(), 0.17f * bbox.LengthY(), 0.13f * bbox.LengthZ()));
+    tool.Transform(mat);
+
+    MeshKernel result;
+    SetOperations(mesh, tool, result, SetOperations::Union).Do();
+}
+
+struct OperationEntry
+{
+    const char* name;
+    Operation func;
+    // the import operations read the file written by the export before
+    const char* prerequisite;
+};
+
+const OperationEntry Operations[] = {
+    {"export_stl",  ExportSTL, 0},
+    {"import_stl",  ImportSTL, "export_stl"},
+    {"export_obj",  ExportOBJ, 0},
+    {"import_obj",  ImportOBJ, "export_obj"},
+    {"grid",        BuildGrid, 0},
+    {"neighbours",  RebuildNeighbours, 0},
+    {"smoothing",   Smooth, 0},
+    {"decimation",  Decimate, 0},
+    {"curvature",   ComputeCurvature, 0},
+    {"boolean",     Union, 0},
+};
+
+bool IsSelected(const Options& opts, const std::string& operation)
+{
+    if (opts.operations.empty())
+        return true;
+    return std::find(opts.operations.begin(), opts.operations.end(), operation) != opts.operations.end();
+}
+
+Result Measure(const Dataset& data, const OperationEntry& op, int repeat, const std::string& tempDir)
+{
+    std::vector<double> times;
+    for (int i = 0; i < repeat; i++) {
+        MeshKernel mesh(data.mesh);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        op.func(mesh, tempDir);
+        std::chrono::duration<double> diff = std::chrono::steady_clock::now() - start;
+        times.push_back(diff.count());
+    }
+
+    std::sort(times.begin(), times.end());
+    Result result;
+    result.dataset = data.name;
+    result.operation = op.name;
+    result.facets = data.mesh.CountFacets();
+    result.points = data.mesh.CountPoints();
+    result.repeat = repeat;
+    result.minimum = times.front();
+    result.median = times[times.size() / 2];
+    result.baseline = -1.0;
+    return result;
+}
+
+/*
+ * Reads the minimum times from the CSV file \a fn that was written by an
+ * earlier run. Returns false if the file cannot be read or has another format.
+ */
+bool ReadBaseline(const std::string& fn, Baseline& baseline)
+{
+    Base::FileInfo fi(fn);
+    Base::ifstream str(fi, std::ios::in);
+    std::string line;
+    if (!str || !std::getline(str, line) || line.compare(0, 18, "dataset,operation,") != 0)
+        return false;
+
+    while (std::getline(str, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        if (line.empty())
+            continue;
+        std::vector<std::string> fields;
+        std::string::size_type pos = 0, next;
+        while ((next = line.find(',', pos)) != std::string::npos) {
+            fields.push_back(line.substr(pos, next - pos));
+            pos = next + 1;
+        }
+        fields.push_back(line.substr(pos));
+
+        // the minimum time is the seventh column
+        if (fields.size() < 7)
+            return false;
+        baseline[std::make_pair(fields[0], fields[1])] = std::atof(fields[6].c_str());
+    }
+    return true;
+}
+
+void WriteHeader(std::ostream& out, const Options& opts)
+{
+    if (!opts.json) {
+        out << "dataset,operation,facets,points,threads,repeat,min_seconds,median_seconds";
+        if (!opts.baseline.empty())
+            out << ",baseline_seconds,ratio";
+        out << "\n";
+    }
+}
+
+// Returns s as quoted JSON string, file names may contain quotes or backslashes
+std::string JsonString(const std::string& s)
+{
+    std::string str = "\"";
+    for (std::string::const_iterator it = s.begin(); it != s.end(); ++it) {
+        switch (*it) {
+        case '"':  str += "\\\""; break;
+        case '\\': str += "\\\\"; break;
+        case '\b': str += "\\b"; break;
+        case '\f': str += "\\f"; break;
+        case '\n': str += "\\n"; break;
+        case '\r': str += "\\r"; break;
+        case '\t': str += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(*it) < 0x20) {
+                char buf[8];
+                snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(*it));
+                str += buf;
+            }
+            else {
+                str += *it;
+            }
+            break;
+        }
+    }
+    str += "\"";
+    return str;
+}
+
+void WriteResult(std::ostream& out, const Options& opts, const Result& res)
+{
+    int threads = QThread::idealThreadCount();
+    bool compare = !opts.baseline.empty();
+    double ratio = res.baseline > 0.0 ? res.minimum / res.baseline : 0.0;
+    if (opts.json) {
+        out << "{\"dataset\": " << JsonString(res.dataset) << ", \"operation\": " << JsonString(res.operation)
+            << ", \"facets\": " << res.facets << ", \"points\": " << res.points
+            << ", \"threads\": " << threads << ", \"repeat\": " << res.repeat
+            << ", \"min_seconds\": " << res.minimum << ", \"median_seconds\": " << res.median;
+        if (compare && res.baseline >= 0.0) {
+            out << ", \"baseline_seconds\": " << res.baseline;
+            if (ratio > 0.0)
+                out << ", \"ratio\": " << ratio;
+        }
+        out << "}\n";
+    }
+    else {
+        out << res.dataset << "," << res.operation << "," << res.facets << "," << res.points
+            << "," << threads << "," << res.repeat << "," << res.minimum << "," << res.median;
+        if (compare) {
+            out << ",";
+            if (res.baseline >= 0.0)
+                out << res.baseline;
+            out << ",";
+            if (ratio > 0.0)
+                out << ratio;
+        }
+        out << "\n";
+    }
+    out.flush();
+}
+
+// Returns true if the operation is slower than the baseline by more than the threshold
+bool IsRegression(const Options& opts, const Result& res)
+{
+    if (res.baseline < 0.0)
+        return false;
+    return res.minimum > res.baseline * (1.0 + opts.threshold / 100.0) &&
+           res.minimum - res.baseline > MinDifference;
+}
+
+void PrintUsage(const char* exe)
+{
+    std::cerr << "Usage: " << exe << " [options] [mesh files...]\n"
+              << "Times the mesh algorithms on synthetic spheres and the given mesh files.\n\n"
+              << "Options:\n"
+              << "  --size small|medium|large|all  size of the synthetic sphere (default: small,medium)\n"
+              << "  --level n                      sphere with 20*4^n facets instead of --size\n"
+              << "  --no-synthetic                 only use the given mesh files\n"
+              << "  --operation name               run only this operation (can be repeated)\n"
+              << "  --repeat n                     number of runs per operation (default: 3)\n"
+              << "  --json                         write JSON lines instead of CSV\n"
+              << "  --output file                  write the results to file instead of stdout\n"
+              << "  --baseline file                compare with the CSV output of an earlier run\n"
+              << "  --threshold percent            allowed slowdown against the baseline (default: 10)\n"
+              << "  --list                         list the operations\n\n"
+              << "The exit code is 1 if an operation failed and 2 if an operation is slower\n"
+              << "than the baseline by more than the threshold.\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Options opts;
+    bool synthetic = true;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--size" && hasValue) {
+            std::string size = argv[++i];
+            if (size == "all") {
+                opts.sizes.push_back("small");
+                opts.sizes.push_back("medium");
+                opts.sizes.push_back("large");
+            }
+            else if (SubdivisionLevel(size) >= 0) {
+                opts.sizes.push_back(size);
+            }
+            else {
+                std::cerr << "Unknown size '" << size << "'\n";
+                return 1;
+            }
+        }
+        else if (arg == "--level" && hasValue) {
+            opts.level = std::atoi(argv[++i]);
+        }
+        else if (arg == "--no-synthetic") {
+            synthetic = false;
+        }
+        else if (arg == "--operation" && hasValue) {
+            std::string name = argv[++i];
+            bool known = false;
+            for (std::size_t j = 0; j < sizeof(Operations) / sizeof(Operations[0]); j++) {
+                if (name == Operations[j].name)
+                    known = true;
+            }
+            if (!known) {
+                std::cerr << "Unknown operation '" << name << "'\n";
+                return 1;
+            }
+            opts.operations.push_back(name);
+        }
+        else if (arg == "--repeat" && hasValue) {
+            opts.repeat = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--json") {
+            opts.json = true;
+        }
+        else if (arg == "--output" && hasValue) {
+            opts.output = argv[++i];
+        }
+        else if (arg == "--baseline" && hasValue) {
+            opts.baseline = argv[++i];
+        }
+        else if (arg == "--threshold" && hasValue) {
+            opts.threshold = std::max(0.0, std::atof(argv[++i]));
+        }
+        else if (arg == "--list") {
+            for (std::size_t j = 0; j < sizeof(Operations) / sizeof(Operations[0]); j++)
+                std::cout << Operations[j].name << "\n";
+            return 0;
+        }
+        else if (arg == "--help" || arg == "-h" || arg.compare(0, 2, "--") == 0) {
+            PrintUsage(argv[0]);
+            return arg.compare(0, 2, "--") == 0 && arg != "--help" ? 1 : 0;
+        }
+        else {
+            opts.files.push_back(arg);
+        }
+    }
+
+    Baseline baseline;
+    if (!opts.baseline.empty() && !ReadBaseline(opts.baseline, baseline)) {
+        std::cerr << "Cannot read the baseline '" << opts.baseline << "'\n";
+        return 1;
+    }
+
+    // the synthetic datasets
+    std::vector<Dataset*> datasets;
+    if (synthetic) {
+        std::vector<int> levels;
+        if (opts.level >= 0) {
+            levels.push_back(opts.level);
+        }
+        else if (opts.sizes.empty()) {
+            levels.push_back(SubdivisionLevel("small"));
+            levels.push_back(SubdivisionLevel("medium"));
+        }
+        else {
+            for (std::vector<std::string>::iterator it = opts.sizes.begin(); it != opts.sizes.end(); ++it)
+                levels.push_back(SubdivisionLevel(*it));
+        }
+
+        for (std::vector<int>::iterator it = levels.begin(); it != levels.end(); ++it) {
+            Dataset* data = new Dataset();
+            char name[32];
+            snprintf(name, sizeof(name), "sphere%d", *it);
+            data->name = name;
+            CreateSphere(data->mesh, *it, Base::Vector3f(0.0f, 0.0f, 0.0f), 10.0f);
+            datasets.push_back(data);
+        }
+    }
+
+    // the file based datasets
+    for (std::vector<std::string>::iterator it = opts.files.begin(); it != opts.files.end(); ++it) {
+        Dataset* data = new Dataset();
+        data->name = Base::FileInfo(*it).fileName();
+        try {
+            if (!MeshInput(data->mesh).LoadAny(it->c_str())) {
+                std::cerr << "Failed to load '" << *it << "'\n";
+                delete data;
+                continue;
+            }
+        }
+        catch (const Base::Exception& e) {
+            std::cerr << "Failed to load '" << *it << "': " << e.what() << "\n";
+            delete data;
+            continue;
+        }
+        datasets.push_back(data);
+    }
+
+    std::ofstream file;
+    if (!opts.output.empty()) {
+        file.open(opts.output.c_str());
+        if (!file) {
+            std::cerr << "Cannot write to '" << opts.output << "'\n";
+            return 1;
+        }
+    }
+    std::ostream& out = opts.output.empty() ? std::cout : file;
+    WriteHeader(out, opts);
+
+    int ret = 0;
+    bool regression = false;
+    std::string tempDir = Base::FileInfo::getTempPath();
+    for (std::vector<Dataset*>::iterator it = datasets.begin(); it != datasets.end(); ++it) {
+        std::vector<std::string> done;
+        for (std::size_t j = 0; j < sizeof(Operations) / sizeof(Operations[0]); j++) {
+            const OperationEntry& op = Operations[j];
+            if (!IsSelected(opts, op.name))
+                continue;
+
+            try {
+                // write the file to import without measuring it if the export wasn't selected
+                if (op.prerequisite && std::find(done.begin(), done.end(), op.prerequisite) == done.end()) {
+                    for (std::size_t k = 0; k < j; k++) {
+                        if (std::strcmp(Operations[k].name, op.prerequisite) == 0) {
+                            MeshKernel mesh((*it)->mesh);
+                            Operations[k].func(mesh, tempDir);
+                        }
+                    }
+                }
+
+                Result res = Measure(**it, op, opts.repeat, tempDir);
+                Baseline::const_iterator jt = baseline.find(std::make_pair(res.dataset, res.operation));
+                if (jt != baseline.end())
+                    res.baseline = jt->second;
+                WriteResult(out, opts, res);
+                done.push_back(op.name);
+
+                if (IsRegression(opts, res)) {
+                    std::cerr << res.dataset << ": " << res.operation << " takes " << res.minimum
+                              << "s instead of " << res.baseline << "s\n";
+                    regression = true;
+                }
+            }
+            catch (const Base::Exception& e) {
+                std::cerr << (*it)->name << ": " << op.name << " failed: " << e.what() << "\n";
+                ret = 1;
+            }
+        }
+        delete *it;
+    }
+
+    Base::FileInfo(tempDir + "MeshBenchmark.stl").deleteFile();
+    Base::FileInfo(tempDir + "MeshBenchmark.obj").deleteFile();
+    if (ret == 0 && regression)
+        ret = 2;
+    return ret;
+}
@@ -23,6 +23,7 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <memory>
 # include <QDockWidget>
 # include <QMessageBox>
 #endif
@@ -435,45 +436,7 @@ void DlgEvaluateMeshImp::on_checkOrientationButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeOrientationButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeOrientationButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalOrientation eval(rMesh);
-        std::vector<unsigned long> inds = eval.GetIndices();
-#if 0
-        if (inds.empty() && !eval.Evaluate()) {
-            d->ui.checkOrientationButton->setText(tr("Flipped normals found"));
-            MeshEvalFoldOversOnSurface f_eval(rMesh);
-            if (!f_eval.Evaluate()) {
-                qApp->restoreOverrideCursor();
-                QMessageBox::warning(this, tr("Orientation"),
-                    tr("Check failed due to folds on the surface.\n"
-                    "Please run the command to repair folds first"));
-                qApp->setOverrideCursor(Qt::WaitCursor);
-            }
-        }
-        else
-#endif
-        if (inds.empty()) {
-            d->ui.checkOrientationButton->setText( tr("No flipped normals") );
-            d->ui.checkOrientationButton->setChecked(false);
-            d->ui.repairOrientationButton->setEnabled(false);
-            removeViewProvider( "MeshGui::ViewProviderMeshOrientation" );
-        }
-        else {
-            d->ui.checkOrientationButton->setText( tr("%1 flipped normals").arg(inds.size()) );
-            d->ui.checkOrientationButton->setChecked(true);
-            d->ui.repairOrientationButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            addViewProvider( "MeshGui::ViewProviderMeshOrientation", eval.GetIndices());
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeOrientationButton->setEnabled(true);
-    }
+    analyzeMesh(MeshEvalHealth::Orientation);
 }
 
 void DlgEvaluateMeshImp::on_repairOrientationButton_clicked()
@@ -525,58 +488,10 @@ void DlgEvaluateMeshImp::on_checkNonmanifoldsButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeNonmanifoldsButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeNonmanifoldsButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalTopology f_eval(rMesh);
-        bool ok1 = f_eval.Evaluate();
-        bool ok2 = true;
-        std::vector<unsigned long> point_indices;
-
-        if (d->checkNonManfoldPoints) {
-            MeshEvalPointManifolds p_eval(rMesh);
-            ok2 = p_eval.Evaluate();
-            if (!ok2)
-                point_indices = p_eval.GetIndices();
-        }
-
-        if (ok1 && ok2) {
-            d->ui.checkNonmanifoldsButton->setText(tr("No non-manifolds"));
-            d->ui.checkNonmanifoldsButton->setChecked(false);
-            d->ui.repairNonmanifoldsButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshNonManifolds");
-            removeViewProvider("MeshGui::ViewProviderMeshNonManifoldPoints");
-        }
-        else {
-            d->ui.checkNonmanifoldsButton->setText(tr("%1 non-manifolds").arg(f_eval.CountManifolds()+point_indices.size()));
-            d->ui.checkNonmanifoldsButton->setChecked(true);
-            d->ui.repairNonmanifoldsButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-
-            if (!ok1) {
-                const std::vector<std::pair<unsigned long, unsigned long> >& inds = f_eval.GetIndices();
-                std::vector<unsigned long> indices;
-                indices.reserve(2*inds.size());
-                std::vector<std::pair<unsigned long, unsigned long> >::const_iterator it;
-                for (it = inds.begin(); it != inds.end(); ++it) {
-                    indices.push_back(it->first);
-                    indices.push_back(it->second);
-                }
-
-                addViewProvider("MeshGui::ViewProviderMeshNonManifolds", indices);
-            }
-
-            if (!ok2) {
-                addViewProvider("MeshGui::ViewProviderMeshNonManifoldPoints", point_indices);
-            }
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeNonmanifoldsButton->setEnabled(true);
-    }
+    int checks = MeshEvalHealth::NonManifolds;
+    if (d->checkNonManfoldPoints)
+        checks |= MeshEvalHealth::NonManifoldPoints;
+    analyzeMesh(checks);
 }
 
 void DlgEvaluateMeshImp::on_repairNonmanifoldsButton_clicked()
@@ -627,55 +542,7 @@ void DlgEvaluateMeshImp::on_checkIndicesButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeIndicesButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeIndicesButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalRangeFacet rf(rMesh);
-        MeshEvalRangePoint rp(rMesh);
-        MeshEvalCorruptedFacets cf(rMesh);
-        MeshEvalNeighbourhood nb(rMesh);
-        
-        if (!rf.Evaluate()) {
-            d->ui.checkIndicesButton->setText(tr("Invalid face indices"));
-            d->ui.checkIndicesButton->setChecked(true);
-            d->ui.repairIndicesButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshIndices", rf.GetIndices());
-        }
-        else if (!rp.Evaluate()) {
-            d->ui.checkIndicesButton->setText(tr("Invalid point indices"));
-            d->ui.checkIndicesButton->setChecked(true);
-            d->ui.repairIndicesButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            //addViewProvider("MeshGui::ViewProviderMeshIndices", rp.GetIndices());
-        }
-        else if (!cf.Evaluate()) {
-            d->ui.checkIndicesButton->setText(tr("Multiple point indices"));
-            d->ui.checkIndicesButton->setChecked(true);
-            d->ui.repairIndicesButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshIndices", cf.GetIndices());
-        }
-        else if (!nb.Evaluate()) {
-            d->ui.checkIndicesButton->setText(tr("Invalid neighbour indices"));
-            d->ui.checkIndicesButton->setChecked(true);
-            d->ui.repairIndicesButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshIndices", nb.GetIndices());
-        }
-        else {
-            d->ui.checkIndicesButton->setText(tr("No invalid indices"));
-            d->ui.checkIndicesButton->setChecked(false);
-            d->ui.repairIndicesButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshIndices");
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeIndicesButton->setEnabled(true);
-    }
+    analyzeMesh(MeshEvalHealth::Indices);
 }
 
 void DlgEvaluateMeshImp::on_repairIndicesButton_clicked()
@@ -716,32 +583,7 @@ void DlgEvaluateMeshImp::on_checkDegenerationButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeDegeneratedButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeDegeneratedButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalDegeneratedFacets eval(rMesh, d->epsilonDegenerated);
-        std::vector<unsigned long> degen = eval.GetIndices();
-        
-        if (degen.empty()) {
-            d->ui.checkDegenerationButton->setText(tr("No degenerations"));
-            d->ui.checkDegenerationButton->setChecked(false);
-            d->ui.repairDegeneratedButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshDegenerations");
-        }
-        else {
-            d->ui.checkDegenerationButton->setText(tr("%1 degenerated faces").arg(degen.size()));
-            d->ui.checkDegenerationButton->setChecked(true);
-            d->ui.repairDegeneratedButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshDegenerations", degen);
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeDegeneratedButton->setEnabled(true);
-    }
+    analyzeMesh(MeshEvalHealth::Degenerations);
 }
 
 void DlgEvaluateMeshImp::on_repairDegeneratedButton_clicked()
@@ -782,33 +624,7 @@ void DlgEvaluateMeshImp::on_checkDuplicatedFacesButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeDuplicatedFacesButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeDuplicatedFacesButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalDuplicateFacets eval(rMesh);
-        std::vector<unsigned long> dupl = eval.GetIndices();
-    
-        if (dupl.empty()) {
-            d->ui.checkDuplicatedFacesButton->setText(tr("No duplicated faces"));
-            d->ui.checkDuplicatedFacesButton->setChecked(false);
-            d->ui.repairDuplicatedFacesButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces");
-        }
-        else {
-            d->ui.checkDuplicatedFacesButton->setText(tr("%1 duplicated faces").arg(dupl.size()));
-            d->ui.checkDuplicatedFacesButton->setChecked(true);
-            d->ui.repairDuplicatedFacesButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-
-            addViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces", dupl);
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeDuplicatedFacesButton->setEnabled(true);
-    }
+    analyzeMesh(MeshEvalHealth::DuplicatedFacets);
 }
 
 void DlgEvaluateMeshImp::on_repairDuplicatedFacesButton_clicked()
@@ -849,31 +665,7 @@ void DlgEvaluateMeshImp::on_checkDuplicatedPointsButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeDuplicatedPointsButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeDuplicatedPointsButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalDuplicatePoints eval(rMesh);
-    
-        if (eval.Evaluate()) {
-            d->ui.checkDuplicatedPointsButton->setText(tr("No duplicated points"));
-            d->ui.checkDuplicatedPointsButton->setChecked(false);
-            d->ui.repairDuplicatedPointsButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints");
-        }
-        else {
-            d->ui.checkDuplicatedPointsButton->setText(tr("Duplicated points"));
-            d->ui.checkDuplicatedPointsButton->setChecked(true);
-            d->ui.repairDuplicatedPointsButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints", eval.GetIndices());
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeDuplicatedPointsButton->setEnabled(true);
-    }
+    analyzeMesh(MeshEvalHealth::DuplicatedPoints);
 }
 
 void DlgEvaluateMeshImp::on_repairDuplicatedPointsButton_clicked()
@@ -914,48 +706,7 @@ void DlgEvaluateMeshImp::on_checkSelfIntersectionButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeSelfIntersectionButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeSelfIntersectionButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalSelfIntersection eval(rMesh);
-        std::vector<std::pair<unsigned long, unsigned long> > intersection;
-        try {
-            eval.GetIntersections(intersection);
-        }
-        catch (const Base::AbortException&) {
-            Base::Console().Message("The self-intersection analyse was aborted by the user\n");
-        }
-
-        if (intersection.empty()) {
-            d->ui.checkSelfIntersectionButton->setText(tr("No self-intersections"));
-            d->ui.checkSelfIntersectionButton->setChecked(false);
-            d->ui.repairSelfIntersectionButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshSelfIntersections");
-        }
-        else {
-            d->ui.checkSelfIntersectionButton->setText(tr("Self-intersections"));
-            d->ui.checkSelfIntersectionButton->setChecked(true);
-            d->ui.repairSelfIntersectionButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-
-            std::vector<unsigned long> indices;
-            indices.reserve(2*intersection.size());
-            std::vector<std::pair<unsigned long, unsigned long> >::iterator it;
-            for (it = intersection.begin(); it != intersection.end(); ++it) {
-                indices.push_back(it->first);
-                indices.push_back(it->second);
-            }
-
-            addViewProvider("MeshGui::ViewProviderMeshSelfIntersections", indices);
-            d->self_intersections.swap(indices);
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeSelfIntersectionButton->setEnabled(true);
-    }
+    analyzeMesh(MeshEvalHealth::SelfIntersections);
 }
 
 void DlgEvaluateMeshImp::on_repairSelfIntersectionButton_clicked()
@@ -1004,46 +755,7 @@ void DlgEvaluateMeshImp::on_checkFoldsButton_clicked()
 
 void DlgEvaluateMeshImp::on_analyzeFoldsButton_clicked()
 {
-    if (d->meshFeature) {
-        d->ui.analyzeFoldsButton->setEnabled(false);
-        qApp->processEvents();
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
-        MeshEvalFoldsOnSurface s_eval(rMesh);
-        MeshEvalFoldsOnBoundary b_eval(rMesh);
-        MeshEvalFoldOversOnSurface f_eval(rMesh);
-        bool ok1 = s_eval.Evaluate();
-        bool ok2 = b_eval.Evaluate();
-        bool ok3 = f_eval.Evaluate();
-    
-        if (ok1 && ok2 && ok3) {
-            d->ui.checkFoldsButton->setText(tr("No folds on surface"));
-            d->ui.checkFoldsButton->setChecked(false);
-            d->ui.repairFoldsButton->setEnabled(false);
-            removeViewProvider("MeshGui::ViewProviderMeshFolds");
-        }
-        else {
-            std::vector<unsigned long> inds  = f_eval.GetIndices();
-            std::vector<unsigned long> inds1 = s_eval.GetIndices();
-            std::vector<unsigned long> inds2 = b_eval.GetIndices();
-            inds.insert(inds.end(), inds1.begin(), inds1.end());
-            inds.insert(inds.end(), inds2.begin(), inds2.end());
-
-            // remove duplicates
-            std::sort(inds.begin(), inds.end());
-            inds.erase(std::unique(inds.begin(), inds.end()), inds.end());
-            
-            d->ui.checkFoldsButton->setText(tr("%1 folds on surface").arg(inds.size()));
-            d->ui.checkFoldsButton->setChecked(true);
-            d->ui.repairFoldsButton->setEnabled(true);
-            d->ui.repairAllTogether->setEnabled(true);
-            addViewProvider("MeshGui::ViewProviderMeshFolds", inds);
-        }
-
-        qApp->restoreOverrideCursor();
-        d->ui.analyzeFoldsButton->setEnabled(true);
-    }
+    analyzeMesh(MeshEvalHealth::Folds);
 }
 
 void DlgEvaluateMeshImp::on_repairFoldsButton_clicked()
@@ -1073,17 +785,231 @@ void DlgEvaluateMeshImp::on_repairFoldsButton_clicked()
     }
 }
 
+void DlgEvaluateMeshImp::analyzeMesh(int checks)
+{
+    if (!d->meshFeature)
+        return;
+
+    QList<QAbstractButton*> buttons;
+    if (checks & MeshEvalHealth::Orientation)
+        buttons << d->ui.analyzeOrientationButton;
+    if (checks & (MeshEvalHealth::NonManifolds | MeshEvalHealth::NonManifoldPoints))
+        buttons << d->ui.analyzeNonmanifoldsButton;
+    if (checks & MeshEvalHealth::Indices)
+        buttons << d->ui.analyzeIndicesButton;
+    if (checks & MeshEvalHealth::Degenerations)
+        buttons << d->ui.analyzeDegeneratedButton;
+    if (checks & MeshEvalHealth::DuplicatedFacets)
+        buttons << d->ui.analyzeDuplicatedFacesButton;
+    if (checks & MeshEvalHealth::DuplicatedPoints)
+        buttons << d->ui.analyzeDuplicatedPointsButton;
+    if (checks & MeshEvalHealth::SelfIntersections)
+        buttons << d->ui.analyzeSelfIntersectionButton;
+    if (checks & MeshEvalHealth::Folds)
+        buttons << d->ui.analyzeFoldsButton;
+
+    for (QList<QAbstractButton*>::iterator it = buttons.begin(); it != buttons.end(); ++it)
+        (*it)->setEnabled(false);
+    qApp->processEvents();
+    qApp->setOverrideCursor(Qt::WaitCursor);
+
+    // all checks share the same edge list and grid and run in parallel
+    const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
+    MeshEvalHealth eval(rMesh, checks, d->epsilonDegenerated);
+    try {
+        eval.Evaluate();
+    }
+    catch (const Base::AbortException&) {
+        Base::Console().Message("The mesh analyse was aborted by the user\n");
+        qApp->restoreOverrideCursor();
+        for (QList<QAbstractButton*>::iterator it = buttons.begin(); it != buttons.end(); ++it)
+            (*it)->setEnabled(true);
+        return;
+    }
+
+    if (checks & MeshEvalHealth::Orientation) {
+        const std::vector<unsigned long>& inds = eval.GetIndices(MeshEvalHealth::Orientation);
+        if (inds.empty()) {
+            d->ui.checkOrientationButton->setText( tr("No flipped normals") );
+            d->ui.checkOrientationButton->setChecked(false);
+            d->ui.repairOrientationButton->setEnabled(false);
+            removeViewProvider( "MeshGui::ViewProviderMeshOrientation" );
+        }
+        else {
+            d->ui.checkOrientationButton->setText( tr("%1 flipped normals").arg(inds.size()) );
+            d->ui.checkOrientationButton->setChecked(true);
+            d->ui.repairOrientationButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider( "MeshGui::ViewProviderMeshOrientation", inds);
+        }
+    }
+
+    if (checks & (MeshEvalHealth::NonManifolds | MeshEvalHealth::NonManifoldPoints)) {
+        const std::vector<unsigned long>& indices = eval.GetIndices(MeshEvalHealth::NonManifolds);
+        const std::vector<unsigned long>& point_indices = eval.GetIndices(MeshEvalHealth::NonManifoldPoints);
+
+        if (indices.empty() && point_indices.empty()) {
+            d->ui.checkNonmanifoldsButton->setText(tr("No non-manifolds"));
+            d->ui.checkNonmanifoldsButton->setChecked(false);
+            d->ui.repairNonmanifoldsButton->setEnabled(false);
+            removeViewProvider("MeshGui::ViewProviderMeshNonManifolds");
+            removeViewProvider("MeshGui::ViewProviderMeshNonManifoldPoints");
+        }
+        else {
+            d->ui.checkNonmanifoldsButton->setText(tr("%1 non-manifolds").arg(eval.CountNonManifolds()+point_indices.size()));
+            d->ui.checkNonmanifoldsButton->setChecked(true);
+            d->ui.repairNonmanifoldsButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+
+            if (!indices.empty()) {
+                addViewProvider("MeshGui::ViewProviderMeshNonManifolds", indices);
+            }
+
+            if (!point_indices.empty()) {
+                addViewProvider("MeshGui::ViewProviderMeshNonManifoldPoints", point_indices);
+            }
+        }
+    }
+
+    if (checks & MeshEvalHealth::Indices) {
+        const std::vector<unsigned long>& inds = eval.GetIndices(MeshEvalHealth::Indices);
+        switch (eval.GetIndexDefect()) {
+        case MeshEvalHealth::InvalidFacetIndices:
+            d->ui.checkIndicesButton->setText(tr("Invalid face indices"));
+            d->ui.checkIndicesButton->setChecked(true);
+            d->ui.repairIndicesButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshIndices", inds);
+            break;
+        case MeshEvalHealth::InvalidPointIndices:
+            d->ui.checkIndicesButton->setText(tr("Invalid point indices"));
+            d->ui.checkIndicesButton->setChecked(true);
+            d->ui.repairIndicesButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            //addViewProvider("MeshGui::ViewProviderMeshIndices", inds);
+            break;
+        case MeshEvalHealth::CorruptedFacets:
+            d->ui.checkIndicesButton->setText(tr("Multiple point indices"));
+            d->ui.checkIndicesButton->setChecked(true);
+            d->ui.repairIndicesButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshIndices", inds);
+            break;
+        case MeshEvalHealth::InvalidNeighbourIndices:
+            d->ui.checkIndicesButton->setText(tr("Invalid neighbour indices"));
+            d->ui.checkIndicesButton->setChecked(true);
+            d->ui.repairIndicesButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshIndices", inds);
+            break;
+        default:
+            d->ui.checkIndicesButton->setText(tr("No invalid indices"));
+            d->ui.checkIndicesButton->setChecked(false);
+            d->ui.repairIndicesButton->setEnabled(false);
+            removeViewProvider("MeshGui::ViewProviderMeshIndices");
+            break;
+        }
+    }
+
+    if (checks & MeshEvalHealth::Degenerations) {
+        const std::vector<unsigned long>& degen = eval.GetIndices(MeshEvalHealth::Degenerations);
+        if (degen.empty()) {
+            d->ui.checkDegenerationButton->setText(tr("No degenerations"));
+            d->ui.checkDegenerationButton->setChecked(false);
+            d->ui.repairDegeneratedButton->setEnabled(false);
+            removeViewProvider("MeshGui::ViewProviderMeshDegenerations");
+        }
+        else {
+            d->ui.checkDegenerationButton->setText(tr("%1 degenerated faces").arg(degen.size()));
+            d->ui.checkDegenerationButton->setChecked(true);
+            d->ui.repairDegeneratedButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshDegenerations", degen);
+        }
+    }
+
+    if (checks & MeshEvalHealth::DuplicatedFacets) {
+        const std::vector<unsigned long>& dupl = eval.GetIndices(MeshEvalHealth::DuplicatedFacets);
+        if (dupl.empty()) {
+            d->ui.checkDuplicatedFacesButton->setText(tr("No duplicated faces"));
+            d->ui.checkDuplicatedFacesButton->setChecked(false);
+            d->ui.repairDuplicatedFacesButton->setEnabled(false);
+            removeViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces");
+        }
+        else {
+            d->ui.checkDuplicatedFacesButton->setText(tr("%1 duplicated faces").arg(dupl.size()));
+            d->ui.checkDuplicatedFacesButton->setChecked(true);
+            d->ui.repairDuplicatedFacesButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshDuplicatedFaces", dupl);
+        }
+    }
+
+    if (checks & MeshEvalHealth::DuplicatedPoints) {
+        const std::vector<unsigned long>& dupl = eval.GetIndices(MeshEvalHealth::DuplicatedPoints);
+        if (dupl.empty()) {
+            d->ui.checkDuplicatedPointsButton->setText(tr("No duplicated points"));
+            d->ui.checkDuplicatedPointsButton->setChecked(false);
+            d->ui.repairDuplicatedPointsButton->setEnabled(false);
+            removeViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints");
+        }
+        else {
+            d->ui.checkDuplicatedPointsButton->setText(tr("Duplicated points"));
+            d->ui.checkDuplicatedPointsButton->setChecked(true);
+            d->ui.repairDuplicatedPointsButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshDuplicatedPoints", dupl);
+        }
+    }
+
+    if (checks & MeshEvalHealth::SelfIntersections) {
+        std::vector<unsigned long> indices = eval.GetIndices(MeshEvalHealth::SelfIntersections);
+        if (indices.empty()) {
+            d->ui.checkSelfIntersectionButton->setText(tr("No self-intersections"));
+            d->ui.checkSelfIntersectionButton->setChecked(false);
+            d->ui.repairSelfIntersectionButton->setEnabled(false);
+            removeViewProvider("MeshGui::ViewProviderMeshSelfIntersections");
+        }
+        else {
+            d->ui.checkSelfIntersectionButton->setText(tr("Self-intersections"));
+            d->ui.checkSelfIntersectionButton->setChecked(true);
+            d->ui.repairSelfIntersectionButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshSelfIntersections", indices);
+        }
+        d->self_intersections.swap(indices);
+    }
+
+    if (checks & MeshEvalHealth::Folds) {
+        const std::vector<unsigned long>& inds = eval.GetIndices(MeshEvalHealth::Folds);
+        if (inds.empty()) {
+            d->ui.checkFoldsButton->setText(tr("No folds on surface"));
+            d->ui.checkFoldsButton->setChecked(false);
+            d->ui.repairFoldsButton->setEnabled(false);
+            removeViewProvider("MeshGui::ViewProviderMeshFolds");
+        }
+        else {
+            d->ui.checkFoldsButton->setText(tr("%1 folds on surface").arg(inds.size()));
+            d->ui.checkFoldsButton->setChecked(true);
+            d->ui.repairFoldsButton->setEnabled(true);
+            d->ui.repairAllTogether->setEnabled(true);
+            addViewProvider("MeshGui::ViewProviderMeshFolds", inds);
+        }
+    }
+
+    qApp->restoreOverrideCursor();
+    for (QList<QAbstractButton*>::iterator it = buttons.begin(); it != buttons.end(); ++it)
+        (*it)->setEnabled(true);
+}
+
 void DlgEvaluateMeshImp::on_analyzeAllTogether_clicked()
 {
-    on_analyzeOrientationButton_clicked();
-    on_analyzeDuplicatedFacesButton_clicked();
-    on_analyzeDuplicatedPointsButton_clicked();
-    on_analyzeNonmanifoldsButton_clicked();
-    on_analyzeDegeneratedButton_clicked();
-    on_analyzeIndicesButton_clicked();
-    on_analyzeSelfIntersectionButton_clicked();
-    if (d->enableFoldsCheck)
-        on_analyzeFoldsButton_clicked();
+    int checks = MeshEvalHealth::AllChecks;
+    if (!d->checkNonManfoldPoints)
+        checks &= ~MeshEvalHealth::NonManifoldPoints;
+    if (!d->enableFoldsCheck)
+        checks &= ~MeshEvalHealth::Folds;
+    analyzeMesh(checks);
 }
 
 void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
@@ -1098,95 +1024,90 @@ void DlgEvaluateMeshImp::on_repairAllTogether_clicked()
         bool run = false;
         bool self = true;
         int max_iter=10;
-        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
+        const int steps[] = {
+            MeshEvalHealth::SelfIntersections, MeshEvalHealth::Folds,
+            MeshEvalHealth::Orientation, MeshEvalHealth::NonManifolds,
+            MeshEvalHealth::Indices, MeshEvalHealth::Degenerations,
+            MeshEvalHealth::DuplicatedFacets, MeshEvalHealth::DuplicatedPoints
+        };
         try {
             do {
                 run = false;
-                {
-                    MeshEvalSelfIntersection eval(rMesh);
-                    if (self && !eval.Evaluate()) {
+                int pending = MeshEvalHealth::AllChecks & ~MeshEvalHealth::NonManifoldPoints;
+                if (!self)
+                    pending &= ~MeshEvalHealth::SelfIntersections;
+                if (!d->enableFoldsCheck)
+                    pending &= ~MeshEvalHealth::Folds;
+
+                // All pending checks are evaluated together. Only after a repair
+                // has changed the mesh the remaining checks are evaluated again.
+                std::unique_ptr<MeshEvalHealth> eval;
+                bool modified = true;
+                for (std::size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+                    MeshEvalHealth::Check check = static_cast<MeshEvalHealth::Check>(steps[i]);
+                    if (!(pending & check))
+                        continue;
+                    if (modified) {
+                        const MeshKernel& rMesh = d->meshFeature->Mesh.getValue().getKernel();
+                        eval.reset(new MeshEvalHealth(rMesh, pending, d->epsilonDegenerated));
+                        eval->Evaluate();
+                        modified = false;
+                    }
+                    pending &= ~check;
+
+                    if (!eval->HasDefect(check)) {
+                        if (check == MeshEvalHealth::SelfIntersections)
+                            self = false; // once no self-intersections found do not repeat it later on
+                        continue;
+                    }
+
+                    switch (check) {
+                    case MeshEvalHealth::SelfIntersections:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").fixSelfIntersections()",
                             docName, objName);
-                        run = true;
-                    }
-                    else {
-                        self = false; // once no self-intersections found do not repeat it later on
-                    }
-                    qApp->processEvents();
-                }
-                if (d->enableFoldsCheck) {
-                    MeshEvalFoldsOnSurface s_eval(rMesh);
-                    MeshEvalFoldsOnBoundary b_eval(rMesh);
-                    MeshEvalFoldOversOnSurface f_eval(rMesh);
-                    if (!s_eval.Evaluate() || !b_eval.Evaluate() || !f_eval.Evaluate()) {
+                        break;
+                    case MeshEvalHealth::Folds:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeFoldsOnSurface()",
                             docName, objName);
-                        run = true;
-                    }
-                    qApp->processEvents();
-                }
-                {
-                    MeshEvalOrientation eval(rMesh);
-                    if (!eval.Evaluate()) {
+                        break;
+                    case MeshEvalHealth::Orientation:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").harmonizeNormals()",
                             docName, objName);
-                        run = true;
-                    }
-                    qApp->processEvents();
-                }
-                {
-                    MeshEvalTopology eval(rMesh);
-                    if (!eval.Evaluate()) {
+                        break;
+                    case MeshEvalHealth::NonManifolds:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeNonManifolds()",
                             docName, objName);
-                        run = true;
-                    }
-                    qApp->processEvents();
-                }
-                {
-                    MeshEvalRangeFacet rf(rMesh);
-                    MeshEvalRangePoint rp(rMesh);
-                    MeshEvalCorruptedFacets cf(rMesh);
-                    MeshEvalNeighbourhood nb(rMesh);
-                    if (!rf.Evaluate() || !rp.Evaluate() || !cf.Evaluate() || !nb.Evaluate()) {
+                        break;
+                    case MeshEvalHealth::Indices:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").fixIndices()",
                             docName, objName);
-                        run = true;
-                    }
-                }
-                {
-                    MeshEvalDegeneratedFacets eval(rMesh, d->epsilonDegenerated);
-                    if (!eval.Evaluate()) {
+                        break;
+                    case MeshEvalHealth::Degenerations:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").fixDegenerations(%f)",
                             docName, objName, d->epsilonDegenerated);
-                        run = true;
-                    }
-                    qApp->processEvents();
-                }
-                {
-                    MeshEvalDuplicateFacets eval(rMesh);
-                    if (!eval.Evaluate()) {
+                        break;
+                    case MeshEvalHealth::DuplicatedFacets:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeDuplicatedFacets()",
                             docName, objName);
-                        run = true;
-                    }
-                    qApp->processEvents();
-                }
-                {
-                    MeshEvalDuplicatePoints eval(rMesh);
-                    if (!eval.Evaluate()) {
+                        break;
+                    case MeshEvalHealth::DuplicatedPoints:
                         Gui::Command::doCommand(Gui::Command::App,
                             "App.getDocument(\"%s\").getObject(\"%s\").removeDuplicatedPoints()",
                             docName, objName);
-                        run = true;
+                        break;
+                    default:
+                        break;
                     }
+
+                    run = true;
+                    modified = true;
                     qApp->processEvents();
                 }
             } while(d->ui.checkRepeatButton->isChecked() && run && (--max_iter > 0));
@@ -126,6 +126,7 @@ protected:
     void refreshList();
     void showInformation();
     void cleanInformation();
+    void analyzeMesh(int checks);
     void addViewProvider(const char* vp, const std::vector<unsigned long>& indices);
     void removeViewProvider(const char* vp);
     void removeViewProviders();
@@ -36,6 +36,7 @@
 #include <Mod/Mesh/App/Core/MeshKernel.h>
 #include <Mod/Mesh/App/Core/Iterator.h>
 #include <Mod/Mesh/App/Core/Algorithm.h>
+#include <Mod/Mesh/App/Core/BVH.h>
 #include <Mod/Mesh/App/Mesh.h>
 
 #include <Base/Exception.h>
@@ -81,16 +82,24 @@ void CurveProjector::writeIntersectionPointsToFile(const char *name)
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
 CurveProjectorShape::CurveProjectorShape(const TopoDS_Shape &aShape, const MeshKernel &pMesh)
-: CurveProjector(aShape,pMesh)
+: CurveProjector(aShape,pMesh), _pBVH(0)
 {
   Do();
 }
 
+CurveProjectorShape::~CurveProjectorShape()
+{
+  delete _pBVH;
+}
+
 void CurveProjectorShape::Do(void)
 {
   TopExp_Explorer Ex;
   TopoDS_Shape Edge;
 
+  if (!_pBVH)
+    _pBVH = new MeshCore::MeshFacetBVH(_Mesh);
+
   for (Ex.Init(_Shape, TopAbs_EDGE); Ex.More(); Ex.Next())
   {
 	  const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
@@ -218,6 +227,23 @@ bool CurveProjectorShape::findStartPoint(const MeshKernel &MeshK,const Base::Vec
   float MinLength = FLOAT_MAX;
   bool bHit = false;
 
+  // If the point projects into the nearest facet it is the searched facet
+  // because no other facet can have a shorter distance along its normal
+  if (_pBVH && &MeshK == &_Mesh)
+  {
+    Base::Vector3f Nearest;
+    unsigned long Index;
+    if (_pBVH->NearestFacetToPoint(Pnt, Nearest, Index))
+    {
+      MeshGeomFacet Facet = MeshK.GetFacet(Index);
+      if (Facet.Foraminate(Pnt, Facet.GetNormal(), Rslt))
+      {
+        FaceIndex = Index;
+        return true;
+      }
+    }
+  }
+
   // go through the whole Mesh
   MeshFacetIterator It(MeshK);
   for(It.Init();It.More();It.Next())
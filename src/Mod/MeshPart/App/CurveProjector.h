@@ -43,6 +43,7 @@ namespace MeshCore
 {
 class MeshKernel;
 class MeshGeomFacet;
+class MeshFacetBVH;
 };
 
 using MeshCore::MeshKernel;
@@ -94,7 +95,7 @@ class MeshPartExport CurveProjectorShape: public CurveProjector
 {
 public:
   CurveProjectorShape(const TopoDS_Shape &aShape, const MeshKernel &pMesh);
-  virtual ~CurveProjectorShape() {}
+  virtual ~CurveProjectorShape();
 
   void projectCurve(const TopoDS_Edge& aEdge,
                     std::vector<FaceSplitEdge> &vSplitEdges);
@@ -105,6 +106,10 @@ public:
 
 protected:
   virtual void Do();
+
+private:
+  // bounding volume hierarchy of _Mesh to find the start points
+  MeshCore::MeshFacetBVH* _pBVH;
 };
 
 
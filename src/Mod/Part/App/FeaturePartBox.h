@@ -47,6 +47,10 @@ public:
     /// recalculate the Feature
     App::DocumentObjectExecReturn *execute(void);
     short mustExecute() const;
+    /// only builds a new shape from its own properties
+    bool isExecuteThreadSafe(void) const {
+        return true;
+    }
     /// returns the type name of the ViewProvider
     const char* getViewProviderName(void) const {
         return "PartGui::ViewProviderBox";
@@ -48,6 +48,8 @@
 #include <OSD_OpenFile.hxx>
 #endif
 
+#include <boost/functional/hash.hpp>
+
 #include <Base/Console.h>
 #include <Base/Writer.h>
 #include <Base/Reader.h>
@@ -73,17 +75,29 @@ using namespace Part;
 
 TYPESYSTEM_SOURCE(Part::PropertyPartShape , App::PropertyComplexGeoData);
 
-PropertyPartShape::PropertyPartShape()
+PropertyPartShape::PropertyPartShape() : _hash(0)
 {
 }
 
 PropertyPartShape::~PropertyPartShape()
 {
+    if (_deferredFile)
+        _deferredFile->cancel();
+}
+
+void PropertyPartShape::restoreDeferred() const
+{
+    if (_deferredFile && _deferredFile->isPending())
+        _deferredFile->restore();
 }
 
 void PropertyPartShape::setValue(const TopoShape& sh)
 {
     aboutToSetValue();
+    if (_deferredFile) {
+        _deferredFile->cancel();
+        _deferredFile.reset();
+    }
     _Shape = sh;
     hasSetValue();
 }
@@ -91,27 +105,35 @@ void PropertyPartShape::setValue(const TopoShape& sh)
 void PropertyPartShape::setValue(const TopoDS_Shape& sh)
 {
     aboutToSetValue();
+    if (_deferredFile) {
+        _deferredFile->cancel();
+        _deferredFile.reset();
+    }
     _Shape.setShape(sh);
     hasSetValue();
 }
 
 const TopoDS_Shape& PropertyPartShape::getValue(void)const 
 {
+    restoreDeferred();
     return _Shape.getShape();
 }
 
 const TopoShape& PropertyPartShape::getShape() const
 {
+    restoreDeferred();
     return this->_Shape;
 }
 
 const Data::ComplexGeoData* PropertyPartShape::getComplexData() const
 {
+    restoreDeferred();
     return &(this->_Shape);
 }
 
 Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 {
+    restoreDeferred();
     Base::BoundBox3d box;
     if (_Shape.getShape().IsNull())
         return box;
@@ -138,6 +160,7 @@ Base::BoundBox3d PropertyPartShape::getBoundingBox() const
 
 void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 {
+    restoreDeferred();
     aboutToSetValue();
     _Shape.transformGeometry(rclTrf);
     hasSetValue();
@@ -145,6 +168,7 @@ void PropertyPartShape::transformGeometry(const Base::Matrix4D &rclTrf)
 
 PyObject *PropertyPartShape::getPyObject(void)
 {
+    restoreDeferred();
     Base::PyObjectBase* prop;
     const TopoDS_Shape& sh = _Shape.getShape();
     if (sh.IsNull()) {
@@ -204,8 +228,11 @@ void PropertyPartShape::setPyObject(PyObject *value)
 
 App::Property *PropertyPartShape::Copy(void) const
 {
+    restoreDeferred();
     PropertyPartShape *prop = new PropertyPartShape();
     prop->_Shape = this->_Shape;
+    // Note: Copy the geometry, several algorithms (e.g. fix(), sewShape())
+    // modify the referenced TShape in place which must not affect the copy
     if (!_Shape.getShape().IsNull()) {
         BRepBuilderAPI_Copy copy(_Shape.getShape());
         prop->_Shape.setShape(copy.Shape());
@@ -216,8 +243,13 @@ App::Property *PropertyPartShape::Copy(void) const
 
 void PropertyPartShape::Paste(const App::Property &from)
 {
+    const TopoShape& shape = dynamic_cast<const PropertyPartShape&>(from).getShape();
     aboutToSetValue();
-    _Shape = dynamic_cast<const PropertyPartShape&>(from)._Shape;
+    if (_deferredFile) {
+        _deferredFile->cancel();
+        _deferredFile.reset();
+    }
+    _Shape = shape;
     hasSetValue();
 }
 
@@ -226,6 +258,44 @@ unsigned int PropertyPartShape::getMemSize (void) const
     return _Shape.getMemSize();
 }
 
+bool PropertyPartShape::getValueHash(std::size_t& hash) const
+{
+    // The hash of a TopoDS_Shape only depends on the address of its TShape
+    // which differs for every recompute. A fingerprint of only some properties
+    // may miss a change of the geometry and then dependent objects wouldn't be
+    // recomputed. So, the hash is computed from the complete BRep data.
+    hash = 0;
+    const TopoDS_Shape& shape = getValue();
+    if (shape.IsNull())
+        return true;
+
+    // Serializing the shape is expensive. The hash is kept as long as the
+    // property holds the same TShape with the same location and orientation.
+    // The cached shape keeps a reference to the TShape so that its address
+    // can't be reused by another shape.
+    if (!_hashedShape.IsNull() && _hashedShape.IsEqual(shape)) {
+        hash = _hash;
+        return true;
+    }
+
+    try {
+        std::ostringstream str;
+        str.precision(17);
+        BRepTools::Write(shape, str);
+        std::string data = str.str();
+        boost::hash_combine(hash, static_cast<int>(shape.Orientation()));
+        boost::hash_range(hash, data.begin(), data.end());
+    }
+    catch (Standard_Failure&) {
+        _hashedShape.Nullify();
+        return false;
+    }
+
+    _hashedShape = shape;
+    _hash = hash;
+    return true;
+}
+
 void PropertyPartShape::getPaths(std::vector<App::ObjectIdentifier> &paths) const
 {
     paths.push_back(App::ObjectIdentifier(getContainer()) << App::ObjectIdentifier::Component::SimpleComponent(getName())
@@ -316,6 +386,7 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
 {
     // If the shape is empty we simply store nothing. The file size will be 0 which
     // can be checked when reading in the data.
+    restoreDeferred();
     if (_Shape.getShape().IsNull())
         return;
     TopoDS_Shape myShape = _Shape.getShape();
@@ -381,6 +452,26 @@ void PropertyPartShape::SaveDocFile (Base::Writer &writer) const
     }
 }
 
+bool PropertyPartShape::isSaveDocFileThreadSafe() const
+{
+    // all threads would share the same temporary file
+    return App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("DirectAccess", true);
+}
+
+bool PropertyPartShape::deferRestoreDocFile(const std::shared_ptr<Base::DeferredFile>& file)
+{
+    _deferredFile = file;
+    file->setHandler([this](Base::Reader& reader) {
+        // Read the shape into a property without container because the
+        // value has already been set when the document was restored.
+        PropertyPartShape prop;
+        prop.RestoreDocFile(reader);
+        _Shape = prop._Shape;
+    });
+    return true;
+}
+
 void PropertyPartShape::RestoreDocFile(Base::Reader &reader)
 {
     Base::FileInfo brep(reader.getFileName());
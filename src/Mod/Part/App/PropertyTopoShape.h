@@ -29,8 +29,13 @@
 #include <App/DocumentObject.h>
 #include <App/PropertyGeo.h>
 #include <map>
+#include <memory>
 #include <vector>
 
+namespace Base {
+class DeferredFile;
+}
+
 namespace Part
 {
 
@@ -81,18 +86,33 @@ public:
     void Restore(Base::XMLReader &reader);
 
     void SaveDocFile (Base::Writer &writer) const;
+    /// Returns false if the shape is written through a temporary file
+    bool isSaveDocFileThreadSafe() const;
     void RestoreDocFile(Base::Reader &reader);
+    /// The shape is read on demand when accessed the first time
+    bool deferRestoreDocFile(const std::shared_ptr<Base::DeferredFile>&);
 
     App::Property *Copy(void) const;
     void Paste(const App::Property &from);
     unsigned int getMemSize (void) const;
     //@}
 
+    /// Computes a fingerprint of the geometry of the shape
+    virtual bool getValueHash(std::size_t& hash) const;
+
     /// Get valid paths for this property; used by auto completer
     virtual void getPaths(std::vector<App::ObjectIdentifier> & paths) const;
 
+private:
+    /// reads the shape if the document has been restored lazily
+    void restoreDeferred() const;
+
 private:
     TopoShape _Shape;
+    std::shared_ptr<Base::DeferredFile> _deferredFile;
+    /// the shape for which the value hash was computed the last time
+    mutable TopoDS_Shape _hashedShape;
+    mutable std::size_t _hash;
 };
 
 struct PartExport ShapeHistory {
@@ -38,6 +38,82 @@ class PartTestCases(unittest.TestCase):
         self.Doc.recompute()
         self.failUnless(len(self.Box.Shape.Faces)==6)
 
+    def testSkipUnchangedOutputs(self):
+        class Copy:
+            def __init__(self, obj):
+                obj.addProperty("App::PropertyLink","Base")
+                obj.Proxy = self
+                self.count = 0
+            def execute(self, obj):
+                self.count += 1
+                obj.Shape = obj.Base.Shape
+
+        box = self.Doc.addObject("Part::Box","Box")
+        copy = self.Doc.addObject("Part::FeaturePython","Copy")
+        proxy = Copy(copy)
+        copy.Base = box
+
+        param = App.ParamGet("User parameter:BaseApp/Preferences/Document")
+        skip = param.GetBool("SkipUnchangedOutputs", False)
+        param.SetBool("SkipUnchangedOutputs", True)
+        try:
+            self.Doc.recompute()
+            self.assertEqual(proxy.count, 1)
+            # the box is executed again but builds the same shape
+            box.touch()
+            self.Doc.recompute()
+            self.assertEqual(proxy.count, 1)
+            box.Length = 20.0
+            self.Doc.recompute()
+            self.assertEqual(proxy.count, 2)
+            self.assertAlmostEqual(copy.Shape.Volume, 2000.0)
+        finally:
+            param.SetBool("SkipUnchangedOutputs", skip)
+
+        # without the option the unchanged output is propagated
+        box.touch()
+        self.Doc.recompute()
+        self.assertEqual(proxy.count, 3)
+
+    def testParallelRecompute(self):
+        # independent boxes run in worker threads, the cuts in the calling thread
+        boxes = []
+        for i in range(8):
+            box = self.Doc.addObject("Part::Box","Box")
+            box.Length = 1.0 + i
+            box.Width = 2.0 + i
+            box.Height = 3.0 + i
+            boxes.append(box)
+        cuts = []
+        for i in range(0, len(boxes), 2):
+            cut = self.Doc.addObject("Part::Cut","Cut")
+            cut.Base = boxes[i+1]
+            cut.Tool = boxes[i]
+            cuts.append(cut)
+        objects = boxes + cuts
+
+        self.Doc.recompute()
+        serial = [(o.Shape.Volume, o.Shape.BoundBox) for o in objects]
+
+        param = App.ParamGet("User parameter:BaseApp/Preferences/Document")
+        parallel = param.GetBool("ParallelRecompute", False)
+        threads = param.GetInt("RecomputeThreads", 0)
+        param.SetBool("ParallelRecompute", True)
+        param.SetInt("RecomputeThreads", 4)
+        try:
+            for o in objects:
+                o.touch()
+            self.Doc.recompute()
+        finally:
+            param.SetBool("ParallelRecompute", parallel)
+            param.SetInt("RecomputeThreads", threads)
+
+        for o, (volume, bbox) in zip(objects, serial):
+            self.assertFalse('Touched' in o.State)
+            self.assertAlmostEqual(o.Shape.Volume, volume)
+            self.assertTrue(o.Shape.BoundBox.isInside(bbox))
+            self.assertTrue(bbox.isInside(o.Shape.BoundBox))
+
     def testIssue2985(self):
         v1 = App.Vector(0.0,0.0,0.0)
         v2 = App.Vector(10.0,0.0,0.0)
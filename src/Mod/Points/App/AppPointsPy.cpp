@@ -30,6 +30,7 @@
 #include <CXX/Extensions.hxx>
 #include <CXX/Objects.hxx>
 
+#include <Base/BoundBoxPy.h>
 #include <Base/Console.h>
 #include <Base/Interpreter.h>
 #include <Base/FileInfo.h>
@@ -43,6 +44,7 @@
 #include "Points.h"
 #include "PointsPy.h"
 #include "PointsAlgos.h"
+#include "PointsOctree.h"
 #include "Structured.h"
 #include "Properties.h"
 
@@ -52,15 +54,26 @@ class Module : public Py::ExtensionModule<Module>
 public:
     Module() : Py::ExtensionModule<Module>("Points")
     {
-        add_varargs_method("open",&Module::open
+        add_varargs_method("open",&Module::open,
+            "open(string,[int],[BoundBox]) -- Load a point cloud into a new document.\n"
+            "If a number n is given only every n-th point is loaded,\n"
+            "if a bounding box is given only the points inside it are loaded."
         );
-        add_varargs_method("insert",&Module::importer
+        add_varargs_method("insert",&Module::importer,
+            "insert(string,string,[int],[BoundBox]) -- Load a point cloud into the given document.\n"
+            "If a number n is given only every n-th point is loaded,\n"
+            "if a bounding box is given only the points inside it are loaded."
         );
         add_varargs_method("export",&Module::exporter
         );
         add_varargs_method("show",&Module::show,
             "show(points,[string]) -- Add the points to the active document or create one if no document exists."
         );
+        add_varargs_method("readOctree",&Module::readOctree,
+            "readOctree(string,[int],[BoundBox]) -- Read the points of an octree file written by Points.writeOctree().\n"
+            "If the number of points is given an evenly distributed subset of at most this size is read,\n"
+            "if a bounding box is given only the points inside it are read."
+        );
         initialize("This module is the Points module."); // register with Python
     }
 
@@ -70,7 +83,9 @@ private:
     Py::Object open(const Py::Tuple& args)
     {
         char* Name;
-        if (!PyArg_ParseTuple(args.ptr(), "et","utf-8",&Name))
+        long step = 1;
+        PyObject *pcBox = 0;
+        if (!PyArg_ParseTuple(args.ptr(), "et|lO!","utf-8",&Name,&step,&(Base::BoundBoxPy::Type),&pcBox))
             throw Py::Exception();
         std::string EncodedName = std::string(Name);
         PyMem_Free(Name);
@@ -97,6 +112,10 @@ private:
                 throw Py::RuntimeError("Unsupported file extension");
             }
 
+            if (step > 1)
+                reader->setSubsampling(static_cast<std::size_t>(step));
+            if (pcBox)
+                reader->setBoundBox(*static_cast<Base::BoundBoxPy*>(pcBox)->getBoundBoxPtr());
             reader->read(EncodedName);
 
             App::Document *pcDoc = App::GetApplication().newDocument("Unnamed");
@@ -182,7 +201,9 @@ private:
     {
         char* Name;
         const char* DocName;
-        if (!PyArg_ParseTuple(args.ptr(), "ets","utf-8",&Name,&DocName))
+        long step = 1;
+        PyObject *pcBox = 0;
+        if (!PyArg_ParseTuple(args.ptr(), "ets|lO!","utf-8",&Name,&DocName,&step,&(Base::BoundBoxPy::Type),&pcBox))
             throw Py::Exception();
         std::string EncodedName = std::string(Name);
         PyMem_Free(Name);
@@ -209,6 +230,10 @@ private:
                 throw Py::RuntimeError("Unsupported file extension");
             }
 
+            if (step > 1)
+                reader->setSubsampling(static_cast<std::size_t>(step));
+            if (pcBox)
+                reader->setBoundBox(*static_cast<Base::BoundBoxPy*>(pcBox)->getBoundBoxPtr());
             reader->read(EncodedName);
 
             App::Document *pcDoc = App::GetApplication().getDocument(DocName);
@@ -392,6 +417,41 @@ private:
 
         return Py::None();
     }
+
+    Py::Object readOctree(const Py::Tuple& args)
+    {
+        char* Name;
+        long count = -1;
+        PyObject *pcBox = 0;
+        if (!PyArg_ParseTuple(args.ptr(), "et|lO!", "utf-8", &Name, &count, &(Base::BoundBoxPy::Type), &pcBox))
+            throw Py::Exception();
+        std::string EncodedName = std::string(Name);
+        PyMem_Free(Name);
+
+        PointsOctree octree;
+        if (!octree.Open(EncodedName))
+            throw Py::RuntimeError("Cannot read octree file");
+
+        Base::BoundBox3f box;
+        if (pcBox) {
+            Base::BoundBox3d bbox = *static_cast<Base::BoundBoxPy*>(pcBox)->getBoundBoxPtr();
+            box = Base::BoundBox3f(bbox.MinX, bbox.MinY, bbox.MinZ, bbox.MaxX, bbox.MaxY, bbox.MaxZ);
+        }
+
+        // the octree keeps the points in global coordinates
+        std::vector<unsigned long> indices;
+        std::vector<Base::Vector3f> points;
+        if (count >= 0)
+            octree.LevelOfDetail(static_cast<unsigned long>(count), indices, &points, pcBox ? &box : 0);
+        else if (pcBox)
+            octree.InBox(box, indices, &points);
+        else
+            octree.LevelOfDetail(octree.CountPoints(), indices, &points);
+
+        std::unique_ptr<PointKernel> kernel(new PointKernel());
+        kernel->swap(points);
+        return Py::asObject(new PointsPy(kernel.release()));
+    }
 };
 
 PyObject* initModule()
@@ -27,8 +27,6 @@
 # include <iostream>
 #endif
 
-#include <boost/math/special_functions/fpclassify.hpp>
-#include <QtConcurrentMap>
 
 #include <Base/Exception.h>
 #include <Base/Matrix.h>
@@ -38,12 +36,9 @@
 
 #include "Points.h"
 #include "PointsAlgos.h"
+#include "PointsParallel.h"
 #include "PointsPy.h"
 
-#ifdef _WIN32
-# include <ppl.h>
-#endif
-
 using namespace Points;
 using namespace std;
 
@@ -84,42 +79,12 @@ Data::Segment* PointKernel::getSubElement(const char* /*Type*/, unsigned long /*
 
 void PointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
-    std::vector<value_type>& kernel = getBasicPoints();
-#ifdef _WIN32
-    // Win32-only at the moment since ppl.h is a Microsoft library. Points is not using Qt so we cannot use QtConcurrent
-    // We could also rewrite Points to leverage SIMD instructions
-    // Other option: openMP. But with VC2013 results in high CPU usage even after computation (busy-waits for >100ms)
-    Concurrency::parallel_for_each(kernel.begin(), kernel.end(), [rclMat](value_type& value) {
-        value = rclMat * value;
-    });
-#else
-    QtConcurrent::blockingMap(kernel, [rclMat](value_type& value) {
-        rclMat.multVec(value, value);
-    });
-#endif
+    PointsParallel::Transform(_Points, rclMat);
 }
 
 Base::BoundBox3d PointKernel::getBoundBox(void)const
 {
-    Base::BoundBox3d bnd;
-
-#ifdef _WIN32
-    // Thread-local bounding boxes
-    Concurrency::combinable<Base::BoundBox3d> bbs;
-    // Cannot use a const_point_iterator here as it is *not* a proper iterator (fails the for_each template)
-    Concurrency::parallel_for_each(_Points.begin(), _Points.end(), [this, &bbs](const value_type& value) {
-        Base::Vector3d vertd(value.x, value.y, value.z);
-        bbs.local().Add(this->_Mtrx * vertd);
-    });
-    // Combine each thread-local bounding box in the final bounding box
-    bbs.combine_each([&bnd](const Base::BoundBox3d& lbb) {
-        bnd.Add(lbb);
-    });
-#else
-    for (const_point_iterator it = begin(); it != end(); ++it)
-        bnd.Add(*it);
-#endif
-    return bnd;
+    return PointsParallel::BoundBox(_Points, _Mtrx);
 }
 
 void PointKernel::operator = (const PointKernel& Kernel)
@@ -138,30 +103,12 @@ unsigned int PointKernel::getMemSize (void) const
 
 PointKernel::size_type PointKernel::countValid(void) const
 {
-    size_type num = 0;
-    for (const_point_iterator it = begin(); it != end(); ++it) {
-        if (!(boost::math::isnan(it->x) || 
-              boost::math::isnan(it->y) ||
-              boost::math::isnan(it->z)))
-            num++;
-    }
-    return num;
+    return PointsParallel::CountValid(_Points);
 }
 
 std::vector<PointKernel::value_type> PointKernel::getValidPoints() const
 {
-    std::vector<PointKernel::value_type> valid;
-    valid.reserve(countValid());
-    for (const_point_iterator it = begin(); it != end(); ++it) {
-        if (!(boost::math::isnan(it->x) || 
-              boost::math::isnan(it->y) ||
-              boost::math::isnan(it->z)))
-            valid.push_back(value_type(
-                    static_cast<float_type>(it->x),
-                    static_cast<float_type>(it->y),
-                    static_cast<float_type>(it->z)));
-    }
-    return valid;
+    return PointsParallel::ValidPoints(_Points, _Mtrx);
 }
 
 void PointKernel::Save (Base::Writer &writer) const
@@ -237,11 +184,7 @@ void PointKernel::getPoints(std::vector<Base::Vector3d> &Points,
                             std::vector<Base::Vector3d> &/*Normals*/,
                             float /*Accuracy*/, uint16_t /*flags*/) const
 {
-    unsigned long ctpoints = _Points.size();
-    Points.reserve(ctpoints);
-    for (unsigned long i=0; i<ctpoints; i++) {
-        Points.push_back(this->getPoint(i));
-    }
+    PointsParallel::Transform(_Points, _Mtrx, Points);
 }
 
 // ----------------------------------------------------------------------------
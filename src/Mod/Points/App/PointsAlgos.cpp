@@ -26,6 +26,9 @@
 #ifdef FC_OS_LINUX
 # include <unistd.h>
 #endif
+# include <algorithm>
+# include <cstring>
+# include <limits>
 # include <sstream>
 #endif
 
@@ -44,6 +47,9 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <QByteArray>
+#include <QFile>
+#include <QtConcurrentMap>
 
 using namespace Points;
 
@@ -122,6 +128,8 @@ Reader::Reader()
 {
     width = 0;
     height = 0;
+    subsampling = 1;
+    cropping = false;
 }
 
 Reader::~Reader()
@@ -190,6 +198,750 @@ int Reader::getHeight() const
     return height;
 }
 
+void Reader::setSubsampling(std::size_t step)
+{
+    subsampling = std::max<std::size_t>(step, 1);
+}
+
+void Reader::setBoundBox(const Base::BoundBox3d& box)
+{
+    boundBox = box;
+    cropping = box.IsValid();
+}
+
+bool Reader::isFiltered() const
+{
+    return (subsampling > 1 || cropping);
+}
+
+// ----------------------------------------------------------------------------
+
+namespace {
+
+// Number of binary records handled by a single task
+const std::size_t RecordsPerBlock = 1 << 18;
+// Number of bytes of text parsed by a single task
+const std::size_t BytesPerChunk = 1 << 22;
+
+enum FieldType {
+    Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64
+};
+
+std::size_t fieldSize(FieldType type)
+{
+    switch (type) {
+    case Int8:
+    case UInt8:
+        return 1;
+    case Int16:
+    case UInt16:
+        return 2;
+    case Int32:
+    case UInt32:
+    case Float32:
+        return 4;
+    default:
+        return 8;
+    }
+}
+
+/// Checks that \a num records of \a size bytes fit into \a avail bytes without overflowing
+bool fitsInto(std::size_t num, std::size_t size, std::size_t avail)
+{
+    return size == 0 || num <= avail / size;
+}
+
+FieldType plyFieldType(const std::string& t)
+{
+    if (t == "char" || t == "int8")
+        return Int8;
+    else if (t == "uchar" || t == "uint8")
+        return UInt8;
+    else if (t == "short" || t == "int16")
+        return Int16;
+    else if (t == "ushort" || t == "uint16")
+        return UInt16;
+    else if (t == "int" || t == "int32")
+        return Int32;
+    else if (t == "uint" || t == "uint32")
+        return UInt32;
+    else if (t == "float" || t == "float32")
+        return Float32;
+    else if (t == "double" || t == "float64")
+        return Float64;
+    throw Base::BadFormatError("Unexpected type");
+}
+
+FieldType pcdFieldType(const std::string& t, int size)
+{
+    char c = t.empty() ? ' ' : t[0];
+    switch (size) {
+    case 1:
+        if (c == 'I')
+            return Int8;
+        else if (c == 'U')
+            return UInt8;
+        break;
+    case 2:
+        if (c == 'I')
+            return Int16;
+        else if (c == 'U')
+            return UInt16;
+        break;
+    case 4:
+        if (c == 'I')
+            return Int32;
+        else if (c == 'U')
+            return UInt32;
+        else if (c == 'F')
+            return Float32;
+        break;
+    case 8:
+        if (c == 'F')
+            return Float64;
+        break;
+    }
+    throw Base::BadFormatError("Unexpected type");
+}
+
+bool isBigEndianHost()
+{
+    const uint16_t one = 1;
+    return (*reinterpret_cast<const unsigned char*>(&one) == 0);
+}
+
+template <typename T>
+inline T loadValue(const char* ptr, bool swap)
+{
+    T value;
+    if (swap) {
+        char bytes[sizeof(T)];
+        std::reverse_copy(ptr, ptr + sizeof(T), bytes);
+        std::memcpy(&value, bytes, sizeof(T));
+    }
+    else {
+        std::memcpy(&value, ptr, sizeof(T));
+    }
+    return value;
+}
+
+inline double loadField(const char* ptr, FieldType type, bool swap)
+{
+    switch (type) {
+    case Int8:
+        return loadValue<int8_t>(ptr, swap);
+    case UInt8:
+        return loadValue<uint8_t>(ptr, swap);
+    case Int16:
+        return loadValue<int16_t>(ptr, swap);
+    case UInt16:
+        return loadValue<uint16_t>(ptr, swap);
+    case Int32:
+        return loadValue<int32_t>(ptr, swap);
+    case UInt32:
+        return loadValue<uint32_t>(ptr, swap);
+    case Float32:
+        return loadValue<float>(ptr, swap);
+    default:
+        return loadValue<double>(ptr, swap);
+    }
+}
+
+/**
+ * The roles a field of a record can have. Either the colour is given by
+ * separate channels or it is packed into a single 32-bit field.
+ */
+enum FieldRole {
+    X, Y, Z, NormalX, NormalY, NormalZ, Intensity,
+    Red, Green, Blue, Alpha, PackedColor, NumRoles
+};
+
+/**
+ * Assigns the fields of a record to their roles.
+ */
+struct FieldMap
+{
+    int field[NumRoles];
+    FieldType type[NumRoles];
+    float colorScale;
+
+    FieldMap(const std::vector<std::string>& names, const std::vector<FieldType>& types)
+        : colorScale(1.0f)
+    {
+        static const char* roleNames[NumRoles][2] = {
+            {"x", 0}, {"y", 0}, {"z", 0},
+            {"normal_x", "nx"}, {"normal_y", "ny"}, {"normal_z", "nz"},
+            {"intensity", 0},
+            {"red", 0}, {"green", 0}, {"blue", 0}, {"alpha", 0},
+            {"rgb", "rgba"}
+        };
+
+        for (int r = 0; r < NumRoles; r++) {
+            field[r] = -1;
+            type[r] = Float64;
+            for (int n = 0; n < 2 && field[r] < 0 && roleNames[r][n]; n++) {
+                std::vector<std::string>::const_iterator it = std::find(names.begin(), names.end(), roleNames[r][n]);
+                if (it != names.end()) {
+                    field[r] = static_cast<int>(std::distance(names.begin(), it));
+                    type[r] = types[field[r]];
+                }
+            }
+        }
+
+        // a packed colour must have 32 bits
+        if (has(PackedColor) && fieldSize(type[PackedColor]) != 4)
+            field[PackedColor] = -1;
+
+        switch (type[Red]) {
+        case Int8:
+        case UInt8:
+            colorScale = 1.0f / 255.0f;
+            break;
+        case Int16:
+        case UInt16:
+            colorScale = 1.0f / 65535.0f;
+            break;
+        default:
+            break;
+        }
+    }
+    bool has(FieldRole r) const {
+        return field[r] >= 0;
+    }
+    bool hasPoints() const {
+        return has(X) && has(Y) && has(Z);
+    }
+    bool hasNormals() const {
+        return has(NormalX) && has(NormalY) && has(NormalZ);
+    }
+    bool hasIntensities() const {
+        return has(Intensity);
+    }
+    bool hasColors() const {
+        return (has(Red) && has(Green) && has(Blue)) || has(PackedColor);
+    }
+};
+
+struct Record
+{
+    double value[NumRoles];
+    uint32_t packed;
+};
+
+/**
+ * The typed columns the records are written to.
+ */
+struct PointColumns
+{
+    std::vector<Base::Vector3f> points;
+    std::vector<Base::Vector3f> normals;
+    std::vector<float> intensity;
+    std::vector<App::Color> colors;
+
+    void resize(std::size_t num, const FieldMap& map)
+    {
+        points.resize(num);
+        if (map.hasNormals())
+            normals.resize(num);
+        if (map.hasIntensities())
+            intensity.resize(num);
+        if (map.hasColors())
+            colors.resize(num);
+    }
+    void set(std::size_t pos, const Record& rec, const FieldMap& map)
+    {
+        points[pos].Set(static_cast<float>(rec.value[X]),
+                        static_cast<float>(rec.value[Y]),
+                        static_cast<float>(rec.value[Z]));
+        if (!normals.empty()) {
+            normals[pos].Set(static_cast<float>(rec.value[NormalX]),
+                             static_cast<float>(rec.value[NormalY]),
+                             static_cast<float>(rec.value[NormalZ]));
+        }
+        if (!intensity.empty()) {
+            intensity[pos] = static_cast<float>(rec.value[Intensity]);
+        }
+        if (!colors.empty()) {
+            if (map.has(PackedColor)) {
+                uint32_t packed = rec.packed;
+                colors[pos].set(static_cast<float>((packed >> 16) & 0xff)/255.0f,
+                                static_cast<float>((packed >> 8) & 0xff)/255.0f,
+                                static_cast<float>(packed & 0xff)/255.0f,
+                                static_cast<float>((packed >> 24) & 0xff)/255.0f);
+            }
+            else {
+                float a = map.has(Alpha) ? static_cast<float>(rec.value[Alpha]) : 1.0f;
+                colors[pos].set(static_cast<float>(rec.value[Red]) * map.colorScale,
+                                static_cast<float>(rec.value[Green]) * map.colorScale,
+                                static_cast<float>(rec.value[Blue]) * map.colorScale,
+                                a * map.colorScale);
+            }
+        }
+    }
+};
+
+/**
+ * Selects the records to load: every n-th record and optionally only
+ * the points inside a box.
+ */
+struct LoadFilter
+{
+    std::size_t step;
+    bool crop;
+    Base::BoundBox3d box;
+
+    LoadFilter(std::size_t step, bool crop, const Base::BoundBox3d& box)
+        : step(step), crop(crop), box(box) {
+    }
+    /// The first selected index not below \a index
+    std::size_t next(std::size_t index) const {
+        return ((index + step - 1) / step) * step;
+    }
+    /// The number of selected indices in [first, last) ignoring the box
+    std::size_t count(std::size_t first, std::size_t last) const {
+        return (last + step - 1) / step - (first + step - 1) / step;
+    }
+    bool inside(const Record& rec) const {
+        return box.IsInBox(Base::Vector3d(rec.value[X], rec.value[Y], rec.value[Z]));
+    }
+};
+
+/**
+ * A range of records handled by one task.
+ */
+struct Block
+{
+    std::size_t first;      // index of the first record
+    std::size_t count;      // number of records
+    std::size_t selected;   // number of records passing the filter
+    std::size_t output;     // position of the first selected record in the columns
+    const char* begin;      // text range of the records (ASCII only)
+    const char* end;
+    bool failed;
+
+    Block() : first(0), count(0), selected(0), output(0), begin(0), end(0), failed(false) {
+    }
+};
+
+/**
+ * Records stored as fixed-size binary fields. The field of a role of record i
+ * starts at base + i * step which covers row-major as well as column-major data.
+ */
+class BinaryRecords
+{
+public:
+    BinaryRecords(const char* data, const FieldMap& map,
+                  const std::vector<std::size_t>& offsets,
+                  const std::vector<std::size_t>& steps, bool swap)
+        : swap(swap)
+    {
+        for (int r = 0; r < NumRoles; r++) {
+            base[r] = 0;
+            step[r] = 0;
+            type[r] = map.type[r];
+            if (map.has(static_cast<FieldRole>(r))) {
+                base[r] = data + offsets[map.field[r]];
+                step[r] = steps[map.field[r]];
+            }
+        }
+    }
+
+    std::vector<Block> blocks(std::size_t numRecords) const
+    {
+        std::vector<Block> list;
+        for (std::size_t first = 0; first < numRecords; first += RecordsPerBlock) {
+            Block block;
+            block.first = first;
+            block.count = std::min(RecordsPerBlock, numRecords - first);
+            list.push_back(block);
+        }
+        return list;
+    }
+
+    template <typename Func>
+    void visit(Block& block, const LoadFilter& filter, Func func) const
+    {
+        Record rec;
+        rec.packed = 0;
+        std::size_t last = block.first + block.count;
+        for (std::size_t i = filter.next(block.first); i < last; i += filter.step) {
+            for (int r = 0; r < PackedColor; r++) {
+                if (base[r])
+                    rec.value[r] = loadField(base[r] + i * step[r], type[r], swap);
+            }
+            // keep the bits of the packed colour even if it is declared as float
+            if (base[PackedColor])
+                rec.packed = loadValue<uint32_t>(base[PackedColor] + i * step[PackedColor], swap);
+            func(rec);
+        }
+    }
+
+private:
+    const char* base[NumRoles];
+    std::size_t step[NumRoles];
+    FieldType type[NumRoles];
+    bool swap;
+};
+
+/**
+ * Records stored as lines of whitespace separated numbers. Lines not starting
+ * with a number, e.g. comments, are skipped.
+ */
+class TextRecords
+{
+public:
+    TextRecords(const FieldMap& map, const std::vector<std::size_t>& columns)
+        : packed(map.has(PackedColor))
+        , packedFloat(map.type[PackedColor] == Float32)
+        , numColumns(0)
+    {
+        for (int r = 0; r < NumRoles; r++) {
+            if (map.has(static_cast<FieldRole>(r))) {
+                std::size_t col = columns[map.field[r]];
+                if (col >= roles.size())
+                    roles.resize(col + 1, -1);
+                roles[col] = r;
+            }
+        }
+    }
+
+    static const char* lineEnd(const char* ptr, const char* end) {
+        const char* eol = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+        return eol ? eol : end;
+    }
+    /**
+     * Only lines with exactly \a num numbers are records, all other lines are
+     * skipped. With zero, the default, every line starting with a number is a
+     * record and a malformed record is an error.
+     */
+    void setColumnCount(std::size_t num) {
+        numColumns = num;
+    }
+
+    static bool startsRecord(const char* ptr, const char* end) {
+        while (ptr < end && (*ptr == ' ' || *ptr == '\t'))
+            ++ptr;
+        if (ptr == end)
+            return false;
+        char c = *ptr;
+        if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.')
+            return true;
+        if (end - ptr >= 3) {
+            c = *ptr | 0x20;
+            char d = ptr[1] | 0x20;
+            char e = ptr[2] | 0x20;
+            return (c == 'n' && d == 'a' && e == 'n') || (c == 'i' && d == 'n' && e == 'f');
+        }
+        return false;
+    }
+
+    /// Skips the first \a num records of the text
+    static const char* skip(const char* ptr, const char* end, std::size_t num) {
+        while (num > 0 && ptr < end) {
+            const char* eol = lineEnd(ptr, end);
+            if (startsRecord(ptr, eol))
+                num--;
+            ptr = eol < end ? eol + 1 : end;
+        }
+        return ptr;
+    }
+
+    /**
+     * Splits the text into blocks at line breaks and counts their records.
+     * Records beyond \a numRecords are not part of any block.
+     */
+    std::vector<Block> blocks(const char* begin, const char* end, std::size_t numRecords) const
+    {
+        std::vector<Block> list;
+        const char* ptr = begin;
+        while (ptr < end) {
+            Block block;
+            block.begin = ptr;
+            if (static_cast<std::size_t>(end - ptr) <= BytesPerChunk) {
+                block.end = end;
+            }
+            else {
+                const char* eol = lineEnd(ptr + BytesPerChunk, end);
+                block.end = eol < end ? eol + 1 : end;
+            }
+            ptr = block.end;
+            list.push_back(block);
+        }
+
+        QtConcurrent::blockingMap(list, [this](Block& block) {
+            const char* ptr = block.begin;
+            while (ptr < block.end) {
+                const char* eol = lineEnd(ptr, block.end);
+                if (isRecord(ptr, eol))
+                    block.count++;
+                ptr = eol < block.end ? eol + 1 : block.end;
+            }
+        });
+
+        std::size_t first = 0;
+        for (std::vector<Block>::iterator it = list.begin(); it != list.end(); ++it) {
+            it->first = first;
+            it->count = std::min(it->count, numRecords - std::min(first, numRecords));
+            first += it->count;
+        }
+        return list;
+    }
+
+    template <typename Func>
+    void visit(Block& block, const LoadFilter& filter, Func func) const
+    {
+        Record rec;
+        rec.packed = 0;
+        std::size_t index = block.first;
+        std::size_t last = block.first + block.count;
+        const char* ptr = block.begin;
+        while (ptr < block.end && index < last) {
+            const char* eol = lineEnd(ptr, block.end);
+            if (isRecord(ptr, eol)) {
+                if (index % filter.step == 0) {
+                    if (!parse(ptr, eol, rec)) {
+                        block.failed = true;
+                        return;
+                    }
+                    func(rec);
+                }
+                index++;
+            }
+            ptr = eol < block.end ? eol + 1 : block.end;
+        }
+    }
+
+private:
+    bool isRecord(const char* ptr, const char* end) const
+    {
+        if (!startsRecord(ptr, end))
+            return false;
+        if (numColumns == 0)
+            return true;
+
+        std::size_t count = 0;
+        while (true) {
+            while (ptr < end && (*ptr == ' ' || *ptr == '\t' || *ptr == '\r'))
+                ++ptr;
+            if (ptr == end)
+                return count == numColumns;
+            double value;
+            if (count == numColumns || !parseNumber(ptr, end, value))
+                return false;
+            count++;
+        }
+    }
+
+    bool parse(const char* ptr, const char* end, Record& rec) const
+    {
+        for (std::size_t col = 0; col < roles.size(); col++) {
+            while (ptr < end && (*ptr == ' ' || *ptr == '\t'))
+                ++ptr;
+            if (roles[col] < 0) {
+                // not needed, just skip it
+                const char* tok = ptr;
+                while (ptr < end && *ptr != ' ' && *ptr != '\t' && *ptr != '\r')
+                    ++ptr;
+                if (tok == ptr)
+                    return false;
+            }
+            else {
+                double value;
+                if (!parseNumber(ptr, end, value))
+                    return false;
+                rec.value[roles[col]] = value;
+            }
+        }
+
+        if (packed) {
+            // the bits of a float colour are the packed channels
+            if (packedFloat) {
+                float f = static_cast<float>(rec.value[PackedColor]);
+                std::memcpy(&rec.packed, &f, sizeof(f));
+            }
+            else {
+                rec.packed = static_cast<uint32_t>(rec.value[PackedColor]);
+            }
+        }
+        return true;
+    }
+
+    /// Locale independent parsing of a decimal number
+    static bool parseNumber(const char*& ptr, const char* end, double& value)
+    {
+        static const double powers[] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+
+        bool negative = false;
+        if (ptr < end && (*ptr == '-' || *ptr == '+')) {
+            negative = (*ptr == '-');
+            ++ptr;
+        }
+
+        if (ptr < end && ((*ptr | 0x20) == 'n' || (*ptr | 0x20) == 'i')) {
+            value = (*ptr | 0x20) == 'n' ? std::numeric_limits<double>::quiet_NaN()
+                                          : std::numeric_limits<double>::infinity();
+            while (ptr < end && ((*ptr | 0x20) >= 'a' && (*ptr | 0x20) <= 'z'))
+                ++ptr;
+        }
+        else {
+            uint64_t mantissa = 0;
+            int digits = 0;
+            int exponent = 0;
+            bool any = false;
+            for (; ptr < end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+                any = true;
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + (*ptr - '0');
+                    if (mantissa > 0)
+                        digits++;
+                }
+                else {
+                    exponent++;
+                }
+            }
+            if (ptr < end && *ptr == '.') {
+                for (++ptr; ptr < end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+                    any = true;
+                    if (digits < 19) {
+                        mantissa = mantissa * 10 + (*ptr - '0');
+                        if (mantissa > 0)
+                            digits++;
+                        exponent--;
+                    }
+                }
+            }
+            if (!any)
+                return false;
+            if (ptr < end && (*ptr | 0x20) == 'e') {
+                const char* exp = ptr + 1;
+                bool negexp = false;
+                if (exp < end && (*exp == '-' || *exp == '+')) {
+                    negexp = (*exp == '-');
+                    ++exp;
+                }
+                if (exp < end && *exp >= '0' && *exp <= '9') {
+                    int e = 0;
+                    for (; exp < end && *exp >= '0' && *exp <= '9'; ++exp) {
+                        if (e < 10000)
+                            e = e * 10 + (*exp - '0');
+                    }
+                    exponent += negexp ? -e : e;
+                    ptr = exp;
+                }
+            }
+
+            // scaling by an exact power of ten keeps the rounding error small
+            value = static_cast<double>(mantissa);
+            if (mantissa > 0) {
+                if (exponent < 0 && exponent >= -22)
+                    value /= powers[-exponent];
+                else if (exponent > 0 && exponent <= 22)
+                    value *= powers[exponent];
+                else if (exponent != 0)
+                    value *= std::pow(10.0, exponent);
+            }
+        }
+
+        if (negative)
+            value = -value;
+        // the number must be followed by a separator
+        return (ptr == end || *ptr == ' ' || *ptr == '\t' || *ptr == '\r');
+    }
+
+    std::vector<int> roles;
+    bool packed;
+    bool packedFloat;
+    std::size_t numColumns;
+};
+
+/**
+ * Loads the selected records of all blocks into the columns. The blocks are
+ * first counted to know where each block writes to, then they are loaded
+ * in parallel directly into the final columns. With a crop box the records
+ * are therefore parsed twice.
+ */
+template <typename Source>
+void loadRecords(const Source& source, std::vector<Block>& blocks,
+                 const FieldMap& map, const LoadFilter& filter, PointColumns& columns)
+{
+    QtConcurrent::blockingMap(blocks, [&source, &filter](Block& block) {
+        if (filter.crop) {
+            std::size_t selected = 0;
+            source.visit(block, filter, [&filter, &selected](const Record& rec) {
+                if (filter.inside(rec))
+                    selected++;
+            });
+            block.selected = selected;
+        }
+        else {
+            block.selected = filter.count(block.first, block.first + block.count);
+        }
+    });
+
+    std::size_t total = 0;
+    for (std::vector<Block>::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        if (it->failed)
+            throw Base::BadFormatError("Reading in points failed.");
+        it->output = total;
+        total += it->selected;
+    }
+
+    columns.resize(total, map);
+    QtConcurrent::blockingMap(blocks, [&source, &filter, &map, &columns](Block& block) {
+        std::size_t pos = block.output;
+        source.visit(block, filter, [&filter, &map, &columns, &pos](const Record& rec) {
+            if (!filter.crop || filter.inside(rec))
+                columns.set(pos++, rec, map);
+        });
+    });
+
+    for (std::vector<Block>::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        if (it->failed)
+            throw Base::BadFormatError("Reading in points failed.");
+    }
+}
+
+/**
+ * Gives access to the content of a file. The file is mapped into memory if
+ * possible, otherwise it is read in.
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& filename)
+        : file(QString::fromUtf8(filename.c_str())), map(0)
+    {
+        if (!file.open(QIODevice::ReadOnly))
+            throw Base::FileException("File to load not existing or not readable", filename.c_str());
+        map = file.map(0, file.size());
+        if (!map)
+            buffer = file.readAll();
+    }
+    ~MappedFile()
+    {
+        if (map)
+            file.unmap(map);
+    }
+    const char* data() const
+    {
+        return map ? reinterpret_cast<const char*>(map) : buffer.constData();
+    }
+    std::size_t size() const
+    {
+        return map ? static_cast<std::size_t>(file.size()) : static_cast<std::size_t>(buffer.size());
+    }
+
+private:
+    QFile file;
+    uchar* map;
+    QByteArray buffer;
+};
+
+} // namespace
+
 // ----------------------------------------------------------------------------
 
 AscReader::AscReader()
@@ -202,7 +954,29 @@ AscReader::~AscReader()
 
 void AscReader::read(const std::string& filename)
 {
-    points.load(filename.c_str());
+    clear();
+
+    std::vector<std::string> fields;
+    fields.push_back("x");
+    fields.push_back("y");
+    fields.push_back("z");
+    std::vector<FieldType> types(fields.size(), Float64);
+    std::vector<std::size_t> cols;
+    cols.push_back(0);
+    cols.push_back(1);
+    cols.push_back(2);
+
+    MappedFile file(filename);
+    FieldMap map(fields, types);
+    TextRecords source(map, cols);
+    // like the former regular expression skip all lines that are not exactly three numbers
+    source.setColumnCount(cols.size());
+    std::vector<Block> blocks = source.blocks(file.data(), file.data() + file.size(),
+                                              std::numeric_limits<std::size_t>::max());
+
+    PointColumns columns;
+    loadRecords(source, blocks, map, LoadFilter(subsampling, cropping, boundBox), columns);
+    points.swap(columns.points);
 }
 
 // ----------------------------------------------------------------------------
@@ -239,73 +1013,6 @@ public:
 
 typedef boost::shared_ptr<Converter> ConverterPtr;
 
-class DataStreambuf : public std::streambuf
-{
-public:
-    explicit DataStreambuf(const std::vector<char>& data) : _buffer(data) {
-        _beg = 0;
-        _end = data.size();
-        _cur = 0;
-    }
-    ~DataStreambuf() {
-    }
-
-protected:
-    virtual int_type uflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur++]) & 0x000000ff;
-    }
-    virtual int_type underflow() {
-        if (_cur == _end)
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[_cur]) & 0x000000ff;
-    }
-    virtual int_type pbackfail(int_type ch) {
-        if (_cur == _beg || (ch != traits_type::eof() && ch != _buffer[_cur-1]))
-            return traits_type::eof();
-
-        return static_cast<DataStreambuf::int_type>(_buffer[--_cur]) & 0x000000ff;
-    }
-    virtual std::streamsize showmanyc() {
-        return _end - _cur;
-    }
-    virtual pos_type seekoff(std::streambuf::off_type off,
-        std::ios_base::seekdir way,
-        std::ios_base::openmode = 
-            std::ios::in | std::ios::out) {
-        int p_pos=-1;
-        if (way == std::ios_base::beg)
-            p_pos = _beg;
-        else if (way == std::ios_base::end)
-            p_pos = _end;
-        else if (way == std::ios_base::cur)
-            p_pos = _cur;
-
-        if (p_pos > _end)
-            return traits_type::eof();
-
-        if (((p_pos + off) > _end) || ((p_pos + off) < _beg))
-            return traits_type::eof();
-
-        _cur = p_pos+ off;
-
-        return ((p_pos+off) - _beg);
-    }
-    virtual pos_type seekpos(std::streambuf::pos_type pos,
-        std::ios_base::openmode which =
-        std::ios::in | std::ios::out) {
-        (void)which;
-        return seekoff(pos, std::ios_base::beg);
-    }
-
-private:
-    const std::vector<char>& _buffer;
-    int _beg, _end, _cur;
-};
-
 //Taken from https://github.com/PointCloudLibrary/pcl/blob/master/io/src/lzf.cpp
 unsigned int 
 lzfDecompress (const void *const in_data,  unsigned int in_len,
@@ -515,141 +1222,57 @@ void PlyReader::read(const std::string& filename)
     std::vector<int> sizes;
     std::size_t offset = 0;
     std::size_t numPoints = readHeader(inp, format, offset, fields, types, sizes);
+    std::streamoff header = inp.tellg();
+    inp.close();
+
+    std::vector<FieldType> fieldTypes;
+    for (std::vector<std::string>::iterator it = types.begin(); it != types.end(); ++it)
+        fieldTypes.push_back(plyFieldType(*it));
+
+    FieldMap map(fields, fieldTypes);
+    if (!map.hasPoints() || numPoints == 0 || header < 0)
+        return;
+
+    MappedFile file(filename);
+    const char* data = file.data() + header;
+    const char* end = file.data() + file.size();
+    LoadFilter filter(subsampling, cropping, boundBox);
+    PointColumns columns;
 
-    Eigen::MatrixXd data(numPoints, fields.size());
     if (format == "ascii") {
-        readAscii(inp, offset, data);
-    }
-    else if (format == "binary_little_endian") {
-        readBinary(false, inp, offset, types, sizes, data);
-    }
-    else if (format == "binary_big_endian") {
-        readBinary(true, inp, offset, types, sizes, data);
-    }
-
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t red = max_size, green = max_size, blue = max_size, alpha = max_size;
-    it = std::find(fields.begin(), fields.end(), "red");
-    if (it != fields.end())
-        red = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "green");
-    if (it != fields.end())
-        green = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "blue");
-    if (it != fields.end())
-        blue = std::distance(fields.begin(), it);
-
-    it = std::find(fields.begin(), fields.end(), "alpha");
-    if (it != fields.end())
-        alpha = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (red != max_size && green != max_size && blue != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
-        }
-    }
+        std::vector<std::size_t> cols;
+        for (std::size_t i=0; i<fields.size(); i++)
+            cols.push_back(i);
 
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.push_back(Base::Vector3f(data(i,normal_x),data(i,normal_y),data(i,normal_z)));
-        }
+        // skip the lines of the elements before the vertices
+        TextRecords source(map, cols);
+        data = TextRecords::skip(data, end, offset);
+        std::vector<Block> blocks = source.blocks(data, end, numPoints);
+        loadRecords(source, blocks, map, filter, columns);
     }
-
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
+    else {
+        std::vector<std::size_t> offsets;
+        std::size_t stride = 0;
+        for (std::size_t i=0; i<fieldTypes.size(); i++) {
+            offsets.push_back(stride);
+            stride += fieldSize(fieldTypes[i]);
         }
-    }
 
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        float a = 1.0;
-        if (types[red] == "uchar") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
-        else if (types[red] == "float") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                float r = data(i, red);
-                float g = data(i, green);
-                float b = data(i, blue);
-                if (alpha != max_size)
-                    a = data(i, alpha);
-                colors.push_back(App::Color(r, g, b, a));
-            }
-        }
+        std::size_t avail = file.size() - std::min(static_cast<std::size_t>(header), file.size());
+        if (offset > avail || !fitsInto(numPoints, stride, avail - offset))
+            throw Base::BadFormatError("File expects too many elements");
+
+        bool bigEndian = (format == "binary_big_endian");
+        std::vector<std::size_t> steps(offsets.size(), stride);
+        BinaryRecords source(data + offset, map, offsets, steps, bigEndian != isBigEndianHost());
+        std::vector<Block> blocks = source.blocks(numPoints);
+        loadRecords(source, blocks, map, filter, columns);
     }
+
+    points.swap(columns.points);
+    normals.swap(columns.normals);
+    intensity.swap(columns.intensity);
+    colors.swap(columns.colors);
 }
 
 std::size_t PlyReader::readHeader(std::istream& in,
@@ -820,121 +1443,6 @@ std::size_t PlyReader::readHeader(std::istream& in,
     return numPoints;
 }
 
-void PlyReader::readAscii(std::istream& inp, std::size_t offset, Eigen::MatrixXd& data)
-{
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        if (offset > 0) {
-            offset--;
-            continue;
-        }
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PlyReader::readBinary(bool swapByteOrder,
-                           std::istream& inp,
-                           std::size_t offset,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        std::string t = types[j];
-        switch (sizes[j]) {
-        case 1:
-            if (t == "char" || t == "int8")
-                converters.push_back(convert_int8);
-            else if (t == "uchar" || t == "uint8")
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == "short" || t == "int16")
-                converters.push_back(convert_int16);
-            else if (t == "ushort" || t == "uint16")
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == "int" || t == "int32")
-                converters.push_back(convert_int32);
-            else if (t == "uint" || t == "uint32")
-                converters.push_back(convert_uint32);
-            else if (t == "float" || t == "float32")
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == "double" || t == "float64")
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(static_cast<std::streamoff>(offset), std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
-
-    Base::InputStream str(inp);
-    str.setByteOrder(swapByteOrder ? Base::Stream::BigEndian : Base::Stream::LittleEndian);
-    for (std::size_t i=0; i<numPoints; i++) {
-        for (std::size_t j=0; j<numFields; j++) {
-            double value = converters[j]->toDouble(str);
-            data(i, j) = value;
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 PcdReader::PcdReader()
@@ -958,155 +1466,89 @@ void PcdReader::read(const std::string& filename)
     std::vector<std::string> fields;
     std::vector<std::string> types;
     std::vector<int> sizes;
-    std::size_t numPoints = readHeader(inp, format, fields, types, sizes);
+    std::vector<int> counts;
+    std::size_t numPoints = readHeader(inp, format, fields, types, sizes, counts);
+    std::streamoff header = inp.tellg();
+    inp.close();
+
+    std::vector<FieldType> fieldTypes;
+    for (std::size_t i=0; i<types.size(); i++)
+        fieldTypes.push_back(pcdFieldType(types[i], sizes[i]));
+
+    FieldMap map(fields, fieldTypes);
+    if (!map.hasPoints() || numPoints == 0 || header < 0)
+        return;
+
+    // a field may consist of several elements of which only the first one is used
+    std::vector<std::size_t> columns, offsets, steps;
+    std::size_t numColumns = 0;
+    std::size_t stride = 0;
+    for (std::size_t i=0; i<fieldTypes.size(); i++) {
+        std::size_t count = static_cast<std::size_t>(std::max(counts[i], 1));
+        columns.push_back(numColumns);
+        offsets.push_back(stride);
+        steps.push_back(fieldSize(fieldTypes[i]) * count);
+        numColumns += count;
+        stride += steps.back();
+    }
+
+    MappedFile file(filename);
+    const char* data = file.data() + header;
+    const char* end = file.data() + file.size();
+    LoadFilter filter(subsampling, cropping, boundBox);
+    PointColumns cols;
 
-    Eigen::MatrixXd data(numPoints, fields.size());
     if (format == "ascii") {
-        readAscii(inp, data);
+        TextRecords source(map, columns);
+        std::vector<Block> blocks = source.blocks(data, end, numPoints);
+        loadRecords(source, blocks, map, filter, cols);
     }
     else if (format == "binary") {
-        readBinary(false, inp, types, sizes, data);
+        std::size_t avail = file.size() - std::min(static_cast<std::size_t>(header), file.size());
+        if (!fitsInto(numPoints, stride, avail))
+            throw Base::BadFormatError("File expects too many elements");
+
+        // the records are stored one after the other
+        std::vector<std::size_t> rowSteps(offsets.size(), stride);
+        BinaryRecords source(data, map, offsets, rowSteps, isBigEndianHost());
+        std::vector<Block> blocks = source.blocks(numPoints);
+        loadRecords(source, blocks, map, filter, cols);
     }
     else if (format == "binary_compressed") {
-        unsigned int c, u;
-        Base::InputStream str(inp);
-        str >> c >> u;
+        if (end - data < 8)
+            throw Base::BadFormatError("File expects too many elements");
+
+        uint32_t c = loadValue<uint32_t>(data, isBigEndianHost());
+        uint32_t u = loadValue<uint32_t>(data + 4, isBigEndianHost());
+        if (static_cast<std::size_t>(end - data - 8) < c)
+            throw Base::BadFormatError("File expects too many elements");
+        if (!fitsInto(numPoints, stride, u))
+            throw Base::BadFormatError("File expects too many elements");
 
-        std::vector<char> compressed(c);
-        inp.read(&compressed[0], c);
         std::vector<char> uncompressed(u);
-        if (lzfDecompress(&compressed[0], c, &uncompressed[0], u) == u) {
-            DataStreambuf ibuf(uncompressed);
-            std::istream istr(0);
-            istr.rdbuf(&ibuf);
-            readBinary(true, istr, types, sizes, data);
-        }
-        else {
+        if (lzfDecompress(data + 8, c, &uncompressed[0], u) != u)
             throw Base::BadFormatError("Failed to decompress binary data");
-        }
-    }
 
-    std::vector<std::string>::iterator it;
-    std::size_t max_size = std::numeric_limits<std::size_t>::max();
-
-    // x field
-    std::size_t x = max_size;
-    it = std::find(fields.begin(), fields.end(), "x");
-    if (it != fields.end())
-        x = std::distance(fields.begin(), it);
-
-    // y field
-    std::size_t y = max_size;
-    it = std::find(fields.begin(), fields.end(), "y");
-    if (it != fields.end())
-        y = std::distance(fields.begin(), it);
-
-    // z field
-    std::size_t z = max_size;
-    it = std::find(fields.begin(), fields.end(), "z");
-    if (it != fields.end())
-        z = std::distance(fields.begin(), it);
-
-    // normal x field
-    std::size_t normal_x = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_x");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nx");
-    if (it != fields.end())
-        normal_x = std::distance(fields.begin(), it);
-
-    // normal y field
-    std::size_t normal_y = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_y");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "ny");
-    if (it != fields.end())
-        normal_y = std::distance(fields.begin(), it);
-
-    // normal z field
-    std::size_t normal_z = max_size;
-    it = std::find(fields.begin(), fields.end(), "normal_z");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "nz");
-    if (it != fields.end())
-        normal_z = std::distance(fields.begin(), it);
-
-    // intensity field
-    std::size_t greyvalue = max_size;
-    it = std::find(fields.begin(), fields.end(), "intensity");
-    if (it != fields.end())
-        greyvalue = std::distance(fields.begin(), it);
-
-    // rgb(a) field
-    std::size_t rgba = max_size;
-    it = std::find(fields.begin(), fields.end(), "rgb");
-    if (it == fields.end())
-        it = std::find(fields.begin(), fields.end(), "rgba");
-    if (it != fields.end())
-        rgba = std::distance(fields.begin(), it);
-
-    // transfer the data
-    bool hasData = (x != max_size && y != max_size && z != max_size);
-    bool hasNormal = (normal_x != max_size && normal_y != max_size && normal_z != max_size);
-    bool hasIntensity = (greyvalue != max_size);
-    bool hasColor = (rgba != max_size);
-
-    if (hasData) {
-        points.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            points.push_back(Base::Vector3d(data(i,x),data(i,y),data(i,z)));
-        }
-    }
-
-    if (hasData && hasNormal) {
-        normals.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            normals.push_back(Base::Vector3f(data(i,normal_x),data(i,normal_y),data(i,normal_z)));
-        }
+        // each field is stored for all points before the next field
+        for (std::size_t i=0; i<offsets.size(); i++)
+            offsets[i] *= numPoints;
+        BinaryRecords source(&uncompressed[0], map, offsets, steps, isBigEndianHost());
+        std::vector<Block> blocks = source.blocks(numPoints);
+        loadRecords(source, blocks, map, filter, cols);
     }
-
-    if (hasData && hasIntensity) {
-        intensity.reserve(numPoints);
-        for (std::size_t i=0; i<numPoints; i++) {
-            intensity.push_back(data(i,greyvalue));
-        }
+    else {
+        throw Base::BadFormatError("Unsupported data format");
     }
 
-    if (hasData && hasColor) {
-        colors.reserve(numPoints);
-        if (types[rgba] == "U") {
-            for (std::size_t i=0; i<numPoints; i++) {
-                uint32_t packed = static_cast<uint32_t>(data(i,rgba));
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
-        else if (types[rgba] == "F") {
-            union RGBA {
-                uint32_t u;
-                float f;
-            };
+    points.swap(cols.points);
+    normals.swap(cols.normals);
+    intensity.swap(cols.intensity);
+    colors.swap(cols.colors);
 
-            union RGBA v;
-            for (std::size_t i=0; i<numPoints; i++) {
-                v.f = static_cast<float>(data(i,rgba));
-                uint32_t packed = v.u;
-                uint32_t a = (packed >> 24) & 0xff;
-                uint32_t r = (packed >> 16) & 0xff;
-                uint32_t g = (packed >> 8) & 0xff;
-                uint32_t b = packed & 0xff;
-                colors.push_back(App::Color(static_cast<float>(r)/255.0f,
-                                            static_cast<float>(g)/255.0f,
-                                            static_cast<float>(b)/255.0f,
-                                            static_cast<float>(a)/255.0f));
-            }
-        }
+    // a subset of an organized point cloud has no structure anymore
+    if (isFiltered()) {
+        this->width = static_cast<int>(points.size());
+        this->height = 1;
     }
 }
 
@@ -1114,10 +1556,10 @@ std::size_t PcdReader::readHeader(std::istream& in,
                                   std::string& format,
                                   std::vector<std::string>& fields,
                                   std::vector<std::string>& types,
-                                  std::vector<int>& sizes)
+                                  std::vector<int>& sizes,
+                                  std::vector<int>& counts)
 {
     std::string line;
-    std::vector<std::string> counts;
     std::vector<std::string> list;
     std::size_t points = 0;
 
@@ -1151,7 +1593,7 @@ std::size_t PcdReader::readHeader(std::istream& in,
         }
         else if (kw == "COUNT") {
             for (std::size_t i=1; i<list.size(); i++) {
-                counts.push_back(list[i]);
+                counts.push_back(boost::lexical_cast<int>(list[i]));
             }
         }
         else if (kw == "WIDTH") {
@@ -1182,124 +1624,6 @@ std::size_t PcdReader::readHeader(std::istream& in,
     return points;
 }
 
-void PcdReader::readAscii(std::istream& inp, Eigen::MatrixXd& data)
-{
-    std::string line;
-    std::size_t row = 0;
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-    std::vector<std::string> list;
-    while (std::getline(inp, line) && row < numPoints) {
-        if (line.empty())
-            continue;
-
-        // since the file is loaded in binary mode we may get the CR at the end
-        boost::trim(line);
-        boost::split(list, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-
-        std::istringstream str(line);
-
-        for (std::size_t col = 0; col < list.size() && col < numFields; col++) {
-            double value = boost::lexical_cast<double>(list[col]);
-            data(row, col) = value;
-        }
-
-        ++row;
-    }
-}
-
-void PcdReader::readBinary(bool transpose,
-                           std::istream& inp,
-                           const std::vector<std::string>& types,
-                           const std::vector<int>& sizes,
-                           Eigen::MatrixXd& data)
-{
-    std::size_t numPoints = data.rows();
-    std::size_t numFields = data.cols();
-
-    int neededSize = 0;
-    ConverterPtr convert_float32(new ConverterT<float>);
-    ConverterPtr convert_float64(new ConverterT<double>);
-    ConverterPtr convert_int8(new ConverterT<int8_t>);
-    ConverterPtr convert_uint8(new ConverterT<uint8_t>);
-    ConverterPtr convert_int16(new ConverterT<int16_t>);
-    ConverterPtr convert_uint16(new ConverterT<uint16_t>);
-    ConverterPtr convert_int32(new ConverterT<int32_t>);
-    ConverterPtr convert_uint32(new ConverterT<uint32_t>);
-
-    std::vector<ConverterPtr> converters;
-    for (std::size_t j=0; j<numFields; j++) {
-        char t = types[j][0];
-        switch (sizes[j]) {
-        case 1:
-            if (t == 'I')
-                converters.push_back(convert_int8);
-            else if (t == 'U')
-                converters.push_back(convert_uint8);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 2:
-            if (t == 'I')
-                converters.push_back(convert_int16);
-            else if (t == 'U')
-                converters.push_back(convert_uint16);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 4:
-            if (t == 'I')
-                converters.push_back(convert_int32);
-            else if (t == 'U')
-                converters.push_back(convert_uint32);
-            else if (t == 'F')
-                converters.push_back(convert_float32);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        case 8:
-            if (t == 'F')
-                converters.push_back(convert_float64);
-            else
-                throw Base::BadFormatError("Unexpected type");
-            break;
-        default:
-            throw Base::BadFormatError("Unexpected type");
-        }
-
-        neededSize += converters.back()->getSizeOf();
-    }
-
-    std::streamoff ulSize = 0;
-    std::streamoff ulCurr = 0;
-    std::streambuf* buf = inp.rdbuf();
-    if (buf) {
-        ulCurr = buf->pubseekoff(0, std::ios::cur, std::ios::in);
-        ulSize = buf->pubseekoff(0, std::ios::end, std::ios::in);
-        buf->pubseekoff(ulCurr, std::ios::beg, std::ios::in);
-        if (ulCurr + neededSize*static_cast<std::streamoff>(numPoints) > ulSize)
-            throw Base::BadFormatError("File expects too many elements");
-    }
-
-    Base::InputStream str(inp);
-    if (transpose) {
-        for (std::size_t j=0; j<numFields; j++) {
-            for (std::size_t i=0; i<numPoints; i++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-    else {
-        for (std::size_t i=0; i<numPoints; i++) {
-            for (std::size_t j=0; j<numFields; j++) {
-                double value = converters[j]->toDouble(str);
-                data(i, j) = value;
-            }
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 
 Writer::Writer(const PointKernel& p) : points(p)
@@ -51,6 +51,13 @@ public:
     virtual ~Reader();
     virtual void read(const std::string& filename) = 0;
 
+    /// Only load every n-th point of the file
+    void setSubsampling(std::size_t step);
+    /// Only load the points inside the box, an invalid box loads all points
+    void setBoundBox(const Base::BoundBox3d&);
+    /// True if not all points of the file are loaded
+    bool isFiltered() const;
+
     void clear();
     const PointKernel& getPoints() const;
     bool hasProperties() const;
@@ -70,6 +77,9 @@ protected:
     std::vector<App::Color> colors;
     std::vector<Base::Vector3f> normals;
     int width, height;
+    std::size_t subsampling;
+    bool cropping;
+    Base::BoundBox3d boundBox;
 };
 
 class AscReader : public Reader
@@ -91,11 +101,6 @@ private:
     std::size_t readHeader(std::istream&, std::string& format, std::size_t& offset,
         std::vector<std::string>& fields, std::vector<std::string>& types,
         std::vector<int>& sizes);
-    void readAscii(std::istream&, std::size_t offset, Eigen::MatrixXd& data);
-    void readBinary(bool swapByteOrder, std::istream&, std::size_t offset,
-        const std::vector<std::string>& types,
-        const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
 };
 
 class PcdReader : public Reader
@@ -107,12 +112,7 @@ public:
 
 private:
     std::size_t readHeader(std::istream&, std::string& format, std::vector<std::string>& fields,
-        std::vector<std::string>& types, std::vector<int>& sizes);
-    void readAscii(std::istream&, Eigen::MatrixXd& data);
-    void readBinary(bool transpose, std::istream&,
-        const std::vector<std::string>& types,
-        const std::vector<int>& sizes,
-        Eigen::MatrixXd& data);
+        std::vector<std::string>& types, std::vector<int>& sizes, std::vector<int>& counts);
 };
 
 class Writer
@@ -0,0 +1,268 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <limits>
+#endif
+
+#include <Eigen/Eigenvalues>
+
+#include <Base/Exception.h>
+
+#include "Points.h"
+#include "PointsAnalysis.h"
+#include "PointsKdTree.h"
+#include "PointsParallel.h"
+
+using namespace Points;
+
+namespace {
+
+// the number of points whose neighbours are searched in one go, this bounds
+// the memory of the search results
+const std::size_t ChunkSize = 1 << 18;
+// the number of points a thread processes in one go
+const std::size_t BlockSize = 4096;
+
+// Returns the number of blocks of at most BlockSize points
+int CountBlocks(std::size_t count)
+{
+    return static_cast<int>((count + BlockSize - 1) / BlockSize);
+}
+
+struct EstimateNormals
+{
+    EstimateNormals(const std::vector<Base::Vector3f>& points, std::size_t offset,
+                    const std::vector<unsigned long>& offsets, const std::vector<unsigned long>& indices,
+                    const Base::Vector3d& viewPoint, Base::Vector3d* normals)
+      : points(points), offset(offset), offsets(offsets), indices(indices)
+      , viewPoint(viewPoint), normals(normals)
+    {
+    }
+    void operator()(std::size_t first, std::size_t last, int) const
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t i = first; i < last; i++) {
+            Base::Vector3d& normal = normals[offset + i];
+            normal.Set(nan, nan, nan);
+
+            // the indices of the neighbours of the i-th point are in [begin, end)
+            unsigned long begin = offsets[i], end = offsets[i + 1];
+            while (end > begin && indices[end - 1] == PointsKdTree::NoPoint)
+                end--;
+            if (end - begin < 3)
+                continue;
+
+            Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+            for (unsigned long j = begin; j < end; j++) {
+                const Base::Vector3f& p = points[indices[j]];
+                mean += Eigen::Vector3d(p.x, p.y, p.z);
+            }
+            mean /= static_cast<double>(end - begin);
+
+            Eigen::Matrix3d covMat = Eigen::Matrix3d::Zero();
+            for (unsigned long j = begin; j < end; j++) {
+                const Base::Vector3f& p = points[indices[j]];
+                Eigen::Vector3d d = Eigen::Vector3d(p.x, p.y, p.z) - mean;
+                covMat += d * d.transpose();
+            }
+
+            // the eigenvalues are sorted in increasing order
+            Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(covMat);
+            Eigen::Vector3d w = eig.eigenvectors().col(0);
+            normal.Set(w.x(), w.y(), w.z());
+
+            const Base::Vector3f& p = points[offset + i];
+            Base::Vector3d toView = viewPoint - Base::Vector3d(p.x, p.y, p.z);
+            if (normal * toView < 0.0)
+                normal = -normal;
+        }
+    }
+
+    const std::vector<Base::Vector3f>& points;
+    std::size_t offset;
+    const std::vector<unsigned long>& offsets;
+    const std::vector<unsigned long>& indices;
+    Base::Vector3d viewPoint;
+    Base::Vector3d* normals;
+};
+
+struct MeanDistances
+{
+    MeanDistances(std::size_t offset, unsigned long k, const std::vector<unsigned long>& indices,
+                  const std::vector<float>& sqrDistances, double* distances)
+      : offset(offset), k(k), indices(indices), sqrDistances(sqrDistances), distances(distances)
+    {
+    }
+    void operator()(std::size_t first, std::size_t last, int) const
+    {
+        for (std::size_t i = first; i < last; i++) {
+            // the first neighbour is the point itself, a negative distance
+            // marks a point without neighbours
+            double sum = 0.0;
+            unsigned long count = 0;
+            for (unsigned long j = i * k + 1; j < (i + 1) * k; j++) {
+                if (indices[j] == PointsKdTree::NoPoint)
+                    break;
+                sum += std::sqrt(sqrDistances[j]);
+                count++;
+            }
+            distances[offset + i] = count > 0 ? sum / count : -1.0;
+        }
+    }
+
+    std::size_t offset;
+    unsigned long k;
+    const std::vector<unsigned long>& indices;
+    const std::vector<float>& sqrDistances;
+    double* distances;
+};
+
+std::vector<Base::Vector3f> GlobalPoints(const PointKernel& kernel)
+{
+    std::vector<Base::Vector3f> points = kernel.getBasicPoints();
+    Base::Matrix4D mat = kernel.getTransform();
+    if (mat != Base::Matrix4D())
+        PointsParallel::Transform(points, mat);
+    return points;
+}
+
+}
+
+// ----------------------------------------------------------------------------
+
+NormalEstimation::NormalEstimation(const PointKernel& pts)
+  : myPoints(pts)
+  , kSearch(0)
+  , searchRadius(0)
+{
+}
+
+NormalEstimation::~NormalEstimation()
+{
+}
+
+void NormalEstimation::perform(std::vector<Base::Vector3d>& normals) const
+{
+    if (kSearch <= 0 && searchRadius <= 0)
+        throw Base::ValueError("Either the number of neighbours or the search radius must be set");
+
+    std::vector<Base::Vector3f> points = GlobalPoints(myPoints);
+    normals.resize(points.size());
+
+    PointsKdTree tree;
+    tree.Build(points);
+
+    std::vector<unsigned long> offsets, indices;
+    std::vector<float> sqrDistances;
+    for (std::size_t chunk = 0; chunk < points.size(); chunk += ChunkSize) {
+        std::vector<Base::Vector3f> queries(points.begin() + chunk,
+            points.begin() + std::min(chunk + ChunkSize, points.size()));
+
+        if (kSearch > 0) {
+            unsigned long k = static_cast<unsigned long>(kSearch);
+            tree.FindNearest(queries, k, indices, searchRadius > 0 ? &sqrDistances : 0);
+            offsets.resize(queries.size() + 1);
+            for (std::size_t i = 0; i < offsets.size(); i++)
+                offsets[i] = i * k;
+
+            // keep the nearest points within the radius
+            if (searchRadius > 0) {
+                float sqrRadius = static_cast<float>(searchRadius * searchRadius);
+                for (std::size_t i = 0; i < indices.size(); i++) {
+                    if (sqrDistances[i] > sqrRadius)
+                        indices[i] = PointsKdTree::NoPoint;
+                }
+            }
+        }
+        else {
+            tree.FindInRadius(queries, static_cast<float>(searchRadius), offsets, indices);
+        }
+
+        PointsParallel::ForBlocks(queries.size(), CountBlocks(queries.size()),
+            EstimateNormals(points, chunk, offsets, indices, viewPoint, &normals[0]));
+    }
+}
+
+// ----------------------------------------------------------------------------
+
+OutlierRemoval::OutlierRemoval(const PointKernel& pts)
+  : myPoints(pts)
+  , meanK(8)
+  , stddevMul(1.0)
+{
+}
+
+OutlierRemoval::~OutlierRemoval()
+{
+}
+
+void OutlierRemoval::perform(std::vector<unsigned long>& outliers) const
+{
+    outliers.clear();
+    if (meanK <= 0)
+        throw Base::ValueError("The number of neighbours must be positive");
+
+    std::vector<Base::Vector3f> points = GlobalPoints(myPoints);
+    std::vector<double> distances(points.size());
+
+    PointsKdTree tree;
+    tree.Build(points);
+
+    // the point itself is found as well
+    unsigned long k = static_cast<unsigned long>(meanK) + 1;
+    std::vector<unsigned long> indices;
+    std::vector<float> sqrDistances;
+    for (std::size_t chunk = 0; chunk < points.size(); chunk += ChunkSize) {
+        std::vector<Base::Vector3f> queries(points.begin() + chunk,
+            points.begin() + std::min(chunk + ChunkSize, points.size()));
+        tree.FindNearest(queries, k, indices, &sqrDistances);
+
+        PointsParallel::ForBlocks(queries.size(), CountBlocks(queries.size()),
+            MeanDistances(chunk, k, indices, sqrDistances, &distances[0]));
+    }
+
+    double sum = 0.0, sqrSum = 0.0;
+    std::size_t count = 0;
+    for (std::vector<double>::iterator it = distances.begin(); it != distances.end(); ++it) {
+        if (*it < 0.0)
+            continue;
+        sum += *it;
+        sqrSum += *it * *it;
+        count++;
+    }
+    if (count < 2)
+        return;
+
+    double mean = sum / count;
+    double variance = (sqrSum - sum * sum / count) / (count - 1);
+    double threshold = mean + stddevMul * std::sqrt(std::max(variance, 0.0));
+    for (std::size_t i = 0; i < distances.size(); i++) {
+        if (distances[i] > threshold)
+            outliers.push_back(i);
+    }
+}
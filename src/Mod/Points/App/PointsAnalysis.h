@@ -0,0 +1,108 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef POINTS_ANALYSIS_H
+#define POINTS_ANALYSIS_H
+
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+namespace Points
+{
+class PointKernel;
+
+/**
+ * The NormalEstimation class estimates the normal of each point of a point
+ * cloud as the direction of least variance of its neighbours. The neighbours
+ * are either the k nearest points or the points within a radius or, if both
+ * are set, the k nearest points within the radius. The normals are oriented
+ * towards the view point.
+ * @author FreeCAD Developers
+ */
+class PointsExport NormalEstimation
+{
+public:
+    NormalEstimation(const PointKernel&);
+    ~NormalEstimation();
+
+    void setKSearch(int k)
+    {
+        kSearch = k;
+    }
+    void setSearchRadius(double radius)
+    {
+        searchRadius = radius;
+    }
+    void setViewPoint(const Base::Vector3d& pnt)
+    {
+        viewPoint = pnt;
+    }
+    /** Computes one normal per point in global coordinates. The normal of an
+     * invalid point or of a point with less than three neighbours is set to
+     * NaN. Throws Base::ValueError if neither k nor the radius is set.
+     */
+    void perform(std::vector<Base::Vector3d>& normals) const;
+
+private:
+    const PointKernel& myPoints;
+    int kSearch;
+    double searchRadius;
+    Base::Vector3d viewPoint;
+};
+
+/**
+ * The OutlierRemoval class finds isolated points of a point cloud. For each
+ * point the mean distance to its k nearest neighbours is computed. A point is
+ * an outlier if its mean distance exceeds the mean of all mean distances by
+ * more than a multiple of their standard deviation.
+ * @author FreeCAD Developers
+ */
+class PointsExport OutlierRemoval
+{
+public:
+    OutlierRemoval(const PointKernel&);
+    ~OutlierRemoval();
+
+    void setMeanK(int k)
+    {
+        meanK = k;
+    }
+    void setStddevMulThresh(double mul)
+    {
+        stddevMul = mul;
+    }
+    /// Computes the sorted indices of the outliers. Invalid points are not reported.
+    void perform(std::vector<unsigned long>& outliers) const;
+
+private:
+    const PointKernel& myPoints;
+    int meanK;
+    double stddevMul;
+};
+
+} // namespace Points
+
+
+#endif // POINTS_ANALYSIS_H
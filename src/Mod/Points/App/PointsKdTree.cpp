@@ -0,0 +1,509 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <limits>
+#endif
+
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <QtConcurrentMap>
+
+#include <Base/Matrix.h>
+
+#include "Points.h"
+#include "PointsKdTree.h"
+
+using namespace Points;
+
+namespace {
+
+// the maximum number of points of a leaf
+const unsigned long LeafSize = 16;
+// the number of queries a thread answers in one go
+const std::size_t BatchSize = 1024;
+
+bool IsValid(const Base::Vector3f& p)
+{
+    return !(boost::math::isnan(p.x) || boost::math::isnan(p.y) || boost::math::isnan(p.z));
+}
+
+struct SplitJob
+{
+    unsigned long node;
+    unsigned long begin;
+    unsigned long end;
+    unsigned char axis;
+    float split;
+};
+
+struct SplitNode
+{
+    SplitNode(PointsKdTree::Entry* entries) : entries(entries)
+    {
+    }
+    void operator()(SplitJob& job) const
+    {
+        PointsKdTree::Entry* begin = entries + job.begin;
+        PointsKdTree::Entry* end = entries + job.end;
+
+        // split along the axis with the largest extent
+        float minCoord[3], maxCoord[3];
+        for (int k = 0; k < 3; k++)
+            minCoord[k] = maxCoord[k] = begin->coord[k];
+        for (PointsKdTree::Entry* it = begin + 1; it != end; ++it) {
+            for (int k = 0; k < 3; k++) {
+                minCoord[k] = std::min(minCoord[k], it->coord[k]);
+                maxCoord[k] = std::max(maxCoord[k], it->coord[k]);
+            }
+        }
+        unsigned char axis = 0;
+        for (unsigned char k = 1; k < 3; k++) {
+            if (maxCoord[k] - minCoord[k] > maxCoord[axis] - minCoord[axis])
+                axis = k;
+        }
+
+        PointsKdTree::Entry* mid = begin + (end - begin) / 2;
+        std::nth_element(begin, mid, end, CompareCoord(axis));
+        job.axis = axis;
+        job.split = mid->coord[axis];
+    }
+
+    struct CompareCoord
+    {
+        CompareCoord(unsigned char axis) : axis(axis)
+        {
+        }
+        bool operator()(const PointsKdTree::Entry& a, const PointsKdTree::Entry& b) const
+        {
+            return a.coord[axis] < b.coord[axis];
+        }
+        unsigned char axis;
+    };
+
+    PointsKdTree::Entry* entries;
+};
+
+struct CompareNeighbour
+{
+    bool operator()(const PointsKdTree::Neighbour& a, const PointsKdTree::Neighbour& b) const
+    {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    }
+};
+
+}
+
+// A batch is a run of queries that fall into neighbouring leaves.
+struct PointsKdTree::Batch
+{
+    // the positions of the queries in the input
+    std::vector<unsigned long> queries;
+    // the neighbours of all queries of the batch one after another
+    std::vector<Neighbour> found;
+    // the number of neighbours of each query
+    std::vector<unsigned long> counts;
+};
+
+namespace {
+
+struct NearestBatch
+{
+    NearestBatch(const PointsKdTree* tree, const std::vector<Base::Vector3f>& pnts, unsigned long k,
+                 unsigned long* indices, float* sqrDistances)
+      : tree(tree), pnts(pnts), k(k), indices(indices), sqrDistances(sqrDistances)
+    {
+    }
+    void operator()(PointsKdTree::Batch& batch) const
+    {
+        std::vector<unsigned long> found;
+        std::vector<float> dist;
+        for (std::vector<unsigned long>::const_iterator it = batch.queries.begin(); it != batch.queries.end(); ++it) {
+            tree->FindNearest(pnts[*it], k, found, sqrDistances ? &dist : 0);
+            std::copy(found.begin(), found.end(), indices + *it * k);
+            if (sqrDistances)
+                std::copy(dist.begin(), dist.end(), sqrDistances + *it * k);
+        }
+    }
+
+    const PointsKdTree* tree;
+    const std::vector<Base::Vector3f>& pnts;
+    unsigned long k;
+    unsigned long* indices;
+    float* sqrDistances;
+};
+
+struct RadiusBatch
+{
+    RadiusBatch(const PointsKdTree* tree, const std::vector<Base::Vector3f>& pnts, float radius)
+      : tree(tree), pnts(pnts), radius(radius)
+    {
+    }
+    void operator()(PointsKdTree::Batch& batch) const
+    {
+        std::vector<unsigned long> found;
+        std::vector<float> dist;
+        for (std::vector<unsigned long>::const_iterator it = batch.queries.begin(); it != batch.queries.end(); ++it) {
+            tree->FindInRadius(pnts[*it], radius, found, &dist);
+            for (std::size_t i = 0; i < found.size(); i++)
+                batch.found.push_back(PointsKdTree::Neighbour(dist[i], found[i]));
+            batch.counts.push_back(found.size());
+        }
+    }
+
+    const PointsKdTree* tree;
+    const std::vector<Base::Vector3f>& pnts;
+    float radius;
+};
+
+}
+
+const unsigned long PointsKdTree::NoPoint = std::numeric_limits<unsigned long>::max();
+
+PointsKdTree::PointsKdTree()
+{
+}
+
+PointsKdTree::~PointsKdTree()
+{
+}
+
+void PointsKdTree::Clear()
+{
+    std::vector<Entry>().swap(_entries);
+    std::vector<unsigned char>().swap(_axes);
+    std::vector<float>().swap(_splits);
+    std::vector<unsigned long>().swap(_leaves);
+}
+
+void PointsKdTree::Build(const PointKernel& kernel)
+{
+    Clear();
+
+    // collect the valid points in global coordinates
+    const std::vector<PointKernel::value_type>& points = kernel.getBasicPoints();
+    Base::Matrix4D mat = kernel.getTransform();
+    bool transform = mat != Base::Matrix4D();
+    _entries.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        Base::Vector3f p = points[i];
+        if (!IsValid(p))
+            continue;
+        if (transform) {
+            Base::Vector3d v = mat * Base::Vector3d(p.x, p.y, p.z);
+            p.Set(static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z));
+        }
+        Entry entry;
+        entry.coord[0] = p.x;
+        entry.coord[1] = p.y;
+        entry.coord[2] = p.z;
+        entry.index = i;
+        _entries.push_back(entry);
+    }
+
+    BuildTree();
+}
+
+void PointsKdTree::Build(const std::vector<Base::Vector3f>& points)
+{
+    Clear();
+
+    _entries.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const Base::Vector3f& p = points[i];
+        if (!IsValid(p))
+            continue;
+        Entry entry;
+        entry.coord[0] = p.x;
+        entry.coord[1] = p.y;
+        entry.coord[2] = p.z;
+        entry.index = i;
+        _entries.push_back(entry);
+    }
+
+    BuildTree();
+}
+
+void PointsKdTree::BuildTree()
+{
+    if (_entries.empty())
+        return;
+
+    // the depth of the tree such that no leaf holds more than LeafSize points
+    unsigned long numLeaves = 1;
+    while ((_entries.size() + numLeaves - 1) / numLeaves > LeafSize)
+        numLeaves *= 2;
+
+    unsigned long numInner = numLeaves - 1;
+    _axes.resize(numInner);
+    _splits.resize(numInner);
+
+    // split the nodes level by level, the nodes of a level are split in parallel
+    std::vector<SplitJob> jobs(1);
+    jobs[0].node = 0;
+    jobs[0].begin = 0;
+    jobs[0].end = _entries.size();
+    SplitNode split(&_entries[0]);
+    while (jobs.front().node < numInner) {
+        if (jobs.size() > 1) {
+            QtConcurrent::blockingMap(jobs, split);
+        }
+        else {
+            split(jobs.front());
+        }
+
+        std::vector<SplitJob> children;
+        children.reserve(2 * jobs.size());
+        for (std::vector<SplitJob>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+            _axes[it->node] = it->axis;
+            _splits[it->node] = it->split;
+
+            unsigned long mid = it->begin + (it->end - it->begin) / 2;
+            SplitJob left;
+            left.node = 2 * it->node + 1;
+            left.begin = it->begin;
+            left.end = mid;
+            children.push_back(left);
+
+            SplitJob right;
+            right.node = 2 * it->node + 2;
+            right.begin = mid;
+            right.end = it->end;
+            children.push_back(right);
+        }
+        jobs.swap(children);
+    }
+
+    _leaves.reserve(numLeaves + 1);
+    for (std::vector<SplitJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+        _leaves.push_back(it->begin);
+    _leaves.push_back(_entries.size());
+}
+
+unsigned long PointsKdTree::CountPoints() const
+{
+    return _entries.size();
+}
+
+unsigned long PointsKdTree::FindLeaf(const float* pnt) const
+{
+    unsigned long node = 0;
+    unsigned long numInner = _axes.size();
+    while (node < numInner)
+        node = pnt[_axes[node]] < _splits[node] ? 2 * node + 1 : 2 * node + 2;
+    return node - numInner;
+}
+
+void PointsKdTree::SearchNearest(unsigned long node, const float* pnt, unsigned long k,
+                                 std::vector<Neighbour>& heap) const
+{
+    unsigned long numInner = _axes.size();
+    if (node >= numInner) {
+        unsigned long leaf = node - numInner;
+        for (unsigned long i = _leaves[leaf]; i < _leaves[leaf + 1]; i++) {
+            const Entry& entry = _entries[i];
+            float dx = entry.coord[0] - pnt[0];
+            float dy = entry.coord[1] - pnt[1];
+            float dz = entry.coord[2] - pnt[2];
+            Neighbour neighbour(dx * dx + dy * dy + dz * dz, entry.index);
+            if (heap.size() < k) {
+                heap.push_back(neighbour);
+                std::push_heap(heap.begin(), heap.end(), CompareNeighbour());
+            }
+            else if (CompareNeighbour()(neighbour, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), CompareNeighbour());
+                heap.back() = neighbour;
+                std::push_heap(heap.begin(), heap.end(), CompareNeighbour());
+            }
+        }
+        return;
+    }
+
+    // visit the side of the query point first, the other side only if it
+    // may hold a nearer point
+    float diff = pnt[_axes[node]] - _splits[node];
+    unsigned long first = diff < 0.0f ? 2 * node + 1 : 2 * node + 2;
+    unsigned long second = diff < 0.0f ? 2 * node + 2 : 2 * node + 1;
+    SearchNearest(first, pnt, k, heap);
+    if (heap.size() < k || diff * diff <= heap.front().first)
+        SearchNearest(second, pnt, k, heap);
+}
+
+void PointsKdTree::SearchRadius(unsigned long node, const float* pnt, float sqrRadius,
+                                std::vector<Neighbour>& result) const
+{
+    unsigned long numInner = _axes.size();
+    if (node >= numInner) {
+        unsigned long leaf = node - numInner;
+        for (unsigned long i = _leaves[leaf]; i < _leaves[leaf + 1]; i++) {
+            const Entry& entry = _entries[i];
+            float dx = entry.coord[0] - pnt[0];
+            float dy = entry.coord[1] - pnt[1];
+            float dz = entry.coord[2] - pnt[2];
+            float dist = dx * dx + dy * dy + dz * dz;
+            if (dist <= sqrRadius)
+                result.push_back(Neighbour(dist, entry.index));
+        }
+        return;
+    }
+
+    float diff = pnt[_axes[node]] - _splits[node];
+    if (diff <= 0.0f || diff * diff <= sqrRadius)
+        SearchRadius(2 * node + 1, pnt, sqrRadius, result);
+    if (diff >= 0.0f || diff * diff <= sqrRadius)
+        SearchRadius(2 * node + 2, pnt, sqrRadius, result);
+}
+
+void PointsKdTree::FindNearest(const Base::Vector3f& pnt, unsigned long k, std::vector<unsigned long>& indices,
+                               std::vector<float>* sqrDistances) const
+{
+    indices.clear();
+    if (sqrDistances)
+        sqrDistances->clear();
+    if (_entries.empty() || k == 0 || !IsValid(pnt))
+        return;
+
+    float coord[3] = { pnt.x, pnt.y, pnt.z };
+    std::vector<Neighbour> heap;
+    heap.reserve(std::min<unsigned long>(k, _entries.size()));
+    SearchNearest(0, coord, k, heap);
+    std::sort_heap(heap.begin(), heap.end(), CompareNeighbour());
+
+    indices.reserve(heap.size());
+    for (std::vector<Neighbour>::iterator it = heap.begin(); it != heap.end(); ++it)
+        indices.push_back(it->second);
+    if (sqrDistances) {
+        sqrDistances->reserve(heap.size());
+        for (std::vector<Neighbour>::iterator it = heap.begin(); it != heap.end(); ++it)
+            sqrDistances->push_back(it->first);
+    }
+}
+
+void PointsKdTree::FindInRadius(const Base::Vector3f& pnt, float radius, std::vector<unsigned long>& indices,
+                                std::vector<float>* sqrDistances) const
+{
+    indices.clear();
+    if (sqrDistances)
+        sqrDistances->clear();
+    if (_entries.empty() || radius < 0.0f || !IsValid(pnt))
+        return;
+
+    float coord[3] = { pnt.x, pnt.y, pnt.z };
+    std::vector<Neighbour> result;
+    SearchRadius(0, coord, radius * radius, result);
+    std::sort(result.begin(), result.end(), CompareNeighbour());
+
+    indices.reserve(result.size());
+    for (std::vector<Neighbour>::iterator it = result.begin(); it != result.end(); ++it)
+        indices.push_back(it->second);
+    if (sqrDistances) {
+        sqrDistances->reserve(result.size());
+        for (std::vector<Neighbour>::iterator it = result.begin(); it != result.end(); ++it)
+            sqrDistances->push_back(it->first);
+    }
+}
+
+void PointsKdTree::SortByLeaf(const std::vector<Base::Vector3f>& pnts, std::vector<Batch>& batches) const
+{
+    // invalid points have no neighbours and are left out
+    std::vector<std::pair<unsigned long, unsigned long> > order;
+    order.reserve(pnts.size());
+    for (std::size_t i = 0; i < pnts.size(); i++) {
+        if (!IsValid(pnts[i]))
+            continue;
+        float coord[3] = { pnts[i].x, pnts[i].y, pnts[i].z };
+        order.push_back(std::make_pair(FindLeaf(coord), i));
+    }
+    std::sort(order.begin(), order.end());
+
+    batches.resize((order.size() + BatchSize - 1) / BatchSize);
+    for (std::size_t i = 0; i < order.size(); i++)
+        batches[i / BatchSize].queries.push_back(order[i].second);
+}
+
+void PointsKdTree::FindNearest(const std::vector<Base::Vector3f>& pnts, unsigned long k,
+                               std::vector<unsigned long>& indices, std::vector<float>* sqrDistances) const
+{
+    indices.assign(pnts.size() * k, NoPoint);
+    if (sqrDistances)
+        sqrDistances->assign(pnts.size() * k, std::numeric_limits<float>::max());
+    if (_entries.empty() || k == 0)
+        return;
+
+    std::vector<Batch> batches;
+    SortByLeaf(pnts, batches);
+    NearestBatch search(this, pnts, k, &indices[0], sqrDistances ? &(*sqrDistances)[0] : 0);
+    if (batches.size() > 1) {
+        QtConcurrent::blockingMap(batches, search);
+    }
+    else if (batches.size() == 1) {
+        search(batches.front());
+    }
+}
+
+void PointsKdTree::FindInRadius(const std::vector<Base::Vector3f>& pnts, float radius,
+                                std::vector<unsigned long>& offsets, std::vector<unsigned long>& indices,
+                                std::vector<float>* sqrDistances) const
+{
+    offsets.assign(pnts.size() + 1, 0);
+    indices.clear();
+    if (sqrDistances)
+        sqrDistances->clear();
+    if (_entries.empty() || radius < 0.0f)
+        return;
+
+    std::vector<Batch> batches;
+    SortByLeaf(pnts, batches);
+    RadiusBatch search(this, pnts, radius);
+    if (batches.size() > 1) {
+        QtConcurrent::blockingMap(batches, search);
+    }
+    else if (batches.size() == 1) {
+        search(batches.front());
+    }
+
+    // the batches hold the queries in leaf order, bring them back into input order
+    for (std::vector<Batch>::iterator it = batches.begin(); it != batches.end(); ++it) {
+        for (std::size_t i = 0; i < it->queries.size(); i++)
+            offsets[it->queries[i] + 1] = it->counts[i];
+    }
+    for (std::size_t i = 0; i < pnts.size(); i++)
+        offsets[i + 1] += offsets[i];
+
+    indices.resize(offsets.back());
+    if (sqrDistances)
+        sqrDistances->resize(offsets.back());
+    for (std::vector<Batch>::iterator it = batches.begin(); it != batches.end(); ++it) {
+        std::vector<Neighbour>::const_iterator jt = it->found.begin();
+        for (std::size_t i = 0; i < it->queries.size(); i++) {
+            unsigned long pos = offsets[it->queries[i]];
+            for (unsigned long j = 0; j < it->counts[i]; j++, ++jt) {
+                indices[pos + j] = jt->second;
+                if (sqrDistances)
+                    (*sqrDistances)[pos + j] = jt->first;
+            }
+        }
+    }
+}
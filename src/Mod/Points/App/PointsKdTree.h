@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef POINTS_KDTREE_H
+#define POINTS_KDTREE_H
+
+#include <utility>
+#include <vector>
+
+#include <Base/Vector3D.h>
+
+namespace Points
+{
+class PointKernel;
+
+/**
+ * The PointsKdTree class answers k-nearest neighbour and radius queries on a
+ * point cloud. It is a balanced k-d tree that splits the points at the median
+ * of the axis with the largest extent until a leaf holds only a few points.
+ * The points are stored in the order of the leaves so that a leaf is scanned
+ * linearly.
+ *
+ * The queries of a batch are sorted by the leaf they fall into and are
+ * answered in parallel, so that consecutive queries of a thread visit the
+ * same part of the tree. A single query is answered in the calling thread.
+ * @author FreeCAD Developers
+ */
+class PointsExport PointsKdTree
+{
+public:
+    /// Marks an unused entry of the result of a k-nearest neighbour batch.
+    static const unsigned long NoPoint;
+
+    PointsKdTree();
+    ~PointsKdTree();
+
+    /// Builds the tree of the valid points of \a kernel in global coordinates.
+    void Build(const PointKernel& kernel);
+    /// Builds the tree of the valid points of \a points.
+    void Build(const std::vector<Base::Vector3f>& points);
+    void Clear();
+    /// Returns the number of points in the tree.
+    unsigned long CountPoints() const;
+
+    /** @name Queries
+     * The indices refer to the points the tree was built of and are sorted by
+     * the distance of the points. The squared distances are returned in the
+     * same order if \a sqrDistances is given.
+     */
+    //@{
+    /// Finds the \a k points nearest to \a pnt.
+    void FindNearest(const Base::Vector3f& pnt, unsigned long k, std::vector<unsigned long>& indices,
+                     std::vector<float>* sqrDistances = 0) const;
+    /// Finds the points whose distance to \a pnt is at most \a radius.
+    void FindInRadius(const Base::Vector3f& pnt, float radius, std::vector<unsigned long>& indices,
+                      std::vector<float>* sqrDistances = 0) const;
+    /** Finds the \a k nearest points for each point of \a pnts. The neighbours
+     * of the i-th point are stored at [i*k, (i+1)*k) of \a indices. If there
+     * are less than \a k points in the tree or the query point is invalid the
+     * remaining entries are set to NoPoint.
+     */
+    void FindNearest(const std::vector<Base::Vector3f>& pnts, unsigned long k,
+                     std::vector<unsigned long>& indices, std::vector<float>* sqrDistances = 0) const;
+    /** Finds the points within \a radius for each point of \a pnts. The
+     * neighbours of the i-th point are stored at [offsets[i], offsets[i+1])
+     * of \a indices.
+     */
+    void FindInRadius(const std::vector<Base::Vector3f>& pnts, float radius,
+                      std::vector<unsigned long>& offsets, std::vector<unsigned long>& indices,
+                      std::vector<float>* sqrDistances = 0) const;
+    //@}
+
+public:
+    struct Entry
+    {
+        float coord[3];
+        unsigned long index;
+    };
+    typedef std::pair<float, unsigned long> Neighbour;
+    // internal helper of the parallel queries
+    struct Batch;
+
+private:
+    void BuildTree();
+    unsigned long FindLeaf(const float* pnt) const;
+    void SearchNearest(unsigned long node, const float* pnt, unsigned long k,
+                       std::vector<Neighbour>& heap) const;
+    void SearchRadius(unsigned long node, const float* pnt, float sqrRadius,
+                      std::vector<Neighbour>& result) const;
+    void SortByLeaf(const std::vector<Base::Vector3f>& pnts, std::vector<Batch>& batches) const;
+
+private:
+    PointsKdTree(const PointsKdTree&);
+    void operator = (const PointsKdTree&);
+
+private:
+    // the points in the order of the leaves
+    std::vector<Entry> _entries;
+    // the split axis and value of the inner nodes in heap order, the
+    // children of node i are 2i+1 and 2i+2
+    std::vector<unsigned char> _axes;
+    std::vector<float> _splits;
+    // all leaves have the same depth, leaf i holds the entries in
+    // [_leaves[i], _leaves[i+1])
+    std::vector<unsigned long> _leaves;
+};
+
+} // namespace Points
+
+
+#endif // POINTS_KDTREE_H
@@ -0,0 +1,636 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <limits>
+#endif
+
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <QFile>
+#include <QtConcurrentMap>
+
+#include <Base/Matrix.h>
+
+#include "Points.h"
+#include "PointsOctree.h"
+
+using namespace Points;
+
+namespace {
+
+/*
+ * An octree file starts with an OctreeHeader followed by the nodes. Then come
+ * the coordinates of the points (three floats each) in sort order and after
+ * that, aligned to eight bytes, the indices of the points in the kernel.
+ */
+const uint32_t OctreeMagic = 0x4f504346; // "FCPO"
+const uint32_t OctreeVersion = 1;
+
+struct OctreeHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t numNodes;
+    uint64_t numPoints;
+    uint32_t pointsPerNode;
+    uint32_t numLevels;
+};
+
+// limits the depth for clouds with many equal points
+const unsigned int MaxLevels = 24;
+
+uint64_t CoordOffset(uint64_t numNodes)
+{
+    return sizeof(OctreeHeader) + numNodes * sizeof(PointsOctree::Node);
+}
+
+uint64_t IndexOffset(uint64_t numNodes, uint64_t numPoints)
+{
+    uint64_t offset = CoordOffset(numNodes) + 3 * sizeof(float) * numPoints;
+    return (offset + 7) & ~uint64_t(7);
+}
+
+Base::BoundBox3f GetBox(const float* box)
+{
+    return Base::BoundBox3f(box[0], box[1], box[2], box[3], box[4], box[5]);
+}
+
+// The cubic cell of a node while building
+struct Cell
+{
+    float center[3];
+    float half;
+};
+
+// A node to split into octants and the number of points of its octants
+struct SplitJob
+{
+    uint32_t node;
+    uint64_t begin;
+    uint64_t end;
+    Cell cell;
+    uint64_t counts[8];
+};
+
+inline int Octant(const float* p, const Cell& cell)
+{
+    return (p[0] >= cell.center[0] ? 1 : 0) |
+           (p[1] >= cell.center[1] ? 2 : 0) |
+           (p[2] >= cell.center[2] ? 4 : 0);
+}
+
+// Sorts the points of the job by octant in place
+struct SplitNode
+{
+    SplitNode(float* coords, uint64_t* indices)
+      : coords(coords), indices(indices) {}
+    void operator()(SplitJob& job) const
+    {
+        std::fill(job.counts, job.counts + 8, 0);
+        for (uint64_t i = job.begin; i < job.end; i++)
+            job.counts[Octant(coords + 3 * i, job.cell)]++;
+
+        uint64_t next[8], last[8];
+        uint64_t start = job.begin;
+        for (int o = 0; o < 8; o++) {
+            next[o] = start;
+            start += job.counts[o];
+            last[o] = start;
+        }
+
+        // move every point into the range of its octant by swapping
+        for (int o = 0; o < 8; o++) {
+            while (next[o] < last[o]) {
+                uint64_t i = next[o];
+                int octant = Octant(coords + 3 * i, job.cell);
+                if (octant == o) {
+                    next[o]++;
+                }
+                else {
+                    uint64_t j = next[octant]++;
+                    std::swap_ranges(coords + 3 * i, coords + 3 * i + 3, coords + 3 * j);
+                    std::swap(indices[i], indices[j]);
+                }
+            }
+        }
+    }
+
+    float* coords;
+    uint64_t* indices;
+};
+
+}
+
+PointsOctree::PointsOctree()
+  : _file(0), _map(0), _nodes(0), _coords(0), _indices(0)
+  , _numNodes(0), _numPoints(0), _pointsPerNode(0), _numLevels(0)
+{
+}
+
+PointsOctree::~PointsOctree()
+{
+    Clear();
+}
+
+void PointsOctree::Clear()
+{
+    if (_file) {
+        _file->unmap(_map);
+        delete _file;
+        _file = 0;
+        _map = 0;
+    }
+
+    std::vector<Node>().swap(_nodeArray);
+    std::vector<float>().swap(_coordArray);
+    std::vector<uint64_t>().swap(_indexArray);
+    SetData(0, 0, 0, 0, 0, 0);
+    _numLevels = 0;
+}
+
+void PointsOctree::SetData(const Node* nodes, uint64_t numNodes, const float* coords,
+                           const uint64_t* indices, uint64_t numPoints, uint32_t pointsPerNode)
+{
+    _nodes = nodes;
+    _numNodes = numNodes;
+    _coords = coords;
+    _indices = indices;
+    _numPoints = numPoints;
+    _pointsPerNode = pointsPerNode;
+}
+
+void PointsOctree::Build(const PointKernel& kernel, unsigned long pointsPerNode)
+{
+    Clear();
+    pointsPerNode = std::max<unsigned long>(pointsPerNode, 1);
+
+    // collect the valid points in global coordinates
+    const std::vector<PointKernel::value_type>& points = kernel.getBasicPoints();
+    Base::Matrix4D mat = kernel.getTransform();
+    bool transform = mat != Base::Matrix4D();
+    _coordArray.reserve(3 * points.size());
+    _indexArray.reserve(points.size());
+    Base::BoundBox3f bbox;
+    for (std::size_t i = 0; i < points.size(); i++) {
+        Base::Vector3f p = points[i];
+        if (boost::math::isnan(p.x) || boost::math::isnan(p.y) || boost::math::isnan(p.z))
+            continue;
+        if (transform) {
+            Base::Vector3d v = mat * Base::Vector3d(p.x, p.y, p.z);
+            p.Set(static_cast<float>(v.x), static_cast<float>(v.y), static_cast<float>(v.z));
+        }
+        _coordArray.push_back(p.x);
+        _coordArray.push_back(p.y);
+        _coordArray.push_back(p.z);
+        _indexArray.push_back(i);
+        bbox.Add(p);
+    }
+
+    uint64_t numPoints = _indexArray.size();
+    if (numPoints == 0)
+        return;
+
+    // the root cell is the cube around the bounding box
+    std::vector<Cell> cells(1);
+    Base::Vector3f center = bbox.GetCenter();
+    cells[0].center[0] = center.x;
+    cells[0].center[1] = center.y;
+    cells[0].center[2] = center.z;
+    cells[0].half = std::max(std::max(bbox.LengthX(), bbox.LengthY()), bbox.LengthZ()) / 2.0f;
+
+    Node root;
+    root.begin = 0;
+    root.end = numPoints;
+    root.firstChild = 0;
+    root.numChildren = 0;
+    _nodeArray.push_back(root);
+
+    // split the nodes level by level, the nodes of a level are split in parallel
+    std::size_t levelBegin = 0, levelEnd = 1;
+    unsigned int level = 1;
+    SplitNode split(&_coordArray[0], &_indexArray[0]);
+    while (levelBegin < levelEnd) {
+        std::vector<SplitJob> jobs;
+        if (level < MaxLevels) {
+            for (std::size_t i = levelBegin; i < levelEnd; i++) {
+                const Node& node = _nodeArray[i];
+                if (node.end - node.begin > pointsPerNode && cells[i].half > 0.0f) {
+                    SplitJob job;
+                    job.node = static_cast<uint32_t>(i);
+                    job.begin = node.begin;
+                    job.end = node.end;
+                    job.cell = cells[i];
+                    jobs.push_back(job);
+                }
+            }
+        }
+
+        if (jobs.size() > 1) {
+            QtConcurrent::blockingMap(jobs, split);
+        }
+        else if (jobs.size() == 1) {
+            split(jobs.front());
+        }
+
+        for (std::vector<SplitJob>::iterator it = jobs.begin(); it != jobs.end(); ++it) {
+            if (_nodeArray.size() + 8 > std::numeric_limits<uint32_t>::max())
+                break;
+            _nodeArray[it->node].firstChild = static_cast<uint32_t>(_nodeArray.size());
+            uint64_t begin = it->begin;
+            for (int o = 0; o < 8; o++) {
+                if (it->counts[o] == 0)
+                    continue;
+                Node child;
+                child.begin = begin;
+                child.end = begin + it->counts[o];
+                child.firstChild = 0;
+                child.numChildren = 0;
+                begin = child.end;
+                _nodeArray.push_back(child);
+                _nodeArray[it->node].numChildren++;
+
+                Cell cell;
+                cell.half = it->cell.half / 2.0f;
+                for (int k = 0; k < 3; k++)
+                    cell.center[k] = it->cell.center[k] + ((o & (1 << k)) ? cell.half : -cell.half);
+                cells.push_back(cell);
+            }
+        }
+
+        if (_nodeArray.size() > levelEnd) {
+            levelBegin = levelEnd;
+            levelEnd = _nodeArray.size();
+            level++;
+        }
+        else {
+            levelBegin = levelEnd;
+        }
+    }
+
+    // the boxes of the nodes enclose their points tightly
+    for (std::size_t i = _nodeArray.size(); i-- > 0;) {
+        Node& node = _nodeArray[i];
+        Base::BoundBox3f box;
+        if (node.numChildren == 0) {
+            for (uint64_t j = node.begin; j < node.end; j++) {
+                const float* p = &_coordArray[3 * j];
+                box.Add(Base::Vector3f(p[0], p[1], p[2]));
+            }
+        }
+        else {
+            for (uint32_t j = 0; j < node.numChildren; j++)
+                box.Add(GetBox(_nodeArray[node.firstChild + j].box));
+        }
+        node.box[0] = box.MinX; node.box[1] = box.MinY; node.box[2] = box.MinZ;
+        node.box[3] = box.MaxX; node.box[4] = box.MaxY; node.box[5] = box.MaxZ;
+    }
+
+    _numLevels = level;
+    SetData(&_nodeArray[0], _nodeArray.size(), &_coordArray[0], &_indexArray[0],
+            numPoints, static_cast<uint32_t>(std::min<unsigned long>(pointsPerNode, std::numeric_limits<uint32_t>::max())));
+}
+
+bool PointsOctree::Save(const std::string& file) const
+{
+    QFile output(QString::fromUtf8(file.c_str()));
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+
+    OctreeHeader header;
+    header.magic = OctreeMagic;
+    header.version = OctreeVersion;
+    header.numNodes = _numNodes;
+    header.numPoints = _numPoints;
+    header.pointsPerNode = _pointsPerNode;
+    header.numLevels = _numLevels;
+
+    qint64 nodeSize = static_cast<qint64>(_numNodes * sizeof(Node));
+    qint64 coordSize = static_cast<qint64>(3 * sizeof(float) * _numPoints);
+    qint64 indexSize = static_cast<qint64>(sizeof(uint64_t) * _numPoints);
+    qint64 padding = static_cast<qint64>(IndexOffset(_numNodes, _numPoints) - CoordOffset(_numNodes)) - coordSize;
+    const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
+    bool ok = output.write(reinterpret_cast<const char*>(&header), sizeof(header)) == sizeof(header) &&
+              output.write(reinterpret_cast<const char*>(_nodes), nodeSize) == nodeSize &&
+              output.write(reinterpret_cast<const char*>(_coords), coordSize) == coordSize &&
+              output.write(zeros, padding) == padding &&
+              output.write(reinterpret_cast<const char*>(_indices), indexSize) == indexSize;
+    output.close();
+    return ok;
+}
+
+bool PointsOctree::Open(const std::string& file)
+{
+    Clear();
+
+    QFile* input = new QFile(QString::fromUtf8(file.c_str()));
+    if (!input->open(QIODevice::ReadOnly)) {
+        delete input;
+        return false;
+    }
+
+    qint64 size = input->size();
+    uchar* map = 0;
+    if (size >= static_cast<qint64>(sizeof(OctreeHeader)) &&
+        static_cast<quint64>(size) <= std::numeric_limits<std::size_t>::max())
+        map = input->map(0, size);
+
+    // check the sizes and that the nodes form a tree
+    bool ok = map != 0;
+    const OctreeHeader* header = reinterpret_cast<const OctreeHeader*>(map);
+    if (ok) {
+        quint64 fileSize = static_cast<quint64>(size);
+        ok = header->magic == OctreeMagic && header->version == OctreeVersion &&
+             header->numLevels <= MaxLevels &&
+             header->numNodes <= std::numeric_limits<uint32_t>::max() &&
+             header->numNodes <= fileSize / sizeof(Node) &&
+             header->numPoints <= fileSize / (3 * sizeof(float) + sizeof(uint64_t)) &&
+             IndexOffset(header->numNodes, header->numPoints) + sizeof(uint64_t) * header->numPoints <= fileSize;
+    }
+    if (ok) {
+        // every node but the root has exactly one parent with a lower index
+        const Node* nodes = reinterpret_cast<const Node*>(map + sizeof(OctreeHeader));
+        const unsigned char NoLevel = 0xff;
+        std::vector<unsigned char> levels(header->numNodes, NoLevel);
+        if (header->numNodes > 0)
+            levels[0] = 0;
+        for (uint64_t i = 0; ok && i < header->numNodes; i++) {
+            const Node& node = nodes[i];
+            ok = node.begin <= node.end && node.end <= header->numPoints && node.numChildren <= 8 &&
+                 levels[i] != NoLevel && levels[i] < header->numLevels;
+            if (ok && node.numChildren > 0) {
+                ok = node.firstChild > i && uint64_t(node.firstChild) + node.numChildren <= header->numNodes;
+                for (uint32_t j = 0; ok && j < node.numChildren; j++) {
+                    unsigned char& level = levels[node.firstChild + j];
+                    ok = level == NoLevel;
+                    level = levels[i] + 1;
+                }
+            }
+        }
+    }
+
+    if (!ok) {
+        if (map)
+            input->unmap(map);
+        delete input;
+        return false;
+    }
+
+    _file = input;
+    _map = map;
+    _numLevels = header->numLevels;
+    SetData(reinterpret_cast<const Node*>(map + sizeof(OctreeHeader)), header->numNodes,
+            reinterpret_cast<const float*>(map + CoordOffset(header->numNodes)),
+            reinterpret_cast<const uint64_t*>(map + IndexOffset(header->numNodes, header->numPoints)),
+            header->numPoints, header->pointsPerNode);
+    return true;
+}
+
+unsigned long PointsOctree::CountPoints() const
+{
+    return static_cast<unsigned long>(_numPoints);
+}
+
+unsigned long PointsOctree::CountNodes() const
+{
+    return static_cast<unsigned long>(_numNodes);
+}
+
+unsigned int PointsOctree::CountLevels() const
+{
+    return _numLevels;
+}
+
+Base::BoundBox3f PointsOctree::GetBoundBox() const
+{
+    if (_numNodes == 0)
+        return Base::BoundBox3f();
+    return GetBox(_nodes[0].box);
+}
+
+void PointsOctree::GetResult(const std::vector<uint64_t>& positions, std::vector<unsigned long>& indices,
+                             std::vector<Base::Vector3f>* points) const
+{
+    indices.resize(positions.size());
+    for (std::size_t i = 0; i < positions.size(); i++)
+        indices[i] = static_cast<unsigned long>(_indices[positions[i]]);
+
+    if (points) {
+        points->resize(positions.size());
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            const float* p = _coords + 3 * positions[i];
+            (*points)[i].Set(p[0], p[1], p[2]);
+        }
+    }
+}
+
+void PointsOctree::InBox(const Base::BoundBox3f& box, std::vector<unsigned long>& indices,
+                         std::vector<Base::Vector3f>* points) const
+{
+    std::vector<uint64_t> positions;
+    std::vector<uint32_t> stack;
+    if (_numNodes > 0)
+        stack.push_back(0);
+
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+
+        Base::BoundBox3f nodeBox = GetBox(node.box);
+        if (!box.Intersect(nodeBox))
+            continue;
+        if (box.IsInBox(nodeBox)) {
+            for (uint64_t i = node.begin; i < node.end; i++)
+                positions.push_back(i);
+        }
+        else if (node.numChildren == 0) {
+            for (uint64_t i = node.begin; i < node.end; i++) {
+                const float* p = _coords + 3 * i;
+                if (box.IsInBox(Base::Vector3f(p[0], p[1], p[2])))
+                    positions.push_back(i);
+            }
+        }
+        else {
+            for (uint32_t j = node.numChildren; j-- > 0;)
+                stack.push_back(node.firstChild + j);
+        }
+    }
+
+    GetResult(positions, indices, points);
+}
+
+void PointsOctree::InSphere(const Base::Vector3f& center, float radius, std::vector<unsigned long>& indices,
+                            std::vector<Base::Vector3f>* points) const
+{
+    std::vector<uint64_t> positions;
+    std::vector<uint32_t> stack;
+    if (_numNodes > 0)
+        stack.push_back(0);
+
+    const float c[3] = {center.x, center.y, center.z};
+    float radius2 = radius * radius;
+    while (!stack.empty()) {
+        const Node& node = _nodes[stack.back()];
+        stack.pop_back();
+
+        // the nearest and the farthest point of the node box to the center
+        float nearest = 0.0f, farthest = 0.0f;
+        for (int k = 0; k < 3; k++) {
+            float lower = node.box[k] - c[k];
+            float upper = c[k] - node.box[k + 3];
+            float d = std::max(std::max(lower, upper), 0.0f);
+            float f = std::max(c[k] - node.box[k], node.box[k + 3] - c[k]);
+            nearest += d * d;
+            farthest += f * f;
+        }
+
+        if (nearest > radius2)
+            continue;
+        if (farthest <= radius2) {
+            for (uint64_t i = node.begin; i < node.end; i++)
+                positions.push_back(i);
+        }
+        else if (node.numChildren == 0) {
+            for (uint64_t i = node.begin; i < node.end; i++) {
+                const float* p = _coords + 3 * i;
+                float dx = p[0] - c[0], dy = p[1] - c[1], dz = p[2] - c[2];
+                if (dx * dx + dy * dy + dz * dz <= radius2)
+                    positions.push_back(i);
+            }
+        }
+        else {
+            for (uint32_t j = node.numChildren; j-- > 0;)
+                stack.push_back(node.firstChild + j);
+        }
+    }
+
+    GetResult(positions, indices, points);
+}
+
+void PointsOctree::CountLevelOfDetail(uint32_t node, unsigned int level, const Base::BoundBox3f* box,
+                                      std::vector<uint64_t>& nodeCount, std::vector<uint64_t>& leafCount) const
+{
+    // the levels of the nodes are checked when opening a file, this is a safeguard
+    if (level >= nodeCount.size())
+        return;
+    const Node& rNode = _nodes[node];
+    if (box && !box->Intersect(GetBox(rNode.box)))
+        return;
+
+    uint64_t count = std::min<uint64_t>(rNode.end - rNode.begin, _pointsPerNode);
+    nodeCount[level] += count;
+    if (rNode.numChildren == 0) {
+        leafCount[level] += count;
+    }
+    else {
+        for (uint32_t j = 0; j < rNode.numChildren; j++)
+            CountLevelOfDetail(rNode.firstChild + j, level + 1, box, nodeCount, leafCount);
+    }
+}
+
+void PointsOctree::CollectLevelOfDetail(uint32_t node, unsigned int level, unsigned int target, double scale,
+                                        const Base::BoundBox3f* box, std::vector<uint64_t>& positions) const
+{
+    const Node& rNode = _nodes[node];
+    if (box && !box->Intersect(GetBox(rNode.box)))
+        return;
+
+    if (level < target && rNode.numChildren > 0) {
+        for (uint32_t j = 0; j < rNode.numChildren; j++)
+            CollectLevelOfDetail(rNode.firstChild + j, level + 1, target, scale, box, positions);
+        return;
+    }
+
+    // every k-th point of the node is spread over all of its octants
+    uint64_t count = rNode.end - rNode.begin;
+    uint64_t samples = static_cast<uint64_t>(scale * std::min<uint64_t>(count, _pointsPerNode));
+    samples = std::min(samples, count);
+    for (uint64_t i = 0; i < samples; i++) {
+        uint64_t pos = rNode.begin + (i * count) / samples;
+        if (box) {
+            const float* p = _coords + 3 * pos;
+            if (!box->IsInBox(Base::Vector3f(p[0], p[1], p[2])))
+                continue;
+        }
+        positions.push_back(pos);
+    }
+}
+
+void PointsOctree::LevelOfDetail(unsigned long maxPoints, std::vector<unsigned long>& indices,
+                                 std::vector<Base::Vector3f>* points, const Base::BoundBox3f* box) const
+{
+    std::vector<uint64_t> positions;
+    if (_numNodes == 0 || maxPoints == 0) {
+        GetResult(positions, indices, points);
+        return;
+    }
+
+    // the number of points at each level where the leaves of the upper levels are kept
+    std::vector<uint64_t> nodeCount(_numLevels, 0), leafCount(_numLevels, 0);
+    CountLevelOfDetail(0, 0, box, nodeCount, leafCount);
+
+    unsigned int target = 0;
+    uint64_t leaves = 0;
+    uint64_t cost = nodeCount[0];
+    for (unsigned int level = 0; level < _numLevels; level++) {
+        uint64_t levelCost = nodeCount[level] + leaves;
+        if (level > 0 && levelCost > maxPoints)
+            break;
+        target = level;
+        cost = levelCost;
+        leaves += leafCount[level];
+    }
+
+    // use up the budget at the chosen level
+    double scale = cost > 0 ? static_cast<double>(maxPoints) / static_cast<double>(cost) : 1.0;
+    CollectLevelOfDetail(0, 0, target, scale, box, positions);
+
+    // the nodes crossing the box border lose the samples outside of it, so
+    // search for the scale that uses up the budget
+    double lower = scale, upper = 0;
+    for (int i = 0; box && i < 16 && positions.size() < 0.9 * maxPoints; i++) {
+        double next;
+        if (upper > 0)
+            next = 0.5 * (lower + upper);
+        else if (positions.empty())
+            next = 2.0 * lower;
+        else
+            next = lower * static_cast<double>(maxPoints) / static_cast<double>(positions.size());
+
+        std::vector<uint64_t> more;
+        CollectLevelOfDetail(0, 0, target, next, box, more);
+        if (more.size() > maxPoints) {
+            upper = next;
+        }
+        else {
+            lower = next;
+            positions.swap(more);
+        }
+    }
+
+    GetResult(positions, indices, points);
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef POINTS_OCTREE_H
+#define POINTS_OCTREE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <Base/BoundBox.h>
+#include <Base/Vector3D.h>
+
+class QFile;
+
+namespace Points
+{
+class PointKernel;
+
+/**
+ * The PointsOctree class is a spatial index of a point cloud whose cells adapt
+ * to the density of the points: a cell is split into eight octants as long as
+ * it holds more than a given number of points. Unlike PointsGrid it doesn't
+ * need a cell for empty regions and its depth grows only where the points are
+ * dense.
+ *
+ * The points are sorted so that the points of every node are stored
+ * contiguously. Taking every k-th point of a node therefore gives an evenly
+ * distributed subset of it, which is used as level of detail of the node.
+ *
+ * The octree can be written to a file that is mapped into memory when opened
+ * again, so that only the parts being queried are loaded by the operating
+ * system. The file keeps the coordinates of the points, hence it can be used
+ * without loading the point cloud. It is written in the byte order of the
+ * machine that created it.
+ * @author FreeCAD Developers
+ */
+class PointsExport PointsOctree
+{
+public:
+    PointsOctree();
+    ~PointsOctree();
+
+    /** Builds the octree of the valid points of \a kernel in global
+     * coordinates. A node is split if it holds more than \a pointsPerNode
+     * points which is also the size of the level of detail of a node.
+     */
+    void Build(const PointKernel& kernel, unsigned long pointsPerNode = 4096);
+    /// Writes the octree with the coordinates of the points to \a file.
+    bool Save(const std::string& file) const;
+    /// Maps the octree file \a file into memory.
+    bool Open(const std::string& file);
+    void Clear();
+
+    /** @name Information */
+    //@{
+    unsigned long CountPoints() const;
+    unsigned long CountNodes() const;
+    /// Returns the number of levels, the root node being the first level.
+    unsigned int CountLevels() const;
+    Base::BoundBox3f GetBoundBox() const;
+    //@}
+
+    /** @name Queries
+     * The indices refer to the points of the kernel the octree was built of.
+     * The coordinates are returned in the same order if \a points is given.
+     */
+    //@{
+    void InBox(const Base::BoundBox3f& box, std::vector<unsigned long>& indices,
+               std::vector<Base::Vector3f>* points = 0) const;
+    void InSphere(const Base::Vector3f& center, float radius, std::vector<unsigned long>& indices,
+                  std::vector<Base::Vector3f>* points = 0) const;
+    /** Selects at most \a maxPoints points which are spread over the whole
+     * cloud or the part of it inside \a box. The deepest level whose nodes
+     * together fit into the budget is taken so that the sparse regions keep
+     * more of their points than the dense ones.
+     */
+    void LevelOfDetail(unsigned long maxPoints, std::vector<unsigned long>& indices,
+                       std::vector<Base::Vector3f>* points = 0, const Base::BoundBox3f* box = 0) const;
+    //@}
+
+public:
+    struct Node
+    {
+        float box[6];
+        // the points of the node in sort order
+        uint64_t begin;
+        uint64_t end;
+        // the non-empty children are stored consecutively, a leaf has none
+        uint32_t firstChild;
+        uint32_t numChildren;
+    };
+
+private:
+    void SetData(const Node* nodes, uint64_t numNodes, const float* coords,
+                 const uint64_t* indices, uint64_t numPoints, uint32_t pointsPerNode);
+    void CountLevelOfDetail(uint32_t node, unsigned int level, const Base::BoundBox3f* box,
+                            std::vector<uint64_t>& nodeCount, std::vector<uint64_t>& leafCount) const;
+    void CollectLevelOfDetail(uint32_t node, unsigned int level, unsigned int target, double scale,
+                              const Base::BoundBox3f* box, std::vector<uint64_t>& positions) const;
+    void GetResult(const std::vector<uint64_t>& positions, std::vector<unsigned long>& indices,
+                   std::vector<Base::Vector3f>* points) const;
+
+private:
+    PointsOctree(const PointsOctree&);
+    void operator = (const PointsOctree&);
+
+private:
+    // the data of a built octree
+    std::vector<Node> _nodeArray;
+    std::vector<float> _coordArray;
+    std::vector<uint64_t> _indexArray;
+    // the mapped file of an opened octree
+    QFile* _file;
+    unsigned char* _map;
+    // points either to the arrays or into the mapping
+    const Node* _nodes;
+    const float* _coords;
+    const uint64_t* _indices;
+    uint64_t _numNodes;
+    uint64_t _numPoints;
+    uint32_t _pointsPerNode;
+    unsigned int _numLevels;
+};
+
+} // namespace Points
+
+#endif // POINTS_OCTREE_H
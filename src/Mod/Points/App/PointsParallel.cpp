@@ -0,0 +1,365 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <limits>
+#endif
+
+#include <QThread>
+
+#include "PointsParallel.h"
+
+using namespace Points;
+
+namespace {
+
+// the kernels are bound by memory bandwidth, small arrays are not worth a thread
+const std::size_t MinParallelCount = 100000;
+
+// The coordinates of an array of Base::Vector3f as plain floats
+inline float* Coordinates(std::vector<Base::Vector3f>& points)
+{
+    return points.empty() ? 0 : &points[0].x;
+}
+
+inline const float* Coordinates(const std::vector<Base::Vector3f>& points)
+{
+    return points.empty() ? 0 : &points[0].x;
+}
+
+// The upper 3x4 part of the matrix in row-major order
+struct AffineMatrix
+{
+    explicit AffineMatrix(const Base::Matrix4D& mat)
+    {
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 4; j++)
+                m[4*i+j] = mat[i][j];
+        }
+    }
+    bool isUnity() const
+    {
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 4; j++) {
+                if (m[4*i+j] != (i == j ? 1.0 : 0.0))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    double m[12];
+};
+
+// The loops below work on plain arrays without branches so that they get vectorized
+
+struct TransformRange
+{
+    typedef void result_type;
+    TransformRange(float* p, const Base::Matrix4D& mat)
+      : p(p), mat(mat) {}
+    void operator()(std::size_t begin, std::size_t end, int) const
+    {
+        float* v = p;
+        const double* m = mat.m;
+        for (std::size_t i = begin; i < end; i++) {
+            double x = v[3*i], y = v[3*i+1], z = v[3*i+2];
+            v[3*i]   = static_cast<float>(m[0]*x + m[1]*y + m[2]*z + m[3]);
+            v[3*i+1] = static_cast<float>(m[4]*x + m[5]*y + m[6]*z + m[7]);
+            v[3*i+2] = static_cast<float>(m[8]*x + m[9]*y + m[10]*z + m[11]);
+        }
+    }
+
+    float* p;
+    AffineMatrix mat;
+};
+
+struct TransformToRange
+{
+    typedef void result_type;
+    TransformToRange(const float* p, double* r, const Base::Matrix4D& mat)
+      : p(p), r(r), mat(mat) {}
+    void operator()(std::size_t begin, std::size_t end, int) const
+    {
+        const float* v = p;
+        double* w = r;
+        const double* m = mat.m;
+        for (std::size_t i = begin; i < end; i++) {
+            double x = v[3*i], y = v[3*i+1], z = v[3*i+2];
+            w[3*i]   = m[0]*x + m[1]*y + m[2]*z + m[3];
+            w[3*i+1] = m[4]*x + m[5]*y + m[6]*z + m[7];
+            w[3*i+2] = m[8]*x + m[9]*y + m[10]*z + m[11];
+        }
+    }
+
+    const float* p;
+    double* r;
+    AffineMatrix mat;
+};
+
+struct RotateRange
+{
+    typedef void result_type;
+    RotateRange(char* p, std::size_t stride, const Base::Matrix4D& mat)
+      : p(p), stride(stride), mat(mat) {}
+    void operator()(std::size_t begin, std::size_t end, int) const
+    {
+        const double* m = mat.m;
+        if (stride == sizeof(Base::Vector3f)) {
+            float* v = reinterpret_cast<float*>(p);
+            for (std::size_t i = begin; i < end; i++) {
+                double x = v[3*i], y = v[3*i+1], z = v[3*i+2];
+                v[3*i]   = static_cast<float>(m[0]*x + m[1]*y + m[2]*z);
+                v[3*i+1] = static_cast<float>(m[4]*x + m[5]*y + m[6]*z);
+                v[3*i+2] = static_cast<float>(m[8]*x + m[9]*y + m[10]*z);
+            }
+        }
+        else {
+            for (std::size_t i = begin; i < end; i++) {
+                float* v = reinterpret_cast<float*>(p + i * stride);
+                double x = v[0], y = v[1], z = v[2];
+                v[0] = static_cast<float>(m[0]*x + m[1]*y + m[2]*z);
+                v[1] = static_cast<float>(m[4]*x + m[5]*y + m[6]*z);
+                v[2] = static_cast<float>(m[8]*x + m[9]*y + m[10]*z);
+            }
+        }
+    }
+
+    char* p;
+    std::size_t stride;
+    AffineMatrix mat;
+};
+
+// Writes the minimum and maximum of each transformed coordinate of a block
+// to result[6*block]. A comparison with NaN is false which ignores invalid points.
+struct MinMaxRange
+{
+    typedef void result_type;
+    MinMaxRange(const float* p, const Base::Matrix4D& mat, std::vector<double>& result)
+      : p(p), mat(mat), unity(this->mat.isUnity()), result(&result) {}
+    void operator()(std::size_t begin, std::size_t end, int block) const
+    {
+        const float* v = p;
+        const double* m = mat.m;
+        double lo[3], hi[3];
+        for (int k = 0; k < 3; k++) {
+            lo[k] = std::numeric_limits<double>::max();
+            hi[k] = -std::numeric_limits<double>::max();
+        }
+
+        if (unity) {
+            for (int k = 0; k < 3; k++) {
+                float minValue = std::numeric_limits<float>::max();
+                float maxValue = -std::numeric_limits<float>::max();
+                for (std::size_t i = begin; i < end; i++) {
+                    float c = v[3*i+k];
+                    minValue = c < minValue ? c : minValue;
+                    maxValue = c > maxValue ? c : maxValue;
+                }
+                if (minValue <= maxValue) {
+                    lo[k] = minValue;
+                    hi[k] = maxValue;
+                }
+            }
+        }
+        else {
+            for (std::size_t i = begin; i < end; i++) {
+                double x = v[3*i], y = v[3*i+1], z = v[3*i+2];
+                double tx = m[0]*x + m[1]*y + m[2]*z + m[3];
+                double ty = m[4]*x + m[5]*y + m[6]*z + m[7];
+                double tz = m[8]*x + m[9]*y + m[10]*z + m[11];
+                lo[0] = tx < lo[0] ? tx : lo[0];
+                lo[1] = ty < lo[1] ? ty : lo[1];
+                lo[2] = tz < lo[2] ? tz : lo[2];
+                hi[0] = tx > hi[0] ? tx : hi[0];
+                hi[1] = ty > hi[1] ? ty : hi[1];
+                hi[2] = tz > hi[2] ? tz : hi[2];
+            }
+        }
+
+        double* r = &(*result)[6 * block];
+        for (int k = 0; k < 3; k++) {
+            r[k] = lo[k];
+            r[k+3] = hi[k];
+        }
+    }
+
+    const float* p;
+    AffineMatrix mat;
+    bool unity;
+    std::vector<double>* result;
+};
+
+inline std::size_t IsValid(const float* v)
+{
+    // NaN is the only value that is not equal to itself
+    return static_cast<std::size_t>((v[0] == v[0]) & (v[1] == v[1]) & (v[2] == v[2]));
+}
+
+struct CountValidRange
+{
+    typedef void result_type;
+    CountValidRange(const float* p, std::vector<std::size_t>& result)
+      : p(p), result(&result) {}
+    void operator()(std::size_t begin, std::size_t end, int block) const
+    {
+        const float* v = p;
+        std::size_t count = 0;
+        for (std::size_t i = begin; i < end; i++)
+            count += IsValid(v + 3*i);
+        (*result)[block] = count;
+    }
+
+    const float* p;
+    std::vector<std::size_t>* result;
+};
+
+// Copies the valid points of a block transformed by the matrix to the
+// position given by offsets[block]
+struct CopyValidRange
+{
+    typedef void result_type;
+    CopyValidRange(const float* p, float* r, const Base::Matrix4D& mat,
+                   const std::vector<std::size_t>& offsets)
+      : p(p), r(r), mat(mat), offsets(&offsets) {}
+    void operator()(std::size_t begin, std::size_t end, int block) const
+    {
+        const float* v = p;
+        float* w = r + 3 * (*offsets)[block];
+        const double* m = mat.m;
+        // an invalid point is written and overwritten by the next valid point,
+        // so stop at the last valid point to stay within the block's range
+        std::size_t last = end;
+        while (last > begin && !IsValid(v + 3*(last-1)))
+            --last;
+        for (std::size_t i = begin; i < last; i++) {
+            double x = v[3*i], y = v[3*i+1], z = v[3*i+2];
+            w[0] = static_cast<float>(m[0]*x + m[1]*y + m[2]*z + m[3]);
+            w[1] = static_cast<float>(m[4]*x + m[5]*y + m[6]*z + m[7]);
+            w[2] = static_cast<float>(m[8]*x + m[9]*y + m[10]*z + m[11]);
+            w += 3 * IsValid(v + 3*i);
+        }
+    }
+
+    const float* p;
+    float* r;
+    AffineMatrix mat;
+    const std::vector<std::size_t>* offsets;
+};
+
+}
+
+void PointsParallel::Transform(std::vector<Base::Vector3f>& points, const Base::Matrix4D& mat)
+{
+    std::size_t count = points.size();
+    ForBlocks(count, CountBlocks(count, MinParallelCount), TransformRange(Coordinates(points), mat));
+}
+
+void PointsParallel::Transform(const std::vector<Base::Vector3f>& points, const Base::Matrix4D& mat,
+                               std::vector<Base::Vector3d>& result)
+{
+    std::size_t count = points.size();
+    std::size_t offset = result.size();
+    result.resize(offset + count);
+    if (count == 0)
+        return;
+    ForBlocks(count, CountBlocks(count, MinParallelCount), TransformToRange(Coordinates(points), &result[offset].x, mat));
+}
+
+void PointsParallel::Rotate(Base::Vector3f* vectors, std::size_t count, std::size_t stride,
+                            const Base::Matrix4D& mat)
+{
+    if (count == 0)
+        return;
+    ForBlocks(count, CountBlocks(count, MinParallelCount), RotateRange(reinterpret_cast<char*>(vectors), stride, mat));
+}
+
+void PointsParallel::Rotate(std::vector<Base::Vector3f>& vectors, const Base::Matrix4D& mat)
+{
+    if (vectors.empty())
+        return;
+    Rotate(&vectors[0], vectors.size(), sizeof(Base::Vector3f), mat);
+}
+
+Base::BoundBox3d PointsParallel::BoundBox(const std::vector<Base::Vector3f>& points,
+                                          const Base::Matrix4D& mat)
+{
+    std::size_t count = points.size();
+    int blocks = CountBlocks(count, MinParallelCount);
+    std::vector<double> minmax(6 * blocks);
+    ForBlocks(count, blocks, MinMaxRange(Coordinates(points), mat, minmax));
+
+    Base::BoundBox3d bnd;
+    for (int i = 0; i < blocks; i++) {
+        const double* r = &minmax[6 * i];
+        bnd.MinX = std::min(bnd.MinX, r[0]);
+        bnd.MinY = std::min(bnd.MinY, r[1]);
+        bnd.MinZ = std::min(bnd.MinZ, r[2]);
+        bnd.MaxX = std::max(bnd.MaxX, r[3]);
+        bnd.MaxY = std::max(bnd.MaxY, r[4]);
+        bnd.MaxZ = std::max(bnd.MaxZ, r[5]);
+    }
+    return bnd;
+}
+
+std::size_t PointsParallel::CountValid(const std::vector<Base::Vector3f>& points)
+{
+    std::size_t count = points.size();
+    int blocks = CountBlocks(count, MinParallelCount);
+    std::vector<std::size_t> valid(blocks);
+    ForBlocks(count, blocks, CountValidRange(Coordinates(points), valid));
+
+    std::size_t num = 0;
+    for (int i = 0; i < blocks; i++)
+        num += valid[i];
+    return num;
+}
+
+std::vector<Base::Vector3f> PointsParallel::ValidPoints(const std::vector<Base::Vector3f>& points,
+                                                        const Base::Matrix4D& mat)
+{
+    std::size_t count = points.size();
+    int blocks = CountBlocks(count, MinParallelCount);
+    std::vector<std::size_t> offsets(blocks);
+    ForBlocks(count, blocks, CountValidRange(Coordinates(points), offsets));
+
+    std::size_t num = 0;
+    for (int i = 0; i < blocks; i++) {
+        std::size_t valid = offsets[i];
+        offsets[i] = num;
+        num += valid;
+    }
+
+    std::vector<Base::Vector3f> result(num);
+    ForBlocks(count, blocks, CopyValidRange(Coordinates(points), Coordinates(result), mat, offsets));
+    return result;
+}
+
+int PointsParallel::CountBlocks(std::size_t count, std::size_t minCount)
+{
+    return count < minCount ? 1 : std::max(1, QThread::idealThreadCount());
+}
@@ -0,0 +1,144 @@
+/***************************************************************************
+ *   Copyright (c) 2026 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#ifndef POINTS_PARALLEL_H
+#define POINTS_PARALLEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include <QFuture>
+#include <QList>
+#include <QtConcurrentRun>
+
+#include <Base/BoundBox.h>
+#include <Base/Matrix.h>
+#include <Base/Vector3D.h>
+
+namespace Points
+{
+
+/**
+ * The PointsParallel class collects the data-parallel kernels used by the
+ * point kernel and the point properties. An array is split into one block per
+ * thread and each block is processed by a plain loop without branches over
+ * the float coordinates, so that the compiler can vectorize it. Small arrays
+ * are processed in the calling thread.
+ *
+ * Invalid points, i.e. points with a NaN coordinate, are kept by the
+ * transformations and ignored by the bounding box.
+ * @author FreeCAD Developers
+ */
+class PointsExport PointsParallel
+{
+public:
+    /// Applies the affine transformation \a mat to the points.
+    static void Transform(std::vector<Base::Vector3f>& points, const Base::Matrix4D& mat);
+    /// Writes the points transformed by \a mat to \a result.
+    static void Transform(const std::vector<Base::Vector3f>& points, const Base::Matrix4D& mat,
+                          std::vector<Base::Vector3d>& result);
+    /** Applies the linear part of \a mat, i.e. without the translation, to
+     * \a count vectors, e.g. normals. The vectors are \a stride bytes apart
+     * which allows to transform a vector member of a structure.
+     */
+    static void Rotate(Base::Vector3f* vectors, std::size_t count, std::size_t stride,
+                       const Base::Matrix4D& mat);
+    /// Applies the linear part of \a mat to the vectors.
+    static void Rotate(std::vector<Base::Vector3f>& vectors, const Base::Matrix4D& mat);
+    /// Returns the bounding box of the valid points transformed by \a mat.
+    static Base::BoundBox3d BoundBox(const std::vector<Base::Vector3f>& points,
+                                     const Base::Matrix4D& mat);
+    /// Returns the number of valid points.
+    static std::size_t CountValid(const std::vector<Base::Vector3f>& points);
+    /// Returns the valid points transformed by \a mat in their original order.
+    static std::vector<Base::Vector3f> ValidPoints(const std::vector<Base::Vector3f>& points,
+                                                   const Base::Matrix4D& mat);
+
+    /** Returns the number of blocks ForBlocks() should split \a count elements
+     * into: one per thread, or a single block that the calling thread processes
+     * if there are fewer than \a minCount elements.
+     */
+    static int CountBlocks(std::size_t count, std::size_t minCount);
+    /** Calls func(begin, end, block) for \a blocks consecutive ranges of [0, count).
+     * The blocks are run by the global thread pool, so more blocks than threads
+     * balance uneven work. A single block is run by the calling thread. If a
+     * block throws an exception the first one is rethrown after all blocks
+     * have finished.
+     */
+    template <class Func>
+    static void ForBlocks(std::size_t count, int blocks, const Func& func);
+
+private:
+    // Runs a block and keeps the exception it throws for the calling thread
+    template <class Func>
+    struct BlockTask
+    {
+        typedef void result_type;
+        BlockTask(const Func& func, std::exception_ptr* error)
+          : func(func), error(error)
+        {
+        }
+        void operator()(std::size_t begin, std::size_t end, int block) const
+        {
+            try {
+                func(begin, end, block);
+            }
+            catch (...) {
+                *error = std::current_exception();
+            }
+        }
+        Func func;
+        std::exception_ptr* error;
+    };
+};
+
+template <class Func>
+void PointsParallel::ForBlocks(std::size_t count, int blocks, const Func& func)
+{
+    if (blocks <= 1) {
+        func(0, count, 0);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(blocks);
+    QList<QFuture<void> > futures;
+    for (int i=0; i<blocks; i++) {
+        std::size_t begin = static_cast<std::size_t>((static_cast<uint64_t>(count) * i) / blocks);
+        std::size_t end = static_cast<std::size_t>((static_cast<uint64_t>(count) * (i + 1)) / blocks);
+        futures << QtConcurrent::run(BlockTask<Func>(func, &errors[i]), begin, end, i);
+    }
+    for (QList<QFuture<void> >::iterator it = futures.begin(); it != futures.end(); ++it)
+        it->waitForFinished();
+    for (std::vector<std::exception_ptr>::iterator it = errors.begin(); it != errors.end(); ++it) {
+        if (*it)
+            std::rethrow_exception(*it);
+    }
+}
+
+} // namespace Points
+
+
+#endif // POINTS_PARALLEL_H
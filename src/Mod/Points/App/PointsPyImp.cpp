@@ -24,6 +24,9 @@
 #include "PreCompiled.h"
 
 #include "Mod/Points/App/Points.h"
+#include "Mod/Points/App/PointsOctree.h"
+#include "Mod/Points/App/PointsKdTree.h"
+#include "Mod/Points/App/PointsAnalysis.h"
 #include <Base/Builder3D.h>
 #include <Base/VectorPy.h>
 #include <Base/GeometryPyCXX.h>
@@ -227,6 +230,176 @@ PyObject* PointsPy::fromValid(PyObject * args)
     }
 }
 
+PyObject* PointsPy::writeOctree(PyObject * args)
+{
+    const char* Name;
+    int pointsPerNode = 4096;
+    if (!PyArg_ParseTuple(args, "s|i", &Name, &pointsPerNode))
+        return NULL;
+    if (pointsPerNode < 1) {
+        PyErr_SetString(PyExc_ValueError, "number of points must be positive");
+        return NULL;
+    }
+
+    PY_TRY {
+        PointsOctree octree;
+        octree.Build(*getPointKernelPtr(), static_cast<unsigned long>(pointsPerNode));
+        if (!octree.Save(Name)) {
+            std::string error = std::string("Cannot write octree to ") + Name;
+            throw Base::FileException(error.c_str());
+        }
+    } PY_CATCH;
+
+    Py_Return;
+}
+
+namespace {
+// Converts a point or a sequence of points, returns true for a single point
+bool getQueryPoints(PyObject* obj, std::vector<Base::Vector3f>& pnts)
+{
+    bool single = PyObject_TypeCheck(obj, &(Base::VectorPy::Type)) != 0;
+    if (!single && PySequence_Check(obj) && PySequence_Size(obj) == 3) {
+        Py::Object item(PySequence_GetItem(obj, 0), true);
+        single = PyNumber_Check(item.ptr()) != 0;
+    }
+
+    if (single) {
+        Base::Vector3d v = Py::Vector(obj, false).toVector();
+        pnts.push_back(Base::convertTo<Base::Vector3f>(v));
+    }
+    else {
+        Py::Sequence list(obj);
+        pnts.reserve(list.size());
+        for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+            Base::Vector3d v = Py::Vector(*it).toVector();
+            pnts.push_back(Base::convertTo<Base::Vector3f>(v));
+        }
+    }
+    return single;
+}
+
+Py::List getIndexList(std::vector<unsigned long>::const_iterator begin,
+                      std::vector<unsigned long>::const_iterator end)
+{
+    Py::List list;
+    for (std::vector<unsigned long>::const_iterator it = begin; it != end && *it != PointsKdTree::NoPoint; ++it)
+        list.append(Py::Long(static_cast<long>(*it)));
+    return list;
+}
+}
+
+PyObject* PointsPy::findNearest(PyObject *args, PyObject *kwds)
+{
+    PyObject* obj;
+    int k = 1;
+    static char* keywords_nearest[] = {"Points","K",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i", keywords_nearest, &obj, &k))
+        return NULL;
+    if (k < 1) {
+        PyErr_SetString(PyExc_ValueError, "number of neighbours must be positive");
+        return NULL;
+    }
+
+    PY_TRY {
+        std::vector<Base::Vector3f> pnts;
+        bool single = getQueryPoints(obj, pnts);
+
+        // the tree isn't cached because the points can be changed through
+        // the kernel at any time, the callers batch their queries instead
+        PointsKdTree tree;
+        tree.Build(*getPointKernelPtr());
+        std::vector<unsigned long> indices;
+        tree.FindNearest(pnts, static_cast<unsigned long>(k), indices);
+
+        if (single)
+            return Py::new_reference_to(getIndexList(indices.begin(), indices.end()));
+        Py::List result;
+        for (std::size_t i = 0; i < pnts.size(); i++)
+            result.append(getIndexList(indices.begin() + i * k, indices.begin() + (i + 1) * k));
+        return Py::new_reference_to(result);
+    } PY_CATCH;
+
+    Py_Return;
+}
+
+PyObject* PointsPy::findInRadius(PyObject *args, PyObject *kwds)
+{
+    PyObject* obj;
+    double radius;
+    static char* keywords_radius[] = {"Points","Radius",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Od", keywords_radius, &obj, &radius))
+        return NULL;
+
+    PY_TRY {
+        std::vector<Base::Vector3f> pnts;
+        bool single = getQueryPoints(obj, pnts);
+
+        PointsKdTree tree;
+        tree.Build(*getPointKernelPtr());
+        std::vector<unsigned long> offsets, indices;
+        tree.FindInRadius(pnts, static_cast<float>(radius), offsets, indices);
+
+        if (single)
+            return Py::new_reference_to(getIndexList(indices.begin(), indices.end()));
+        Py::List result;
+        for (std::size_t i = 0; i < pnts.size(); i++)
+            result.append(getIndexList(indices.begin() + offsets[i], indices.begin() + offsets[i + 1]));
+        return Py::new_reference_to(result);
+    } PY_CATCH;
+
+    Py_Return;
+}
+
+PyObject* PointsPy::estimateNormals(PyObject *args, PyObject *kwds)
+{
+    int ksearch = 0;
+    double searchRadius = 0;
+    PyObject* view = 0;
+    static char* keywords_normals[] = {"KSearch","SearchRadius","ViewPoint",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|idO!", keywords_normals,
+                                     &ksearch, &searchRadius, &(Base::VectorPy::Type), &view))
+        return NULL;
+
+    PY_TRY {
+        NormalEstimation estimate(*getPointKernelPtr());
+        estimate.setKSearch(ksearch);
+        estimate.setSearchRadius(searchRadius);
+        if (view)
+            estimate.setViewPoint(static_cast<Base::VectorPy*>(view)->value());
+
+        std::vector<Base::Vector3d> normals;
+        estimate.perform(normals);
+
+        Py::List list;
+        for (std::vector<Base::Vector3d>::iterator it = normals.begin(); it != normals.end(); ++it)
+            list.append(Py::Vector(*it));
+        return Py::new_reference_to(list);
+    } PY_CATCH;
+
+    Py_Return;
+}
+
+PyObject* PointsPy::findOutliers(PyObject *args, PyObject *kwds)
+{
+    int ksearch = 8;
+    double stddevMul = 1.0;
+    static char* keywords_outliers[] = {"KSearch","StdDevMul",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|id", keywords_outliers, &ksearch, &stddevMul))
+        return NULL;
+
+    PY_TRY {
+        OutlierRemoval filter(*getPointKernelPtr());
+        filter.setMeanK(ksearch);
+        filter.setStddevMulThresh(stddevMul);
+
+        std::vector<unsigned long> outliers;
+        filter.perform(outliers);
+        return Py::new_reference_to(getIndexList(outliers.begin(), outliers.end()));
+    } PY_CATCH;
+
+    Py_Return;
+}
+
 Py::Long PointsPy::getCountPoints(void) const
 {
     return Py::Long((long)getPointKernelPtr()->size());
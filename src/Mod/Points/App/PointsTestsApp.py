@@ -0,0 +1,247 @@
+#**************************************************************************
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, os, unittest, tempfile, Points
+from FreeCAD import Vector
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD points module
+#---------------------------------------------------------------------------
+
+
+def makeGrid(nx, ny, nz, spacing=0.1):
+    pts = []
+    for i in range(nx):
+        for j in range(ny):
+            for k in range(nz):
+                pts.append(Vector(i * spacing, j * spacing, k * spacing))
+    return pts
+
+def pointKey(p):
+    return (round(p.x, 4), round(p.y, 4), round(p.z, 4))
+
+
+class PointsOctreeTestCases(unittest.TestCase):
+    def setUp(self):
+        self.grid = makeGrid(50, 50, 4)
+        self.points = Points.Points(self.grid)
+        self.fileName = os.path.join(tempfile.gettempdir(), "PointsOctreeTest.octree")
+        # small leaves to get several levels
+        self.points.writeOctree(self.fileName, 64)
+
+    def testReadAll(self):
+        octree = Points.readOctree(self.fileName)
+        self.assertEqual(octree.CountPoints, len(self.grid))
+        self.assertEqual(set(pointKey(p) for p in octree.Points), set(pointKey(p) for p in self.grid))
+
+    def testLevelOfDetail(self):
+        lod = Points.readOctree(self.fileName, 1000)
+        self.assertLessEqual(lod.CountPoints, 1000)
+        self.assertGreater(lod.CountPoints, 500)
+
+        # the subset is spread over the whole cloud
+        keys = set(pointKey(p) for p in self.grid)
+        box = FreeCAD.BoundBox()
+        for p in lod.Points:
+            self.assertIn(pointKey(p), keys)
+            box.add(p)
+        self.assertGreater(box.XLength, 4.0)
+        self.assertGreater(box.YLength, 4.0)
+
+        # every quarter of the grid gets a fair share
+        for x0, y0 in [(0.0, 0.0), (2.5, 0.0), (0.0, 2.5), (2.5, 2.5)]:
+            inside = [p for p in lod.Points if x0 <= p.x < x0 + 2.5 and y0 <= p.y < y0 + 2.5]
+            self.assertGreater(len(inside), lod.CountPoints / 8)
+
+    def testReadBox(self):
+        box = FreeCAD.BoundBox(1.05, 1.05, -1.0, 2.05, 3.05, 1.0)
+        expected = set(pointKey(p) for p in self.grid if box.isInside(p))
+
+        inBox = Points.readOctree(self.fileName, -1, box)
+        self.assertEqual(set(pointKey(p) for p in inBox.Points), expected)
+
+        # the budget is used up although most nodes cross the box border
+        lod = Points.readOctree(self.fileName, 200, box)
+        self.assertLessEqual(lod.CountPoints, 200)
+        self.assertGreater(lod.CountPoints, 150)
+        for p in lod.Points:
+            self.assertIn(pointKey(p), expected)
+
+    def testSharedChildren(self):
+        # a file where two nodes claim the same children isn't a tree
+        import struct
+        with open(self.fileName, "rb") as f:
+            data = bytearray(f.read())
+        nodeFormat = "=6fQQII"
+        def nodeOffset(i):
+            return struct.calcsize("=IIQQII") + struct.calcsize(nodeFormat) * i
+        def node(i):
+            return list(struct.unpack_from(nodeFormat, data, nodeOffset(i)))
+        first, count = node(0)[8:10]
+        inner = [i for i in range(first, first + count) if node(i)[9] > 0]
+        self.assertGreater(len(inner), 1)
+        values = node(inner[1])
+        values[8:10] = node(inner[0])[8:10]
+        struct.pack_into(nodeFormat, data, nodeOffset(inner[1]), *values)
+
+        fileName = self.fileName + ".bad"
+        with open(fileName, "wb") as f:
+            f.write(data)
+        try:
+            self.assertRaises(RuntimeError, Points.readOctree, fileName)
+        finally:
+            os.remove(fileName)
+
+    def tearDown(self):
+        os.remove(self.fileName)
+
+
+class PointsReaderTestCases(unittest.TestCase):
+    def setUp(self):
+        self.doc = FreeCAD.newDocument("PointsReaderTest")
+        self.dataDir = os.path.join(os.path.dirname(__file__), "TestData")
+        self.fileNames = []
+        # the fixtures hold the points (i, 2i, -i/2) for i in range(10)
+        self.expected = [Vector(i, 2 * i, -0.5 * i) for i in range(10)]
+
+    def load(self, fileName, *args):
+        Points.insert(fileName, self.doc.Name, *args)
+        return self.doc.Objects[-1]
+
+    def checkPoints(self, obj, indices):
+        self.assertEqual([pointKey(p) for p in obj.Points.Points],
+                         [pointKey(self.expected[i]) for i in indices])
+
+    def writeTempFile(self, name, data):
+        fileName = os.path.join(tempfile.gettempdir(), name)
+        self.fileNames.append(fileName)
+        with open(fileName, "wb") as f:
+            f.write(data)
+        return fileName
+
+    def testAsc(self):
+        # lines that aren't exactly three numbers are skipped
+        obj = self.load(os.path.join(self.dataDir, "points.asc"))
+        self.checkPoints(obj, range(10))
+
+    def testPly(self):
+        obj = self.load(os.path.join(self.dataDir, "points.ply"))
+        self.checkPoints(obj, range(10))
+        self.assertEqual(len(obj.Color), 10)
+        for i, c in enumerate(obj.Color):
+            self.assertAlmostEqual(c[0], 25 * i / 255.0, 3)
+            self.assertAlmostEqual(c[2], 1.0, 3)
+
+    def testPcd(self):
+        obj = self.load(os.path.join(self.dataDir, "points.pcd"))
+        self.checkPoints(obj, range(10))
+        self.assertEqual(len(obj.Intensity), 10)
+        for i, v in enumerate(obj.Intensity):
+            self.assertAlmostEqual(v, 0.1 * i, 5)
+
+    def testSubsampling(self):
+        for name in ["points.asc", "points.ply", "points.pcd"]:
+            obj = self.load(os.path.join(self.dataDir, name), 3)
+            self.checkPoints(obj, [0, 3, 6, 9])
+        self.assertEqual(len(obj.Intensity), 4)
+
+    def testBoundBox(self):
+        box = FreeCAD.BoundBox(2.5, -100, -100, 6.5, 100, 100)
+        for name in ["points.asc", "points.ply", "points.pcd"]:
+            obj = self.load(os.path.join(self.dataDir, name), 1, box)
+            self.checkPoints(obj, [3, 4, 5, 6])
+            obj = self.load(os.path.join(self.dataDir, name), 3, box)
+            self.checkPoints(obj, [3, 6])
+        self.assertAlmostEqual(obj.Intensity[1], 0.6, 5)
+
+    def testBinary(self):
+        import struct
+        data = b"".join(struct.pack("<fff", p.x, p.y, p.z) for p in self.expected)
+        header = ("ply\nformat binary_little_endian 1.0\nelement vertex 10\n"
+                  "property float x\nproperty float y\nproperty float z\nend_header\n")
+        obj = self.load(self.writeTempFile("PointsReaderTest.ply", header.encode() + data))
+        self.checkPoints(obj, range(10))
+
+        data = b"".join(struct.pack("=fff", p.x, p.y, p.z) for p in self.expected)
+        header = ("VERSION 0.7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\nCOUNT 1 1 1\n"
+                  "WIDTH 10\nHEIGHT 1\nPOINTS 10\nDATA binary\n")
+        fileName = self.writeTempFile("PointsReaderTest.pcd", header.encode() + data)
+        obj = self.load(fileName, 2)
+        self.checkPoints(obj, [0, 2, 4, 6, 8])
+
+    def testTooManyElements(self):
+        # the size of the vertex data overflows to 8 bytes
+        header = ("ply\nformat binary_little_endian 1.0\nelement vertex 1537228672809129302\n"
+                  "property float x\nproperty float y\nproperty float z\nend_header\n")
+        fileName = self.writeTempFile("PointsReaderOverflow.ply", header.encode() + b"\0" * 24)
+        self.assertRaises(RuntimeError, Points.insert, fileName, self.doc.Name)
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.doc.Name)
+        for fileName in self.fileNames:
+            if os.path.exists(fileName):
+                os.remove(fileName)
+
+class PointsAnalysisTestCases(unittest.TestCase):
+    def setUp(self):
+        self.grid = makeGrid(10, 10, 1)
+        self.points = Points.Points(self.grid)
+
+    def testNearestOnGrid(self):
+        # a point slightly off a grid point finds that grid point first
+        self.assertEqual(self.points.findNearest(Vector(0.31, 0.42, 0.01)), [34])
+        # the inner grid point and its four direct neighbours
+        result = self.points.findInRadius(Vector(0.3, 0.4, 0.0), 0.105)
+        self.assertEqual(result[0], 34)
+        self.assertEqual(sorted(result), [24, 33, 34, 35, 44])
+        # a list of points gives one list of indices per point
+        self.assertEqual(self.points.findNearest([Vector(0.0, 0.0, 0.0), Vector(0.9, 0.9, 0.0)]), [[0], [99]])
+
+    def testNearestBruteForce(self):
+        queries = [Vector(0.0137 * i - 0.05, 0.0291 * i % 1.0, 0.003 * i) for i in range(50)]
+        results = self.points.findNearest(queries, 4)
+        for q, indices in zip(queries, results):
+            self.assertEqual(len(indices), 4)
+            expected = sorted([(p - q).Length for p in self.grid])[:4]
+            found = [(self.grid[i] - q).Length for i in indices]
+            for a, b in zip(found, expected):
+                self.assertAlmostEqual(a, b, 5)
+
+    def testPlaneNormals(self):
+        # the tilted plane z = 0.5 * x + 1
+        pts = [Vector(p.x, p.y, 0.5 * p.x + 1.0) for p in self.grid]
+        plane = Points.Points(pts)
+        expected = Vector(-0.5, 0.0, 1.0)
+        expected.normalize()
+        for normals in (plane.estimateNormals(KSearch=8, ViewPoint=Vector(0, 0, 10)),
+                        plane.estimateNormals(SearchRadius=0.25, ViewPoint=Vector(0, 0, 10))):
+            self.assertEqual(len(normals), len(pts))
+            for n in normals:
+                self.assertAlmostEqual(n.Length, 1.0, 5)
+                self.assertGreater(n.dot(expected), 0.9999)
+
+    def testOutliers(self):
+        pts = self.grid + [Vector(5.0, 5.0, 5.0), Vector(-3.0, 0.0, 2.0)]
+        cloud = Points.Points(pts)
+        self.assertEqual(cloud.findOutliers(), [100, 101])
+        # only the corners stick out of a regular grid
+        self.assertEqual(self.points.findOutliers(KSearch=8, StdDevMul=2.0), [0, 9, 90, 99])
+        self.assertEqual(self.points.findOutliers(KSearch=8, StdDevMul=4.0), [])
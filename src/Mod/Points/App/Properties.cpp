@@ -37,13 +37,9 @@
 
 #include "Points.h"
 #include "Properties.h"
+#include "PointsParallel.h"
 #include "PointsPy.h"
 
-#include <QtConcurrentMap>
-#ifdef _WIN32
-# include <ppl.h>
-#endif
-
 using namespace Points;
 using namespace std;
 
@@ -392,15 +388,7 @@ void PropertyNormalList::transformGeometry(const Base::Matrix4D &mat)
     aboutToSetValue();
 
     // Rotate the normal vectors
-#ifdef _WIN32
-    Concurrency::parallel_for_each(_lValueList.begin(), _lValueList.end(), [rot](Base::Vector3f& value) {
-        value = rot * value;
-    });
-#else
-    QtConcurrent::blockingMap(_lValueList, [rot](Base::Vector3f& value) {
-        rot.multVec(value, value);
-    });
-#endif
+    PointsParallel::Rotate(_lValueList, rot);
 
     hasSetValue();
 }
@@ -527,11 +515,9 @@ void PropertyCurvatureList::transformGeometry(const Base::Matrix4D &mat)
     aboutToSetValue();
 
     // Rotate the principal directions
-    for (int ii=0; ii<getSize(); ii++) {
-        CurvatureInfo ci = operator[](ii);
-        ci.cMaxCurvDir = rot * ci.cMaxCurvDir;
-        ci.cMinCurvDir = rot * ci.cMinCurvDir;
-        set1Value(ii, ci);
+    if (!_lValueList.empty()) {
+        PointsParallel::Rotate(&_lValueList[0].cMaxCurvDir, _lValueList.size(), sizeof(CurvatureInfo), rot);
+        PointsParallel::Rotate(&_lValueList[0].cMinCurvDir, _lValueList.size(), sizeof(CurvatureInfo), rot);
     }
 
     hasSetValue();
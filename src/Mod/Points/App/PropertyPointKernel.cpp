@@ -29,6 +29,7 @@
 # include <algorithm>
 #endif
 
+#include <boost/functional/hash.hpp>
 #include <Base/Exception.h>
 #include <Base/Matrix.h>
 #include <Base/Stream.h>
@@ -54,10 +55,30 @@ PropertyPointKernel::~PropertyPointKernel()
 void PropertyPointKernel::setValue(const PointKernel& m)
 {
     aboutToSetValue();
+    detachPoints(false);
     *_cPoints = m;
     hasSetValue();
 }
 
+void PropertyPointKernel::detachPoints(bool copyData)
+{
+    // the points are referenced by another property, e.g. a snapshot
+    // of the undo/redo stack, which must not see the modification
+    if (_sharedPoints && _sharedPoints.use_count() > 1) {
+        PointKernel* kernel;
+        if (copyData) {
+            kernel = new PointKernel(*_cPoints);
+        }
+        else {
+            kernel = new PointKernel();
+            kernel->setTransform(_cPoints->getTransform());
+        }
+        _cPoints = kernel;
+    }
+
+    _sharedPoints.reset();
+}
+
 const PointKernel& PropertyPointKernel::getValue(void) const 
 {
     return *_cPoints;
@@ -114,6 +135,7 @@ void PropertyPointKernel::Restore(Base::XMLReader &reader)
         mtrx.fromString(Matrix);
 
         aboutToSetValue();
+        detachPoints(true);
         _cPoints->setTransform(mtrx);
         hasSetValue();
     }
@@ -128,14 +150,20 @@ void PropertyPointKernel::SaveDocFile (Base::Writer &writer) const
 void PropertyPointKernel::RestoreDocFile(Base::Reader &reader)
 {
     aboutToSetValue();
+    detachPoints(false);
     _cPoints->RestoreDocFile(reader);
     hasSetValue();
 }
 
 App::Property *PropertyPointKernel::Copy(void) const 
 {
+    // reference the same points, they get copied before either of
+    // the two properties modifies them
+    if (!_sharedPoints)
+        _sharedPoints = std::make_shared<int>(0);
     PropertyPointKernel* prop = new PropertyPointKernel();
-    (*prop->_cPoints) = (*this->_cPoints);
+    prop->_cPoints = this->_cPoints;
+    prop->_sharedPoints = this->_sharedPoints;
     return prop;
 }
 
@@ -143,7 +171,10 @@ void PropertyPointKernel::Paste(const App::Property &from)
 {
     aboutToSetValue();
     const PropertyPointKernel& prop = dynamic_cast<const PropertyPointKernel&>(from);
-    *(this->_cPoints) = *(prop._cPoints);
+    if (!prop._sharedPoints)
+        prop._sharedPoints = std::make_shared<int>(0);
+    _cPoints = prop._cPoints;
+    _sharedPoints = prop._sharedPoints;
     hasSetValue();
 }
 
@@ -152,9 +183,38 @@ unsigned int PropertyPointKernel::getMemSize (void) const
     return sizeof(Base::Vector3f) * this->_cPoints->size();
 }
 
+std::size_t PropertyPointKernel::getOwnedMemSize (void) const
+{
+    // the points are still referenced by another copy of this property
+    if (_sharedPoints && _sharedPoints.use_count() > 1)
+        return 0;
+    return getMemSize();
+}
+
+bool PropertyPointKernel::getValueHash(std::size_t& hash) const
+{
+    hash = 0;
+    Base::Matrix4D mat = _cPoints->getTransform();
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++)
+            boost::hash_combine(hash, mat[i][j]);
+    }
+
+    const std::vector<PointKernel::value_type>& points = _cPoints->getBasicPoints();
+    boost::hash_combine(hash, points.size());
+    for (std::vector<PointKernel::value_type>::const_iterator it = points.begin(); it != points.end(); ++it) {
+        boost::hash_combine(hash, it->x);
+        boost::hash_combine(hash, it->y);
+        boost::hash_combine(hash, it->z);
+    }
+
+    return true;
+}
+
 PointKernel* PropertyPointKernel::startEditing()
 {
     aboutToSetValue();
+    detachPoints(true);
     return static_cast<PointKernel*>(_cPoints);
 }
 
@@ -194,6 +254,7 @@ void PropertyPointKernel::removeIndices( const std::vector<unsigned long>& uIndi
 void PropertyPointKernel::transformGeometry(const Base::Matrix4D &rclMat)
 {
     aboutToSetValue();
+    detachPoints(true);
     _cPoints->transformGeometry(rclMat);
     hasSetValue();
 }
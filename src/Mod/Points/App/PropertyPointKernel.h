@@ -24,6 +24,7 @@
 #ifndef POINTS_PROPERTYPOINTKERNEL_H
 #define POINTS_PROPERTYPOINTKERNEL_H
 
+#include <memory>
 #include "Points.h"
 
 namespace Points
@@ -62,11 +63,17 @@ public:
 
     /** @name Undo/Redo */
     //@{
-    /// returns a new copy of the property (mainly for Undo/Redo and transactions)
+    /** returns a new copy of the property (mainly for Undo/Redo and transactions)
+     * The copy shares the points with this property until one of them gets modified.
+     */
     App::Property *Copy(void) const;
     /// paste the value from the property (mainly for Undo/Redo and transactions)
     void Paste(const App::Property &from);
     unsigned int getMemSize (void) const;
+    /// Returns 0 as long as the points are shared with another copy
+    std::size_t getOwnedMemSize (void) const;
+    /// Computes a hash of the points and the placement of the point cloud
+    bool getValueHash(std::size_t& hash) const;
     //@}
 
     /** @name Save/restore */
@@ -86,8 +93,14 @@ public:
     void removeIndices( const std::vector<unsigned long>& );
     //@}
 
+private:
+    /// makes sure that the points are not shared with a copy before modifying them
+    void detachPoints(bool copyData);
+
 private:
     Base::Reference<PointKernel> _cPoints;
+    /// shared by all copies of this property that reference the same points
+    mutable std::shared_ptr<int> _sharedPoints;
 };
 
 } // namespace Points
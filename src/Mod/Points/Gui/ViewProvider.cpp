@@ -39,6 +39,8 @@
 
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <limits>
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 
 /// Here the FreeCAD includes sorted by Base,App,Gui,...
 #include <Base/Console.h>
@@ -56,6 +58,7 @@
 
 #include <Gui/View3DInventorViewer.h>
 #include <Mod/Points/App/PointsFeature.h>
+#include <Mod/Points/App/PointsOctree.h>
 
 #include "ViewProvider.h"
 #include "../App/Properties.h"
@@ -116,13 +119,14 @@ void ViewProviderPoints::onChanged(const App::Property* prop)
 void ViewProviderPoints::setVertexColorMode(App::PropertyColorList* pcProperty)
 {
     const std::vector<App::Color>& val = pcProperty->getValues();
+    std::size_t num = displayIndices.empty() ? val.size() : displayIndices.size();
 
-    pcColorMat->diffuseColor.setNum(val.size());
+    pcColorMat->diffuseColor.setNum(num);
     SbColor* col = pcColorMat->diffuseColor.startEditing();
 
-    std::size_t i=0;
-    for (std::vector<App::Color>::const_iterator it = val.begin(); it != val.end(); ++it) {
-        col[i++].setValue(it->r, it->g, it->b);
+    for (std::size_t i=0; i<num; i++) {
+        const App::Color& c = val[displayIndices.empty() ? i : displayIndices[i]];
+        col[i].setValue(c.r, c.g, c.b);
     }
 
     pcColorMat->diffuseColor.finishEditing();
@@ -131,13 +135,14 @@ void ViewProviderPoints::setVertexColorMode(App::PropertyColorList* pcProperty)
 void ViewProviderPoints::setVertexGreyvalueMode(Points::PropertyGreyValueList* pcProperty)
 {
     const std::vector<float>& val = pcProperty->getValues();
+    std::size_t num = displayIndices.empty() ? val.size() : displayIndices.size();
 
-    pcColorMat->diffuseColor.setNum(val.size());
+    pcColorMat->diffuseColor.setNum(num);
     SbColor* col = pcColorMat->diffuseColor.startEditing();
 
-    std::size_t i=0;
-    for (std::vector<float>::const_iterator it = val.begin(); it != val.end(); ++it) {
-        col[i++].setValue(*it, *it, *it);
+    for (std::size_t i=0; i<num; i++) {
+        float grey = val[displayIndices.empty() ? i : displayIndices[i]];
+        col[i].setValue(grey, grey, grey);
     }
 
     pcColorMat->diffuseColor.finishEditing();
@@ -146,13 +151,14 @@ void ViewProviderPoints::setVertexGreyvalueMode(Points::PropertyGreyValueList* p
 void ViewProviderPoints::setVertexNormalMode(Points::PropertyNormalList* pcProperty)
 {
     const std::vector<Base::Vector3f>& val = pcProperty->getValues();
+    std::size_t num = displayIndices.empty() ? val.size() : displayIndices.size();
 
-    pcPointsNormal->vector.setNum(val.size());
+    pcPointsNormal->vector.setNum(num);
     SbVec3f* norm = pcPointsNormal->vector.startEditing();
 
-    std::size_t i=0;
-    for (std::vector<Base::Vector3f>::const_iterator it = val.begin(); it != val.end(); ++it) {
-        norm[i++].setValue(it->x, it->y, it->z);
+    for (std::size_t i=0; i<num; i++) {
+        const Base::Vector3f& n = val[displayIndices.empty() ? i : displayIndices[i]];
+        norm[i].setValue(n.x, n.y, n.z);
     }
 
     pcPointsNormal->vector.finishEditing();
@@ -161,6 +167,10 @@ void ViewProviderPoints::setVertexNormalMode(Points::PropertyNormalList* pcPrope
 void ViewProviderPoints::setDisplayMode(const char* ModeName)
 {
     int numPoints = pcPointsCoord->point.getNum();
+    if (!displayIndices.empty()) {
+        // only a level of detail is shown but the lists belong to all points
+        numPoints = static_cast<int>(static_cast<Points::Feature*>(pcObject)->Points.getValue().size());
+    }
 
     if (strcmp("Color",ModeName) == 0) {
         std::map<std::string,App::Property*> Map;
@@ -343,14 +353,22 @@ void ViewProviderPoints::clipPointsCallback(void *, SoEventCallback * n)
 
 PROPERTY_SOURCE(PointsGui::ViewProviderScattered, PointsGui::ViewProviderPoints)
 
+App::PropertyIntegerConstraint::Constraints ViewProviderScattered::intRange = {0,std::numeric_limits<int>::max(),100000};
+
 ViewProviderScattered::ViewProviderScattered()
+  : octree(0), octreeBuilder(0)
 {
+    ADD_PROPERTY(MaxDisplayPoints,(2000000));
+    MaxDisplayPoints.setConstraints(&intRange);
+
     pcPoints = new SoPointSet();
     pcPoints->ref();
 }
 
 ViewProviderScattered::~ViewProviderScattered()
 {
+    delete octreeBuilder;
+    delete octree;
     pcPoints->unref();
 }
 
@@ -404,11 +422,19 @@ void ViewProviderScattered::updateData(const App::Property* prop)
 {
     ViewProviderPoints::updateData(prop);
     if (prop->getTypeId() == Points::PropertyPointKernel::getClassTypeId()) {
-        ViewProviderPointsBuilder builder;
-        builder.createPoints(prop, pcPointsCoord, pcPoints);
+        // the octree of the old points is of no use any more
+        delete octree;
+        octree = 0;
+        if (needsOctree()) {
+            if (!octreeBuilder)
+                octreeBuilder = new OctreeBuilder(this);
+            octreeBuilder->start(*static_cast<const Points::PropertyPointKernel*>(prop));
+        }
+        else if (octreeBuilder) {
+            octreeBuilder->cancel();
+        }
 
-        // The number of points might have changed, so force also a resize of the Inventor internals
-        setActiveMode();
+        showPoints();
     }
     else if (prop->getTypeId() == Points::PropertyNormalList::getClassTypeId()) {
         setActiveMode();
@@ -421,6 +447,150 @@ void ViewProviderScattered::updateData(const App::Property* prop)
     }
 }
 
+void ViewProviderScattered::onChanged(const App::Property* prop)
+{
+    if (prop == &MaxDisplayPoints) {
+        if (pcObject) {
+            // the octree is kept, only a different level of detail is shown
+            if (!octree && needsOctree() && !(octreeBuilder && octreeBuilder->isRunning())) {
+                if (!octreeBuilder)
+                    octreeBuilder = new OctreeBuilder(this);
+                octreeBuilder->start(static_cast<Points::Feature*>(pcObject)->Points);
+            }
+            showPoints();
+        }
+    }
+    else {
+        ViewProviderPoints::onChanged(prop);
+    }
+}
+
+void ViewProviderScattered::setOctree(Points::PointsOctree* tree)
+{
+    delete octree;
+    octree = tree;
+    showPoints();
+}
+
+bool ViewProviderScattered::needsOctree() const
+{
+    unsigned long limit = static_cast<unsigned long>(MaxDisplayPoints.getValue());
+    const Points::PointKernel& kernel = static_cast<Points::Feature*>(pcObject)->Points.getValue();
+    return limit > 0 && kernel.size() > limit;
+}
+
+void ViewProviderScattered::showPoints()
+{
+    // show the level of detail of the octree for big clouds
+    const Points::PropertyPointKernel& prop = static_cast<Points::Feature*>(pcObject)->Points;
+    unsigned long limit = static_cast<unsigned long>(MaxDisplayPoints.getValue());
+    displayIndices.clear();
+    if (needsOctree()) {
+        if (octree) {
+            octree->LevelOfDetail(limit, displayIndices);
+            std::sort(displayIndices.begin(), displayIndices.end());
+        }
+        else {
+            // while the octree is being built every n-th point is shown
+            unsigned long count = prop.getValue().size();
+            unsigned long step = (count + limit - 1) / limit;
+            displayIndices.reserve(count / step + 1);
+            for (unsigned long index = 0; index < count; index += step)
+                displayIndices.push_back(index);
+        }
+    }
+
+    ViewProviderPointsBuilder builder;
+    if (displayIndices.empty())
+        builder.createPoints(&prop, pcPointsCoord, pcPoints);
+    else
+        builder.createPoints(&prop, pcPointsCoord, pcPoints, displayIndices);
+
+    // The number of points might have changed, so force also a resize of the Inventor internals
+    setActiveMode();
+}
+
+// -------------------------------------------------
+
+namespace {
+Points::PointsOctree* buildOctree(const Points::PropertyPointKernel* prop)
+{
+    Points::PointsOctree* octree = new Points::PointsOctree();
+    octree->Build(prop->getValue());
+    return octree;
+}
+}
+
+OctreeBuilder::OctreeBuilder(ViewProviderScattered* vp)
+  : view(vp)
+  , watcher(new QFutureWatcher<Points::PointsOctree*>(this))
+  , running(0)
+  , pending(0)
+  , discard(false)
+{
+    connect(watcher, SIGNAL(finished()), this, SLOT(onFinished()));
+}
+
+OctreeBuilder::~OctreeBuilder()
+{
+    // the worker thread still reads the points
+    if (running) {
+        watcher->waitForFinished();
+        delete watcher->result();
+        delete running;
+    }
+    delete pending;
+}
+
+void OctreeBuilder::start(const Points::PropertyPointKernel& prop)
+{
+    // the copy shares the points and keeps them alive if the property changes
+    delete pending;
+    pending = prop.Copy();
+    if (running)
+        discard = true;
+    else
+        run();
+}
+
+void OctreeBuilder::cancel()
+{
+    delete pending;
+    pending = 0;
+    discard = (running != 0);
+}
+
+bool OctreeBuilder::isRunning() const
+{
+    return running != 0;
+}
+
+void OctreeBuilder::run()
+{
+    running = pending;
+    pending = 0;
+    discard = false;
+    watcher->setFuture(QtConcurrent::run(&buildOctree,
+        static_cast<const Points::PropertyPointKernel*>(running)));
+}
+
+void OctreeBuilder::onFinished()
+{
+    Points::PointsOctree* octree = watcher->result();
+    delete running;
+    running = 0;
+
+    // the points have changed in the meantime
+    if (discard) {
+        delete octree;
+        if (pending)
+            run();
+    }
+    else {
+        view->setOctree(octree);
+    }
+}
+
 void ViewProviderScattered::cut(const std::vector<SbVec2f>& picked, Gui::View3DInventorViewer &Viewer)
 {
     // create the polygon from the picked points
@@ -678,6 +848,26 @@ void ViewProviderPointsBuilder::createPoints(const App::Property* prop, SoCoordi
     coords->point.finishEditing();
 }
 
+void ViewProviderPointsBuilder::createPoints(const App::Property* prop, SoCoordinate3* coords, SoPointSet* points,
+                                             const std::vector<unsigned long>& indices) const
+{
+    const Points::PropertyPointKernel* prop_points = static_cast<const Points::PropertyPointKernel*>(prop);
+    const Points::PointKernel& cPts = prop_points->getValue();
+
+    coords->point.setNum(indices.size());
+    SbVec3f* vec = coords->point.startEditing();
+
+    // get the given points
+    const std::vector<Points::PointKernel::value_type>& kernel = cPts.getBasicPoints();
+    for (std::size_t idx = 0; idx < indices.size(); idx++) {
+        const Points::PointKernel::value_type& pnt = kernel[indices[idx]];
+        vec[idx].setValue(pnt.x, pnt.y, pnt.z);
+    }
+
+    points->numPoints = indices.size();
+    coords->point.finishEditing();
+}
+
 void ViewProviderPointsBuilder::createPoints(const App::Property* prop, SoCoordinate3* coords, SoIndexedPointSet* points) const
 {
     const Points::PropertyPointKernel* prop_points = static_cast<const Points::PropertyPointKernel*>(prop);
@@ -709,3 +899,5 @@ void ViewProviderPointsBuilder::createPoints(const App::Property* prop, SoCoordi
     }
     points->coordIndex.finishEditing();
 }
+
+#include "moc_ViewProvider.cpp"
@@ -28,6 +28,7 @@
 #include <Gui/ViewProviderPythonFeature.h>
 #include <Gui/ViewProviderBuilder.h>
 #include <Inventor/SbVec2f.h>
+#include <QObject>
 
 
 class SoSwitch;
@@ -49,12 +50,18 @@ namespace Gui {
 namespace Points {
     class PropertyGreyValueList;
     class PropertyNormalList;
+    class PropertyPointKernel;
     class PointKernel;
+    class PointsOctree;
     class Feature;
 }
 
+template <typename T> class QFutureWatcher;
+
 namespace PointsGui {
 
+class OctreeBuilder;
+
 class ViewProviderPointsBuilder : public Gui::ViewProviderBuilder
 {
 public:
@@ -62,6 +69,8 @@ public:
     ~ViewProviderPointsBuilder(){}
     virtual void buildNodes(const App::Property*, std::vector<SoNode*>&) const;
     void createPoints(const App::Property*, SoCoordinate3*, SoPointSet*) const;
+    /// Only creates the points with the given indices
+    void createPoints(const App::Property*, SoCoordinate3*, SoPointSet*, const std::vector<unsigned long>&) const;
     void createPoints(const App::Property*, SoCoordinate3*, SoIndexedPointSet*) const;
 };
 
@@ -107,6 +116,8 @@ protected:
     SoMaterial          * pcColorMat;
     SoNormal            * pcPointsNormal;
     SoDrawStyle         * pcPointStyle;
+    /// The indices of the displayed points if only a level of detail is shown
+    std::vector<unsigned long> displayIndices;
 
 private:
     static App::PropertyFloatConstraint::Constraints floatRange;
@@ -125,6 +136,9 @@ public:
     ViewProviderScattered();
     virtual ~ViewProviderScattered();
 
+    /// Shows an evenly distributed subset of bigger point clouds, 0 shows all points
+    App::PropertyIntegerConstraint MaxDisplayPoints;
+
     /**
      * Extracts the point data from the feature \a pcFeature and creates
      * an Inventor node \a SoNode with these data. 
@@ -132,12 +146,59 @@ public:
     virtual void attach(App::DocumentObject *);
     /// Update the point representation
     virtual void updateData(const App::Property*);
+    /// Takes the octree of the current points, called when it has been built
+    void setOctree(Points::PointsOctree*);
 
 protected:
+    void onChanged(const App::Property* prop);
     virtual void cut(const std::vector<SbVec2f>& picked, Gui::View3DInventorViewer &Viewer);
 
+private:
+    bool needsOctree() const;
+    void showPoints();
+
 protected:
     SoPointSet          * pcPoints;
+
+private:
+    // the octree of the current points, kept until the points change
+    Points::PointsOctree* octree;
+    OctreeBuilder* octreeBuilder;
+    static App::PropertyIntegerConstraint::Constraints intRange;
+};
+
+/**
+ * The OctreeBuilder class builds the octree of a point cloud in a worker
+ * thread and passes it to the view provider when it is done, so that the GUI
+ * isn't blocked by big point clouds.
+ */
+class OctreeBuilder : public QObject
+{
+    Q_OBJECT
+
+public:
+    OctreeBuilder(ViewProviderScattered*);
+    ~OctreeBuilder();
+
+    /// Builds the octree of the points, a running build is discarded
+    void start(const Points::PropertyPointKernel&);
+    /// Discards a running build
+    void cancel();
+    bool isRunning() const;
+
+private Q_SLOTS:
+    void onFinished();
+
+private:
+    void run();
+
+private:
+    ViewProviderScattered* view;
+    QFutureWatcher<Points::PointsOctree*>* watcher;
+    // copies of the points property that share the points with it
+    App::Property* running;
+    App::Property* pending;
+    bool discard;
 };
 
 /**
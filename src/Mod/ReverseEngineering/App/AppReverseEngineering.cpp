@@ -39,6 +39,7 @@
 #include <Mod/Part/App/BSplineSurfacePy.h>
 #include <Mod/Mesh/App/Mesh.h>
 #include <Mod/Mesh/App/MeshPy.h>
+#include <Mod/Points/App/PointsAnalysis.h>
 #include <Mod/Points/App/PointsPy.h>
 
 #include "ApproxSurface.h"
@@ -113,6 +114,7 @@ public:
         add_keyword_method("filterVoxelGrid",&Module::filterVoxelGrid,
             "filterVoxelGrid(dim)."
         );
+#endif
         add_keyword_method("normalEstimation",&Module::normalEstimation,
             "normalEstimation(Points,[KSearch=0, SearchRadius=0]) -> Normals\n"
             "KSearch is an int and used to search the k-nearest neighbours in\n"
@@ -131,7 +133,6 @@ public:
             "f.ViewObject.Proxy=0\n"
             "f.ViewObject.DisplayMode=1\n"
         );
-#endif
 #if defined(HAVE_PCL_SEGMENTATION)
         add_keyword_method("regionGrowingSegmentation",&Module::regionGrowingSegmentation,
             "regionGrowingSegmentation()."
@@ -624,7 +625,6 @@ Mesh.show(m)
         return Py::asObject(new Points::PointsPy(points_sample));
     }
 #endif
-#if defined(HAVE_PCL_FILTERS)
     Py::Object normalEstimation(const Py::Tuple& args, const Py::Dict& kwds)
     {
         PyObject *pts;
@@ -640,10 +640,15 @@ Mesh.show(m)
         Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
 
         std::vector<Base::Vector3d> normals;
-        NormalEstimation estimate(*points);
-        estimate.setKSearch(ksearch);
-        estimate.setSearchRadius(searchRadius);
-        estimate.perform(normals);
+        try {
+            Points::NormalEstimation estimate(*points);
+            estimate.setKSearch(ksearch);
+            estimate.setSearchRadius(searchRadius);
+            estimate.perform(normals);
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
 
         Py::List list;
         for (std::vector<Base::Vector3d>::iterator it = normals.begin(); it != normals.end(); ++it) {
@@ -652,7 +657,6 @@ Mesh.show(m)
 
         return list;
     }
-#endif
 #if defined(HAVE_PCL_SEGMENTATION)
     Py::Object regionGrowingSegmentation(const Py::Tuple& args, const Py::Dict& kwds)
     {
@@ -434,6 +434,36 @@ class DocumentSaveRestoreCases(unittest.TestCase):
     self.failUnless(self.Doc.Label_1.TypeTransient == 4711)
     self.failUnless(self.Doc == FreeCAD.getDocument(self.Doc.Name))
 
+  def testParallelSave(self):
+    # the files must be the same no matter how many threads are used
+    import zipfile
+    for i in range(1,4):
+      getattr(self.Doc, "Label_%d" % i).FloatList = [float(j) for j in range(i * 1000)]
+      getattr(self.Doc, "Label_%d" % i).VectorList = [FreeCAD.Vector(j, i, 0) for j in range(i * 1000)]
+    param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Document")
+    threads = param.GetInt("SaveThreads", 0)
+    names = []
+    for num in (4, 1):
+      param.SetInt("SaveThreads", num)
+      name = self.TempPath + os.sep + "ParallelSave%d.FCStd" % num
+      self.Doc.saveAs(name)
+      names.append(name)
+    param.SetInt("SaveThreads", threads)
+
+    parallel = zipfile.ZipFile(names[0])
+    serial = zipfile.ZipFile(names[1])
+    self.failUnless(serial.namelist() == parallel.namelist())
+    for entry in serial.namelist():
+      if entry != "Document.xml":
+        self.failUnless(serial.read(entry) == parallel.read(entry))
+    serial.close()
+    parallel.close()
+
+    Doc = FreeCAD.open(names[0])
+    self.failUnless(Doc.Label_3.FloatList[2999] == 2999.0)
+    self.failUnless(Doc.Label_2.VectorList[1999] == FreeCAD.Vector(1999, 2, 0))
+    FreeCAD.closeDocument(Doc.Name)
+
   def testRestore(self):
     Doc = FreeCAD.newDocument("RestoreTests")
     Doc.addObject("App::FeatureTest","Label_1")
@@ -609,6 +639,25 @@ class DocumentRecomputeCases(unittest.TestCase):
     self.Doc.removeObject(L7.Name)
     self.Doc.removeObject(L8.Name)
 
+  def testRecomputeProfile(self):
+    L1 = self.Doc.addObject("App::FeatureTest","Label_1")
+    L2 = self.Doc.addObject("App::FeatureTest","Label_2")
+    L3 = self.Doc.addObject("App::FeatureTest","Label_3")
+    L1.LinkList = [L2,L3]
+    L2.Link = L3
+    L3.enforceRecompute()
+
+    self.Doc.RecomputeProfiling = True
+    self.failUnless(self.Doc.RecomputeProfiling)
+    self.failUnless(self.Doc.recompute()==3)
+    profile = self.Doc.recomputeProfile()
+    self.failUnless(len(profile["Objects"])==3)
+    self.failUnless(profile["CriticalPath"]==[L3.Name,L2.Name,L1.Name])
+    self.failUnless(profile["TotalTime"] >= profile["CriticalPathTime"])
+    self.failUnless(self.Doc.recomputeProfile("json").startswith("{"))
+    self.failUnless("traceEvents" in self.Doc.recomputeProfile("trace"))
+    self.Doc.RecomputeProfiling = False
+
   def tearDown(self):
     #closing doc
     FreeCAD.closeDocument("RecomputeTests")
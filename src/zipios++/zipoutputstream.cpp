@@ -56,6 +56,17 @@ void ZipOutputStream::putNextEntry(const std::string& entryName) {
 }
 
 
+void ZipOutputStream::putDeflatedEntry(const std::string& entryName, const std::string& data,
+                                       uint32 crc, uint32 size) {
+  ozf->putDeflatedEntry( ZipCDirEntry(entryName), data, crc, size ) ;
+}
+
+
+int ZipOutputStream::getLevel() const {
+  return ozf->getLevel() ;
+}
+
+
 void ZipOutputStream::setComment( const std::string &comment ) {
   ozf->setComment( comment ) ;
 }
@@ -54,6 +54,15 @@ public:
   */
   void putNextEntry(const std::string& entryName);
 
+  /** Writes a complete entry whose data has already been compressed
+      with ZipOutputStreambuf::deflateData().
+  */
+  void putDeflatedEntry(const std::string& entryName, const std::string& data,
+                        uint32 crc, uint32 size);
+
+  /** Returns the compression level used for subsequent entries. */
+  int getLevel() const ;
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const std::string& comment ) ;
 
@@ -81,6 +81,59 @@ void ZipOutputStreambuf::putNextEntry( const ZipCDirEntry &entry ) {
 }
 
 
+void ZipOutputStreambuf::putDeflatedEntry( const ZipCDirEntry &entry, const string &data,
+					   uint32 crc, uint32 size ) {
+  if ( _open_entry )
+    closeEntry() ;
+
+  _entries.push_back( entry ) ;
+  ZipCDirEntry &ent = _entries.back() ;
+
+  ostream os( _outbuf ) ;
+
+  // The sizes are already known, so the header can be written directly
+  ent.setLocalHeaderOffset( os.tellp() ) ;
+  ent.setMethod( _method ) ;
+  ent.setSize( size ) ;
+  ent.setCrc( crc ) ;
+  ent.setCompressedSize( data.size() ) ;
+  ent.setTime( currentDosTime() ) ;
+
+  os << static_cast< ZipLocalEntry >( ent ) ;
+  os.write( data.data(), data.size() ) ;
+}
+
+
+bool ZipOutputStreambuf::deflateData( const char *in, size_t len, int level,
+				      string &out, uint32 &crc ) {
+  // same settings as DeflateOutputStreambuf::init()
+  static const int default_mem_level = 8 ;
+
+  z_stream zs ;
+  zs.zalloc = Z_NULL ;
+  zs.zfree  = Z_NULL ;
+  zs.opaque = Z_NULL ;
+  if ( deflateInit2( &zs, level, Z_DEFLATED, -MAX_WBITS,
+		     default_mem_level, Z_DEFAULT_STRATEGY ) != Z_OK )
+    return false ;
+
+  crc = crc32( 0, Z_NULL, 0 ) ;
+  crc = crc32( crc, reinterpret_cast< const Bytef * >( in ), len ) ;
+
+  out.resize( deflateBound( &zs, len ) ) ;
+  zs.next_in   = reinterpret_cast< Bytef * >( const_cast< char * >( in ) ) ;
+  zs.avail_in  = len ;
+  zs.next_out  = reinterpret_cast< Bytef * >( &( out[ 0 ] ) ) ;
+  zs.avail_out = out.size() ;
+
+  int err = deflate( &zs, Z_FINISH ) ;
+  out.resize( out.size() - zs.avail_out ) ;
+  deflateEnd( &zs ) ;
+
+  return err == Z_STREAM_END ;
+}
+
+
 void ZipOutputStreambuf::setComment( const string &comment ) {
   _zip_comment = comment ;
 }
@@ -147,13 +200,7 @@ void ZipOutputStreambuf::updateEntryHeaderInfo() {
 			   - entry.getLocalHeaderSize() ) ;
 
   // Mark Donszelmann: added current date and time
-  time_t ltime;
-  time( &ltime );
-  struct tm *now;
-  now = localtime( &ltime );
-  int dosTime = (now->tm_year - 80) << 25 | (now->tm_mon + 1) << 21 | now->tm_mday << 16 |
-              now->tm_hour << 11 | now->tm_min << 5 | now->tm_sec >> 1;
-  entry.setTime(dosTime);
+  entry.setTime(currentDosTime());
 
   // write ZipLocalEntry header to header position
   os.seekp( entry.getLocalHeaderOffset() ) ;
@@ -162,6 +209,16 @@ void ZipOutputStreambuf::updateEntryHeaderInfo() {
 }
 
 
+int ZipOutputStreambuf::currentDosTime() {
+  time_t ltime;
+  time( &ltime );
+  struct tm *now;
+  now = localtime( &ltime );
+  return (now->tm_year - 80) << 25 | (now->tm_mon + 1) << 21 | now->tm_mday << 16 |
+         now->tm_hour << 11 | now->tm_min << 5 | now->tm_sec >> 1;
+}
+
+
 void ZipOutputStreambuf::writeCentralDirectory( const vector< ZipCDirEntry > &entries, 
 						EndOfCentralDirectory eocd, 
 						ostream &os ) {
@@ -49,6 +49,25 @@ public:
       entry. */
   void putNextEntry( const ZipCDirEntry &entry ) ;
 
+  /** Writes a complete entry whose data has already been compressed with
+      deflateData(), e.g. by another thread. The current entry (if one is
+      open) is closed first.
+      @param data the compressed data.
+      @param crc the crc32 of the uncompressed data.
+      @param size the size of the uncompressed data. */
+  void putDeflatedEntry( const ZipCDirEntry &entry, const string &data,
+                         uint32 crc, uint32 size ) ;
+
+  /** Compresses a buffer with the same settings that are used for
+      entries written through this streambuf, so that the result can be
+      passed to putDeflatedEntry().
+      @return true on success. */
+  static bool deflateData( const char *in, size_t len, int level,
+                           string &out, uint32 &crc ) ;
+
+  /** Returns the compression level used for subsequent entries. */
+  int getLevel() const { return _level ; }
+
   /** Sets the global comment for the Zip archive. */
   void setComment( const string &comment ) ;
 
@@ -68,6 +87,7 @@ protected:
 
   void setEntryClosedState() ;
   void updateEntryHeaderInfo() ;
+  static int currentDosTime() ;
 
   // Should/could be moved to zipheadio.h ?!
   static void writeCentralDirectory( const vector< ZipCDirEntry > &entries, 